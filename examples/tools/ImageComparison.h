@@ -0,0 +1,39 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef IMAGECOMPARISON_H
+#define IMAGECOMPARISON_H
+
+#include <QImage>
+
+/** Returns the largest difference of a color channel between two images of the
+    same size. Tests use it to compare two ways of painting the same thing, e.g.
+    through a cache and directly, that may round blended colors differently.
+*/
+inline int maximumDifference(const QImage &first, const QImage &second)
+{
+    Q_ASSERT(first.size() == second.size());
+    const QImage a = first.convertToFormat(QImage::Format_ARGB32);
+    const QImage b = second.convertToFormat(QImage::Format_ARGB32);
+    int difference = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const QRgb pa = a.pixel(x, y);
+            const QRgb pb = b.pixel(x, y);
+            difference = qMax(difference, qAbs(qRed(pa) - qRed(pb)));
+            difference = qMax(difference, qAbs(qGreen(pa) - qGreen(pb)));
+            difference = qMax(difference, qAbs(qBlue(pa) - qBlue(pb)));
+            difference = qMax(difference, qAbs(qAlpha(pa) - qAlpha(pb)));
+        }
+    }
+    return difference;
+}
+
+#endif // IMAGECOMPARISON_H
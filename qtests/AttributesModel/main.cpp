@@ -14,6 +14,7 @@
 #include <KDChartDataValueAttributes>
 #include <KDChartGlobal>
 #include <KDChartLineDiagram>
+#include <QStandardItemModel>
 #include <QtTest/QtTest>
 #include <TableModel.h>
 
@@ -137,6 +138,74 @@ private slots:
         QCOMPARE(b.isVisible(), false); // No sharing
     }
 
+    void testKDChartAttributesModelCellDataColumnRemoval()
+    {
+        QStandardItemModel model(10, 4);
+        AttributesModel attrsmodel(&model, nullptr);
+        attrsmodel.setData(attrsmodel.index(3, 1), true, DataHiddenRole);
+        attrsmodel.setData(attrsmodel.index(3, 3), true, DataHiddenRole);
+        QCOMPARE(attrsmodel.data(attrsmodel.index(3, 3), DataHiddenRole).toBool(), true);
+        QVERIFY(!attrsmodel.data(attrsmodel.index(4, 3), DataHiddenRole).isValid());
+
+        // the cells of the columns behind the removed ones move along
+        model.removeColumns(1, 2);
+        QCOMPARE(attrsmodel.data(attrsmodel.index(3, 1), DataHiddenRole).toBool(), true);
+        QVERIFY(!attrsmodel.data(attrsmodel.index(3, 0), DataHiddenRole).isValid());
+
+        attrsmodel.resetData(attrsmodel.index(3, 1), DataHiddenRole);
+        QVERIFY(!attrsmodel.data(attrsmodel.index(3, 1), DataHiddenRole).isValid());
+    }
+
+    void testKDChartAttributesModelCellData()
+    {
+        QStandardItemModel model(10, 4);
+        AttributesModel attrsmodel(&model, nullptr);
+        attrsmodel.setHeaderData(2, Qt::Horizontal, QVariant::fromValue(QPen(Qt::red)), DatasetPenRole);
+        attrsmodel.setData(attrsmodel.index(5, 2), QVariant::fromValue(QPen(Qt::blue)), DatasetPenRole);
+
+        // data() falls back to the dataset, cellData() does not
+        QCOMPARE(attrsmodel.data(attrsmodel.index(4, 2), DatasetPenRole).value<QPen>().color(), QColor(Qt::red));
+        QVERIFY(!attrsmodel.cellData(attrsmodel.index(4, 2), DatasetPenRole).isValid());
+        QCOMPARE(attrsmodel.cellData(attrsmodel.index(5, 2), DatasetPenRole).value<QPen>().color(), QColor(Qt::blue));
+
+        // values of the source model count as cell data
+        model.setData(model.index(6, 2), QVariant::fromValue(QPen(Qt::green)), DatasetPenRole);
+        QCOMPARE(attrsmodel.cellData(attrsmodel.index(6, 2), DatasetPenRole).value<QPen>().color(), QColor(Qt::green));
+    }
+
+    void benchmarkCellAttributeLookup_data()
+    {
+        QTest::addColumn<bool>("cellOverrides");
+        QTest::newRow("dataset attributes only") << false;
+        QTest::newRow("every 10th cell overridden") << true;
+    }
+
+    void benchmarkCellAttributeLookup()
+    {
+        QFETCH(bool, cellOverrides);
+        const int rowCount = 1000;
+        const int columnCount = 8;
+        QStandardItemModel model(rowCount, columnCount);
+        AttributesModel attrsmodel(&model, nullptr);
+        DataValueAttributes visible;
+        visible.setVisible(true);
+        attrsmodel.setHeaderData(2, Qt::Horizontal, QVariant::fromValue(visible), DataValueLabelAttributesRole);
+        if (cellOverrides) {
+            for (int row = 0; row < rowCount; row += 10)
+                for (int column = 0; column < columnCount; ++column)
+                    attrsmodel.setData(attrsmodel.index(row, column), QVariant::fromValue(visible), DataValueLabelAttributesRole);
+        }
+        QCOMPARE(attrsmodel.data(attrsmodel.index(1, 2), DataValueLabelAttributesRole).value<DataValueAttributes>().isVisible(), true);
+        QCOMPARE(attrsmodel.data(attrsmodel.index(1, 3), DataValueLabelAttributesRole).value<DataValueAttributes>().isVisible(), false);
+        QCOMPARE(attrsmodel.data(attrsmodel.index(10, 3), DataValueLabelAttributesRole).value<DataValueAttributes>().isVisible(), cellOverrides);
+
+        QBENCHMARK {
+            for (int row = 0; row < rowCount; ++row)
+                for (int column = 0; column < columnCount; ++column)
+                    attrsmodel.data(attrsmodel.index(row, column), DataValueLabelAttributesRole);
+        }
+    }
+
     void cleanupTestCase()
     {
         delete m_plane;
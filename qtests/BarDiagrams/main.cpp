@@ -13,6 +13,8 @@
 #include <KDChartChart>
 #include <KDChartGlobal>
 #include <KDChartThreeDBarAttributes>
+#include <QImage>
+#include <QPainter>
 #include <QtTest/QtTest>
 
 #include <TableModel.h>
@@ -176,6 +178,44 @@ private slots:
         QVERIFY(m_bars->threeDBarAttributes().angle() == 75);
     }
 
+    void testReverseMapping()
+    {
+        Chart chart;
+        auto *bars = new BarDiagram();
+        bars->setModel(m_model);
+        chart.coordinatePlane()->replaceDiagram(bars);
+
+        QImage image(400, 300, QImage::Format_ARGB32);
+        {
+            QPainter painter(&image);
+            chart.paint(&painter, image.rect());
+        }
+
+        int hits = 0;
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            for (int column = 0; column < m_model->columnCount(); ++column) {
+                const QModelIndex index = m_model->index(row, column);
+                const QRect rect = bars->visualRect(index);
+                if (rect.width() < 3 || rect.height() < 3)
+                    continue;
+                QVERIFY(bars->indexesAt(rect.center()).contains(index));
+                QVERIFY(bars->indexesIn(rect).contains(index));
+                ++hits;
+            }
+        }
+        QVERIFY(hits > 0);
+        QVERIFY(bars->indexesAt(QPoint(-10, -10)).isEmpty());
+
+        bars->setReverseMappingEnabled(false);
+        QVERIFY(!bars->isReverseMappingEnabled());
+        {
+            QPainter painter(&image);
+            chart.paint(&painter, image.rect());
+        }
+        QVERIFY(bars->visualRect(m_model->index(0, 0)).isEmpty());
+        QVERIFY(bars->indexesIn(image.rect()).isEmpty());
+    }
+
     void cleanupTestCase()
     {
     }
@@ -14,10 +14,41 @@
 #include <QtDebug>
 #include <QtTest/QtTest>
 
+#include <cmath>
+#include <limits>
+
+#include <KDChartAttributesModel>
 #include <KDChartCartesianDiagramDataCompressor_p.h>
+#include <KDChartColumnarDataSource>
+#include <KDChartStreamingModel>
 
 typedef KDChart::CartesianDiagramDataCompressor::CachePosition CachePosition;
 
+// a QStandardItemModel that additionally exposes its display values as arrays
+class ColumnarModel : public QStandardItemModel, public KDChart::ColumnarDataSource
+{
+public:
+    const double *columnData(int column) const override
+    {
+        return columns.at(column).constData();
+    }
+
+    void fill(int rowCount, int columnCount)
+    {
+        setColumnCount(columnCount);
+        setRowCount(rowCount);
+        columns.fill(QVector<double>(rowCount), columnCount);
+        for (int row = 0; row < rowCount; ++row)
+            for (int column = 0; column < columnCount; ++column) {
+                const double value = (row * 7 + column * 13) % 17;
+                columns[column][row] = value;
+                setData(index(row, column), value);
+            }
+    }
+
+    QVector<QVector<double>> columns;
+};
+
 struct Match
 {
     Match(const CachePosition &pos, const QModelIndex &index)
@@ -180,6 +211,271 @@ private slots:
                  "datasetDimension == 1 should restore the old column count");
     }
 
+    void columnarDataSourceTest()
+    {
+        ColumnarModel columnarModel;
+        columnarModel.fill(RowCount, ColumnCount);
+        QStandardItemModel plainModel;
+        plainModel.setColumnCount(ColumnCount);
+        plainModel.setRowCount(RowCount);
+        for (int row = 0; row < RowCount; ++row)
+            for (int column = 0; column < ColumnCount; ++column)
+                plainModel.setData(plainModel.index(row, column), columnarModel.columns[column][row]);
+
+        QVERIFY(KDChart::ColumnarDataSource::fromModel(&columnarModel) == &columnarModel);
+        QVERIFY(KDChart::ColumnarDataSource::fromModel(&plainModel) == nullptr);
+
+        KDChart::CartesianDiagramDataCompressor columnar;
+        KDChart::CartesianDiagramDataCompressor plain;
+        columnar.setModel(&columnarModel);
+        plain.setModel(&plainModel);
+        columnar.setResolution(width, height);
+        plain.setResolution(width, height);
+        for (int column = 0; column < columnar.modelDataColumns(); ++column) {
+            for (int row = 0; row < columnar.modelDataRows(); ++row) {
+                const CachePosition position(row, column);
+                QCOMPARE(columnar.data(position).key, plain.data(position).key);
+                QCOMPARE(columnar.data(position).value, plain.data(position).value);
+                QCOMPARE(columnar.data(position).hidden, plain.data(position).hidden);
+                QCOMPARE(columnar.data(position).index.row(), plain.data(position).index.row());
+            }
+        }
+    }
+
+    void pyramidTest()
+    {
+        const int rowCount = 5000;
+        QVector<double> values(rowCount);
+        for (int row = 0; row < rowCount; ++row)
+            values[row] = row % 97 == 3 ? std::numeric_limits<double>::quiet_NaN() : (row * 7919) % 1013;
+        const KDChart::CartesianDiagramDataPyramid::ValueReader reader = [&values](int row) {
+            return values.at(row);
+        };
+
+        KDChart::CartesianDiagramDataPyramid pyramid;
+        pyramid.build(reader, rowCount);
+        // appending in chunks gives the same result as building at once
+        KDChart::CartesianDiagramDataPyramid appended;
+        for (int appendedRows = 0; appendedRows < rowCount; appendedRows = qMin(appendedRows + 333, rowCount))
+            appended.append(reader, qMin(appendedRows + 333, rowCount));
+        QCOMPARE(appended.rowCount(), rowCount);
+
+        const int ranges[][2] = {{0, 5000}, {0, 1}, {31, 33}, {32, 64}, {5, 4999}, {1000, 3001}, {4990, 5000}, {96, 101}};
+        for (const auto &range : ranges) {
+            KDChart::CartesianDiagramDataPyramid::Aggregate expected;
+            for (int row = range[0]; row < range[1]; ++row)
+                expected.add(row, values.at(row));
+            for (const KDChart::CartesianDiagramDataPyramid *p : {&pyramid, &appended}) {
+                const KDChart::CartesianDiagramDataPyramid::Aggregate actual = p->aggregate(reader, range[0], range[1]);
+                QCOMPARE(actual.count, expected.count);
+                QCOMPARE(actual.sum, expected.sum);
+                QCOMPARE(actual.min, expected.min);
+                QCOMPARE(actual.max, expected.max);
+                QCOMPARE(values.at(actual.minRow), expected.min);
+                QCOMPARE(values.at(actual.maxRow), expected.max);
+            }
+        }
+
+        values[2500] = 5000;
+        pyramid.update(reader, 2500, 2500);
+        QCOMPARE(pyramid.aggregate(reader, 0, rowCount).max, 5000.0);
+        QCOMPARE(pyramid.aggregate(reader, 0, rowCount).maxRow, 2500);
+    }
+
+    void pyramidCompressorTest()
+    {
+        // many rows per bucket, the buckets are aggregated from the pyramid
+        ColumnarModel columnarModel;
+        columnarModel.fill(20000, 2);
+        KDChart::CartesianDiagramDataCompressor compressor;
+        compressor.setModel(&columnarModel);
+        for (int resolution : {20, 100, 7}) {
+            compressor.setResolution(resolution, height);
+            QCOMPARE(compressor.modelDataRows(), resolution);
+            const qreal rowsPerBucket = 20000.0 / resolution;
+            for (int row = 0; row < compressor.modelDataRows(); ++row) {
+                const int baseRow = std::floor(row * rowsPerBucket);
+                const int endRow = std::floor((row + 1) * rowsPerBucket);
+                qreal sum = 0;
+                for (int modelRow = baseRow; modelRow < endRow; ++modelRow)
+                    sum += columnarModel.columns[1][modelRow];
+                const KDChart::CartesianDiagramDataCompressor::DataPoint &point = compressor.data(CachePosition(row, 1));
+                QCOMPARE(point.key, (baseRow + endRow - 1) / 2.0);
+                QCOMPARE(point.value, sum / (endRow - baseRow));
+                QCOMPARE(point.index.row(), baseRow);
+            }
+        }
+    }
+
+    void boundsTest()
+    {
+        QVector<QPointF> points;
+        const KDChart::CartesianDiagramDataBounds::PointReader reader = [&points](int row) {
+            return points.at(row);
+        };
+        KDChart::CartesianDiagramDataBounds bounds;
+        auto verify = [&]() {
+            KDChart::CartesianDiagramDataBounds::Box expected;
+            for (const QPointF &point : qAsConst(points))
+                expected.add(point);
+            const KDChart::CartesianDiagramDataBounds::Box actual = bounds.bounds(reader);
+            QCOMPARE(actual.count, expected.count);
+            QCOMPARE(actual.missingCount, expected.missingCount);
+            if (expected.count > 0) {
+                QCOMPARE(actual.xMin, expected.xMin);
+                QCOMPARE(actual.xMax, expected.xMax);
+                QCOMPARE(actual.yMin, expected.yMin);
+                QCOMPARE(actual.yMax, expected.yMax);
+            }
+        };
+
+        for (int row = 0; row < 1000; ++row)
+            points << QPointF(row, row % 89 == 5 ? std::numeric_limits<double>::quiet_NaN() : (row * 7919) % 1013);
+        bounds.build(points.size());
+        verify();
+
+        // shrinking the extreme values
+        for (int row = 0; row < points.size(); ++row) {
+            if (points[row].y() > 1000) {
+                points[row].setY(500);
+                bounds.markChanged(row, row);
+            }
+        }
+        verify();
+        points[17].setY(-3);
+        points[18].setY(std::numeric_limits<double>::quiet_NaN());
+        bounds.markChanged(17, 18);
+        verify();
+
+        // growing and shrinking, down to nothing
+        for (int size : {1500, 1024, 1025, 3, 700, 0, 2}) {
+            while (points.size() < size)
+                points << QPointF(points.size(), -points.size());
+            points.resize(size);
+            bounds.resize(size);
+            verify();
+        }
+    }
+
+    void boundariesFollowModelTest()
+    {
+        QStandardItemModel boundsModel(200, 2);
+        for (int row = 0; row < 200; ++row) {
+            boundsModel.setData(boundsModel.index(row, 0), row % 13);
+            boundsModel.setData(boundsModel.index(row, 1), -(row % 7));
+        }
+        KDChart::CartesianDiagramDataCompressor boundsCompressor;
+        boundsCompressor.setModel(&boundsModel);
+        boundsCompressor.setResolution(1000, height);
+        auto verify = [&]() {
+            qreal yMin = std::numeric_limits<qreal>::max();
+            qreal yMax = -std::numeric_limits<qreal>::max();
+            for (int row = 0; row < boundsModel.rowCount(); ++row)
+                for (int column = 0; column < boundsModel.columnCount(); ++column) {
+                    yMin = qMin(yMin, boundsModel.data(boundsModel.index(row, column)).toReal());
+                    yMax = qMax(yMax, boundsModel.data(boundsModel.index(row, column)).toReal());
+                }
+            const QPair<QPointF, QPointF> boundaries = boundsCompressor.dataBoundaries();
+            QCOMPARE(boundaries.first.x(), 0.0);
+            QCOMPARE(boundaries.second.x(), qreal(boundsModel.rowCount() - 1));
+            QCOMPARE(boundaries.first.y(), yMin);
+            QCOMPARE(boundaries.second.y(), yMax);
+        };
+        verify();
+
+        boundsModel.setData(boundsModel.index(50, 1), 40);
+        verify();
+        boundsModel.setData(boundsModel.index(50, 1), 3);
+        boundsModel.setData(boundsModel.index(120, 0), -20);
+        verify();
+        boundsModel.insertRows(10, 5);
+        for (int row = 10; row < 15; ++row) {
+            boundsModel.setData(boundsModel.index(row, 0), 100 + row);
+            boundsModel.setData(boundsModel.index(row, 1), 0);
+        }
+        verify();
+        boundsModel.removeRows(0, 30);
+        verify();
+        boundsModel.insertRow(boundsModel.rowCount());
+        boundsModel.setData(boundsModel.index(boundsModel.rowCount() - 1, 0), -50);
+        boundsModel.setData(boundsModel.index(boundsModel.rowCount() - 1, 1), 60);
+        verify();
+    }
+
+    void streamingTest()
+    {
+        KDChart::StreamingModel stream(2);
+        stream.setMaximumHistory(1000);
+        KDChart::CartesianDiagramDataCompressor compressor;
+        compressor.setModel(&stream);
+        compressor.setResolution(100, height);
+        // 16 rows per bucket cover the 1000 rows of history with 100 buckets
+        const int bucketSize = 16;
+
+        QVector<double> samples;
+        for (int chunk = 0; chunk < 30; ++chunk) {
+            QVector<double> values;
+            for (int i = 0; i < 97; ++i)
+                values << (samples.size() + i) % 23;
+            stream.appendSamples(0, values);
+            stream.appendSamples(1, values);
+            samples += values;
+
+            const int rowCount = qMin(1000, samples.size());
+            const qint64 evicted = samples.size() - rowCount;
+            QCOMPARE(stream.rowCount(), rowCount);
+            QCOMPARE(stream.evictedSampleCount(), evicted);
+            const qint64 firstBucket = evicted / bucketSize;
+            QCOMPARE(qint64(compressor.modelDataRows()), (evicted + rowCount - 1) / bucketSize - firstBucket + 1);
+
+            for (int row = 0; row < compressor.modelDataRows(); ++row) {
+                // the buckets stay aligned to the sample numbers while the stream scrolls
+                const qint64 firstSample = (firstBucket + row) * bucketSize;
+                const int baseRow = int(qMax(qint64(0), firstSample - evicted));
+                const int endRow = int(qMin(qint64(rowCount), firstSample + bucketSize - evicted));
+                qreal sum = 0;
+                for (int modelRow = baseRow; modelRow < endRow; ++modelRow)
+                    sum += samples.at(evicted + modelRow);
+                for (int column = 0; column < 2; ++column) {
+                    const KDChart::CartesianDiagramDataCompressor::DataPoint &point = compressor.data(CachePosition(row, column));
+                    QCOMPARE(point.key, (baseRow + endRow - 1) / 2.0);
+                    QCOMPARE(point.value, sum / (endRow - baseRow));
+                    QCOMPARE(point.index.row(), baseRow);
+                }
+            }
+        }
+    }
+
+    void columnarSourceSwapTest()
+    {
+        ColumnarModel first;
+        first.fill(RowCount, ColumnCount);
+        ColumnarModel second;
+        second.fill(RowCount, ColumnCount);
+        for (QVector<double> &column : second.columns)
+            for (double &value : column)
+                value += 100.0;
+
+        KDChart::CartesianDiagramDataCompressor expected;
+        expected.setModel(&second);
+        expected.setResolution(width, height);
+
+        // the source of an attributes model can be swapped under a diagram
+        KDChart::AttributesModel attributesModel(&first);
+        KDChart::CartesianDiagramDataCompressor compressor;
+        compressor.setModel(&attributesModel);
+        compressor.setResolution(width, height);
+        QVERIFY(compressor.data(CachePosition(0, 0)).value != expected.data(CachePosition(0, 0)).value);
+
+        attributesModel.setSourceModel(&second);
+        for (int column = 0; column < expected.modelDataColumns(); ++column) {
+            for (int row = 0; row < expected.modelDataRows(); ++row) {
+                const CachePosition position(row, column);
+                QCOMPARE(compressor.data(position).value, expected.data(position).value);
+            }
+        }
+    }
+
     void cleanupTestCase()
     {
     }
@@ -0,0 +1,252 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QAbstractTableModel>
+#include <QImage>
+#include <QPainter>
+#include <QtTest/QtTest>
+
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartGridAttributes>
+#include <KDChartLineDiagram>
+
+#include <KDChartCartesianDiagramDataCompressor_p.h>
+
+using namespace KDChart;
+
+typedef KDChart::CartesianDiagramDataCompressor Compressor;
+typedef Compressor::CachePosition CachePosition;
+
+// a single dataset that is random noise with a few narrow spikes
+class SpikeModel : public QAbstractTableModel
+{
+public:
+    explicit SpikeModel(int rowCount)
+    {
+        values.resize(rowCount);
+        quint32 seed = 1;
+        for (int row = 0; row < rowCount; ++row) {
+            seed = seed * 1103515245 + 12345;
+            values[row] = (seed >> 16) % 100;
+            if (row % 4099 == 17)
+                values[row] = (row % 2) ? 1000 : -1000;
+        }
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : values.size();
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 1;
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (role != Qt::DisplayRole)
+            return QVariant();
+        return values.at(index.row());
+    }
+
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override
+    {
+        Q_UNUSED(role);
+        values[index.row()] = value.toDouble();
+        emit dataChanged(index, index);
+        return true;
+    }
+
+    QVector<double> values;
+};
+
+// a line diagram that computes the data of as many pixel columns as there are rows,
+// so that the line goes through every row
+class FullResolutionLineDiagram : public LineDiagram
+{
+public:
+    void resize(const QSizeF &size) override
+    {
+        const int rowCount = model() ? model()->rowCount() : 0;
+        LineDiagram::resize(QSizeF(qMax(size.width(), qreal(rowCount)), size.height()));
+    }
+};
+
+class CartesianDiagramDataReductionTests : public QObject
+{
+    Q_OBJECT
+
+private:
+    // paints a chart with only diagram in it, without grid lines
+    QImage render(LineDiagram *diagram, QAbstractItemModel *model) const
+    {
+        Chart chart;
+        chart.resize(Width, Height);
+        diagram->setModel(model);
+        diagram->setAntiAliasing(false);
+        diagram->setPen(QPen(Qt::black, 0));
+        chart.coordinatePlane()->replaceDiagram(diagram);
+        GridAttributes grid = chart.coordinatePlane()->globalGridAttributes();
+        grid.setGridVisible(false);
+        chart.coordinatePlane()->setGlobalGridAttributes(grid);
+
+        QImage image(Width, Height, QImage::Format_RGB32);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        chart.paint(&painter, image.rect());
+        return image;
+    }
+
+    // The pixels of first that are neither in second nor in the pixel column to their left
+    // or right in second. The samples of a pixel column are not at the center of the column,
+    // so a line through them may step into a neighboring column elsewhere than the line
+    // through all rows does.
+    int strayPixels(const QImage &first, const QImage &second) const
+    {
+        int count = 0;
+        for (int y = 0; y < first.height(); ++y) {
+            for (int x = 0; x < first.width(); ++x) {
+                const QRgb color = first.pixel(x, y);
+                bool found = false;
+                for (int dx = -1; dx <= 1 && !found; ++dx) {
+                    const int neighbor = qBound(0, x + dx, second.width() - 1);
+                    found = second.pixel(neighbor, y) == color;
+                }
+                if (!found)
+                    ++count;
+            }
+        }
+        return count;
+    }
+
+    QVector<QPointF> visiblePoints(const Compressor &compressor) const
+    {
+        QVector<QPointF> points;
+        for (int row = 0; row < compressor.modelDataRows(); ++row) {
+            const Compressor::DataPoint &point = compressor.data(CachePosition(row, 0));
+            if (!point.hidden)
+                points << QPointF(point.key, point.value);
+        }
+        return points;
+    }
+
+private slots:
+
+    void minMaxPointCountTest()
+    {
+        SpikeModel model(RowCount);
+        Compressor compressor;
+        compressor.setModel(&model);
+        compressor.setApproximationMode(Compressor::MinMaxPerPixel);
+        compressor.setResolution(Width, Height);
+
+        QCOMPARE(compressor.modelDataRows(), 4 * Width);
+        const QVector<QPointF> points = visiblePoints(compressor);
+        QVERIFY(points.size() <= 4 * Width);
+        // the points are actual samples, in row order
+        for (int i = 0; i < points.size(); ++i) {
+            const int row = int(points.at(i).x());
+            QCOMPARE(points.at(i).x(), qreal(row));
+            QCOMPARE(points.at(i).y(), model.values.at(row));
+            if (i > 0)
+                QVERIFY(points.at(i - 1).x() < points.at(i).x());
+        }
+    }
+
+    void minMaxRenderingTest()
+    {
+        SpikeModel model(RowCount);
+
+        // one cache row per model row: the line through all rows
+        auto *full = new FullResolutionLineDiagram;
+        const QImage expected = render(full, &model);
+
+        auto *reduced = new LineDiagram;
+        reduced->setDataReductionMode(KDChartEnums::DataReductionMinMax);
+        const QImage actual = render(reduced, &model);
+
+        QImage blank(Width, Height, QImage::Format_RGB32);
+        blank.fill(Qt::white);
+        QVERIFY(strayPixels(expected, blank) > 0);
+        QCOMPARE(strayPixels(actual, expected), 0);
+        QCOMPARE(strayPixels(expected, actual), 0);
+
+        // averaging loses the spikes
+        const QImage averaged = render(new LineDiagram, &model);
+        QVERIFY(strayPixels(averaged, expected) > 0);
+    }
+
+    void minMaxDataChangedTest()
+    {
+        SpikeModel model(RowCount);
+        Compressor compressor;
+        compressor.setModel(&model);
+        compressor.setApproximationMode(Compressor::MinMaxPerPixel);
+        compressor.setResolution(Width, Height);
+        QCOMPARE(compressor.dataBoundaries().second.y(), 1000.0);
+
+        model.setData(model.index(RowCount / 2 + 3, 0), 2000);
+        QCOMPARE(compressor.dataBoundaries().second.y(), 2000.0);
+        QVERIFY(visiblePoints(compressor).contains(QPointF(RowCount / 2 + 3, 2000)));
+    }
+
+    void minMaxSmallModelTest()
+    {
+        // up to four rows per pixel, all rows are kept
+        SpikeModel model(3 * Width);
+        Compressor compressor;
+        compressor.setModel(&model);
+        compressor.setApproximationMode(Compressor::MinMaxPerPixel);
+        compressor.setResolution(Width, Height);
+
+        QCOMPARE(compressor.modelDataRows(), 3 * Width);
+        for (int row = 0; row < compressor.modelDataRows(); ++row) {
+            const Compressor::DataPoint &point = compressor.data(CachePosition(row, 0));
+            QCOMPARE(point.key, qreal(row));
+            QCOMPARE(point.value, model.values.at(row));
+            QVERIFY(!point.hidden);
+        }
+    }
+
+    void largestTriangleTest()
+    {
+        SpikeModel model(RowCount);
+        Compressor compressor;
+        compressor.setModel(&model);
+        compressor.setApproximationMode(Compressor::LargestTriangleThreeBuckets);
+        compressor.setResolution(Width, Height);
+
+        QCOMPARE(compressor.modelDataRows(), 2 * Width);
+        const QVector<QPointF> points = visiblePoints(compressor);
+        QCOMPARE(points.size(), 2 * Width);
+        QCOMPARE(points.first().x(), 0.0);
+        QCOMPARE(points.last().x(), qreal(RowCount - 1));
+        for (int i = 1; i < points.size(); ++i)
+            QVERIFY(points.at(i - 1).x() < points.at(i).x());
+        // every spike dominates its bucket
+        for (int row = 17; row < RowCount; row += 4099)
+            QVERIFY(points.contains(QPointF(row, model.values.at(row))));
+    }
+
+private:
+    static const int RowCount;
+    static const int Width;
+    static const int Height;
+};
+
+const int CartesianDiagramDataReductionTests::RowCount = 20000;
+const int CartesianDiagramDataReductionTests::Width = 200;
+const int CartesianDiagramDataReductionTests::Height = 300;
+
+QTEST_MAIN(CartesianDiagramDataReductionTests)
+
+#include "CartesianDiagramDataReductionTests.moc"
@@ -13,10 +13,13 @@
 #include <KDChartChart>
 #include <KDChartGridAttributes>
 #include <KDChartPlotter>
+#include <QImage>
+#include <QPainter>
 #include <QPair>
 #include <QPointF>
 #include <QStandardItemModel>
 #include <QString>
+#include <QVector>
 #include <QtTest/QtTest>
 
 using namespace KDChart;
@@ -79,9 +82,14 @@ private slots:
     void testGlobalGridAttributesSettings();
     void testGridAttributesSettings();
     void testAxesCalcModesSettings();
+    void testBatchTranslation_data();
+    void testBatchTranslation();
+    void benchmarkTranslation_data();
+    void benchmarkTranslation();
 
 private:
     void doTestRangeSettings(AbstractCartesianDiagram *diagram, const QPointF &min, const QPointF &max);
+    void layoutForTranslation(AbstractCoordinatePlane::AxesCalcMode modeX, AbstractCoordinatePlane::AxesCalcMode modeY);
 
     Chart *m_chart;
     BarDiagram *m_bars;
@@ -278,6 +286,89 @@ void TestCartesianPlanes::testAxesCalcModesSettings()
     QCOMPARE(m_plane->axesCalcModeY(), AbstractCoordinatePlane::Linear);
 }
 
+void TestCartesianPlanes::layoutForTranslation(AbstractCoordinatePlane::AxesCalcMode modeX,
+                                               AbstractCoordinatePlane::AxesCalcMode modeY)
+{
+    QList<QPointF> points;
+    points << QPointF(1.0, 40.0) << QPointF(2.0, 45.0) << QPointF(3.0, 42.0);
+    m_model->setXyValues(points);
+    m_plane->addDiagram(m_plotter);
+    m_plane->setHorizontalRange(qMakePair(qreal(1.0), qreal(1000.0)));
+    m_plane->setVerticalRange(qMakePair(qreal(1.0), qreal(1000.0)));
+    m_plane->setAxesCalcModeX(modeX);
+    m_plane->setAxesCalcModeY(modeY);
+    m_plane->setZoomFactors(2.0, 1.5);
+    m_plane->setZoomCenter(QPointF(0.3, 0.6));
+
+    // painting lays out the plane, which sets up its transformation
+    QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    m_chart->paint(&painter, image.rect());
+}
+
+void TestCartesianPlanes::testBatchTranslation_data()
+{
+    QTest::addColumn<int>("modeX");
+    QTest::addColumn<int>("modeY");
+    QTest::newRow("linear") << int(AbstractCoordinatePlane::Linear) << int(AbstractCoordinatePlane::Linear);
+    QTest::newRow("logarithmic x") << int(AbstractCoordinatePlane::Logarithmic) << int(AbstractCoordinatePlane::Linear);
+    QTest::newRow("logarithmic y") << int(AbstractCoordinatePlane::Linear) << int(AbstractCoordinatePlane::Logarithmic);
+    QTest::newRow("logarithmic") << int(AbstractCoordinatePlane::Logarithmic) << int(AbstractCoordinatePlane::Logarithmic);
+}
+
+void TestCartesianPlanes::testBatchTranslation()
+{
+    QFETCH(int, modeX);
+    QFETCH(int, modeY);
+    layoutForTranslation(AbstractCoordinatePlane::AxesCalcMode(modeX), AbstractCoordinatePlane::AxesCalcMode(modeY));
+
+    QVector<qreal> xs;
+    QVector<qreal> ys;
+    for (int i = 1; i <= 1000; i += 7) {
+        xs << i;
+        ys << 1001 - i;
+    }
+    QVector<QPointF> batch(xs.size());
+    m_plane->translate(xs.constData(), ys.constData(), batch.data(), xs.size());
+    for (int i = 0; i < xs.size(); ++i) {
+        QCOMPARE(batch.at(i), m_plane->translate(QPointF(xs.at(i), ys.at(i))));
+    }
+}
+
+void TestCartesianPlanes::benchmarkTranslation_data()
+{
+    QTest::addColumn<bool>("batch");
+    QTest::newRow("scalar") << false;
+    QTest::newRow("batch") << true;
+}
+
+void TestCartesianPlanes::benchmarkTranslation()
+{
+    QFETCH(bool, batch);
+    layoutForTranslation(AbstractCoordinatePlane::Linear, AbstractCoordinatePlane::Logarithmic);
+
+    const int count = 100000;
+    QVector<qreal> xs(count);
+    QVector<qreal> ys(count);
+    for (int i = 0; i < count; ++i) {
+        xs[i] = 1.0 + i % 999;
+        ys[i] = 1.0 + (i * 7) % 999;
+    }
+    QVector<QPointF> out(count);
+    QPointF *const outData = out.data();
+
+    if (batch) {
+        QBENCHMARK {
+            m_plane->translate(xs.constData(), ys.constData(), outData, count);
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = 0; i < count; ++i)
+                outData[i] = m_plane->translate(QPointF(xs.at(i), ys.at(i)));
+        }
+    }
+}
+
 QTEST_MAIN(TestCartesianPlanes)
 
 #include "main.moc"
@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartBarDiagram>
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartHeaderFooter>
+#include <KDChartLegend>
+#include <QImage>
+#include <QPainter>
+#include <QPicture>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include <ImageComparison.h>
+
+using namespace KDChart;
+
+class CountingBarDiagram : public BarDiagram
+{
+    Q_OBJECT
+
+public:
+    void paint(PaintContext *paintContext) override
+    {
+        ++paintCount;
+        BarDiagram::paint(paintContext);
+    }
+
+    int paintCount = 0;
+};
+
+class OverlayChart : public Chart
+{
+    Q_OBJECT
+
+public:
+    OverlayChart()
+    {
+        connect(this, &Chart::overlayPaintRequested, this, [this](QPainter *painter) {
+            ++overlayCount;
+            painter->fillRect(QRect(overlayPosition, QSize(4, 4)), Qt::red);
+        });
+    }
+
+    int overlayCount = 0;
+    QPoint overlayPosition;
+};
+
+class TestChartLayers : public QObject
+{
+    Q_OBJECT
+
+private:
+    CountingBarDiagram *createDiagram(int offset)
+    {
+        auto *model = new QStandardItemModel(RowCount, 3, m_chart);
+        for (int row = 0; row < RowCount; ++row) {
+            for (int column = 0; column < 3; ++column)
+                model->setData(model->index(row, column), (row + offset) % 5 + column);
+        }
+        auto *bars = new CountingBarDiagram;
+        bars->setModel(model);
+        return bars;
+    }
+
+private slots:
+
+    void init()
+    {
+        m_chart = new OverlayChart;
+        m_chart->resize(400, 300);
+        m_first = createDiagram(0);
+        m_chart->coordinatePlane()->replaceDiagram(m_first);
+        auto *secondPlane = new CartesianCoordinatePlane(m_chart);
+        m_chart->addCoordinatePlane(secondPlane);
+        m_second = createDiagram(2);
+        secondPlane->replaceDiagram(m_second);
+        m_chart->addLegend(new Legend(m_first, m_chart));
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+    }
+
+    void testDisabledByDefault()
+    {
+        QVERIFY(!m_chart->isLayerCachingEnabled());
+        m_chart->setLayerCachingEnabled(true);
+        QVERIFY(m_chart->isLayerCachingEnabled());
+    }
+
+    void testSameImage()
+    {
+        const QImage direct = m_chart->grab().toImage();
+        m_chart->setLayerCachingEnabled(true);
+        const QImage layered = m_chart->grab().toImage();
+        QCOMPARE(layered.size(), direct.size());
+        QVERIFY(maximumDifference(layered, direct) <= 2);
+    }
+
+    void testOverlayReusesLayers()
+    {
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        QCOMPARE(m_first->paintCount, 1);
+        QCOMPARE(m_second->paintCount, 1);
+        QCOMPARE(m_chart->overlayCount, 1);
+
+        m_chart->overlayPosition = QPoint(100, 100);
+        m_chart->updateOverlay();
+        const QImage image = m_chart->grab().toImage();
+        QCOMPARE(m_first->paintCount, 1);
+        QCOMPARE(m_second->paintCount, 1);
+        QCOMPARE(m_chart->overlayCount, 2);
+        QCOMPARE(image.pixel(101, 101), QColor(Qt::red).rgb());
+    }
+
+    void testDataChangeRendersOnlyItsPlane()
+    {
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        auto *model = static_cast<QStandardItemModel *>(m_first->model());
+        model->setData(model->index(0, 0), 3);
+        const QImage layered = m_chart->grab().toImage();
+        QCOMPARE(m_first->paintCount, 2);
+        QCOMPARE(m_second->paintCount, 1);
+
+        m_chart->setLayerCachingEnabled(false);
+        QVERIFY(maximumDifference(layered, m_chart->grab().toImage()) <= 2);
+    }
+
+    void testUntrackedRepaintRendersAllLayers()
+    {
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        m_chart->update();
+        m_chart->grab();
+        QCOMPARE(m_first->paintCount, 2);
+        QCOMPARE(m_second->paintCount, 2);
+
+        m_chart->resize(300, 200);
+        m_chart->updateOverlay();
+        m_chart->grab();
+        QCOMPARE(m_first->paintCount, 3);
+        QCOMPARE(m_second->paintCount, 3);
+    }
+
+    void testInvalidateLayers()
+    {
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        // repainted together with a tracked change, which alone would keep the plane layers
+        m_chart->invalidateLayers();
+        m_chart->updateOverlay();
+        m_chart->grab();
+        QCOMPARE(m_first->paintCount, 2);
+        QCOMPARE(m_second->paintCount, 2);
+        QCOMPARE(m_chart->overlayCount, 2);
+    }
+
+    void testUntrackedChangesWithOverlay()
+    {
+        auto *header = new HeaderFooter(m_chart);
+        header->setText(QStringLiteral("Header A"));
+        m_chart->addHeaderFooter(header);
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+
+        // each repainted together with a tracked change, which keeps the plane layers
+        BackgroundAttributes background = m_chart->backgroundAttributes();
+        background.setVisible(true);
+        background.setBrush(Qt::green);
+        m_chart->setBackgroundAttributes(background);
+        m_chart->updateOverlay();
+        QImage layered = m_chart->grab().toImage();
+        QCOMPARE(m_first->paintCount, 1);
+        m_chart->setLayerCachingEnabled(false);
+        QVERIFY(maximumDifference(layered, m_chart->grab().toImage()) <= 2);
+
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        header->setText(QStringLiteral("Header B"));
+        m_chart->updateOverlay();
+        layered = m_chart->grab().toImage();
+        m_chart->setLayerCachingEnabled(false);
+        QVERIFY(maximumDifference(layered, m_chart->grab().toImage()) <= 2);
+    }
+
+    void testPaintDevices()
+    {
+        m_chart->setLayerCachingEnabled(true);
+        m_chart->grab();
+        const int paintCount = m_first->paintCount;
+
+        // a QPicture records the chart itself, not images of the layers
+        QPicture picture;
+        QPainter painter(&picture);
+        m_chart->render(&painter);
+        painter.end();
+        QCOMPARE(m_first->paintCount, paintCount + 1);
+    }
+
+    void benchmarkOverlayRepaint_data()
+    {
+        QTest::addColumn<bool>("cached");
+        QTest::newRow("uncached") << false;
+        QTest::newRow("cached") << true;
+    }
+
+    void benchmarkOverlayRepaint()
+    {
+        QFETCH(bool, cached);
+        m_chart->setLayerCachingEnabled(cached);
+        QPixmap pixmap(m_chart->size());
+        m_chart->render(&pixmap);
+        int x = 0;
+        QBENCHMARK {
+            m_chart->overlayPosition = QPoint(x++ % 400, 150);
+            m_chart->updateOverlay();
+            m_chart->render(&pixmap);
+        }
+    }
+
+private:
+    static const int RowCount;
+
+    OverlayChart *m_chart;
+    CountingBarDiagram *m_first;
+    CountingBarDiagram *m_second;
+};
+
+const int TestChartLayers::RowCount = 50;
+
+QTEST_MAIN(TestChartLayers)
+
+#include "main.moc"
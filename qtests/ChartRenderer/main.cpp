@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartChartRenderer>
+#include <KDChartLegend>
+#include <KDChartLineDiagram>
+#include <QStandardItemModel>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+using namespace KDChart;
+
+class TestChartRenderer : public QObject
+{
+    Q_OBJECT
+
+private:
+    // a line chart with a legend, every chart with slightly different data
+    Chart *createChart(int seed)
+    {
+        auto *model = new QStandardItemModel(RowCount, DatasetCount, this);
+        for (int row = 0; row < RowCount; ++row) {
+            for (int column = 0; column < DatasetCount; ++column)
+                model->setData(model->index(row, column), 10 * column + std::sin((row + seed) * 0.05) * 5);
+        }
+        auto *chart = new Chart;
+        auto *lines = new LineDiagram;
+        lines->setModel(model);
+        chart->coordinatePlane()->replaceDiagram(lines);
+        chart->addLegend(new Legend(lines, chart));
+        m_charts << chart;
+        return chart;
+    }
+
+    QList<Chart *> createCharts(int count)
+    {
+        QList<Chart *> charts;
+        for (int i = 0; i < count; ++i)
+            charts << createChart(i);
+        return charts;
+    }
+
+private slots:
+
+    void cleanup()
+    {
+        qDeleteAll(m_charts);
+        m_charts.clear();
+    }
+
+    void testSettings()
+    {
+        ChartRenderer renderer;
+        QCOMPARE(renderer.size(), QSize(800, 600));
+        QCOMPARE(renderer.background(), QBrush(Qt::white));
+        QCOMPARE(renderer.imageFormat(), QImage::Format_ARGB32_Premultiplied);
+        QVERIFY(renderer.threadPool() == nullptr);
+
+        QThreadPool pool;
+        renderer.setSize(QSize(200, 100));
+        renderer.setBackground(Qt::transparent);
+        renderer.setImageFormat(QImage::Format_RGB32);
+        renderer.setThreadPool(&pool);
+        QCOMPARE(renderer.size(), QSize(200, 100));
+        QCOMPARE(renderer.background(), QBrush(Qt::transparent));
+        QCOMPARE(renderer.imageFormat(), QImage::Format_RGB32);
+        QCOMPARE(renderer.threadPool(), &pool);
+    }
+
+    void testRender()
+    {
+        ChartRenderer renderer;
+        renderer.setSize(QSize(400, 300));
+        const QImage image = renderer.render(createChart(0));
+        QCOMPARE(image.size(), QSize(400, 300));
+        QCOMPARE(image.format(), QImage::Format_ARGB32_Premultiplied);
+
+        // something besides the background was drawn
+        bool painted = false;
+        for (int y = 0; y < image.height() && !painted; ++y) {
+            for (int x = 0; x < image.width() && !painted; ++x)
+                painted = image.pixel(x, y) != qRgb(255, 255, 255);
+        }
+        QVERIFY(painted);
+        QVERIFY(renderer.render(nullptr).pixel(0, 0) == qRgb(255, 255, 255));
+    }
+
+    void testRenderBatch()
+    {
+        const QList<Chart *> charts = createCharts(8);
+        ChartRenderer renderer;
+        renderer.setSize(QSize(400, 300));
+        const QList<QImage> images = renderer.render(charts);
+        QCOMPARE(images.size(), charts.size());
+        // rasterizing on the pool gives the same images as in the calling thread
+        for (int i = 0; i < charts.size(); ++i)
+            QCOMPARE(images.at(i), renderer.render(charts.at(i)));
+        QVERIFY(images.at(0) != images.at(1));
+
+        // a chart that is in the batch twice is painted twice, by one thread after the other
+        const QList<QImage> twice = renderer.render({charts.at(0), charts.at(1), charts.at(0)});
+        QCOMPARE(twice.at(0), images.at(0));
+        QCOMPARE(twice.at(1), images.at(1));
+        QCOMPARE(twice.at(2), images.at(0));
+    }
+
+    void testRenderToFiles()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QList<Chart *> charts = createCharts(2);
+        const QStringList fileNames = {dir.filePath(QStringLiteral("chart.png")),
+                                       dir.filePath(QStringLiteral("chart.svg"))};
+        ChartRenderer renderer;
+        renderer.setSize(QSize(400, 300));
+        QVERIFY(renderer.renderToFiles(charts, fileNames));
+
+        QCOMPARE(QImage(fileNames.at(0)).size(), QSize(400, 300));
+        QFile svg(fileNames.at(1));
+        QVERIFY(svg.open(QIODevice::ReadOnly));
+        QVERIFY(svg.readAll().contains("<svg"));
+
+        QVERIFY(!renderer.renderToFiles(charts.mid(0, 1), {dir.filePath(QStringLiteral("missing/chart.png"))}));
+    }
+
+    void benchmarkRenderBatch_data()
+    {
+        QTest::addColumn<int>("threadCount");
+        QTest::newRow("1 thread") << 1;
+        QTest::newRow("ideal thread count") << QThread::idealThreadCount();
+    }
+
+    void benchmarkRenderBatch()
+    {
+        QFETCH(int, threadCount);
+        const QList<Chart *> charts = createCharts(BenchmarkChartCount);
+        QThreadPool pool;
+        pool.setMaxThreadCount(threadCount);
+        ChartRenderer renderer;
+        renderer.setThreadPool(&pool);
+
+        QBENCHMARK {
+            renderer.render(charts);
+        }
+    }
+
+private:
+    QList<Chart *> m_charts;
+
+    static const int RowCount;
+    static const int DatasetCount;
+    static const int BenchmarkChartCount;
+};
+
+const int TestChartRenderer::RowCount = 500;
+const int TestChartRenderer::DatasetCount = 4;
+const int TestChartRenderer::BenchmarkChartCount = 32;
+
+QTEST_MAIN(TestChartRenderer)
+
+#include "main.moc"
@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartBarDiagram>
+#include <KDChartChart>
+#include <KDChartDataValueAttributes>
+#include <KDChartLabelCache>
+#include <KDChartLegend>
+#include <QImage>
+#include <QPainter>
+#include <QPicture>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include <ImageComparison.h>
+
+using namespace KDChart;
+
+class TestLabelCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    QImage paintChart(const QPointF &offset = QPointF())
+    {
+        QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        painter.translate(offset);
+        m_chart->paint(&painter, image.rect());
+        return image;
+    }
+
+private slots:
+
+    void init()
+    {
+        m_model = new QStandardItemModel(RowCount, 3, this);
+        for (int row = 0; row < RowCount; ++row) {
+            for (int column = 0; column < 3; ++column)
+                m_model->setData(m_model->index(row, column), (row % 4) + column);
+        }
+        m_chart = new Chart;
+        auto *bars = new BarDiagram;
+        bars->setModel(m_model);
+        DataValueAttributes dva = bars->dataValueAttributes();
+        dva.setVisible(true);
+        bars->setDataValueAttributes(dva);
+        m_chart->coordinatePlane()->replaceDiagram(bars);
+        m_chart->addLegend(new Legend(bars, m_chart));
+
+        LabelCache *cache = LabelCache::instance();
+        cache->setEnabled(true);
+        cache->setMaximumSize(4096);
+        cache->clear();
+        cache->resetStatistics();
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+        delete m_model;
+    }
+
+    void testSettings()
+    {
+        LabelCache *cache = LabelCache::instance();
+        QVERIFY(cache->isEnabled());
+        QCOMPARE(cache->maximumSize(), 4096);
+        cache->setMaximumSize(100);
+        QCOMPARE(cache->maximumSize(), 100);
+        cache->setEnabled(false);
+        QVERIFY(!cache->isEnabled());
+    }
+
+    void testRepaintHitsCache()
+    {
+        LabelCache *cache = LabelCache::instance();
+        const QImage first = paintChart();
+        QVERIFY(cache->missCount() > 0);
+        QVERIFY(cache->count() > 0);
+        QVERIFY(cache->size() > 0);
+
+        cache->resetStatistics();
+        const QImage second = paintChart();
+        QCOMPARE(cache->missCount(), 0);
+        QVERIFY(cache->hitCount() > 0);
+        QCOMPARE(second, first);
+    }
+
+    void testMaximumSize()
+    {
+        LabelCache *cache = LabelCache::instance();
+        cache->setMaximumSize(1);
+        paintChart();
+        QVERIFY(cache->size() <= 1);
+        cache->setMaximumSize(4096);
+    }
+
+    void testDisabled()
+    {
+        LabelCache *cache = LabelCache::instance();
+        const QImage cached = paintChart();
+        cache->setEnabled(false);
+        QCOMPARE(cache->count(), 0);
+        cache->resetStatistics();
+        const QImage uncached = paintChart();
+        QCOMPARE(cache->hitCount(), 0);
+        QCOMPARE(cache->missCount(), 0);
+        QCOMPARE(uncached.size(), cached.size());
+        QVERIFY(maximumDifference(cached, uncached) <= 2);
+    }
+
+    void testFractionalPositions_data()
+    {
+        QTest::addColumn<QPointF>("offset");
+        QTest::newRow("quarter") << QPointF(0.25, 0.25);
+        QTest::newRow("half") << QPointF(0.5, 0.5);
+        QTest::newRow("mixed") << QPointF(0.3, 0.7);
+    }
+
+    // labels cached at one sub-pixel position are not reused at another one
+    void testFractionalPositions()
+    {
+        QFETCH(QPointF, offset);
+        LabelCache *cache = LabelCache::instance();
+        paintChart();
+        cache->resetStatistics();
+        const QImage cached = paintChart(offset);
+        QVERIFY(cache->missCount() > 0);
+        // painted again from the cache
+        QCOMPARE(paintChart(offset), cached);
+
+        cache->setEnabled(false);
+        const QImage uncached = paintChart(offset);
+        QVERIFY(maximumDifference(cached, uncached) <= 2);
+    }
+
+    void testVectorOutputIsNotCached()
+    {
+        LabelCache *cache = LabelCache::instance();
+        QPicture picture;
+        QPainter painter(&picture);
+        m_chart->paint(&painter, QRect(0, 0, 400, 300));
+        painter.end();
+        QCOMPARE(cache->hitCount(), 0);
+        QCOMPARE(cache->missCount(), 0);
+    }
+
+    void benchmarkRepaint_data()
+    {
+        QTest::addColumn<bool>("enabled");
+        QTest::newRow("uncached") << false;
+        QTest::newRow("cached") << true;
+    }
+
+    void benchmarkRepaint()
+    {
+        QFETCH(bool, enabled);
+        LabelCache::instance()->setEnabled(enabled);
+        QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        QBENCHMARK {
+            m_chart->paint(&painter, image.rect());
+        }
+    }
+
+private:
+    static const int RowCount;
+
+    Chart *m_chart;
+    QStandardItemModel *m_model;
+};
+
+const int TestLabelCache::RowCount = 20;
+
+QTEST_MAIN(TestLabelCache)
+
+#include "main.moc"
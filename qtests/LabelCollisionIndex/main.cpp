@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QPainterPath>
+#include <QTransform>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include <KDChartLabelCollisionIndex_p.h>
+
+using namespace KDChart;
+
+class TestLabelCollisionIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    // outlines of data value texts as they are tested while painting: rotated rects
+    QVector<QPainterPath> labelOutlines(int count, int rotation) const
+    {
+        QVector<QPainterPath> outlines;
+        quint32 seed = 7;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1103515245 + 12345;
+            const qreal x = (seed >> 8) % 2000;
+            seed = seed * 1103515245 + 12345;
+            const qreal y = (seed >> 8) % 1500;
+            QTransform transform;
+            transform.translate(x, y);
+            transform.rotate(rotation);
+            QPainterPath path;
+            path.addPolygon(transform.mapToPolygon(QRect(0, 0, 30, 12)));
+            outlines << path;
+        }
+        return outlines;
+    }
+
+    // which outlines would be painted, compared to all that were painted before
+    QVector<bool> paintedBruteForce(const QVector<QPainterPath> &outlines) const
+    {
+        QVector<bool> painted;
+        QList<QPainterPath> drawn;
+        for (const QPainterPath &outline : outlines) {
+            bool drawIt = true;
+            for (const QPainterPath &other : drawn) {
+                if (other.intersects(outline)) {
+                    drawIt = false;
+                    break;
+                }
+            }
+            if (drawIt)
+                drawn << outline;
+            painted << drawIt;
+        }
+        return painted;
+    }
+
+    QVector<bool> paintedIndexed(const QVector<QPainterPath> &outlines) const
+    {
+        QVector<bool> painted;
+        LabelCollisionIndex index;
+        for (const QPainterPath &outline : outlines) {
+            const bool drawIt = !index.intersects(outline);
+            if (drawIt)
+                index.insert(outline);
+            painted << drawIt;
+        }
+        return painted;
+    }
+
+private slots:
+    void testSameResultAsBruteForce_data()
+    {
+        QTest::addColumn<int>("rotation");
+        QTest::newRow("horizontal") << 0;
+        QTest::newRow("rotated") << 45;
+        QTest::newRow("vertical") << 90;
+    }
+
+    void testSameResultAsBruteForce()
+    {
+        QFETCH(int, rotation);
+        const QVector<QPainterPath> outlines = labelOutlines(2000, rotation);
+        const QVector<bool> expected = paintedBruteForce(outlines);
+        QCOMPARE(paintedIndexed(outlines), expected);
+        QVERIFY(expected.contains(true));
+        QVERIFY(expected.contains(false));
+    }
+
+    void testLargeOutlines()
+    {
+        LabelCollisionIndex index;
+        QPainterPath small;
+        small.addRect(0, 0, 10, 10);
+        index.insert(small);
+
+        // spans far more cells than are worth bucketing
+        QPainterPath large;
+        large.addRect(-5000, 500, 10000, 10);
+        QVERIFY(!index.intersects(large));
+        index.insert(large);
+
+        QPainterPath crossing;
+        crossing.addRect(3000, 490, 10, 30);
+        QVERIFY(index.intersects(crossing));
+        QPainterPath touching;
+        touching.addRect(5, 5, 10, 10);
+        QVERIFY(index.intersects(touching));
+        QPainterPath apart;
+        apart.addRect(100, 100, 10, 10);
+        QVERIFY(!index.intersects(apart));
+        QCOMPARE(index.count(), 2);
+
+        index.clear();
+        QVERIFY(index.isEmpty());
+        QVERIFY(!index.intersects(crossing));
+    }
+
+    void benchmarkPlacement_data()
+    {
+        QTest::addColumn<bool>("indexed");
+        QTest::newRow("brute force") << false;
+        QTest::newRow("indexed") << true;
+    }
+
+    void benchmarkPlacement()
+    {
+        QFETCH(bool, indexed);
+        const QVector<QPainterPath> outlines = labelOutlines(LabelCount, 30);
+        if (indexed) {
+            QBENCHMARK {
+                paintedIndexed(outlines);
+            }
+        } else {
+            QBENCHMARK {
+                paintedBruteForce(outlines);
+            }
+        }
+    }
+
+private:
+    static const int LabelCount;
+};
+
+const int TestLabelCollisionIndex::LabelCount = 5000;
+
+QTEST_MAIN(TestLabelCollisionIndex)
+
+#include "main.moc"
@@ -18,10 +18,26 @@
 #include <KDChartLegend>
 #include <KDChartLineDiagram>
 
+#include <KDChartLegend_p.h>
+
 #include <TableModel.h>
 
 using namespace KDChart;
 
+// gives the test the layout items the legend built for its entries
+class LegendProbe : public Legend
+{
+    Q_OBJECT
+
+public:
+    using Legend::Legend;
+
+    QList<DatasetItems> datasetItems() const
+    {
+        return d_func()->shownDatasetItems();
+    }
+};
+
 class TestLegends : public QObject
 {
     Q_OBJECT
@@ -124,17 +140,114 @@ private slots:
         QVERIFY(l->legendStyle() == Legend::LinesOnly);
     }
 
+    void testRebuildMeasuresChangedTexts()
+    {
+        auto *l = new Legend(m_lines, m_chart);
+        const QSize before = l->sizeHint();
+        l->setText(0, QStringLiteral("A much longer text than any dataset label"));
+        const QSize longer = l->sizeHint();
+        QVERIFY(longer.width() > before.width());
+        l->forceRebuild();
+        QCOMPARE(l->sizeHint(), longer);
+        l->resetTexts();
+        QCOMPARE(l->sizeHint(), before);
+        delete l;
+    }
+
+    void testRebuildOnlyChangedEntries()
+    {
+        auto *l = new LegendProbe(m_lines, m_chart);
+        const QList<DatasetItems> before = l->datasetItems();
+        QVERIFY(before.size() > 2);
+
+        // a new text for one dataset creates a new text item for that entry only
+        l->setText(1, QStringLiteral("Changed"));
+        QList<DatasetItems> after = l->datasetItems();
+        QCOMPARE(after.size(), before.size());
+        for (int i = 0; i < after.size(); ++i) {
+            QCOMPARE(after.at(i).label == before.at(i).label, i != 1);
+            QCOMPARE(after.at(i).markerLine == before.at(i).markerLine, i != 1);
+        }
+
+        // a new brush for one dataset keeps all texts, and replaces that entry's marker only
+        const QList<DatasetItems> changedText = after;
+        l->setBrush(2, Qt::magenta);
+        after = l->datasetItems();
+        for (int i = 0; i < after.size(); ++i) {
+            QCOMPARE(after.at(i).label, changedText.at(i).label);
+            QCOMPARE(after.at(i).markerLine == changedText.at(i).markerLine, i != 2);
+        }
+        delete l;
+    }
+
+    void testVisibleEntries()
+    {
+        QStandardItemModel model(2, DatasetCount);
+        auto *bars = new BarDiagram;
+        bars->setModel(&model);
+        auto *l = new Legend(bars, m_chart);
+        QCOMPARE(l->maximumVisibleEntries(), 0);
+        QCOMPARE(l->firstVisibleEntry(), 0);
+        const QSize all = l->sizeHint();
+
+        l->setMaximumVisibleEntries(10);
+        QCOMPARE(l->maximumVisibleEntries(), 10);
+        const QSize visible = l->sizeHint();
+        QVERIFY(visible.height() < all.height() / 10);
+
+        l->setFirstVisibleEntry(DatasetCount);
+        QCOMPARE(l->firstVisibleEntry(), DatasetCount - 10);
+        l->setFirstVisibleEntry(5);
+        QCOMPARE(l->firstVisibleEntry(), 5);
+
+        QWheelEvent scroll(QPointF(1, 1), QPointF(1, 1), QPoint(), QPoint(0, -240), Qt::NoButton,
+                           Qt::NoModifier, Qt::NoScrollPhase, false);
+        QApplication::sendEvent(l, &scroll);
+        QCOMPARE(l->firstVisibleEntry(), 7);
+
+        l->setMaximumVisibleEntries(0);
+        QCOMPARE(l->sizeHint(), all);
+        delete l;
+        delete bars;
+    }
+
+    void benchmarkRebuild_data()
+    {
+        QTest::addColumn<int>("maximumVisibleEntries");
+        QTest::newRow("all") << 0;
+        QTest::newRow("virtualized") << 20;
+    }
+
+    void benchmarkRebuild()
+    {
+        QFETCH(int, maximumVisibleEntries);
+        QStandardItemModel model(2, DatasetCount);
+        auto *bars = new BarDiagram;
+        bars->setModel(&model);
+        auto *l = new Legend(bars, m_chart);
+        l->setMaximumVisibleEntries(maximumVisibleEntries);
+        QBENCHMARK {
+            l->forceRebuild();
+        }
+        delete l;
+        delete bars;
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static const int DatasetCount;
+
     Chart *m_chart;
     BarDiagram *m_bars;
     LineDiagram *m_lines;
     TableModel *m_tableModel;
 };
 
+const int TestLegends::DatasetCount = 2000;
+
 QTEST_MAIN(TestLegends)
 
 #include "main.moc"
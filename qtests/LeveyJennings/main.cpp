@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartLeveyJenningsDiagram>
+#include <QDateTime>
+#include <QStandardItemModel>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+using namespace KDChart;
+
+class TestLeveyJennings : public QObject
+{
+    Q_OBJECT
+
+private:
+    // appends a row, without a QC value if value is invalid
+    void appendValue(const QVariant &value)
+    {
+        QList<QStandardItem *> items;
+        for (int column = 0; column < 4; ++column)
+            items << new QStandardItem;
+        items[0]->setData(1, Qt::DisplayRole);
+        items[1]->setData(value, Qt::DisplayRole);
+        items[2]->setData(true, Qt::DisplayRole);
+        items[3]->setData(QDateTime(QDate(2023, 1, 1), QTime(8, 0)).addSecs(60 * m_model->rowCount()),
+                          Qt::DisplayRole);
+        m_model->appendRow(items);
+    }
+
+    // the statistics computed in two passes over the values in the model
+    void verifyStatistics()
+    {
+        QVector<qreal> values;
+        for (int row = 0; row < m_model->rowCount(); ++row)
+            values << m_model->data(m_model->index(row, 1)).toReal();
+        qreal mean = 0.0;
+        for (qreal value : values)
+            mean += value;
+        mean /= values.count();
+        qreal squaredDeviations = 0.0;
+        for (qreal value : values)
+            squaredDeviations += (value - mean) * (value - mean);
+        const qreal sd = std::sqrt(squaredDeviations / (values.count() - 1));
+
+        QVERIFY(qAbs(m_diagram->calculatedMeanValue() - mean) <= 1e-6 * qMax(qreal(1.0), qAbs(mean)));
+        QVERIFY(qAbs(m_diagram->calculatedStandardDeviation() - sd) <= 1e-3 * sd);
+    }
+
+    QVector<LeveyJenningsDiagram::ControlRules> violations() const
+    {
+        QVector<LeveyJenningsDiagram::ControlRules> result;
+        for (int row = 0; row < m_model->rowCount(); ++row)
+            result << m_diagram->violatedControlRules(row);
+        return result;
+    }
+
+private slots:
+
+    void init()
+    {
+        m_model = new QStandardItemModel(0, 4);
+        m_diagram = new LeveyJenningsDiagram;
+        m_diagram->setModel(m_model);
+        m_diagram->setExpectedMeanValue(0.0);
+        m_diagram->setExpectedStandardDeviation(1.0);
+    }
+
+    void cleanup()
+    {
+        delete m_diagram;
+        delete m_model;
+    }
+
+    void testStatisticsFollowModel()
+    {
+        QVERIFY(std::isnan(m_diagram->calculatedMeanValue()));
+        for (int i = 0; i < 100; ++i)
+            appendValue(std::sin(i * 0.3) * 4 + 10);
+        verifyStatistics();
+
+        m_model->setData(m_model->index(17, 1), 42.0);
+        verifyStatistics();
+        m_model->removeRows(10, 20);
+        verifyStatistics();
+        m_model->insertRow(5, QList<QStandardItem *>() << new QStandardItem(1) << new QStandardItem(3.0));
+        verifyStatistics();
+    }
+
+    void testStatisticsAreStable()
+    {
+        // the sum of squares formula loses all digits of the deviation for values like these
+        for (int i = 0; i < 1000; ++i)
+            appendValue(1e9 + (i % 2 ? 0.5 : -0.5));
+        QVERIFY(qAbs(m_diagram->calculatedStandardDeviation() - 0.50025) < 1e-3);
+    }
+
+    void testControlRules()
+    {
+        QCOMPARE(m_diagram->controlRules(), LeveyJenningsDiagram::ControlRules());
+        const QVector<qreal> values = {0.5, 3.5, -0.1, 2.5, 2.6, -2.5, -0.2,
+                                       0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5};
+        for (qreal value : values)
+            appendValue(value);
+        QCOMPARE(m_diagram->violatedControlRules(1), LeveyJenningsDiagram::ControlRules());
+
+        m_diagram->setControlRules(LeveyJenningsDiagram::AllControlRules);
+        QVector<LeveyJenningsDiagram::ControlRules> expected(values.count());
+        expected[1] = LeveyJenningsDiagram::Rule1_3s;
+        expected[3] = LeveyJenningsDiagram::Rule2_2s;
+        expected[4] = LeveyJenningsDiagram::Rule2_2s | LeveyJenningsDiagram::RuleR_4s;
+        expected[5] = LeveyJenningsDiagram::RuleR_4s;
+        for (int row = 7; row < values.count(); ++row)
+            expected[row] = LeveyJenningsDiagram::Rule10x;
+        QCOMPARE(violations(), expected);
+
+        m_diagram->setControlRules(LeveyJenningsDiagram::Rule1_3s);
+        QCOMPARE(m_diagram->violatedControlRules(1), LeveyJenningsDiagram::ControlRules(LeveyJenningsDiagram::Rule1_3s));
+        QCOMPARE(m_diagram->violatedControlRules(4), LeveyJenningsDiagram::ControlRules());
+    }
+
+    void testStreamingEqualsRecalculation()
+    {
+        m_diagram->setControlRules(LeveyJenningsDiagram::AllControlRules);
+        for (int i = 0; i < 500; ++i) {
+            appendValue(std::sin(i * 0.7) * 2.8 + (i % 40 < 12 ? 0.9 : 0.0));
+            // filled in after the row was added, as QC values often are
+            if (i % 7 == 0)
+                m_model->setData(m_model->index(i, 1), -3.2);
+        }
+        const QVector<LeveyJenningsDiagram::ControlRules> streamed = violations();
+        int outliers = 0;
+        for (LeveyJenningsDiagram::ControlRules rules : streamed) {
+            if (rules & LeveyJenningsDiagram::Rule1_3s)
+                ++outliers;
+        }
+        QVERIFY(outliers > 0);
+
+        QMetaObject::invokeMethod(m_diagram, "calculateMeanAndStandardDeviation");
+        QCOMPARE(violations(), streamed);
+    }
+
+    void testFillingInAppendedRows()
+    {
+        m_diagram->setControlRules(LeveyJenningsDiagram::AllControlRules);
+        for (int i = 0; i < 300; ++i) {
+            // rows are added before their QC values are known, usually only the last
+            // one is filled in, which is checked on its own
+            for (int row = 0; row < 3; ++row)
+                appendValue(QVariant());
+            const int last = m_model->rowCount() - 1;
+            m_model->setData(m_model->index(last, 1), std::sin(i * 0.7) * 2.8 + (i % 40 < 12 ? 0.9 : 0.0));
+            if (i % 11 == 0)
+                m_model->setData(m_model->index(last - 1, 1), 3.4);
+        }
+        const QVector<LeveyJenningsDiagram::ControlRules> streamed = violations();
+
+        QMetaObject::invokeMethod(m_diagram, "calculateMeanAndStandardDeviation");
+        QCOMPARE(violations(), streamed);
+    }
+
+    void testChangedColumns()
+    {
+        for (int i = 0; i < 20; ++i)
+            appendValue(1.0);
+        m_model->insertColumns(4, 2);
+        m_diagram->setControlRules(LeveyJenningsDiagram::Rule1_3s);
+        QCOMPARE(m_diagram->violatedControlRules(7), LeveyJenningsDiagram::ControlRules());
+
+        // the expected mean of the row moves the value 4 SD away from it, changed
+        // together with columns the statistics do not depend on
+        m_model->blockSignals(true);
+        m_model->setData(m_model->index(7, 4), -3.0);
+        m_model->setData(m_model->index(7, 5), 1.0);
+        m_model->blockSignals(false);
+        QMetaObject::invokeMethod(m_model, "dataChanged", Q_ARG(QModelIndex, m_model->index(7, 2)),
+                                  Q_ARG(QModelIndex, m_model->index(7, 5)));
+        QCOMPARE(m_diagram->violatedControlRules(7), LeveyJenningsDiagram::ControlRules(LeveyJenningsDiagram::Rule1_3s));
+    }
+
+    void testSortedModel()
+    {
+        m_diagram->setControlRules(LeveyJenningsDiagram::AllControlRules);
+        for (int i = 0; i < 100; ++i)
+            appendValue(std::sin(i * 0.7) * 2.8);
+        m_model->sort(1);
+
+        // another diagram reads the sorted rows from scratch
+        LeveyJenningsDiagram diagram;
+        diagram.setModel(m_model);
+        diagram.setExpectedMeanValue(0.0);
+        diagram.setExpectedStandardDeviation(1.0);
+        diagram.setControlRules(LeveyJenningsDiagram::AllControlRules);
+        for (int row = 0; row < m_model->rowCount(); ++row)
+            QCOMPARE(m_diagram->violatedControlRules(row), diagram.violatedControlRules(row));
+    }
+
+    void benchmarkAppend()
+    {
+        m_diagram->setControlRules(LeveyJenningsDiagram::AllControlRules);
+        int i = 0;
+        QBENCHMARK {
+            appendValue(std::sin(i++ * 0.7) * 2.5);
+        }
+    }
+
+private:
+    QStandardItemModel *m_model;
+    LeveyJenningsDiagram *m_diagram;
+};
+
+QTEST_MAIN(TestLeveyJennings)
+
+#include "main.moc"
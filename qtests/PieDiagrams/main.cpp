@@ -9,11 +9,16 @@
 ****************************************************************************/
 
 #include <KDChartChart>
+#include <KDChartDataValueAttributes>
 #include <KDChartGlobal>
 #include <KDChartPieAttributes>
 #include <KDChartPieDiagram>
 #include <KDChartPolarCoordinatePlane>
+#include <KDChartRingDiagram>
 #include <KDChartThreeDPieAttributes>
+#include <QImage>
+#include <QPainter>
+#include <QStandardItemModel>
 #include <QtTest/QtTest>
 
 #include <TableModel.h>
@@ -23,6 +28,15 @@ using namespace KDChart;
 class TestPieDiagrams : public QObject
 {
     Q_OBJECT
+private:
+    static void paintChart(Chart *chart)
+    {
+        QImage image(400, 400, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        chart->paint(&painter, image.rect());
+    }
+
 private slots:
 
     void initTestCase()
@@ -130,16 +144,161 @@ private slots:
         QVERIFY(m_pie->threeDPieAttributes().useShadowColors() == false);
     }
 
+    void testValueTotalsFollowModel()
+    {
+        QStandardItemModel model(1, 4);
+        for (int column = 0; column < 4; ++column)
+            model.setData(model.index(0, column), column + 1.0);
+        PieDiagram pie;
+        pie.setModel(&model);
+        QCOMPARE(pie.valueTotals(), 10.0);
+
+        model.setData(model.index(0, 1), -5.0);
+        QCOMPARE(pie.valueTotals(), 13.0);
+        model.insertColumn(4);
+        model.setData(model.index(0, 4), 7.0);
+        QCOMPARE(pie.valueTotals(), 20.0);
+        model.removeColumns(0, 2);
+        QCOMPARE(pie.valueTotals(), 14.0);
+    }
+
+    void testRingValueTotals()
+    {
+        QStandardItemModel model(2, 3);
+        for (int row = 0; row < 2; ++row) {
+            for (int column = 0; column < 3; ++column)
+                model.setData(model.index(row, column), (row + 1) * (column + 1.0));
+        }
+        RingDiagram ring;
+        ring.setModel(&model);
+        QCOMPARE(ring.valueTotals(0), 6.0);
+        QCOMPARE(ring.valueTotals(1), 12.0);
+        QCOMPARE(ring.valueTotals(), 18.0);
+
+        model.setData(model.index(1, 2), -10.0);
+        QCOMPARE(ring.valueTotals(1), 14.0);
+        model.removeRow(0);
+        QCOMPARE(ring.valueTotals(0), 14.0);
+        QCOMPARE(ring.valueTotals(), 14.0);
+    }
+
+    void testOtherSlice()
+    {
+        QStandardItemModel model(1, 21);
+        model.setData(model.index(0, 0), 1000.0);
+        for (int column = 1; column < 21; ++column)
+            model.setData(model.index(0, column), 10.0);
+        Chart chart;
+        chart.replaceCoordinatePlane(new PolarCoordinatePlane(&chart));
+        auto *pie = new PieDiagram;
+        pie->setModel(&model);
+        chart.coordinatePlane()->replaceDiagram(pie);
+
+        QCOMPARE(pie->otherSliceThreshold(), 0.0);
+        QCOMPARE(pie->otherSliceLabel(), QString::fromLatin1("Other"));
+        QCOMPARE(pie->otherSliceBrush(), QBrush(Qt::lightGray));
+        QCOMPARE(pie->otherSlicePen(), QPen(QColor(Qt::lightGray)));
+        paintChart(&chart);
+        QVERIFY(!pie->visualRect(model.index(0, 5)).isEmpty());
+        QVERIFY(pie->otherSliceIndexes().isEmpty());
+        QVERIFY(pie->otherSliceToolTip().isEmpty());
+
+        // the small slices are 3 degrees wide, and are painted as one slice belonging to none of them
+        pie->setOtherSliceThreshold(5.0);
+        QCOMPARE(pie->otherSliceThreshold(), 5.0);
+        paintChart(&chart);
+        QVERIFY(!pie->visualRect(model.index(0, 0)).isEmpty());
+        QVERIFY(pie->visualRect(model.index(0, 1)).isEmpty());
+        QVERIFY(pie->visualRect(model.index(0, 5)).isEmpty());
+        QCOMPARE(pie->valueTotals(), 1200.0);
+        QCOMPARE(pie->otherSliceIndexes().count(), 20);
+        QCOMPARE(pie->otherSliceIndexes().first(), model.index(0, 1));
+        QCOMPARE(pie->otherSliceIndexes().last(), model.index(0, 20));
+        QVERIFY(pie->otherSliceToolTip().startsWith(QLatin1String("Other ")));
+        pie->setOtherSliceToolTip(QString::fromLatin1("Small values"));
+        QCOMPARE(pie->otherSliceToolTip(), QString::fromLatin1("Small values"));
+
+        // the "Other" slice is painted last, from 300 to 360 degrees, near the middle of the right side
+        const QRect sliceRect = pie->visualRect(model.index(0, 0));
+        QPoint otherSlicePoint;
+        for (int x = 399; x >= 0 && otherSlicePoint.isNull(); --x) {
+            const QPoint point(x, sliceRect.center().y() + 5);
+            if (pie->isOtherSliceAt(point))
+                otherSlicePoint = point;
+        }
+        QVERIFY(!otherSlicePoint.isNull());
+        QVERIFY(!pie->indexAt(otherSlicePoint).isValid());
+        QVERIFY(!pie->isOtherSliceAt(QPoint(0, 0)));
+
+        pie->setOtherSliceBrush(Qt::darkGreen);
+        QCOMPARE(pie->otherSlicePen(), QPen(QColor(Qt::darkGreen)));
+        pie->setOtherSlicePen(QPen(Qt::black, 2));
+        QCOMPARE(pie->otherSlicePen(), QPen(Qt::black, 2));
+        paintChart(&chart);
+        QVERIFY(pie->isOtherSliceAt(otherSlicePoint));
+
+        // 12 degrees each
+        for (int column = 1; column < 21; ++column)
+            model.setData(model.index(0, column), 100.0);
+        paintChart(&chart);
+        QVERIFY(!pie->visualRect(model.index(0, 5)).isEmpty());
+        QVERIFY(pie->otherSliceIndexes().isEmpty());
+        QVERIFY(!pie->isOtherSliceAt(otherSlicePoint));
+    }
+
+    void benchmarkManySlices_data()
+    {
+        QTest::addColumn<bool>("ring");
+        QTest::addColumn<qreal>("otherSliceThreshold");
+        QTest::newRow("pie") << false << 0.0;
+        QTest::newRow("pie with other slice") << false << 1.0;
+        QTest::newRow("ring") << true << 0.0;
+    }
+
+    void benchmarkManySlices()
+    {
+        QFETCH(bool, ring);
+        QFETCH(qreal, otherSliceThreshold);
+        QStandardItemModel model(1, SliceCount);
+        for (int column = 0; column < SliceCount; ++column)
+            model.setData(model.index(0, column), column % 100 == 0 ? 500.0 : (column % 7) + 1.0);
+        Chart chart;
+        chart.replaceCoordinatePlane(new PolarCoordinatePlane(&chart));
+        AbstractPieDiagram *diagram = nullptr;
+        if (ring) {
+            diagram = new RingDiagram;
+        } else {
+            auto *pie = new PieDiagram;
+            pie->setOtherSliceThreshold(otherSliceThreshold);
+            diagram = pie;
+        }
+        diagram->setModel(&model);
+        DataValueAttributes dva(diagram->dataValueAttributes());
+        dva.setVisible(true);
+        diagram->setDataValueAttributes(dva);
+        chart.coordinatePlane()->replaceDiagram(diagram);
+
+        QImage image(600, 600, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        QBENCHMARK {
+            chart.paint(&painter, image.rect());
+        }
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static const int SliceCount;
+
     Chart *m_chart;
     PieDiagram *m_pie;
     TableModel *m_model;
 };
 
+const int TestPieDiagrams::SliceCount = 1200;
+
 QTEST_MAIN(TestPieDiagrams)
 
 #include "main.moc"
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartDataValueAttributes>
+#include <KDChartStockDiagram>
+#include <KDChartTextAttributes>
+#include <QImage>
+#include <QPainter>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+class TestStockDiagrams : public QObject
+{
+    Q_OBJECT
+
+private:
+    QImage paintChart()
+    {
+        QImage image(m_chart->size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        m_chart->paint(&painter, image.rect());
+        return image;
+    }
+
+    // the bounding rect of the pixels of the label color
+    static QRect labelRect(const QImage &image)
+    {
+        QRect rect;
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                const QColor color = image.pixelColor(x, y);
+                if (color.blue() > 150 && color.red() < 100 && color.green() < 100)
+                    rect |= QRect(x, y, 1, 1);
+            }
+        }
+        return rect;
+    }
+
+private slots:
+
+    void init()
+    {
+        // open, high, low and close of three days
+        const qreal values[3][4] = {{10, 14, 8, 12}, {12, 16, 9, 11}, {11, 15, 10, 13}};
+        m_model = new QStandardItemModel(3, 4, this);
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 4; ++column)
+                m_model->setData(m_model->index(row, column), values[row][column]);
+        }
+        m_chart = new Chart;
+        m_chart->resize(400, 300);
+        m_stock = new StockDiagram;
+        m_stock->setType(StockDiagram::OpenHighLowClose);
+        m_stock->setModel(m_model);
+        m_chart->coordinatePlane()->replaceDiagram(m_stock);
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+        delete m_model;
+    }
+
+    // Data value texts of OHLC bars are anchored at the projected points of the bar,
+    // like the lines, not at the values in diagram coordinates taken as pixels.
+    void testOHLCLabelPositions_data()
+    {
+        QTest::addColumn<int>("column");
+        QTest::addColumn<qreal>("xOffset");
+        QTest::newRow("open") << 0 << -1.0;
+        QTest::newRow("high") << 1 << 0.0;
+        QTest::newRow("low") << 2 << 0.0;
+        QTest::newRow("close") << 3 << 1.0;
+    }
+
+    void testOHLCLabelPositions()
+    {
+        QFETCH(int, column);
+        QFETCH(qreal, xOffset);
+
+        const QModelIndex index = m_model->index(1, column);
+        DataValueAttributes dva = m_stock->dataValueAttributes(index);
+        dva.setVisible(true);
+        TextAttributes ta = dva.textAttributes();
+        ta.setPen(QPen(QColor(0, 0, 255)));
+        dva.setTextAttributes(ta);
+        m_stock->setDataValueAttributes(index, dva);
+
+        const QRect label = labelRect(paintChart());
+        QVERIFY(!label.isEmpty());
+
+        // the end of the open or close tick, or the low or high end of the bar
+        const qreal tickLength = m_stock->stockBarAttributes().tickLength();
+        const auto *plane = static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane());
+        const QPointF anchor = plane->translate(QPointF(1.5 + xOffset * tickLength,
+                                                        m_model->data(index).toReal()));
+        QVERIFY2(qAbs(label.center().x() - anchor.x()) < 30 && qAbs(label.center().y() - anchor.y()) < 30,
+                 qPrintable(QStringLiteral("label at (%1, %2), anchor at (%3, %4)")
+                                .arg(label.center().x())
+                                .arg(label.center().y())
+                                .arg(anchor.x())
+                                .arg(anchor.y())));
+    }
+
+private:
+    Chart *m_chart;
+    StockDiagram *m_stock;
+    QStandardItemModel *m_model;
+};
+
+QTEST_MAIN(TestStockDiagrams)
+
+#include "main.moc"
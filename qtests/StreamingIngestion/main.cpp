@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartChart>
+#include <KDChartPlotter>
+#include <KDChartStreamingModel>
+#include <QSignalSpy>
+#include <QThread>
+#include <QVector>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+// pushes the x and y values of one plotter dataset, in chunks, retrying while the buffer is full
+class Producer : public QThread
+{
+public:
+    Producer(StreamingModel *model, int index)
+        : m_model(model)
+        , m_index(index)
+    {
+    }
+
+    static double value(int index, int sample)
+    {
+        return index * 1000 + sample % 997;
+    }
+
+    static const int SampleCount;
+    static const int ChunkSize;
+
+protected:
+    void run() override
+    {
+        QVector<double> x(ChunkSize);
+        QVector<double> y(ChunkSize);
+        for (int first = 0; first < SampleCount; first += ChunkSize) {
+            const int count = qMin(ChunkSize, SampleCount - first);
+            for (int i = 0; i < count; ++i) {
+                x[i] = first + i;
+                y[i] = value(m_index, first + i);
+            }
+            push(2 * m_index, x.constData(), count);
+            push(2 * m_index + 1, y.constData(), count);
+        }
+    }
+
+private:
+    void push(int dataset, const double *samples, int count)
+    {
+        int pushed = 0;
+        while (pushed < count) {
+            pushed += m_model->pushSamples(dataset, samples + pushed, count - pushed);
+            if (pushed < count)
+                QThread::yieldCurrentThread();
+        }
+    }
+
+    StreamingModel *m_model;
+    int m_index;
+};
+
+const int Producer::SampleCount = 20000;
+const int Producer::ChunkSize = 64;
+
+class TestStreamingIngestion : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testSettings()
+    {
+        StreamingModel model(2);
+        QCOMPARE(model.ingestionBufferSize(), 0);
+        QCOMPARE(model.ingestionInterval(), 16);
+        const double sample = 1.0;
+        QCOMPARE(model.pushSamples(0, &sample, 1), 0);
+
+        model.setIngestionBufferSize(1000);
+        QCOMPARE(model.ingestionBufferSize(), 1024);
+        model.setIngestionBufferSize(1024);
+        QCOMPARE(model.ingestionBufferSize(), 1024);
+        model.setIngestionInterval(5);
+        QCOMPARE(model.ingestionInterval(), 5);
+        QCOMPARE(model.pushSamples(2, &sample, 1), 0);
+    }
+
+    void testFlushAppendsAllDatasetsAtOnce()
+    {
+        StreamingModel model(3);
+        model.setIngestionBufferSize(16);
+        model.appendSamples(0, QVector<double>{1.0, 2.0});
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+        QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex, QModelIndex, QVector<int>)));
+
+        const double first[] = {3.0, 4.0, 5.0};
+        const double second[] = {6.0, 7.0, 8.0, 9.0};
+        QCOMPARE(model.pushSamples(0, first, 3), 3);
+        QCOMPARE(model.pushSamples(2, second, 4), 4);
+        QCOMPARE(model.rowCount(), 2);
+
+        model.flushPushedSamples();
+        QCOMPARE(model.rowCount(), 5);
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(inserted.at(0).at(1).toInt(), 2);
+        QCOMPARE(inserted.at(0).at(2).toInt(), 4);
+        // one change covering the rows that existed already
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(changed.at(0).at(0).toModelIndex(), model.index(0, 0));
+        QCOMPARE(changed.at(0).at(1).toModelIndex(), model.index(1, 2));
+
+        QCOMPARE(model.data(model.index(4, 0)).toDouble(), 5.0);
+        QCOMPARE(model.data(model.index(3, 2)).toDouble(), 9.0);
+        QVERIFY(!model.data(model.index(3, 1)).isValid());
+        QVERIFY(!model.data(model.index(4, 2)).isValid());
+
+        model.flushPushedSamples();
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(changed.count(), 1);
+    }
+
+    void testFullBuffer()
+    {
+        StreamingModel model(1);
+        model.setIngestionBufferSize(8);
+        QVector<double> samples;
+        for (int i = 0; i < 20; ++i)
+            samples << i;
+        QCOMPARE(model.pushSamples(0, samples.constData(), 10), 8);
+        QCOMPARE(model.pushSamples(0, samples.constData() + 8, 2), 0);
+        model.flushPushedSamples();
+        // wraps around the end of the buffer
+        QCOMPARE(model.pushSamples(0, samples.constData() + 8, 12), 8);
+        model.flushPushedSamples();
+        QCOMPARE(model.rowCount(), 16);
+        for (int row = 0; row < 16; ++row)
+            QCOMPARE(model.data(model.index(row, 0)).toDouble(), double(row));
+    }
+
+    void testClearDiscardsQueuedSamples()
+    {
+        StreamingModel model(1);
+        model.setIngestionBufferSize(8);
+        const double samples[] = {1.0, 2.0};
+        model.pushSamples(0, samples, 2);
+        model.clear();
+        model.flushPushedSamples();
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+    void testDatasetCountAfterEviction()
+    {
+        StreamingModel model(1);
+        model.setIngestionBufferSize(8);
+        model.setMaximumHistory(4);
+        model.appendSamples(0, QVector<double>{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0});
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(model.evictedSampleCount(), qint64(6));
+
+        model.setDatasetCount(3);
+        QCOMPARE(model.columnCount(), 3);
+        QCOMPARE(model.rowCount(), 4);
+        for (int row = 0; row < 4; ++row) {
+            QCOMPARE(model.data(model.index(row, 0)).toDouble(), 7.0 + row);
+            QVERIFY(!model.data(model.index(row, 1)).isValid());
+            QVERIFY(!model.data(model.index(row, 2)).isValid());
+            QVERIFY(qIsNaN(model.columnData(2)[row]));
+        }
+
+        // the buffers of the new datasets are compacted along with the others
+        model.appendSamples(0, QVector<double>{11.0, 12.0});
+        const double sample = 20.0;
+        QCOMPARE(model.pushSamples(2, &sample, 1), 1);
+        model.flushPushedSamples();
+        QCOMPARE(model.rowCount(), 4);
+        QCOMPARE(model.data(model.index(3, 0)).toDouble(), 12.0);
+        QCOMPARE(model.data(model.index(0, 2)).toDouble(), 20.0);
+        for (int row = 0; row < 4; ++row)
+            QVERIFY(!model.data(model.index(row, 1)).isValid());
+        for (int row = 1; row < 4; ++row)
+            QVERIFY(!model.data(model.index(row, 2)).isValid());
+    }
+
+    void testPushesAreCoalesced()
+    {
+        StreamingModel model(1);
+        model.setIngestionBufferSize(1024);
+        model.setIngestionInterval(50);
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+        for (int i = 0; i < 100; ++i) {
+            const double sample = i;
+            model.pushSamples(0, &sample, 1);
+        }
+        QCOMPARE(model.rowCount(), 0);
+        QTRY_COMPARE(model.rowCount(), 100);
+        QCOMPARE(inserted.count(), 1);
+    }
+
+    void testProducerThreads()
+    {
+        const int producerCount = 4;
+        StreamingModel model(2 * producerCount);
+        model.setIngestionBufferSize(4096);
+        Chart chart;
+        chart.resize(400, 300);
+        auto *plotter = new Plotter;
+        plotter->setModel(&model);
+        chart.coordinatePlane()->replaceDiagram(plotter);
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+        QVector<Producer *> producers;
+        for (int index = 0; index < producerCount; ++index) {
+            producers << new Producer(&model, index);
+            producers.last()->start();
+        }
+        // paint while the samples stream in, as a live chart would
+        for (bool running = true; running;) {
+            running = false;
+            for (Producer *producer : producers)
+                running = running || !producer->isFinished();
+            QCoreApplication::processEvents();
+            chart.grab();
+        }
+        for (Producer *producer : producers)
+            producer->wait();
+        qDeleteAll(producers);
+        model.flushPushedSamples();
+
+        QCOMPARE(model.rowCount(), Producer::SampleCount);
+        for (int index = 0; index < producerCount; ++index) {
+            for (int row = 0; row < Producer::SampleCount; ++row) {
+                QCOMPARE(model.data(model.index(row, 2 * index)).toDouble(), double(row));
+                QCOMPARE(model.data(model.index(row, 2 * index + 1)).toDouble(), Producer::value(index, row));
+            }
+        }
+        // far fewer updates than the chunks pushed
+        QVERIFY(inserted.count() < producerCount * Producer::SampleCount / Producer::ChunkSize);
+
+        const QPair<QPointF, QPointF> boundaries = plotter->dataBoundaries();
+        QCOMPARE(boundaries.first.x(), 0.0);
+        QCOMPARE(boundaries.second.x(), double(Producer::SampleCount - 1));
+        QVERIFY(!chart.grab().isNull());
+    }
+};
+
+QTEST_MAIN(TestStreamingIngestion)
+
+#include "main.moc"
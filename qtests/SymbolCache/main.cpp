@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartChart>
+#include <KDChartLeveyJenningsCoordinatePlane>
+#include <KDChartLeveyJenningsDiagram>
+#include <KDChartLineDiagram>
+#include <KDChartMarkerAttributes>
+#include <KDChartSymbolCache>
+#include <QDateTime>
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPicture>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include <ImageComparison.h>
+
+using namespace KDChart;
+
+class TestSymbolCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QImage createImage()
+    {
+        QImage image(200, 60, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        return image;
+    }
+
+    void paintMarkers(QPaintDevice *device, const MarkerAttributes &ma, const QBrush &brush,
+                      int count = 6, const QPointF &offset = QPointF())
+    {
+        QPainter painter(device);
+        for (int i = 0; i < count; ++i)
+            m_diagram->paintMarker(&painter, ma, brush, ma.pen(), QPointF(20 + 30 * (i % 6), 30) + offset,
+                                   ma.markerSize());
+    }
+
+private slots:
+
+    void init()
+    {
+        m_diagram = new LineDiagram;
+        SymbolCache *cache = SymbolCache::instance();
+        cache->setEnabled(true);
+        cache->setMaximumSize(2048);
+        cache->clear();
+        cache->resetStatistics();
+    }
+
+    void cleanup()
+    {
+        delete m_diagram;
+    }
+
+    void testSettings()
+    {
+        SymbolCache *cache = SymbolCache::instance();
+        QVERIFY(cache->isEnabled());
+        QCOMPARE(cache->maximumSize(), 2048);
+        cache->setMaximumSize(100);
+        QCOMPARE(cache->maximumSize(), 100);
+        cache->setEnabled(false);
+        QVERIFY(!cache->isEnabled());
+    }
+
+    void testSpritesLookLikeMarkers_data()
+    {
+        QTest::addColumn<int>("style");
+        QTest::addColumn<bool>("threeD");
+        QTest::newRow("circle") << int(MarkerAttributes::MarkerCircle) << false;
+        QTest::newRow("3D circle") << int(MarkerAttributes::MarkerCircle) << true;
+        QTest::newRow("square") << int(MarkerAttributes::MarkerSquare) << false;
+        QTest::newRow("diamond") << int(MarkerAttributes::MarkerDiamond) << false;
+        QTest::newRow("ring") << int(MarkerAttributes::MarkerRing) << false;
+        QTest::newRow("cross") << int(MarkerAttributes::MarkerCross) << false;
+        QTest::newRow("fast cross") << int(MarkerAttributes::MarkerFastCross) << false;
+    }
+
+    void testSpritesLookLikeMarkers()
+    {
+        QFETCH(int, style);
+        QFETCH(bool, threeD);
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        ma.setMarkerStyle(style);
+        ma.setThreeD(threeD);
+        ma.setMarkerSize(QSizeF(13, 9));
+        ma.setPen(QPen(Qt::darkBlue, 2.0));
+
+        QImage cached = createImage();
+        paintMarkers(&cached, ma, QBrush(Qt::yellow));
+        SymbolCache *cache = SymbolCache::instance();
+        QCOMPARE(cache->missCount(), 1);
+        QCOMPARE(cache->hitCount(), 5);
+        QCOMPARE(cache->count(), 1);
+
+        cache->setEnabled(false);
+        QImage direct = createImage();
+        paintMarkers(&direct, ma, QBrush(Qt::yellow));
+        QVERIFY(maximumDifference(cached, direct) <= 2);
+    }
+
+    void testFractionalPositions_data()
+    {
+        QTest::addColumn<QPointF>("offset");
+        QTest::addColumn<int>("tolerance");
+        // the sprites are rendered for quarter pixels, other positions are up to
+        // an eighth of a pixel off
+        QTest::newRow("quarter") << QPointF(0.25, 0.75) << 2;
+        QTest::newRow("half") << QPointF(0.5, 0.5) << 2;
+        QTest::newRow("arbitrary") << QPointF(0.3, 0.6) << 40;
+    }
+
+    void testFractionalPositions()
+    {
+        QFETCH(QPointF, offset);
+        QFETCH(int, tolerance);
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        ma.setMarkerStyle(MarkerAttributes::MarkerCircle);
+        ma.setMarkerSize(QSizeF(11, 11));
+        ma.setPen(QPen(Qt::darkBlue, 1.5));
+
+        QImage cached = createImage();
+        paintMarkers(&cached, ma, QBrush(Qt::yellow), 6, offset);
+        SymbolCache *cache = SymbolCache::instance();
+        QCOMPARE(cache->missCount(), 1);
+        QCOMPARE(cache->hitCount(), 5);
+
+        cache->setEnabled(false);
+        QImage direct = createImage();
+        paintMarkers(&direct, ma, QBrush(Qt::yellow), 6, offset);
+        QVERIFY(maximumDifference(cached, direct) <= tolerance);
+    }
+
+    void testKeyDescribesMarker()
+    {
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        ma.setMarkerSize(QSizeF(10, 10));
+        QImage image = createImage();
+        paintMarkers(&image, ma, QBrush(Qt::red));
+        paintMarkers(&image, ma, QBrush(Qt::green));
+        ma.setMarkerSize(QSizeF(12, 10));
+        paintMarkers(&image, ma, QBrush(Qt::green));
+        ma.setPen(QPen(Qt::black, 3.0));
+        paintMarkers(&image, ma, QBrush(Qt::green));
+        QCOMPARE(SymbolCache::instance()->count(), 4);
+        QCOMPARE(SymbolCache::instance()->missCount(), 4);
+    }
+
+    void testGradientsAreNotCached()
+    {
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        QLinearGradient gradient(0, 0, 10, 10);
+        gradient.setColorAt(0.0, Qt::red);
+        gradient.setColorAt(1.0, Qt::blue);
+        QImage image = createImage();
+        paintMarkers(&image, ma, QBrush(gradient));
+        QCOMPARE(SymbolCache::instance()->hitCount(), 0);
+        QCOMPARE(SymbolCache::instance()->missCount(), 0);
+    }
+
+    void testVectorOutputIsNotCached()
+    {
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        QPicture picture;
+        paintMarkers(&picture, ma, QBrush(Qt::red));
+        QCOMPARE(SymbolCache::instance()->hitCount(), 0);
+        QCOMPARE(SymbolCache::instance()->missCount(), 0);
+    }
+
+    void testLeveyJenningsIcons()
+    {
+        QStandardItemModel model(0, 4);
+        for (int row = 0; row < RowCount; ++row) {
+            QList<QStandardItem *> items;
+            for (int column = 0; column < 4; ++column)
+                items << new QStandardItem;
+            items[0]->setData(row / 10, Qt::DisplayRole);
+            items[1]->setData(row % 5 - 2.0, Qt::DisplayRole);
+            items[2]->setData(row % 7 != 0, Qt::DisplayRole);
+            items[3]->setData(QDateTime(QDate(2023, 1, 1), QTime(8, 0)).addSecs(3600 * row),
+                              Qt::DisplayRole);
+            model.appendRow(items);
+        }
+        Chart chart;
+        auto *diagram = new LeveyJenningsDiagram;
+        diagram->setModel(&model);
+        diagram->setExpectedMeanValue(0.0);
+        diagram->setExpectedStandardDeviation(1.0);
+        auto *plane = new LeveyJenningsCoordinatePlane;
+        chart.replaceCoordinatePlane(plane);
+        plane->replaceDiagram(diagram);
+
+        SymbolCache *cache = SymbolCache::instance();
+        QImage image(600, 400, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        {
+            QPainter painter(&image);
+            chart.paint(&painter, image.rect());
+        }
+        // the icons are rendered once, not for each data point
+        QVERIFY(cache->missCount() > 0);
+        QVERIFY(cache->hitCount() >= RowCount - cache->missCount());
+
+        cache->resetStatistics();
+        QImage repainted(image.size(), QImage::Format_ARGB32_Premultiplied);
+        repainted.fill(Qt::white);
+        {
+            QPainter painter(&repainted);
+            chart.paint(&painter, repainted.rect());
+        }
+        QCOMPARE(cache->missCount(), 0);
+        QCOMPARE(repainted, image);
+    }
+
+    void benchmarkMarkers_data()
+    {
+        QTest::addColumn<bool>("enabled");
+        QTest::newRow("uncached") << false;
+        QTest::newRow("cached") << true;
+    }
+
+    void benchmarkMarkers()
+    {
+        QFETCH(bool, enabled);
+        SymbolCache::instance()->setEnabled(enabled);
+        MarkerAttributes ma;
+        ma.setVisible(true);
+        ma.setMarkerStyle(MarkerAttributes::MarkerDiamond);
+        ma.setPen(QPen(Qt::black));
+        QImage image(1000, 1000, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        QBENCHMARK {
+            for (int i = 0; i < MarkerCount; ++i) {
+                const QPointF pos((i * 37) % 1000, (i * 91) % 1000);
+                m_diagram->paintMarker(&painter, ma, QBrush(Qt::red), ma.pen(), pos, ma.markerSize());
+            }
+        }
+    }
+
+private:
+    static const int RowCount;
+    static const int MarkerCount;
+
+    LineDiagram *m_diagram;
+};
+
+const int TestSymbolCache::RowCount = 40;
+const int TestSymbolCache::MarkerCount = 100000;
+
+QTEST_MAIN(TestSymbolCache)
+
+#include "main.moc"
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartBarDiagram>
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+class CountingBarDiagram : public BarDiagram
+{
+    Q_OBJECT
+
+public:
+    void paint(PaintContext *paintContext) override
+    {
+        ++paintCount;
+        BarDiagram::paint(paintContext);
+    }
+
+    int paintCount = 0;
+};
+
+class TestUpdateCoalescing : public QObject
+{
+    Q_OBJECT
+
+private:
+    void changeValues(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            m_model->setData(m_model->index(i % RowCount, i % 3), (i * 7) % 11);
+    }
+
+private slots:
+
+    void init()
+    {
+        m_chart = new Chart;
+        m_chart->resize(400, 300);
+        m_model = new QStandardItemModel(RowCount, 3, m_chart);
+        for (int row = 0; row < RowCount; ++row) {
+            for (int column = 0; column < 3; ++column)
+                m_model->setData(m_model->index(row, column), row % 5 + column);
+        }
+        m_diagram = new CountingBarDiagram;
+        m_diagram->setModel(m_model);
+        m_chart->coordinatePlane()->replaceDiagram(m_diagram);
+        m_chart->grab();
+        m_chart->resetUpdateStatistics();
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+    }
+
+    void testSettings()
+    {
+        QVERIFY(!m_chart->isUpdateCoalescingEnabled());
+        QCOMPARE(m_chart->maximumFrameRate(), 0);
+        m_chart->setUpdateCoalescingEnabled(true);
+        QVERIFY(m_chart->isUpdateCoalescingEnabled());
+        m_chart->setMaximumFrameRate(30);
+        QCOMPARE(m_chart->maximumFrameRate(), 30);
+        m_chart->setMaximumFrameRate(-5);
+        QCOMPARE(m_chart->maximumFrameRate(), 0);
+    }
+
+    void testDisabledUpdatesRightAway()
+    {
+        changeValues(100);
+        QCoreApplication::processEvents();
+        QCOMPARE(m_chart->coalescedUpdateCount(), 0);
+        QCOMPARE(m_chart->updateFrameCount(), 0);
+    }
+
+    void testChangesAreCoalesced()
+    {
+        m_chart->setUpdateCoalescingEnabled(true);
+        changeValues(1000);
+        // at least a relayout and a repaint per change, merged into the first one
+        QVERIFY(m_chart->coalescedUpdateCount() >= 2 * 1000 - 1);
+        QCOMPARE(m_chart->updateFrameCount(), 0);
+        QTRY_COMPARE(m_chart->updateFrameCount(), 1);
+
+        const int paintCount = m_diagram->paintCount;
+        const QImage coalesced = m_chart->grab().toImage();
+        QCOMPARE(m_diagram->paintCount, paintCount + 1);
+
+        m_chart->setUpdateCoalescingEnabled(false);
+        m_chart->update();
+        QCOMPARE(m_chart->grab().toImage(), coalesced);
+    }
+
+    void testPaintPerformsPendingUpdates()
+    {
+        m_chart->setUpdateCoalescingEnabled(true);
+        changeValues(50);
+        const QImage coalesced = m_chart->grab().toImage();
+        QCOMPARE(m_chart->updateFrameCount(), 1);
+        QCoreApplication::processEvents();
+        QCOMPARE(m_chart->updateFrameCount(), 1);
+
+        m_chart->setUpdateCoalescingEnabled(false);
+        m_chart->update();
+        QCOMPARE(m_chart->grab().toImage(), coalesced);
+    }
+
+    void testMaximumFrameRate()
+    {
+        m_chart->setUpdateCoalescingEnabled(true);
+        m_chart->setMaximumFrameRate(10);
+        QElapsedTimer timer;
+        timer.start();
+        changeValues(1);
+        QTRY_COMPARE(m_chart->updateFrameCount(), 1);
+        changeValues(1);
+        QTRY_COMPARE(m_chart->updateFrameCount(), 2);
+        // the second frame comes 100 ms after the first one at the earliest
+        QVERIFY(timer.elapsed() >= 95);
+    }
+
+    void benchmarkChangeStorm_data()
+    {
+        QTest::addColumn<bool>("coalesced");
+        QTest::newRow("immediate") << false;
+        QTest::newRow("coalesced") << true;
+    }
+
+    void benchmarkChangeStorm()
+    {
+        QFETCH(bool, coalesced);
+        m_chart->setUpdateCoalescingEnabled(coalesced);
+        QBENCHMARK {
+            changeValues(1000);
+            QCoreApplication::processEvents();
+        }
+    }
+
+private:
+    static const int RowCount;
+
+    Chart *m_chart;
+    QStandardItemModel *m_model;
+    CountingBarDiagram *m_diagram;
+};
+
+const int TestUpdateCoalescing::RowCount = 50;
+
+QTEST_MAIN(TestUpdateCoalescing)
+
+#include "main.moc"
@@ -111,6 +111,52 @@ struct CoordinateTransformation
         return transform.map(data);
     }
 
+    // convert count data space points, same result as translate() for each of them
+    void translate(const qreal *xs, const qreal *ys, QPointF *out, int count) const
+    {
+        const bool logX = axesCalcModeX == CartesianCoordinatePlane::Logarithmic;
+        const bool logY = axesCalcModeY == CartesianCoordinatePlane::Logarithmic;
+        if (transform.type() > QTransform::TxScale) {
+            // updateTransform() never builds a rotation, but stay correct if it ever does
+            for (int i = 0; i < count; ++i) {
+                out[i] = translate(QPointF(xs[i], ys[i]));
+            }
+            return;
+        }
+
+        // for translation and scaling, QTransform::map() is one multiply-add per coordinate;
+        // hoisting that and the calculation modes out of the loops leaves straight loops
+        // without branches that the compiler can vectorize
+        const qreal scaleX = transform.m11();
+        const qreal scaleY = transform.m22();
+        const qreal dx = transform.dx();
+        const qreal dy = transform.dy();
+        if (!logX && !logY) {
+            for (int i = 0; i < count; ++i) {
+                out[i] = QPointF(xs[i] * scaleX + dx, ys[i] * scaleY + dy);
+            }
+            return;
+        }
+
+        // -log10(-value) for a negative range, see logTransform()
+        const qreal signX = isPositiveX ? 1.0 : -1.0;
+        const qreal signY = isPositiveY ? 1.0 : -1.0;
+        if (logX && logY) {
+            for (int i = 0; i < count; ++i) {
+                out[i] = QPointF(signX * log10(signX * xs[i]) * scaleX + dx,
+                                 signY * log10(signY * ys[i]) * scaleY + dy);
+            }
+        } else if (logX) {
+            for (int i = 0; i < count; ++i) {
+                out[i] = QPointF(signX * log10(signX * xs[i]) * scaleX + dx, ys[i] * scaleY + dy);
+            }
+        } else {
+            for (int i = 0; i < count; ++i) {
+                out[i] = QPointF(xs[i] * scaleX + dx, signY * log10(signY * ys[i]) * scaleY + dy);
+            }
+        }
+    }
+
     // convert screen point to data space point
     inline const QPointF translateBack(const QPointF &screenPoint) const
     {
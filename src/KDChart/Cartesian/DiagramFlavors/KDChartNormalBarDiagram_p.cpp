@@ -15,6 +15,7 @@
 #include "KDChartAbstractCartesianDiagram.h"
 #include "KDChartAttributesModel.h"
 #include "KDChartBarDiagram.h"
+#include "KDChartCartesianCoordinatePlane_p.h"
 #include "KDChartTextAttributes.h"
 
 using namespace KDChart;
@@ -32,53 +33,11 @@ BarDiagram::BarType NormalBarDiagram::type() const
 
 const QPair<QPointF, QPointF> NormalBarDiagram::calculateDataBoundaries() const
 {
-    const int rowCount = compressor().modelDataRows();
-    const int colCount = compressor().modelDataColumns();
-
     const qreal xMin = 0.0;
-    const qreal xMax = rowCount;
+    const qreal xMax = compressor().modelDataRows();
     qreal yMin = 0.0;
     qreal yMax = 0.0;
-
-    qreal usedDepth = 0;
-
-    bool isFirst = true;
-    for (int column = 0; column < colCount; ++column) {
-        for (int row = 0; row < rowCount; ++row) {
-            const CartesianDiagramDataCompressor::CachePosition position(row, column);
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
-            const qreal value = ISNAN(point.value) ? 0.0 : point.value;
-
-            QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(sourceIndex);
-
-            if (threeDAttrs.isEnabled())
-                usedDepth = qMax(usedDepth, threeDAttrs.depth());
-
-            // this is always true yMin can be 0 in case all values
-            // are the same
-            // same for yMax it can be zero if all values are negative
-            if (isFirst) {
-                yMin = value;
-                yMax = value;
-                isFirst = false;
-            } else {
-                yMin = qMin(yMin, value);
-                yMax = qMax(yMax, value);
-            }
-        }
-    }
-
-    // special cases
-    if (yMax == yMin) {
-        if (yMin == 0.0) {
-            yMax = 0.1; // we need at least a range
-        } else if (yMax < 0.0) {
-            yMax = 0.0; // extend the range to zero
-        } else if (yMin > 0.0) {
-            yMin = 0.0; // dito
-        }
-    }
+    valueRange(&yMin, &yMax);
 
     return QPair<QPointF, QPointF>(QPointF(xMin, yMin), QPointF(xMax, yMax));
 }
@@ -144,6 +103,33 @@ void NormalBarDiagram::paint(PaintContext *ctx)
 
     LabelPaintCache lpc;
 
+    // the tops and bottoms of all bars are translated in one batch, in parallel for many bars;
+    // bar n is the one of row n / colCount and column n % colCount
+    Q_ASSERT(dynamic_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane()));
+    const auto *plane = static_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane());
+    const int barCount = rowCount * colCount;
+    QVector<CartesianDiagramDataCompressor::DataPoint> barPoints(barCount);
+    QVector<qreal> topKeys(barCount);
+    QVector<qreal> values(barCount);
+    QVector<qreal> bottomKeys(barCount);
+    const QVector<qreal> zeros(barCount, 0.0);
+    QVector<QPointF> topPoints(barCount);
+    QVector<QPointF> bottomPoints(barCount);
+    for (int row = 0; row < rowCount; ++row) {
+        for (int column = 0; column < colCount; ++column) {
+            const int bar = row * colCount + column;
+            const CartesianDiagramDataCompressor::CachePosition position(row, column);
+            const CartesianDiagramDataCompressor::DataPoint &point = barPoints[bar] = compressor().data(position);
+            topKeys[bar] = point.key + 0.5;
+            values[bar] = point.value;
+            bottomKeys[bar] = point.key;
+        }
+    }
+    CartesianCoordinatePlane::Private::translateInParallel(plane, topKeys.constData(), values.constData(),
+                                                           topPoints.data(), barCount);
+    CartesianCoordinatePlane::Private::translateInParallel(plane, bottomKeys.constData(), zeros.constData(),
+                                                           bottomPoints.data(), barCount);
+
     for (int row = 0; row < rowCount; ++row) {
         qreal offset = -groupWidth / 2 + spaceBetweenGroups / 2;
 
@@ -161,13 +147,13 @@ void NormalBarDiagram::paint(PaintContext *ctx)
 
         for (int column = 0; column < colCount; ++column) {
             // paint one group
-            const CartesianDiagramDataCompressor::CachePosition position(row, column);
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
+            const int bar = row * colCount + column;
+            const CartesianDiagramDataCompressor::DataPoint &point = barPoints.at(bar);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
             const qreal value = point.value; // attributesModel()->data( sourceIndex ).toReal();
             if (!point.hidden && !ISNAN(value)) {
-                QPointF topPoint = ctx->coordinatePlane()->translate(QPointF(point.key + 0.5, value));
-                QPointF bottomPoint = ctx->coordinatePlane()->translate(QPointF(point.key, 0));
+                QPointF topPoint = topPoints.at(bar);
+                const QPointF bottomPoint = bottomPoints.at(bar);
 
                 if (threeDAttrs.isEnabled()) {
                     const qreal usedDepth = threeDAttrs.depth() / 4;
@@ -15,6 +15,7 @@
 #include "KDChartAbstractCartesianDiagram.h"
 #include "KDChartAttributesModel.h"
 #include "KDChartBarDiagram.h"
+#include "KDChartCartesianCoordinatePlane_p.h"
 #include "KDChartLineDiagram.h"
 #include "KDChartNormalLineDiagram_p.h"
 #include "KDChartTextAttributes.h"
@@ -48,6 +49,20 @@ void NormalLineDiagram::paint(PaintContext *ctx)
     }
 }
 
+namespace {
+// a point of a dataset, with what painting it needs from the model and the attributes;
+// its key and values are kept in separate arrays to translate them in batches
+struct LinePoint
+{
+    QModelIndex sourceIndex;
+    int row;
+    int column;
+    uint transparency;
+    bool displayArea;
+    bool firstOfDataset;
+};
+}
+
 void NormalLineDiagram::paintWithLines(PaintContext *ctx)
 {
     reverseMapper().clear();
@@ -63,32 +78,42 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
     LabelPaintCache lpc;
     LineAttributesInfoList lineList;
 
+    // when zoomed in, only the buckets in view need to be aggregated and painted
+    const QRectF visibleRange = plane->visibleDataRange();
+    const qreal keyOffset = diagram()->centerDataPoints() ? 0.5 : 0;
+    const QPair<int, int> rows = compressor().rowRange(qMin(visibleRange.left(), visibleRange.right()) - keyOffset,
+                                                       qMax(visibleRange.left(), visibleRange.right()) - keyOffset);
+
+    // Get min. y value, used as lower or upper bounding for area highlighting
+    const qreal minYValue = qMin(visibleRange.bottom(), visibleRange.top());
+
+    // 1. read everything needed from the model and the attributes, in painting order;
+    // hidden points and bridged missing values do not take part in painting at all
+    QVector<LinePoint> points;
+    QVector<qreal> keys; // including keyOffset
+    QVector<qreal> values; // NaN if the line is interrupted here
+    QVector<qreal> areaBoundingValues;
     const int step = rev ? -1 : 1;
     const int end = rev ? -1 : columnCount;
     for (int column = rev ? columnCount - 1 : 0; column != end; column += step) {
-        LineAttributes laPreviousCell;
-        CartesianDiagramDataCompressor::DataPoint lastPoint;
-        qreal lastAreaBoundingValue = 0;
-
-        // Get min. y value, used as lower or upper bounding for area highlighting
-        const qreal minYValue = qMin(plane->visibleDataRange().bottom(), plane->visibleDataRange().top());
-
-        CartesianDiagramDataCompressor::CachePosition previousCellPosition;
-        for (int row = 0; row < rowCount; ++row) {
+        bool firstOfDataset = true;
+        for (int row = rows.first; row < rows.second; ++row) {
             const CartesianDiagramDataCompressor::CachePosition position(row, column);
             // get where to draw the line from:
-            CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
+            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             if (point.hidden) {
                 continue;
             }
 
-            const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
+            LinePoint linePoint;
+            qreal value = point.value;
+            qreal areaBoundingValue;
+            linePoint.sourceIndex = attributesModel()->mapToSource(point.index);
 
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(linePoint.sourceIndex);
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
             // lower or upper bounding for the highlighted area
-            qreal areaBoundingValue;
             if (laCell.areaBoundingDataset() != -1) {
                 const CartesianDiagramDataCompressor::CachePosition areaBoundingCachePosition(row, laCell.areaBoundingDataset());
                 areaBoundingValue = compressor().data(areaBoundingCachePosition).value;
@@ -97,14 +122,14 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
                 areaBoundingValue = minYValue;
             }
 
-            if (ISNAN(point.value)) {
+            if (ISNAN(value)) {
                 switch (policy) {
                 case LineAttributes::MissingValuesAreBridged:
                     // we just bridge both values
                     continue;
                 case LineAttributes::MissingValuesShownAsZero:
                     // set it to zero
-                    point.value = 0.0;
+                    value = 0.0;
                     break;
                 case LineAttributes::MissingValuesHideSegments:
                     // they're just hidden
@@ -115,36 +140,61 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
                 }
             }
 
-            if (!ISNAN(point.value)) {
-                // area corners, a + b are the line ends:
-                const qreal offset = diagram()->centerDataPoints() ? 0.5 : 0;
-                const QPointF a(plane->translate(QPointF(lastPoint.key + offset, lastPoint.value)));
-                const QPointF b(plane->translate(QPointF(point.key + offset, point.value)));
-                const QPointF c(plane->translate(QPointF(lastPoint.key + offset, lastAreaBoundingValue)));
-                const QPointF d(plane->translate(QPointF(point.key + offset, areaBoundingValue)));
-                const PositionPoints pts = PositionPoints(b, a, d, c);
-
-                // add label
-                m_private->addLabel(&lpc, sourceIndex, &position, pts, Position::NorthWest,
-                                    Position::NorthWest, point.value);
-
-                // add line and area, if switched on and we have a current and previous value
-                if (!ISNAN(a.x()) && !ISNAN(a.y()) && !ISNAN(b.x()) && !ISNAN(b.y())) {
-                    lineList.append(LineAttributesInfo(sourceIndex, a, b));
+            linePoint.row = row;
+            linePoint.column = column;
+            linePoint.transparency = laCell.transparency();
+            linePoint.displayArea = laCell.displayArea();
+            linePoint.firstOfDataset = firstOfDataset;
+            firstOfDataset = false;
+            points.append(linePoint);
+            keys.append(point.key + keyOffset);
+            values.append(value);
+            areaBoundingValues.append(areaBoundingValue);
+        }
+    }
 
-                    if (laCell.displayArea()) {
-                        QList<QPolygonF> areas;
-                        areas << (QPolygonF() << a << b << d << c);
-                        PaintingHelpers::paintAreas(m_private, ctx, attributesModel()->mapToSource(lastPoint.index),
-                                                    areas, laCell.transparency());
-                    }
-                }
+    // 2. translate the line ends and the bottom of the area of all points. The ends of the
+    // segment from the previous point of the dataset are that point's ones, so every point is
+    // translated only once. That is done in batches, in parallel for many points.
+    const int pointCount = points.size();
+    QVector<QPointF> lineEnds(pointCount);
+    QVector<QPointF> areaEnds(pointCount);
+    CartesianCoordinatePlane::Private::translateInParallel(plane, keys.constData(), values.constData(),
+                                                           lineEnds.data(), pointCount);
+    CartesianCoordinatePlane::Private::translateInParallel(plane, keys.constData(), areaBoundingValues.constData(),
+                                                           areaEnds.data(), pointCount);
+
+    // 3. collect labels and lines, and paint the areas, in painting order
+    const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+    const QPointF firstLineStart = plane->translate(QPointF(nan, nan));
+    const QPointF firstAreaStart = plane->translate(QPointF(nan, 0));
+    for (int i = 0; i < pointCount; ++i) {
+        const LinePoint &point = points.at(i);
+        const qreal value = values.at(i);
+        if (ISNAN(value))
+            continue;
+        // area corners, a + b are the line ends:
+        const QPointF a = point.firstOfDataset ? firstLineStart : lineEnds.at(i - 1);
+        const QPointF b = lineEnds.at(i);
+        const QPointF c = point.firstOfDataset ? firstAreaStart : areaEnds.at(i - 1);
+        const QPointF d = areaEnds.at(i);
+        const CartesianDiagramDataCompressor::CachePosition position(point.row, point.column);
+        const PositionPoints pts = PositionPoints(b, a, d, c);
+
+        // add label
+        m_private->addLabel(&lpc, point.sourceIndex, &position, pts, Position::NorthWest,
+                            Position::NorthWest, value);
+
+        // add line and area, if switched on and we have a current and previous value
+        if (!ISNAN(a.x()) && !ISNAN(a.y()) && !ISNAN(b.x()) && !ISNAN(b.y())) {
+            lineList.append(LineAttributesInfo(point.sourceIndex, a, b));
+
+            if (point.displayArea) {
+                QList<QPolygonF> areas;
+                areas << (QPolygonF() << a << b << d << c);
+                PaintingHelpers::paintAreas(m_private, ctx, points.at(i - 1).sourceIndex,
+                                            areas, point.transparency);
             }
-
-            previousCellPosition = position;
-            laPreviousCell = laCell;
-            lastAreaBoundingValue = areaBoundingValue;
-            lastPoint = point;
         }
     }
 
@@ -172,7 +222,6 @@ void NormalLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
     const int step = rev ? -1 : 1;
     const int end = rev ? -1 : columnCount;
     for (int column = rev ? columnCount - 1 : 0; column != end; column += step) {
-        LineAttributes laPreviousCell;
         CartesianDiagramDataCompressor::DataPoint lastPoint;
         qreal lastAreaBoundingValue = 0;
 
@@ -190,7 +239,7 @@ void NormalLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
 
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
 
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
             // lower or upper bounding for the highlighted area
@@ -293,7 +342,6 @@ void NormalLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
             }
 
             previousCellPosition = position;
-            laPreviousCell = laCell;
             lastAreaBoundingValue = areaBoundingValue;
             lastPoint = point;
         }
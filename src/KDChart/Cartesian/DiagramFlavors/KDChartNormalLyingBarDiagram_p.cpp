@@ -15,6 +15,7 @@
 #include "KDChartAbstractCartesianDiagram.h"
 #include "KDChartAttributesModel.h"
 #include "KDChartBarDiagram.h"
+#include "KDChartCartesianCoordinatePlane_p.h"
 #include "KDChartTextAttributes.h"
 
 using namespace KDChart;
@@ -30,47 +31,14 @@ BarDiagram::BarType NormalLyingBarDiagram::type() const
     return BarDiagram::Normal;
 }
 
-// TODO there is a lot of duplication between this and the non-lying bar diagram, fix it someday...
 const QPair<QPointF, QPointF> NormalLyingBarDiagram::calculateDataBoundaries() const
 {
-    const int rowCount = compressor().modelDataRows();
-    const int colCount = compressor().modelDataColumns();
-
     const qreal xMin = 0.0;
-    const qreal xMax = rowCount;
+    const qreal xMax = compressor().modelDataRows();
     qreal yMin = 0.0;
     qreal yMax = 0.0;
+    valueRange(&yMin, &yMax);
 
-    bool isFirst = true;
-    for (int column = 0; column < colCount; ++column) {
-        for (int row = 0; row < rowCount; ++row) {
-            const CartesianDiagramDataCompressor::CachePosition position(row, column);
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
-            const qreal value = ISNAN(point.value) ? 0.0 : point.value;
-            // this is always true yMin can be 0 in case all values
-            // are the same
-            // same for yMax it can be zero if all values are negative
-            if (isFirst) {
-                yMin = value;
-                yMax = value;
-                isFirst = false;
-            } else {
-                yMin = qMin(yMin, value);
-                yMax = qMax(yMax, value);
-            }
-        }
-    }
-
-    // special cases
-    if (yMax == yMin) {
-        if (yMin == 0.0) {
-            yMax = 0.1; // we need at least a range
-        } else if (yMax < 0.0) {
-            yMax = 0.0; // they are the same and negative
-        } else if (yMin > 0.0) {
-            yMin = 0.0; // they are the same but positive
-        }
-    }
     const QPointF bottomLeft(QPointF(yMin, xMin));
     const QPointF topRight(QPointF(yMax, xMax));
 
@@ -132,6 +100,31 @@ void NormalLyingBarDiagram::paint(PaintContext *ctx)
 
     LabelPaintCache lpc;
 
+    // the starts and ends of all bars are translated in one batch, in parallel for many bars;
+    // bar n is the one of row n / colCount and column n % colCount
+    Q_ASSERT(dynamic_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane()));
+    const auto *plane = static_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane());
+    const int barCount = rowCount * colCount;
+    QVector<CartesianDiagramDataCompressor::DataPoint> barPoints(barCount);
+    const QVector<qreal> zeros(barCount, 0.0);
+    QVector<qreal> values(barCount);
+    QVector<qreal> keys(barCount);
+    QVector<QPointF> topLefts(barCount);
+    QVector<QPointF> bottomRights(barCount);
+    for (int row = 0; row < rowCount; row++) {
+        for (int column = 0; column < colCount; column++) {
+            const int bar = row * colCount + column;
+            const CartesianDiagramDataCompressor::CachePosition position(row, column);
+            const CartesianDiagramDataCompressor::DataPoint &point = barPoints[bar] = compressor().data(position);
+            values[bar] = point.value;
+            keys[bar] = point.key + 0.5;
+        }
+    }
+    CartesianCoordinatePlane::Private::translateInParallel(plane, zeros.constData(), keys.constData(),
+                                                           topLefts.data(), barCount);
+    CartesianCoordinatePlane::Private::translateInParallel(plane, values.constData(), keys.constData(),
+                                                           bottomRights.data(), barCount);
+
     for (int row = 0; row < rowCount; row++) {
         qreal offset = -groupWidth / 2 + spaceBetweenGroups / 2;
 
@@ -149,14 +142,12 @@ void NormalLyingBarDiagram::paint(PaintContext *ctx)
 
         for (int column = 0; column < colCount; column++) {
             // paint one group
-            const CartesianDiagramDataCompressor::CachePosition position(row, column);
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
+            const int bar = row * colCount + column;
+            const CartesianDiagramDataCompressor::DataPoint &point = barPoints.at(bar);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
 
-            QPointF dataPoint(0, (point.key + 0.5));
-            const QPointF topLeft = ctx->coordinatePlane()->translate(dataPoint);
-            dataPoint.rx() += point.value;
-            const QPointF bottomRight = ctx->coordinatePlane()->translate(dataPoint) + QPointF(0, barWidth);
+            const QPointF topLeft = topLefts.at(bar);
+            const QPointF bottomRight = bottomRights.at(bar) + QPointF(0, barWidth);
 
             const QRectF rect = QRectF(topLeft, bottomRight).translated(1.0, offset);
             m_private->addLabel(&lpc, sourceIndex, nullptr, PositionPoints(rect), Position::North,
@@ -9,6 +9,7 @@
 ****************************************************************************/
 
 #include "KDChartNormalPlotter_p.h"
+#include "KDChartCartesianCoordinatePlane_p.h"
 #include "KDChartPlotter.h"
 #include "PaintingHelpers_p.h"
 
@@ -54,7 +55,7 @@ void NormalPlotter::paint(PaintContext *ctx)
                 const PlotterDiagramCompressor::DataPoint point = *it;
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-                LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+                const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
                 const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
                 if (ISNAN(point.key) || ISNAN(point.value)) {
@@ -108,16 +109,36 @@ void NormalPlotter::paint(PaintContext *ctx)
     } else {
         if (colCount == 0 || rowCount == 0)
             return;
+        // the points of a dataset and their projections on the null line are translated in
+        // one batch, in parallel for many points; a and c are those of the previous point, or of a missing one after a gap
+        const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+        const QPointF missingPoint = plane->translate(QPointF(nan, nan));
+        const QPointF missingNullPoint = plane->translate(QPointF(nan, 0.0));
+        QVector<CartesianDiagramDataCompressor::DataPoint> points(rowCount);
+        QVector<qreal> keys(rowCount);
+        QVector<qreal> values(rowCount);
+        const QVector<qreal> zeros(rowCount, 0.0);
+        QVector<QPointF> valuePoints(rowCount);
+        QVector<QPointF> nullPoints(rowCount);
         for (int column = 0; column < colCount; ++column) {
             LineAttributesInfoList lineList;
-            CartesianDiagramDataCompressor::DataPoint lastPoint;
-
             for (int row = 0; row < rowCount; ++row) {
                 const CartesianDiagramDataCompressor::CachePosition position(row, column);
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
+                const CartesianDiagramDataCompressor::DataPoint &point = points[row] = compressor().data(position);
+                keys[row] = point.key;
+                values[row] = point.value;
+            }
+            CartesianCoordinatePlane::Private::translateInParallel(plane, keys.constData(), values.constData(),
+                                                                   valuePoints.data(), rowCount);
+            CartesianCoordinatePlane::Private::translateInParallel(plane, keys.constData(), zeros.constData(),
+                                                                   nullPoints.data(), rowCount);
+
+            int lastRow = -1;
+            for (int row = 0; row < rowCount; ++row) {
+                const CartesianDiagramDataCompressor::DataPoint &point = points.at(row);
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-                LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+                const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
                 const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
 
                 if (ISNAN(point.key) || ISNAN(point.value)) {
@@ -127,18 +148,18 @@ void NormalPlotter::paint(PaintContext *ctx)
                     case LineAttributes::MissingValuesShownAsZero: // fall-through since that attribute makes no sense for the plotter
                     case LineAttributes::MissingValuesHideSegments: // fall-through since they're just hidden
                     default:
-                        lastPoint = CartesianDiagramDataCompressor::DataPoint();
+                        lastRow = -1;
                         continue;
                     }
                 }
 
                 // data area painting: a and b are prev / current data points, c and d are on the null line
-                const QPointF b(plane->translate(QPointF(point.key, point.value)));
+                const QPointF b(valuePoints.at(row));
 
                 if (!point.hidden && PaintingHelpers::isFinite(b)) {
-                    const QPointF a(plane->translate(QPointF(lastPoint.key, lastPoint.value)));
-                    const QPointF c(plane->translate(QPointF(lastPoint.key, 0.0)));
-                    const QPointF d(plane->translate(QPointF(point.key, 0.0)));
+                    const QPointF a(lastRow == -1 ? missingPoint : valuePoints.at(lastRow));
+                    const QPointF c(lastRow == -1 ? missingNullPoint : nullPoints.at(lastRow));
+                    const QPointF d(nullPoints.at(row));
 
                     // data point label
                     const PositionPoints pts = PositionPoints(b, a, d, c);
@@ -156,14 +177,15 @@ void NormalPlotter::paint(PaintContext *ctx)
                             QPolygonF polygon;
                             polygon << a << b << d << c;
                             areas << polygon;
+                            const QModelIndex lastIndex = lastRow == -1 ? QModelIndex() : points.at(lastRow).index;
                             PaintingHelpers::paintAreas(m_private, ctx,
-                                                        attributesModel()->mapToSource(lastPoint.index),
+                                                        attributesModel()->mapToSource(lastIndex),
                                                         areas, laCell.transparency());
                         }
                     }
                 }
 
-                lastPoint = point;
+                lastRow = row;
             }
             PaintingHelpers::paintElements(m_private, ctx, lpc, lineList);
         }
@@ -40,13 +40,14 @@ const QPair<QPointF, QPointF> PercentBarDiagram::calculateDataBoundaries() const
     const qreal yMax = 100.0;
 
     qreal usedDepth = 0;
+    const AttributeSnapshot attributes(attributesModel());
 
     for (int row = 0; row < rowCount; ++row) {
         for (int col = 0; col < colCount; ++col) {
             const CartesianDiagramDataCompressor::CachePosition position(row, col);
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data(position);
             QModelIndex sourceIndex = attributesModel()->mapToSource(p.index);
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(sourceIndex);
+            const ThreeDBarAttributes &threeDAttrs = attributes.threeDBarAttributes(sourceIndex);
 
             if (threeDAttrs.isEnabled() && threeDAttrs.depth() > usedDepth) {
                 usedDepth = threeDAttrs.depth();
@@ -140,7 +141,7 @@ void PercentBarDiagram::paint(PaintContext *ctx)
             const CartesianDiagramDataCompressor::CachePosition position(row, col);
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data(position);
             QModelIndex sourceIndex = attributesModel()->mapToSource(p.index);
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(sourceIndex);
+            const ThreeDBarAttributes &threeDAttrs = m_private->paintAttributes.threeDBarAttributes(sourceIndex);
 
             if (threeDAttrs.isEnabled()) {
                 if (barWidth > 0)
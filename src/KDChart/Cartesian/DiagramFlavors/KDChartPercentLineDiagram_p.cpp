@@ -91,7 +91,7 @@ void PercentLineDiagram::paintWithLines(PaintContext *ctx)
             const CartesianDiagramDataCompressor::CachePosition position(row, col);
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
             if (ISNAN(point.value) && policy == LineAttributes::MissingValuesAreBridged)
                 point.value = interpolateMissingValue(position);
@@ -118,7 +118,7 @@ void PercentLineDiagram::paintWithLines(PaintContext *ctx)
             const CartesianDiagramDataCompressor::CachePosition position(row, column);
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const bool bDisplayCellArea = laCell.displayArea();
 
             qreal stackedValues = 0, nextValues = 0, nextKey = 0;
@@ -257,7 +257,7 @@ void PercentLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
             const CartesianDiagramDataCompressor::CachePosition position(row, col);
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
             if (ISNAN(point.value) && policy == LineAttributes::MissingValuesAreBridged)
                 point.value = interpolateMissingValue(position);
@@ -283,7 +283,7 @@ void PercentLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
 
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const bool bDisplayCellArea = laCell.displayArea();
 
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
@@ -147,7 +147,7 @@ void PercentLyingBarDiagram::paint(PaintContext *ctx)
             const CartesianDiagramDataCompressor::CachePosition position(curRow, col);
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data(position);
             QModelIndex sourceIndex = attributesModel()->mapToSource(p.index);
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(sourceIndex);
+            const ThreeDBarAttributes &threeDAttrs = m_private->paintAttributes.threeDBarAttributes(sourceIndex);
 
             if (threeDAttrs.isEnabled()) {
                 if (barWidth > 0) {
@@ -192,8 +192,6 @@ void PercentPlotter::paint(PaintContext *ctx)
                     extraY += y;
             }
 
-            LineAttributes laCell;
-
             const qreal scalingFactor =
                 qFuzzyIsNull(yValueSums[i.key()]) ? 0.0 : 100.0 / yValueSums[i.key()];
 
@@ -206,7 +204,7 @@ void PercentPlotter::paint(PaintContext *ctx)
             const QPointF c(plane->translate(QPointF(lastPoint.key, lastExtraY * scalingFactor)));
             const QPointF d(plane->translate(QPointF(point.key, extraY * scalingFactor)));
             // add the line to the list:
-            laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             // add data point labels:
             const PositionPoints pts = PositionPoints(b, a, d, c);
             // if necessary, add the area to the area list:
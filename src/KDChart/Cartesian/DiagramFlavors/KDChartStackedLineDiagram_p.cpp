@@ -128,7 +128,7 @@ void StackedLineDiagram::paintWithLines(PaintContext *ctx)
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
 
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const bool bDisplayCellArea = laCell.displayArea();
 
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
@@ -261,7 +261,7 @@ void StackedLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
             CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
             const QModelIndex sourceIndex = attributesModel()->mapToSource(point.index);
 
-            const LineAttributes laCell = diagram()->lineAttributes(sourceIndex);
+            const LineAttributes &laCell = m_private->paintAttributes.lineAttributes(sourceIndex);
             const bool bDisplayCellArea = laCell.displayArea();
 
             const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
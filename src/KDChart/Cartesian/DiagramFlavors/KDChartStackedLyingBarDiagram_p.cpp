@@ -146,7 +146,7 @@ void StackedLyingBarDiagram::paint(PaintContext *ctx)
             const CartesianDiagramDataCompressor::DataPoint p = compressor().data(position);
 
             const QModelIndex index = attributesModel()->mapToSource(p.index);
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(index);
+            const ThreeDBarAttributes &threeDAttrs = m_private->paintAttributes.threeDBarAttributes(index);
             const qreal value = p.value;
             qreal stackedValues = 0.0;
             qreal key = 0.0;
@@ -10,6 +10,7 @@
 
 #include "KDChartAbstractCartesianDiagram.h"
 #include "KDChartAbstractCartesianDiagram_p.h"
+#include "KDChartStreamingModel.h"
 
 #include <KDABLibFakes>
 
@@ -102,9 +103,9 @@ void KDChart::AbstractCartesianDiagram::setCoordinatePlane(AbstractCoordinatePla
 {
     if (coordinatePlane()) {
         disconnect(attributesModel(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
-                   coordinatePlane(), SLOT(relayout()));
+                   this, SLOT(relayoutForRowChange()));
         disconnect(attributesModel(), SIGNAL(rowsInserted(const QModelIndex &, int, int)),
-                   coordinatePlane(), SLOT(relayout()));
+                   this, SLOT(relayoutForRowChange()));
         disconnect(attributesModel(), SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
                    coordinatePlane(), SLOT(relayout()));
         disconnect(attributesModel(), SIGNAL(columnsInserted(const QModelIndex &, int, int)),
@@ -116,9 +117,9 @@ void KDChart::AbstractCartesianDiagram::setCoordinatePlane(AbstractCoordinatePla
     if (plane) {
         // Readjust the layout when the dataset count changes
         connect(attributesModel(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
-                plane, SLOT(relayout()));
+                this, SLOT(relayoutForRowChange()));
         connect(attributesModel(), SIGNAL(rowsInserted(const QModelIndex &, int, int)),
-                plane, SLOT(relayout()));
+                this, SLOT(relayoutForRowChange()));
         connect(attributesModel(), SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
                 plane, SLOT(relayout()));
         connect(attributesModel(), SIGNAL(columnsInserted(const QModelIndex &, int, int)),
@@ -129,6 +130,21 @@ void KDChart::AbstractCartesianDiagram::setCoordinatePlane(AbstractCoordinatePla
     }
 }
 
+void AbstractCartesianDiagram::relayoutForRowChange()
+{
+    AbstractCoordinatePlane *plane = coordinatePlane();
+    if (!plane) {
+        return;
+    }
+    // appending samples to a stream (and dropping the oldest ones) changes nothing
+    // but the data range, the sizes of the chart's elements stay the same
+    if (StreamingModel::fromModel(attributesModel())) {
+        plane->layoutDiagrams();
+    } else {
+        plane->relayout();
+    }
+}
+
 void AbstractCartesianDiagram::setReferenceDiagram(AbstractCartesianDiagram *diagram, const QPointF &offset)
 {
     d->referenceDiagram = diagram;
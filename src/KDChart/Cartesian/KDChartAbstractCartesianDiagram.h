@@ -108,6 +108,12 @@ public:
 
 protected Q_SLOTS:
     void connectAttributesModel(AttributesModel *);
+    /**
+     * Readjusts the coordinate plane after rows were inserted or removed.
+     * For a StreamingModel, only the data range of the plane is updated,
+     * without laying out the whole chart again.
+     */
+    void relayoutForRowChange();
 
 protected:
     /** @return the 3D item depth of the model index \a index */
@@ -26,6 +26,7 @@
 
 #include <KDChartAbstractDiagram_p.h>
 #include <KDChartAbstractThreeDAttributes.h>
+#include <KDChartEnums.h>
 #include <KDChartGridAttributes.h>
 
 #include <KDABLibFakes>
@@ -58,10 +59,11 @@ public:
         const QModelIndex &index,
         const CartesianDiagramDataCompressor::CachePosition *position) const override
     {
+        // labels are added while painting, after paintAttributes were reset
         if (position)
-            return compressor.aggregatedAttrs(diagram, index, *position);
+            return compressor.aggregatedAttrs(paintAttributes, index, *position);
         CartesianDiagramDataCompressor::AggregatedDataValueAttributes allAttrs;
-        allAttrs[index] = diagram->dataValueAttributes(index);
+        allAttrs[index] = paintAttributes.dataValueAttributes(index);
         return allAttrs;
     }
 
@@ -70,7 +72,28 @@ public:
     AbstractCartesianDiagram *referenceDiagram = nullptr;
     QPointF referenceDiagramOffset;
 
+    // hands dataReductionMode on to the compressor; stacked and percent types add up the
+    // datasets cache row by cache row, so they need rows that are averaged alike
+    void updateApproximationMode(bool datasetsAreStacked)
+    {
+        CartesianDiagramDataCompressor::ApproximationMode mode = CartesianDiagramDataCompressor::Precise;
+        if (!datasetsAreStacked) {
+            switch (dataReductionMode) {
+            case KDChartEnums::DataReductionAverage:
+                break;
+            case KDChartEnums::DataReductionMinMax:
+                mode = CartesianDiagramDataCompressor::MinMaxPerPixel;
+                break;
+            case KDChartEnums::DataReductionLargestTriangle:
+                mode = CartesianDiagramDataCompressor::LargestTriangleThreeBuckets;
+                break;
+            }
+        }
+        compressor.setApproximationMode(mode);
+    }
+
     mutable CartesianDiagramDataCompressor compressor;
+    KDChartEnums::DataReductionMode dataReductionMode = KDChartEnums::DataReductionAverage;
 };
 
 KDCHART_IMPL_DERIVED_DIAGRAM(AbstractCartesianDiagram, AbstractDiagram, CartesianCoordinatePlane)
@@ -85,6 +85,7 @@ void BarDiagram::Private::setOrientationAndType(Qt::Orientation o, BarDiagram::B
     }
 
     Q_ASSERT(implementor->type() == type);
+    updateApproximationMode(type != BarDiagram::Normal);
 
     // AbstractAxis settings - see AbstractDiagram and CartesianAxis
     barDia->setPercentMode(type == BarDiagram::Percent);
@@ -124,6 +125,7 @@ BarDiagram *BarDiagram::clone() const
 {
     auto *newDiagram = new BarDiagram(new Private(*d));
     newDiagram->setType(type());
+    newDiagram->setDataReductionMode(dataReductionMode());
     return newDiagram;
 }
 
@@ -166,6 +168,33 @@ void BarDiagram::setOrientation(Qt::Orientation orientation)
     d->setOrientationAndType(orientation, d->implementor->type());
 }
 
+/**
+ * Sets how datasets with more values than the diagram is wide in pixels
+ * are condensed. With KDChartEnums::DataReductionMinMax, a normal bar diagram
+ * paints the bars of the first, minimum, maximum and last value of each
+ * pixel column at their actual positions, instead of averaged bars.
+ * Stacked and percent bar diagrams always average.
+ */
+void BarDiagram::setDataReductionMode(KDChartEnums::DataReductionMode mode)
+{
+    if (d->dataReductionMode == mode) {
+        return;
+    }
+
+    d->dataReductionMode = mode;
+    d->updateApproximationMode(type() != BarDiagram::Normal);
+    setDataBoundariesDirty();
+    emit propertiesChanged();
+}
+
+/**
+ * @return the data reduction mode set by setDataReductionMode()
+ */
+KDChartEnums::DataReductionMode BarDiagram::dataReductionMode() const
+{
+    return d->dataReductionMode;
+}
+
 /**
  * @return the orientation of the bar diagram
  */
@@ -364,6 +393,7 @@ void BarDiagram::paint(PaintContext *ctx)
     // ctx->painter()->setClipRect( ctx->rectangle() );
 
     // paint different bar types Normal - Stacked - Percent - Default Normal
+    d->paintAttributes.reset(attributesModel());
     d->implementor->paint(ctx);
 
     ctx->setCoordinatePlane(plane);
@@ -12,6 +12,7 @@
 #define KDCHARTBARDIAGRAM_H
 
 #include "KDChartAbstractCartesianDiagram.h"
+#include "KDChartEnums.h"
 #include "KDChartBarAttributes.h"
 
 QT_BEGIN_NAMESPACE
@@ -63,6 +64,9 @@ public:
     void setOrientation(Qt::Orientation orientation);
     Qt::Orientation orientation() const;
 
+    void setDataReductionMode(KDChartEnums::DataReductionMode mode);
+    KDChartEnums::DataReductionMode dataReductionMode() const;
+
     void setBarAttributes(const BarAttributes &a);
     void setBarAttributes(int column, const BarAttributes &a);
     void setBarAttributes(const QModelIndex &index, const BarAttributes &a);
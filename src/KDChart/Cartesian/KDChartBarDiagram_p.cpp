@@ -26,11 +26,11 @@ void BarDiagram::BarDiagramType::paintBars(PaintContext *ctx, const QModelIndex
     PainterSaver painterSaver(ctx->painter());
 
     // Pending Michel: configure threeDBrush settings - shadowColor etc...
-    QBrush indexBrush(diagram()->brush(index));
-    QPen indexPen(diagram()->pen(index));
+    QBrush indexBrush(m_private->paintAttributes.brush(index));
+    const QPen &indexPen = m_private->paintAttributes.pen(index);
 
     ctx->painter()->setRenderHint(QPainter::Antialiasing, diagram()->antiAliasing());
-    ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes(index);
+    ThreeDBarAttributes threeDAttrs = m_private->paintAttributes.threeDBarAttributes(index);
     if (threeDAttrs.isEnabled()) {
         indexBrush = threeDAttrs.threeDBrush(indexBrush, bar);
     }
@@ -165,6 +165,34 @@ void BarDiagram::BarDiagramType::calculateValueAndGapWidths(int rowCount, int co
     outSpaceBetweenGroups += unitWidth * ba.groupGapFactor();
 }
 
+void BarDiagram::BarDiagramType::valueRange(qreal *minimum, qreal *maximum) const
+{
+    const CartesianDiagramDataBounds::Box box = compressor().dataBoundingBox();
+    qreal yMin = 0.0;
+    qreal yMax = 0.0;
+    if (box.count > 0) {
+        yMin = box.yMin;
+        yMax = box.yMax;
+        if (box.missingCount > 0) {
+            yMin = qMin(yMin, 0.0);
+            yMax = qMax(yMax, 0.0);
+        }
+    }
+
+    // special cases
+    if (yMax == yMin) {
+        if (yMin == 0.0) {
+            yMax = 0.1; // we need at least a range
+        } else if (yMax < 0.0) {
+            yMax = 0.0; // extend the range to zero
+        } else if (yMin > 0.0) {
+            yMin = 0.0; // dito
+        }
+    }
+    *minimum = yMin;
+    *maximum = yMax;
+}
+
 ReverseMapper &BarDiagram::BarDiagramType::reverseMapper()
 {
     return m_private->reverseMapper;
@@ -85,6 +85,10 @@ protected:
     ReverseMapper &reverseMapper();
     CartesianDiagramDataCompressor &compressor() const;
 
+    // the smallest and largest bar value, missing values counting as zero, extended
+    // to zero if they are the same; only reads the values changed since the last call
+    void valueRange(qreal *minimum, qreal *maximum) const;
+
     void paintBars(PaintContext *ctx, const QModelIndex &index, const QRectF &bar, qreal maxDepth);
     void calculateValueAndGapWidths(int rowCount, int colCount,
                                     qreal groupWidth,
@@ -19,6 +19,7 @@
 #include "KDChartGridAttributes.h"
 #include "KDChartPaintContext.h"
 #include "KDChartPainterSaver_p.h"
+#include "KDChartParallel_p.h"
 #include "KDChartStockDiagram.h"
 
 #include <KDABLibFakes>
@@ -426,6 +427,22 @@ const QPointF CartesianCoordinatePlane::translate(const QPointF &diagramPoint) c
     return d->coordinateTransformation.translate(diagramPoint);
 }
 
+void CartesianCoordinatePlane::translate(const qreal *xs, const qreal *ys, QPointF *out, int count) const
+{
+    d->coordinateTransformation.translate(xs, ys, out, count);
+}
+
+void CartesianCoordinatePlane::Private::translateInParallel(const CartesianCoordinatePlane *plane, const qreal *xs,
+                                                            const qreal *ys, QPointF *out, int count, int threshold)
+{
+    CoordinateTransformation transformation = get(const_cast<CartesianCoordinatePlane *>(plane))->coordinateTransformation;
+    // QTransform::type() caches its result on first use, which must not happen in the workers
+    transformation.transform.type();
+    parallelFor(count, threshold, [&transformation, xs, ys, out](int from, int to) {
+        transformation.translate(xs + from, ys + from, out + from, to - from);
+    });
+}
+
 const QPointF CartesianCoordinatePlane::translateBack(const QPointF &screenPoint) const
 {
     return d->coordinateTransformation.translateBack(screenPoint);
@@ -51,6 +51,15 @@ public:
 
     const QPointF translate(const QPointF &diagramPoint) const override;
 
+    /**
+     * Translates @p count diagram points at once, storing the screen point for
+     * (@p xs[i], @p ys[i]) in @p out[i]. The result is the same as calling
+     * translate(const QPointF&) for every point, but the per-point overhead of
+     * the calculation modes and zoom is paid only once. Used by the diagrams
+     * to translate whole datasets while painting.
+     */
+    void translate(const qreal *xs, const qreal *ys, QPointF *out, int count) const;
+
     /**
      * \sa setZoomFactorX, setZoomCenter
      */
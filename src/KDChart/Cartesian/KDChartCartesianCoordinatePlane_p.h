@@ -57,6 +57,12 @@ public:
         return static_cast<Private *>(plane->d_func());
     }
 
+    // Like CartesianCoordinatePlane::translate() for arrays, but on the thread pool from
+    // threshold points on. The workers share a copy of the transformation, prepared so
+    // that they only read it, and never the plane itself.
+    static void translateInParallel(const CartesianCoordinatePlane *plane, const qreal *xs, const qreal *ys,
+                                    QPointF *out, int count, int threshold = 16384);
+
     bool isVisiblePoint(const AbstractCoordinatePlane *plane, const QPointF &point) const override
     {
         QPointF p = point;
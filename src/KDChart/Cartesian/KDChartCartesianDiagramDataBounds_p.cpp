@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartCartesianDiagramDataBounds_p.h"
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+void CartesianDiagramDataBounds::Box::add(const QPointF &point)
+{
+    if (ISNAN(point.x()) || ISNAN(point.y())) {
+        ++missingCount;
+        return;
+    }
+    if (count == 0) {
+        xMin = xMax = point.x();
+        yMin = yMax = point.y();
+    } else {
+        xMin = qMin(xMin, point.x());
+        xMax = qMax(xMax, point.x());
+        yMin = qMin(yMin, point.y());
+        yMax = qMax(yMax, point.y());
+    }
+    ++count;
+}
+
+void CartesianDiagramDataBounds::Box::add(const Box &other)
+{
+    missingCount += other.missingCount;
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        xMin = other.xMin;
+        xMax = other.xMax;
+        yMin = other.yMin;
+        yMax = other.yMax;
+    } else {
+        xMin = qMin(xMin, other.xMin);
+        xMax = qMax(xMax, other.xMax);
+        yMin = qMin(yMin, other.yMin);
+        yMax = qMax(yMax, other.yMax);
+    }
+    count += other.count;
+}
+
+bool CartesianDiagramDataBounds::isEmpty() const
+{
+    return m_levels.isEmpty();
+}
+
+int CartesianDiagramDataBounds::rowCount() const
+{
+    return m_levels.isEmpty() ? 0 : m_levels.first().size();
+}
+
+void CartesianDiagramDataBounds::clear()
+{
+    m_levels.clear();
+    m_changed.clear();
+}
+
+void CartesianDiagramDataBounds::build(int rowCount)
+{
+    clear();
+    m_levels.resize(1);
+    m_levels[0].resize(rowCount);
+    markChanged(0, rowCount - 1);
+}
+
+void CartesianDiagramDataBounds::resize(int rowCount)
+{
+    if (m_levels.isEmpty()) {
+        build(rowCount);
+        return;
+    }
+    const int oldRowCount = m_levels.first().size();
+    if (rowCount == oldRowCount) {
+        return;
+    }
+    m_levels[0].resize(rowCount);
+    if (rowCount > oldRowCount) {
+        markChanged(oldRowCount, rowCount - 1);
+    } else {
+        // the last box of each level lost rows
+        updateLevels(qMax(0, rowCount - 1), rowCount);
+    }
+}
+
+void CartesianDiagramDataBounds::markChanged(int firstRow, int lastRow)
+{
+    if (m_levels.isEmpty() || firstRow > lastRow) {
+        return;
+    }
+    // changes usually come in runs of rows, one row after the other
+    if (!m_changed.isEmpty() && firstRow <= m_changed.last().second && lastRow + 1 >= m_changed.last().first) {
+        m_changed.last().first = qMin(m_changed.last().first, firstRow);
+        m_changed.last().second = qMax(m_changed.last().second, lastRow + 1);
+    } else {
+        m_changed.append(qMakePair(firstRow, lastRow + 1));
+    }
+    // with changes all over the dataset, reading all rows once is cheaper
+    if (m_changed.size() > 16 && m_changed.size() > rowCount() / 16) {
+        m_changed = {qMakePair(0, rowCount())};
+    }
+}
+
+CartesianDiagramDataBounds::Box CartesianDiagramDataBounds::bounds(const PointReader &point)
+{
+    if (m_levels.isEmpty()) {
+        return Box();
+    }
+    QVector<Box> &boxes = m_levels[0];
+    for (const QPair<int, int> &range : qAsConst(m_changed)) {
+        const int first = qMax(0, range.first);
+        const int end = qMin(range.second, boxes.size());
+        for (int row = first; row < end; ++row) {
+            Box box;
+            box.add(point(row));
+            boxes[row] = box;
+        }
+        if (first < end) {
+            updateLevels(first, end);
+        }
+    }
+    m_changed.clear();
+    return m_levels.last().isEmpty() ? Box() : m_levels.last().first();
+}
+
+void CartesianDiagramDataBounds::updateLevels(int firstRow, int endRow)
+{
+    int level = 0;
+    for (; m_levels.at(level).size() > 1; ++level) {
+        if (level + 1 == m_levels.size()) {
+            m_levels.resize(level + 2);
+        }
+        const QVector<Box> &below = m_levels[level];
+        QVector<Box> &above = m_levels[level + 1];
+        above.resize((below.size() + 1) / 2);
+        firstRow /= 2;
+        endRow = (endRow + 1) / 2;
+        for (int node = firstRow; node < endRow; ++node) {
+            Box box = below.at(2 * node);
+            if (2 * node + 1 < below.size()) {
+                box.add(below.at(2 * node + 1));
+            }
+            above[node] = box;
+        }
+    }
+    m_levels.resize(level + 1);
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTCARTESIANDIAGRAMDATABOUNDS_H
+#define KDCHARTCARTESIANDIAGRAMDATABOUNDS_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <functional>
+
+#include <QPair>
+#include <QPointF>
+#include <QVector>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+// - the bounding box of the data points of one dataset in the compressor's cache,
+// kept in a tree of boxes over the cache rows, two boxes of one level making up
+// a box of the next level
+// - changed rows are only marked; when the bounds are asked for, the boxes of the
+// k changed rows and the boxes above them are computed again, in O(k + log(rows))
+// for a range of rows, instead of reading all rows again
+class KDCHART_EXPORT CartesianDiagramDataBounds
+{
+public:
+    // reads the key (x) and value (y) of a cache row, NaN for missing values
+    typedef std::function<QPointF(int row)> PointReader;
+
+    class Box
+    {
+    public:
+        void add(const QPointF &point);
+        void add(const Box &other);
+
+        qreal xMin = 0.0;
+        qreal xMax = 0.0;
+        qreal yMin = 0.0;
+        qreal yMax = 0.0;
+        int count = 0; // number of points with key and value
+        int missingCount = 0; // number of points without key or value
+    };
+
+    bool isEmpty() const;
+    int rowCount() const;
+    void clear();
+
+    // starts over with rowCount rows, all of them to be read
+    void build(int rowCount);
+    // grows or shrinks the tree to rowCount rows, the rows added are to be read
+    void resize(int rowCount);
+    // the points of rows [firstRow, lastRow] are to be read again
+    void markChanged(int firstRow, int lastRow);
+
+    // the bounding box of all rows, reading the changed rows first
+    Box bounds(const PointReader &point);
+
+private:
+    // recompute the boxes above level 0 that cover the rows [firstRow, endRow)
+    void updateLevels(int firstRow, int endRow);
+
+    QVector<QVector<Box>> m_levels; // level 0: one box per row
+    QVector<QPair<int, int>> m_changed; // [first, end) ranges of rows to read again
+};
+}
+
+#endif
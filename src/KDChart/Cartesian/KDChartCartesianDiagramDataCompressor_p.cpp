@@ -13,13 +13,32 @@
 #include <QAbstractItemModel>
 #include <QtDebug>
 
+#include <algorithm>
+
 #include "KDChartAbstractCartesianDiagram.h"
+#include "KDChartAttributeSnapshot_p.h"
+#include "KDChartStreamingModel.h"
 
 #include <KDABLibFakes>
 
 using namespace KDChart;
 using namespace std;
 
+// modes that pick actual samples instead of aggregating them; the samples picked for a
+// pixel column depend on the rows around them, so structural model changes rebuild the cache
+static bool picksSamples(CartesianDiagramDataCompressor::ApproximationMode mode)
+{
+    return mode == CartesianDiagramDataCompressor::MinMaxPerPixel
+        || mode == CartesianDiagramDataCompressor::LargestTriangleThreeBuckets;
+}
+
+static CartesianDiagramDataPyramid::ValueReader valueReader(const ModelDataCache<qreal, Qt::DisplayRole> &cache, int column)
+{
+    return [&cache, column](int row) {
+        return cache.data(row, column);
+    };
+}
+
 CartesianDiagramDataCompressor::CartesianDiagramDataCompressor(QObject *parent)
     : QObject(parent)
 {
@@ -40,7 +59,7 @@ static bool contains(const CartesianDiagramDataCompressor::AggregatedDataValueAt
 }
 
 CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDataCompressor::aggregatedAttrs(
-    const AbstractDiagram *diagram,
+    const AttributeSnapshot &attributes,
     const QModelIndex &index,
     const CachePosition &position) const
 {
@@ -50,10 +69,17 @@ CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDa
         return i.value();
     }
 
-    // aggregate attributes from all indices in the same CachePosition as index
+    // aggregate attributes from all indices in the same CachePosition as index;
+    // a decimated cache row shows a single sample, not an aggregate
+    QModelIndexList neighborIndexes;
+    if (isDecimating()) {
+        neighborIndexes << data(position).index;
+    } else {
+        neighborIndexes = mapToModel(position);
+    }
     CartesianDiagramDataCompressor::AggregatedDataValueAttributes aggregated;
-    Q_FOREACH (const QModelIndex &neighborIndex, mapToModel(position)) {
-        DataValueAttributes attrs = diagram->dataValueAttributes(neighborIndex);
+    Q_FOREACH (const QModelIndex &neighborIndex, neighborIndexes) {
+        DataValueAttributes attrs = attributes.dataValueAttributes(neighborIndex);
         // only store visible and unique attributes
         if (!attrs.isVisible()) {
             continue;
@@ -65,7 +91,7 @@ CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDa
     // if none of the attributes had the visible flag set, we just take the one set for the index
     // to avoid returning an empty list (### why not return an empty list?)
     if (aggregated.isEmpty()) {
-        aggregated[index] = diagram->dataValueAttributes(index);
+        aggregated[index] = attributes.dataValueAttributes(index);
     }
 
     m_dataValueAttributesCache[position] = aggregated;
@@ -75,7 +101,7 @@ CartesianDiagramDataCompressor::AggregatedDataValueAttributes CartesianDiagramDa
 bool CartesianDiagramDataCompressor::prepareDataChange(const QModelIndex &parent, bool isRows,
                                                        int *start, int *end)
 {
-    if (parent != m_rootIndex) {
+    if (parent != m_rootIndex || picksSamples(m_mode) || isStreaming()) {
         return false;
     }
     Q_ASSERT(*start <= *end);
@@ -113,6 +139,33 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted(const QModelIndex
 
 void CartesianDiagramDataCompressor::slotRowsInserted(const QModelIndex &parent, int start, int end)
 {
+    if (parent == m_rootIndex) {
+        // appended rows extend the pyramids, rows inserted anywhere else invalidate them
+        const int rowCount = m_model->rowCount(m_rootIndex);
+        for (int column = 0; column < m_pyramids.size(); ++column) {
+            CartesianDiagramDataPyramid &pyramid = m_pyramids[column];
+            if (pyramid.isEmpty()) {
+                continue;
+            }
+            if (start == pyramid.rowCount()) {
+                pyramid.append(valueReader(m_modelCache, column), rowCount);
+            } else {
+                pyramid.clear();
+            }
+        }
+    }
+    if (parent == m_rootIndex && isStreaming()) {
+        if (end == m_model->rowCount(m_rootIndex) - 1 && streamBucketSize() == m_streamBucketSize) {
+            appendStreamRows();
+        } else {
+            rebuildCache();
+        }
+        return;
+    }
+    if (parent == m_rootIndex && picksSamples(m_mode)) {
+        rebuildCache();
+        return;
+    }
     if (!prepareDataChange(parent, true, &start, &end)) {
         return;
     }
@@ -121,6 +174,8 @@ void CartesianDiagramDataCompressor::slotRowsInserted(const QModelIndex &parent,
             retrieveModelData(CachePosition(j, i));
         }
     }
+    // appending rows only adds to the bounds, rows inserted before others move them
+    resizeBounds(start);
 }
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted(const QModelIndex &parent, int start, int end)
@@ -128,13 +183,20 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted(const QModelIn
     if (!prepareDataChange(parent, false, &start, &end)) {
         return;
     }
-    const int rowCount = qMin(m_model ? m_model->rowCount(m_rootIndex) : 0, m_xResolution);
     Q_ASSERT(start >= 0 && start <= m_data.size());
-    m_data.insert(start, end - start + 1, QVector<DataPoint>(rowCount));
+    m_data.insert(start, end - start + 1, QVector<DataPoint>(cacheRowCount()));
+    m_bounds.clear();
 }
 
 void CartesianDiagramDataCompressor::slotColumnsInserted(const QModelIndex &parent, int start, int end)
 {
+    if (parent == m_rootIndex) {
+        clearPyramids();
+    }
+    if (parent == m_rootIndex && (picksSamples(m_mode) || isStreaming())) {
+        rebuildCache();
+        return;
+    }
     if (!prepareDataChange(parent, false, &start, &end)) {
         return;
     }
@@ -162,6 +224,20 @@ void CartesianDiagramDataCompressor::slotRowsRemoved(const QModelIndex &parent,
     Q_ASSERT(start <= end);
     Q_UNUSED(end)
 
+    clearPyramids();
+    if (isStreaming()) {
+        if (start == 0 && streamBucketSize() == m_streamBucketSize) {
+            removeStreamRows(end - start + 1);
+        } else {
+            rebuildCache();
+        }
+        return;
+    }
+    if (picksSamples(m_mode)) {
+        rebuildCache();
+        return;
+    }
+
     CachePosition startPos = mapToCache(start, 0);
     static const CachePosition nullPosition;
     if (startPos == nullPosition) {
@@ -175,6 +251,7 @@ void CartesianDiagramDataCompressor::slotRowsRemoved(const QModelIndex &parent,
             retrieveModelData(CachePosition(j, i));
         }
     }
+    resizeBounds(startPos.row);
 }
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
@@ -183,6 +260,7 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved(const QModelInd
         return;
     }
     m_data.remove(start, end - start + 1);
+    m_bounds.clear();
 }
 
 void CartesianDiagramDataCompressor::slotColumnsRemoved(const QModelIndex &parent, int start, int end)
@@ -192,6 +270,12 @@ void CartesianDiagramDataCompressor::slotColumnsRemoved(const QModelIndex &paren
     Q_ASSERT(start <= end);
     Q_UNUSED(end);
 
+    clearPyramids();
+    if (picksSamples(m_mode) || isStreaming()) {
+        rebuildCache();
+        return;
+    }
+
     const CachePosition startPos = mapToCache(0, start);
 
     static const CachePosition nullPosition;
@@ -230,8 +314,17 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
     Q_ASSERT(topLeftIndex.parent() == bottomRightIndex.parent());
     Q_ASSERT(topLeftIndex.row() <= bottomRightIndex.row());
     Q_ASSERT(topLeftIndex.column() <= bottomRightIndex.column());
+    if (m_datasetDimension == 1) {
+        for (int column = topLeftIndex.column(); column <= bottomRightIndex.column() && column < m_pyramids.size(); ++column) {
+            m_pyramids[column].update(valueReader(m_modelCache, column), topLeftIndex.row(), bottomRightIndex.row());
+        }
+    }
     CachePosition topleft = mapToCache(topLeftIndex);
     CachePosition bottomright = mapToCache(bottomRightIndex);
+    if (m_mode == LargestTriangleThreeBuckets && isDecimating()) {
+        // invalidate() drops the whole column anyway
+        bottomright.row = topleft.row;
+    }
     for (int row = topleft.row; row <= bottomright.row; ++row)
         for (int column = topleft.column; column <= bottomright.column; ++column)
             invalidate(CachePosition(row, column));
@@ -239,6 +332,7 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
 
 void CartesianDiagramDataCompressor::slotModelLayoutChanged()
 {
+    clearPyramids();
     rebuildCache();
     calculateSampleStepWidth();
 }
@@ -306,7 +400,7 @@ void CartesianDiagramDataCompressor::setModel(QAbstractItemModel *model)
         disconnect(m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex, int, int)),
                    this, SLOT(slotColumnsAboutToBeRemoved(QModelIndex, int, int)));
         disconnect(m_model, SIGNAL(modelReset()),
-                   this, SLOT(rebuildCache()));
+                   this, SLOT(slotModelReset()));
         m_model = nullptr;
     }
 
@@ -336,8 +430,9 @@ void CartesianDiagramDataCompressor::setModel(QAbstractItemModel *model)
                 SLOT(slotColumnsRemoved(QModelIndex, int, int)));
         connect(m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex, int, int)),
                 SLOT(slotColumnsAboutToBeRemoved(QModelIndex, int, int)));
-        connect(m_model, SIGNAL(modelReset()), SLOT(rebuildCache()));
+        connect(m_model, SIGNAL(modelReset()), SLOT(slotModelReset()));
     }
+    clearPyramids();
     rebuildCache();
     calculateSampleStepWidth();
 }
@@ -348,11 +443,26 @@ void CartesianDiagramDataCompressor::setRootIndex(const QModelIndex &root)
         Q_ASSERT(root.model() == m_model || !root.isValid());
         m_rootIndex = root;
         m_modelCache.setRootIndex(root);
+        clearPyramids();
+        rebuildCache();
+        calculateSampleStepWidth();
+    }
+}
+
+void CartesianDiagramDataCompressor::setApproximationMode(ApproximationMode mode)
+{
+    if (mode != m_mode) {
+        m_mode = mode;
         rebuildCache();
         calculateSampleStepWidth();
     }
 }
 
+CartesianDiagramDataCompressor::ApproximationMode CartesianDiagramDataCompressor::approximationMode() const
+{
+    return m_mode;
+}
+
 void CartesianDiagramDataCompressor::recalcResolution()
 {
     setResolution(m_xResolution, m_yResolution);
@@ -382,10 +492,17 @@ bool CartesianDiagramDataCompressor::setResolutionInternal(int x, int y)
     return m_xResolution != oldXRes || m_yResolution != oldYRes;
 }
 
+void CartesianDiagramDataCompressor::slotModelReset()
+{
+    clearPyramids();
+    rebuildCache();
+}
+
 void CartesianDiagramDataCompressor::clearCache()
 {
     for (int column = 0; column < m_data.size(); ++column)
         m_data[column].fill(DataPoint());
+    m_bounds.clear();
 }
 
 void CartesianDiagramDataCompressor::rebuildCache()
@@ -393,10 +510,18 @@ void CartesianDiagramDataCompressor::rebuildCache()
     Q_ASSERT(m_datasetDimension != 0);
 
     m_data.clear();
+    m_bounds.clear();
+    m_columnarSource = m_rootIndex.isValid() ? nullptr : ColumnarDataSource::fromModel(m_model);
+    m_streamingModel = m_rootIndex.isValid() ? nullptr : StreamingModel::fromModel(m_model);
     setResolutionInternal(m_xResolution, m_yResolution);
+    m_streamBucketSize = 0;
+    if (m_streamingModel && m_mode == Precise && m_datasetDimension == 1 && m_xResolution > 0) {
+        m_streamBucketSize = streamBucketSize();
+        m_streamFirstBucket = m_streamingModel->evictedSampleCount() / m_streamBucketSize;
+    }
     const int columnDivisor = m_datasetDimension == 2 ? 2 : 1;
     const int columnCount = m_model ? m_model->columnCount(m_rootIndex) / columnDivisor : 0;
-    const int rowCount = qMin(m_model ? m_model->rowCount(m_rootIndex) : 0, m_xResolution);
+    const int rowCount = cacheRowCount();
     m_data.resize(columnCount);
     for (int i = 0; i < columnCount; ++i) {
         m_data[i].resize(rowCount);
@@ -418,42 +543,63 @@ const CartesianDiagramDataCompressor::DataPoint &CartesianDiagramDataCompressor:
 }
 
 QPair<QPointF, QPointF> CartesianDiagramDataCompressor::dataBoundaries() const
+{
+    const CartesianDiagramDataBounds::Box box = dataBoundingBox();
+    if (box.count == 0) {
+        const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+        return qMakePair(QPointF(nan, nan), QPointF(nan, nan));
+    }
+    return qMakePair(QPointF(box.xMin, box.yMin), QPointF(box.xMax, box.yMax));
+}
+
+CartesianDiagramDataBounds::Box CartesianDiagramDataCompressor::dataBoundingBox() const
 {
     const int colCount = modelDataColumns();
-    qreal xMin = std::numeric_limits<qreal>::quiet_NaN();
-    qreal xMax = std::numeric_limits<qreal>::quiet_NaN();
-    qreal yMin = std::numeric_limits<qreal>::quiet_NaN();
-    qreal yMax = std::numeric_limits<qreal>::quiet_NaN();
+    m_bounds.resize(colCount);
 
+    CartesianDiagramDataBounds::Box result;
     for (int column = 0; column < colCount; ++column) {
-        const DataPointVector &data = m_data[column];
-        int row = 0;
-        for (DataPointVector::const_iterator it = data.begin(); it != data.end(); ++it, ++row) {
-            const DataPoint &p = *it;
-            if (!p.index.isValid())
-                retrieveModelData(CachePosition(row, column));
-
-            if (ISNAN(p.key) || ISNAN(p.value)) {
-                continue;
-            }
+        CartesianDiagramDataBounds &bounds = m_bounds[column];
+        const int rowCount = m_data[column].size();
+        if (bounds.isEmpty() || bounds.rowCount() != rowCount) {
+            bounds.build(rowCount);
+        }
+        result.add(bounds.bounds([this, column](int row) {
+            const DataPoint &point = data(CachePosition(row, column));
+            return QPointF(point.key, point.value);
+        }));
+    }
+    return result;
+}
 
-            if (ISNAN(xMin)) {
-                xMin = p.key;
-                xMax = p.key;
-                yMin = p.value;
-                yMax = p.value;
-            } else {
-                xMin = qMin(xMin, p.key);
-                xMax = qMax(xMax, p.key);
-                yMin = qMin(yMin, p.value);
-                yMax = qMax(yMax, p.value);
-            }
+void CartesianDiagramDataCompressor::resizeBounds(int firstRow)
+{
+    if (m_bounds.size() != m_data.size()) {
+        m_bounds.clear();
+        return;
+    }
+    for (int column = 0; column < m_bounds.size(); ++column) {
+        CartesianDiagramDataBounds &bounds = m_bounds[column];
+        if (!bounds.isEmpty()) {
+            bounds.resize(m_data[column].size());
+            bounds.markChanged(firstRow, m_data[column].size() - 1);
         }
     }
+}
 
-    const QPointF bottomLeft(xMin, yMin);
-    const QPointF topRight(xMax, yMax);
-    return qMakePair(bottomLeft, topRight);
+QPair<int, int> CartesianDiagramDataCompressor::rowRange(qreal minKey, qreal maxKey) const
+{
+    const int rowCount = modelDataRows();
+    // the keys are model rows only for one-dimensional datasets
+    if (m_datasetDimension != 1 || rowCount == 0 || ISNAN(minKey) || ISNAN(maxKey)) {
+        return qMakePair(0, rowCount);
+    }
+    const int lastModelRow = m_model->rowCount(m_rootIndex) - 1;
+    const int firstRow = int(qBound(qreal(0), floor(minKey), qreal(lastModelRow)));
+    const int lastRow = int(qBound(qreal(0), ceil(maxKey), qreal(lastModelRow)));
+    const int first = mapToCache(firstRow, 0).row - pointsPerBucket();
+    const int end = mapToCache(lastRow, 0).row + 2 * pointsPerBucket();
+    return qMakePair(qMax(0, first), qMin(rowCount, end));
 }
 
 void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &position) const
@@ -463,7 +609,28 @@ void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &posi
     result.hidden = true;
 
     switch (m_mode) {
+    case MinMaxPerPixel:
+    case LargestTriangleThreeBuckets:
+        if (isDecimating()) {
+            if (m_mode == MinMaxPerPixel) {
+                retrieveMinMaxData(position);
+            } else {
+                retrieveLargestTriangleData(position.column);
+            }
+            Q_ASSERT(isCached(position));
+            return;
+        }
+        // one model row per cache row, nothing to pick from
+        Q_FALLTHROUGH();
     case Precise: {
+        // the buckets of a stream are too small for the pyramid to pay off
+        if (m_datasetDimension == 1 && !isStreaming() && retrievePyramidData(position, &result)) {
+            break;
+        }
+        if (m_columnarSource && retrieveColumnarData(position, &result)) {
+            break;
+        }
+
         const QModelIndexList indexes = mapToModel(position);
 
         if (m_datasetDimension == 2) {
@@ -494,6 +661,7 @@ void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &posi
             // the DataPoint point is visible if any of the underlying, aggregated points is visible
             if (m_model->data(index, DataHiddenRole).value<bool>() == false) {
                 result.hidden = false;
+                break;
             }
         }
         break;
@@ -506,6 +674,219 @@ void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &posi
     Q_ASSERT(isCached(position));
 }
 
+bool CartesianDiagramDataCompressor::retrieveColumnarData(const CachePosition &position, DataPoint *result) const
+{
+    // Same aggregation as the model based code path in retrieveModelData(), but reading
+    // the values from the arrays of the data source, without creating indexes or
+    // QVariants for each of them.
+    if (m_datasetDimension == 2) {
+        const double *keys = m_columnarSource->columnData(position.column * 2);
+        const double *values = m_columnarSource->columnData(position.column * 2 + 1);
+        if (!keys || !values) {
+            return false;
+        }
+        result->index = m_model->index(position.row, position.column * 2, m_rootIndex); // checked
+        result->key = keys[position.row];
+        result->value = values[position.row];
+        const QModelIndex valueIndex = m_model->index(position.row, position.column * 2 + 1, m_rootIndex); // checked
+        result->hidden = m_model->data(result->index, DataHiddenRole).value<bool>()
+            && m_model->data(valueIndex, DataHiddenRole).value<bool>();
+        return true;
+    }
+
+    const double *values = m_columnarSource->columnData(position.column);
+    if (!values) {
+        return false;
+    }
+    int baseRow;
+    int endRow;
+    bucketRows(position.row, &baseRow, &endRow);
+    if (baseRow >= endRow) {
+        return true;
+    }
+
+    qreal sum = std::numeric_limits<qreal>::quiet_NaN();
+    for (int row = baseRow; row < endRow; ++row) {
+        const qreal value = values[row];
+        if (!ISNAN(value)) {
+            sum = ISNAN(sum) ? value : sum + value;
+        }
+    }
+    const int count = endRow - baseRow;
+    result->key = (baseRow + endRow - 1) / 2.0;
+    result->value = sum / count;
+    result->index = m_model->index(baseRow, position.column, m_rootIndex); // checked
+
+    // the DataPoint is visible if any of the underlying, aggregated points is visible, so in
+    // the common case of nothing being hidden, only the first index needs to be looked at
+    for (int row = baseRow; row < endRow; ++row) {
+        const QModelIndex index = row == baseRow ? result->index : m_model->index(row, position.column, m_rootIndex); // checked
+        if (m_model->data(index, DataHiddenRole).value<bool>() == false) {
+            result->hidden = false;
+            break;
+        }
+    }
+    return true;
+}
+
+bool CartesianDiagramDataCompressor::retrievePyramidData(const CachePosition &position, DataPoint *result) const
+{
+    int baseRow;
+    int endRow;
+    bucketRows(position.row, &baseRow, &endRow);
+    if (endRow - baseRow < 2 * CartesianDiagramDataPyramid::BlockSize) {
+        return false;
+    }
+
+    const CartesianDiagramDataPyramid::Aggregate aggregate =
+        pyramid(position.column).aggregate(valueReader(m_modelCache, position.column), baseRow, endRow);
+    // same as the model based code path: missing values count as zero for the average,
+    // only a bucket without any values is missing itself
+    result->key = (baseRow + endRow - 1) / 2.0;
+    result->value = aggregate.count > 0 ? aggregate.sum / (endRow - baseRow) : std::numeric_limits<qreal>::quiet_NaN();
+    result->index = m_model->index(baseRow, position.column, m_rootIndex); // checked
+
+    for (int row = baseRow; row < endRow; ++row) {
+        const QModelIndex index = row == baseRow ? result->index : m_model->index(row, position.column, m_rootIndex); // checked
+        if (m_model->data(index, DataHiddenRole).value<bool>() == false) {
+            result->hidden = false;
+            break;
+        }
+    }
+    return true;
+}
+
+const CartesianDiagramDataPyramid &CartesianDiagramDataCompressor::pyramid(int column) const
+{
+    if (m_pyramids.size() <= column) {
+        m_pyramids.resize(column + 1);
+    }
+    CartesianDiagramDataPyramid &pyramid = m_pyramids[column];
+    const int rowCount = m_model->rowCount(m_rootIndex);
+    if (pyramid.isEmpty() || pyramid.rowCount() != rowCount) {
+        pyramid.build(valueReader(m_modelCache, column), rowCount);
+    }
+    return pyramid;
+}
+
+void CartesianDiagramDataCompressor::clearPyramids()
+{
+    m_pyramids.clear();
+}
+
+CartesianDiagramDataCompressor::DataPoint CartesianDiagramDataCompressor::samplePoint(int row, int column) const
+{
+    DataPoint point;
+    point.index = m_model->index(row, column, m_rootIndex); // checked
+    point.key = row;
+    point.value = m_modelCache.data(row, column);
+    point.hidden = m_model->data(point.index, DataHiddenRole).value<bool>();
+    return point;
+}
+
+void CartesianDiagramDataCompressor::retrieveMinMaxData(const CachePosition &position) const
+{
+    const int firstSlot = position.row - position.row % 4;
+    int baseRow;
+    int endRow;
+    bucketRows(firstSlot, &baseRow, &endRow);
+    Q_ASSERT(baseRow < endRow);
+
+    CartesianDiagramDataPyramid::Aggregate extremes;
+    if (endRow - baseRow >= 2 * CartesianDiagramDataPyramid::BlockSize) {
+        extremes = pyramid(position.column).aggregate(valueReader(m_modelCache, position.column), baseRow, endRow);
+    } else {
+        for (int row = baseRow; row < endRow; ++row) {
+            extremes.add(row, m_modelCache.data(row, position.column));
+        }
+    }
+
+    // Drawing first -> extremes -> last in row order covers exactly the pixels that the
+    // line through all rows of the pixel column covers.
+    int rows[4] = {baseRow, extremes.minRow, extremes.maxRow, endRow - 1};
+    std::sort(rows, rows + 4);
+    int count = 0;
+    for (int row : rows) {
+        if (row != -1 && (count == 0 || rows[count - 1] != row)) {
+            rows[count++] = row;
+        }
+    }
+
+    DataPointVector &data = m_data[position.column];
+    for (int slot = 0; slot < 4; ++slot) {
+        if (slot < count) {
+            data[firstSlot + slot] = samplePoint(rows[slot], position.column);
+        } else {
+            // pad the pixel column with hidden copies of its last sample, they count as
+            // cached but are skipped by the painters
+            data[firstSlot + slot] = data[firstSlot + count - 1];
+            data[firstSlot + slot].hidden = true;
+        }
+    }
+}
+
+void CartesianDiagramDataCompressor::retrieveLargestTriangleData(int column) const
+{
+    DataPointVector &data = m_data[column];
+    const int pointCount = data.size();
+    const int modelRowCount = m_model->rowCount(m_rootIndex);
+
+    data[0] = samplePoint(0, column);
+    int selectedRow = 0;
+    for (int bucket = 1; bucket < pointCount - 1; ++bucket) {
+        int baseRow;
+        int endRow;
+        bucketRows(bucket, &baseRow, &endRow);
+        int nextBaseRow;
+        int nextEndRow;
+        bucketRows(bucket + 1, &nextBaseRow, &nextEndRow);
+
+        // the third corner of the triangles is the average of the next bucket
+        qreal nextKey = 0.0;
+        qreal nextValue = 0.0;
+        int nextCount = 0;
+        for (int row = nextBaseRow; row < nextEndRow; ++row) {
+            const qreal value = m_modelCache.data(row, column);
+            if (!ISNAN(value)) {
+                nextKey += row;
+                nextValue += value;
+                ++nextCount;
+            }
+        }
+        if (nextCount > 0) {
+            nextKey /= nextCount;
+            nextValue /= nextCount;
+        } else {
+            nextKey = (nextBaseRow + nextEndRow - 1) / 2.0;
+        }
+
+        const qreal selectedKey = selectedRow;
+        qreal selectedValue = m_modelCache.data(selectedRow, column);
+        if (ISNAN(selectedValue)) {
+            selectedValue = nextValue;
+        }
+
+        int bestRow = baseRow;
+        qreal bestArea = -1.0;
+        for (int row = baseRow; row < endRow; ++row) {
+            const qreal value = m_modelCache.data(row, column);
+            if (ISNAN(value)) {
+                continue;
+            }
+            // twice the triangle area, the factor does not matter for the comparison
+            const qreal area = qAbs((selectedKey - nextKey) * (value - selectedValue)
+                                    - (selectedKey - row) * (nextValue - selectedValue));
+            if (area > bestArea) {
+                bestArea = area;
+                bestRow = row;
+            }
+        }
+        data[bucket] = samplePoint(bestRow, column);
+        selectedRow = bestRow;
+    }
+    data[pointCount - 1] = samplePoint(modelRowCount - 1, column);
+}
+
 CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::mapToCache(
     const QModelIndex &index) const
 {
@@ -530,7 +911,30 @@ CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::ma
     if (indexesPerPixel() == 0) {
         return mapToCache(QModelIndex());
     }
-    return CachePosition(int(row / indexesPerPixel()), column / m_datasetDimension);
+    if (isStreaming()) {
+        const qint64 sample = m_streamingModel->evictedSampleCount() + row;
+        return CachePosition(int(sample / m_streamBucketSize - m_streamFirstBucket), column);
+    }
+    if (m_mode == LargestTriangleThreeBuckets && isDecimating()) {
+        // estimate the bucket, then step to the one whose rows contain the row
+        const int pointCount = m_data[0].size();
+        const int modelRowCount = m_model->rowCount(m_rootIndex);
+        int cacheRow = pointCount - 1;
+        if (row < modelRowCount - 1) {
+            cacheRow = row <= 0 ? 0 : qBound(1, 1 + int((row - 1) * qreal(pointCount - 2) / qreal(modelRowCount - 2)), pointCount - 2);
+            int baseRow;
+            int endRow;
+            bucketRows(cacheRow, &baseRow, &endRow);
+            while (row < baseRow && cacheRow > 0) {
+                bucketRows(--cacheRow, &baseRow, &endRow);
+            }
+            while (row >= endRow && cacheRow < pointCount - 1) {
+                bucketRows(++cacheRow, &baseRow, &endRow);
+            }
+        }
+        return CachePosition(cacheRow, column / m_datasetDimension);
+    }
+    return CachePosition(int(row / indexesPerPixel()) * pointsPerBucket(), column / m_datasetDimension);
 }
 
 QModelIndexList CartesianDiagramDataCompressor::mapToModel(const CachePosition &position) const
@@ -547,10 +951,9 @@ QModelIndexList CartesianDiagramDataCompressor::mapToModel(const CachePosition &
     } else {
         // here, indexes per column is usually but not always 1 (e.g. stock diagrams can have three
         // or four dimensions: High-Low-Close or Open-High-Low-Close)
-        const qreal ipp = indexesPerPixel();
-        const int baseRow = floor(position.row * ipp);
-        // the following line needs to work for the last row(s), too...
-        const int endRow = floor((position.row + 1) * ipp);
+        int baseRow;
+        int endRow;
+        bucketRows(position.row, &baseRow, &endRow);
         for (int row = baseRow; row < endRow; ++row) {
             Q_ASSERT(row < m_model->rowCount(m_rootIndex));
             const QModelIndex index = m_model->index(row, position.column, m_rootIndex);
@@ -567,7 +970,141 @@ qreal CartesianDiagramDataCompressor::indexesPerPixel() const
     if (!m_model || m_data.size() == 0 || m_data[0].size() == 0) {
         return 0;
     }
-    return qreal(m_model->rowCount(m_rootIndex)) / qreal(m_data[0].size());
+    if (isStreaming()) {
+        return m_streamBucketSize;
+    }
+    return qreal(m_model->rowCount(m_rootIndex)) / qreal(m_data[0].size() / pointsPerBucket());
+}
+
+int CartesianDiagramDataCompressor::cacheRowCount() const
+{
+    const int modelRowCount = m_model ? m_model->rowCount(m_rootIndex) : 0;
+    if (isStreaming()) {
+        if (modelRowCount == 0) {
+            return 0;
+        }
+        const qint64 lastSample = m_streamingModel->evictedSampleCount() + modelRowCount - 1;
+        return int(lastSample / m_streamBucketSize - m_streamFirstBucket + 1);
+    }
+    switch (m_mode) {
+    case MinMaxPerPixel:
+        // a pixel column never shows more than four distinct points of the line, so
+        // fewer rows than that are simply all kept
+        return modelRowCount > 4 * m_xResolution ? 4 * m_xResolution : modelRowCount;
+    case LargestTriangleThreeBuckets:
+        // at least the first and last row plus one bucket in between
+        return m_xResolution > 0 ? qMin(modelRowCount, qMax(3, 2 * m_xResolution)) : 0;
+    default:
+        return qMin(modelRowCount, m_xResolution);
+    }
+}
+
+bool CartesianDiagramDataCompressor::isDecimating() const
+{
+    return picksSamples(m_mode) && m_model && !m_data.isEmpty()
+        && m_data[0].size() > 0 && m_data[0].size() < m_model->rowCount(m_rootIndex);
+}
+
+int CartesianDiagramDataCompressor::pointsPerBucket() const
+{
+    return m_mode == MinMaxPerPixel && isDecimating() ? 4 : 1;
+}
+
+void CartesianDiagramDataCompressor::bucketRows(int cacheRow, int *baseRow, int *endRow) const
+{
+    if (isStreaming()) {
+        // the first and the last bucket may be cut off by the ends of the model
+        const qint64 evicted = m_streamingModel->evictedSampleCount();
+        const qint64 firstSample = (m_streamFirstBucket + cacheRow) * m_streamBucketSize;
+        *baseRow = int(qMax(qint64(0), firstSample - evicted));
+        *endRow = int(qMin(qint64(m_model->rowCount(m_rootIndex)), firstSample + m_streamBucketSize - evicted));
+        return;
+    }
+    if (m_mode == LargestTriangleThreeBuckets && isDecimating()) {
+        // the first and the last row are buckets of their own, the rows in between are
+        // spread evenly over the remaining buckets
+        const int pointCount = m_data[0].size();
+        const int modelRowCount = m_model->rowCount(m_rootIndex);
+        if (cacheRow == 0) {
+            *baseRow = 0;
+            *endRow = 1;
+        } else if (cacheRow == pointCount - 1) {
+            *baseRow = modelRowCount - 1;
+            *endRow = modelRowCount;
+        } else {
+            const qreal rowsPerBucket = qreal(modelRowCount - 2) / qreal(pointCount - 2);
+            *baseRow = 1 + int(floor((cacheRow - 1) * rowsPerBucket));
+            *endRow = 1 + int(floor(cacheRow * rowsPerBucket));
+        }
+        return;
+    }
+    const qreal ipp = indexesPerPixel();
+    const int bucket = cacheRow / pointsPerBucket();
+    *baseRow = floor(bucket * ipp);
+    // the following line needs to work for the last row(s), too...
+    *endRow = floor((bucket + 1) * ipp);
+}
+
+bool CartesianDiagramDataCompressor::isStreaming() const
+{
+    return m_streamBucketSize > 0 && m_model;
+}
+
+int CartesianDiagramDataCompressor::streamBucketSize() const
+{
+    // with a maximum history, the bucket size never changes; the rows that a stream
+    // briefly has in excess before removing the oldest ones do not count
+    const int maximumHistory = m_streamingModel->maximumHistory();
+    const int window = maximumHistory > 0 ? maximumHistory : m_model->rowCount(m_rootIndex);
+    int size = 1;
+    while (qint64(size) * m_xResolution < window) {
+        size *= 2;
+    }
+    return size;
+}
+
+void CartesianDiagramDataCompressor::appendStreamRows()
+{
+    const int cacheRows = cacheRowCount();
+    const int oldCacheRows = m_data.isEmpty() ? 0 : m_data.first().size();
+    for (int column = 0; column < m_data.size(); ++column) {
+        // the former last bucket may have received rows, the others are new
+        if (!m_data[column].isEmpty()) {
+            invalidate(CachePosition(m_data[column].size() - 1, column));
+        }
+        m_data[column].resize(cacheRows);
+    }
+    resizeBounds(oldCacheRows);
+}
+
+void CartesianDiagramDataCompressor::removeStreamRows(int removed)
+{
+    const qint64 firstBucket = m_streamingModel->evictedSampleCount() / m_streamBucketSize;
+    const int droppedBuckets = int(firstBucket - m_streamFirstBucket);
+    m_streamFirstBucket = firstBucket;
+
+    const int cacheRows = cacheRowCount();
+    for (int column = 0; column < m_data.size(); ++column) {
+        DataPointVector &data = m_data[column];
+        data.remove(0, qMin(droppedBuckets, data.size()));
+        data.resize(cacheRows);
+        if (data.isEmpty()) {
+            continue;
+        }
+        // the first bucket lost rows, the others only moved to lower rows
+        data[0] = DataPoint();
+        for (int row = 1; row < data.size(); ++row) {
+            DataPoint &point = data[row];
+            if (point.index.isValid()) {
+                point.key -= removed;
+                point.index = m_model->index(point.index.row() - removed, point.index.column(), m_rootIndex); // checked
+            }
+        }
+    }
+    // keyed by cache position, which changed for all of them
+    m_dataValueAttributesCache.clear();
+    // the stream keeps few buckets, reading them all again is cheap
+    m_bounds.clear();
 }
 
 bool CartesianDiagramDataCompressor::mapsToModelIndex(const CachePosition &position) const
@@ -578,11 +1115,27 @@ bool CartesianDiagramDataCompressor::mapsToModelIndex(const CachePosition &posit
 void CartesianDiagramDataCompressor::invalidate(const CachePosition &position)
 {
     if (mapsToModelIndex(position)) {
-        m_data[position.column][position.row] = DataPoint();
-        // Also invalidate the data value attributes at "position".
-        // Otherwise the user overwrites the attributes without us noticing
-        // it because we keep reading what's in the cache.
-        m_dataValueAttributesCache.remove(position);
+        // decimated rows are picked together: the four rows of a pixel column in
+        // MinMaxPerPixel mode, the whole column in LargestTriangleThreeBuckets mode
+        int firstRow = position.row;
+        int lastRow = position.row;
+        if (m_mode == LargestTriangleThreeBuckets && isDecimating()) {
+            firstRow = 0;
+            lastRow = m_data[position.column].size() - 1;
+        } else if (pointsPerBucket() > 1) {
+            firstRow = position.row - position.row % pointsPerBucket();
+            lastRow = firstRow + pointsPerBucket() - 1;
+        }
+        if (position.column < m_bounds.size()) {
+            m_bounds[position.column].markChanged(firstRow, lastRow);
+        }
+        for (int row = firstRow; row <= lastRow; ++row) {
+            m_data[position.column][row] = DataPoint();
+            // Also invalidate the data value attributes at "position".
+            // Otherwise the user overwrites the attributes without us noticing
+            // it because we keep reading what's in the cache.
+            m_dataValueAttributesCache.remove(CachePosition(row, position.column));
+        }
     }
 }
 
@@ -595,7 +1148,7 @@ bool CartesianDiagramDataCompressor::isCached(const CachePosition &position) con
 
 void CartesianDiagramDataCompressor::calculateSampleStepWidth()
 {
-    if (m_mode == Precise) {
+    if (m_mode != SamplingSeven) {
         m_sampleStep = 1;
         return;
     }
@@ -631,6 +1184,7 @@ void CartesianDiagramDataCompressor::setDatasetDimension(int dimension)
 {
     if (dimension != m_datasetDimension) {
         m_datasetDimension = dimension;
+        clearPyramids();
         rebuildCache();
         calculateSampleStepWidth();
     }
@@ -31,6 +31,8 @@
 #include <QVector>
 
 #include "KDChartDataValueAttributes.h"
+#include "KDChartCartesianDiagramDataBounds_p.h"
+#include "KDChartCartesianDiagramDataPyramid_p.h"
 #include "KDChartModelDataCache_p.h"
 
 #include "kdchart_export.h"
@@ -43,6 +45,8 @@ QT_END_NAMESPACE
 namespace KDChart {
 
 class AbstractDiagram;
+class AttributeSnapshot;
+class StreamingModel;
 
 // - transparently compress table model data if the diagram widget
 // size does not allow to display all data points in an acceptable way
@@ -115,7 +119,13 @@ public:
         // datapoints for a pixel
         Precise,
         // approximate by averaging out over prime number distances
-        SamplingSeven
+        SamplingSeven,
+        // keep the first, minimum, maximum and last value of each pixel
+        // column (M4), so that the line looks exactly like the full data
+        MinMaxPerPixel,
+        // keep the points spanning the largest triangles with their
+        // neighbors (Largest-Triangle-Three-Buckets)
+        LargestTriangleThreeBuckets
     };
 
     explicit CartesianDiagramDataCompressor(QObject *parent = nullptr);
@@ -126,6 +136,7 @@ public:
     void setResolution(int x, int y);
     void recalcResolution();
     void setApproximationMode(ApproximationMode mode);
+    ApproximationMode approximationMode() const;
     void setDatasetDimension(int dimension);
 
     // output: resulting model resolution, data points
@@ -135,9 +146,17 @@ public:
     const DataPoint &data(const CachePosition &) const;
 
     QPair<QPointF, QPointF> dataBoundaries() const;
+    // the bounding box of all data points, also counting the missing ones; only the
+    // rows that changed since the last call are read again
+    CartesianDiagramDataBounds::Box dataBoundingBox() const;
 
+    // the cache rows [first, second) holding the data points with keys in [minKey, maxKey],
+    // plus a row on either side for the lines leading into that range
+    QPair<int, int> rowRange(qreal minKey, qreal maxKey) const;
+
+    // the data value attributes of the rows at position, looked up in attributes
     AggregatedDataValueAttributes aggregatedAttrs(
-        const AbstractDiagram *diagram,
+        const AttributeSnapshot &attributes,
         const QModelIndex &index,
         const CachePosition &position) const;
 
@@ -159,6 +178,9 @@ private Q_SLOTS:
     // be catchable with this method:
     void slotDiagramLayoutChanged(AbstractDiagram *);
 
+    // the model was reset, nothing cached is valid anymore
+    void slotModelReset();
+
     // geometry has changed
     void rebuildCache();
     // reset all cached values, without changing the cache geometry
@@ -177,6 +199,27 @@ private:
     // Note: returns only valid model indices
     QModelIndexList mapToModel(const CachePosition &) const;
     qreal indexesPerPixel() const;
+    // number of cache rows needed for the model rows and the resolution
+    int cacheRowCount() const;
+    // true if the cache holds actual samples picked from more model rows
+    // (MinMaxPerPixel and LargestTriangleThreeBuckets modes)
+    bool isDecimating() const;
+    // number of cache rows per pixel column, 4 when decimating with MinMaxPerPixel
+    int pointsPerBucket() const;
+    // model rows [*baseRow, *endRow) represented by the cache row
+    void bucketRows(int cacheRow, int *baseRow, int *endRow) const;
+
+    // With a StreamingModel, the buckets are aligned to sample numbers counted from
+    // the first sample ever appended, not to model rows. Appending rows then only
+    // touches the last bucket, and removing rows from the start only drops buckets
+    // at the front; the other buckets stay valid.
+    bool isStreaming() const;
+    // rows per bucket for the current row count and resolution, a power of two
+    int streamBucketSize() const;
+    // update the cache after rows were appended at the end of the streaming model
+    void appendStreamRows();
+    // update the cache after the first @p removed rows of the streaming model were removed
+    void removeStreamRows(int removed);
 
     // common logic for slot{Rows,Columns}[AboutToBe]{Inserted,Removed}
     bool prepareDataChange(const QModelIndex &parent,
@@ -185,6 +228,26 @@ private:
 
     // retrieve data from the model, put it into the cache
     void retrieveModelData(const CachePosition &) const;
+    // retrieve values from the ColumnarDataSource, if any; returns false if
+    // the source does not provide arrays for the columns at the position
+    bool retrieveColumnarData(const CachePosition &, DataPoint *result) const;
+    // aggregate large buckets from the pyramid of the column; returns false if the
+    // bucket is too small for that to pay off
+    bool retrievePyramidData(const CachePosition &, DataPoint *result) const;
+    // the pyramid of a dataset, built on first use
+    const CartesianDiagramDataPyramid &pyramid(int column) const;
+    // drop all pyramids, they get rebuilt on demand
+    void clearPyramids();
+    // resize the bounds trees to the cache rows, with the rows from firstRow on changed
+    void resizeBounds(int firstRow);
+    // fill the cache rows of the pixel column at the position with its first,
+    // minimum, maximum and last sample
+    void retrieveMinMaxData(const CachePosition &) const;
+    // fill all cache rows of the column using Largest-Triangle-Three-Buckets,
+    // each selected point depends on the one selected before it
+    void retrieveLargestTriangleData(int column) const;
+    // the unaggregated data point of a model row
+    DataPoint samplePoint(int row, int column) const;
     // check if a data point is in the cache:
     bool isCached(const CachePosition &) const;
     // set sample step width according to settings:
@@ -192,6 +255,10 @@ private:
 
     QPointer<QAbstractItemModel> m_model;
     QModelIndex m_rootIndex;
+    const ColumnarDataSource *m_columnarSource = nullptr;
+    const StreamingModel *m_streamingModel = nullptr;
+    int m_streamBucketSize = 0; // 0 if not streaming
+    qint64 m_streamFirstBucket = 0; // bucket of cache row 0
 
     ApproximationMode m_mode = Precise;
     int m_xResolution = 0;
@@ -200,6 +267,10 @@ private:
 
     mutable QVector<DataPointVector> m_data; // one per dataset
     ModelDataCache<qreal, Qt::DisplayRole> m_modelCache;
+    // per dataset, kept across resolution changes
+    mutable QVector<CartesianDiagramDataPyramid> m_pyramids;
+    // per dataset, built on first use and dropped when the cache is rebuilt
+    mutable QVector<CartesianDiagramDataBounds> m_bounds;
     mutable DataValueAttributesCache m_dataValueAttributesCache;
     int m_datasetDimension = 1;
 };
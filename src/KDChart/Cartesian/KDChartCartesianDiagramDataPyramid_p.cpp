@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartCartesianDiagramDataPyramid_p.h"
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+void CartesianDiagramDataPyramid::Aggregate::add(int row, qreal value)
+{
+    if (ISNAN(value)) {
+        return;
+    }
+    if (minRow == -1 || value < min) {
+        min = value;
+        minRow = row;
+    }
+    if (maxRow == -1 || value > max) {
+        max = value;
+        maxRow = row;
+    }
+    sum += value;
+    ++count;
+}
+
+void CartesianDiagramDataPyramid::Aggregate::add(const Aggregate &other)
+{
+    if (other.count == 0) {
+        return;
+    }
+    if (minRow == -1 || other.min < min) {
+        min = other.min;
+        minRow = other.minRow;
+    }
+    if (maxRow == -1 || other.max > max) {
+        max = other.max;
+        maxRow = other.maxRow;
+    }
+    sum += other.sum;
+    count += other.count;
+}
+
+bool CartesianDiagramDataPyramid::isEmpty() const
+{
+    return m_levels.isEmpty();
+}
+
+int CartesianDiagramDataPyramid::rowCount() const
+{
+    return m_rowCount;
+}
+
+void CartesianDiagramDataPyramid::clear()
+{
+    m_rowCount = 0;
+    m_levels.clear();
+}
+
+void CartesianDiagramDataPyramid::build(const ValueReader &value, int rowCount)
+{
+    clear();
+    append(value, rowCount);
+}
+
+void CartesianDiagramDataPyramid::append(const ValueReader &value, int newRowCount)
+{
+    if (m_levels.isEmpty()) {
+        m_levels.resize(1);
+    }
+    if (newRowCount <= m_rowCount) {
+        return;
+    }
+    // the last block may have been incomplete, it gets read again
+    const int firstBlock = m_rowCount / BlockSize;
+    const int blockCount = (newRowCount + BlockSize - 1) / BlockSize;
+    m_rowCount = newRowCount;
+    m_levels[0].resize(blockCount);
+    for (int block = firstBlock; block < blockCount; ++block) {
+        m_levels[0][block] = readBlock(value, block);
+    }
+    updateLevels(firstBlock, blockCount);
+}
+
+void CartesianDiagramDataPyramid::update(const ValueReader &value, int firstRow, int lastRow)
+{
+    firstRow = qMax(0, firstRow);
+    lastRow = qMin(lastRow, m_rowCount - 1);
+    if (isEmpty() || firstRow > lastRow) {
+        return;
+    }
+    const int firstBlock = firstRow / BlockSize;
+    const int endBlock = lastRow / BlockSize + 1;
+    for (int block = firstBlock; block < endBlock; ++block) {
+        m_levels[0][block] = readBlock(value, block);
+    }
+    updateLevels(firstBlock, endBlock);
+}
+
+CartesianDiagramDataPyramid::Aggregate CartesianDiagramDataPyramid::aggregate(const ValueReader &value,
+                                                                              int baseRow, int endRow) const
+{
+    Aggregate result;
+    baseRow = qMax(0, baseRow);
+    endRow = qMin(endRow, m_rowCount);
+
+    // whole blocks in the range, the rows before and after them are read directly
+    const int firstBlock = (baseRow + BlockSize - 1) / BlockSize;
+    const int endBlock = endRow / BlockSize;
+    if (firstBlock >= endBlock) {
+        for (int row = baseRow; row < endRow; ++row) {
+            result.add(row, value(row));
+        }
+        return result;
+    }
+    for (int row = baseRow; row < firstBlock * BlockSize; ++row) {
+        result.add(row, value(row));
+    }
+    for (int row = endBlock * BlockSize; row < endRow; ++row) {
+        result.add(row, value(row));
+    }
+
+    // climb up the levels, taking the nodes at the range borders that are not covered
+    // by a node of the next level
+    int first = firstBlock;
+    int end = endBlock;
+    for (int level = 0; first < end; ++level) {
+        const QVector<Aggregate> &nodes = m_levels.at(level);
+        if (first & 1) {
+            result.add(nodes.at(first++));
+        }
+        if (end & 1) {
+            result.add(nodes.at(--end));
+        }
+        first /= 2;
+        end /= 2;
+    }
+    return result;
+}
+
+void CartesianDiagramDataPyramid::updateLevels(int firstBlock, int endBlock)
+{
+    int level = 0;
+    for (; m_levels.at(level).size() > 1; ++level) {
+        if (level + 1 == m_levels.size()) {
+            m_levels.resize(level + 2);
+        }
+        const QVector<Aggregate> &below = m_levels[level];
+        QVector<Aggregate> &above = m_levels[level + 1];
+        above.resize((below.size() + 1) / 2);
+        firstBlock /= 2;
+        endBlock = (endBlock + 1) / 2;
+        for (int node = firstBlock; node < endBlock; ++node) {
+            Aggregate aggregate = below.at(2 * node);
+            if (2 * node + 1 < below.size()) {
+                aggregate.add(below.at(2 * node + 1));
+            }
+            above[node] = aggregate;
+        }
+    }
+    m_levels.resize(level + 1);
+}
+
+CartesianDiagramDataPyramid::Aggregate CartesianDiagramDataPyramid::readBlock(const ValueReader &value, int block) const
+{
+    Aggregate result;
+    const int endRow = qMin((block + 1) * BlockSize, m_rowCount);
+    for (int row = block * BlockSize; row < endRow; ++row) {
+        result.add(row, value(row));
+    }
+    return result;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTCARTESIANDIAGRAMDATAPYRAMID_H
+#define KDCHARTCARTESIANDIAGRAMDATAPYRAMID_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <functional>
+
+#include <QVector>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+// - min/max/sum/count aggregates of one dataset over blocks of rows, the
+// blocks doubling in size from level to level
+// - lets the compressor aggregate any range of rows from O(log(rows)) blocks
+// plus the unaligned rows at both ends, so changing the resolution (zooming)
+// does not need to read all values of the model again
+// - independent of the resolution, it is only dropped when the model changes
+// in ways other than appending rows or changing values
+class KDCHART_EXPORT CartesianDiagramDataPyramid
+{
+public:
+    // reads the value of a row, NaN for missing values
+    typedef std::function<qreal(int row)> ValueReader;
+
+    class Aggregate
+    {
+    public:
+        void add(int row, qreal value);
+        void add(const Aggregate &other);
+
+        qreal min = 0.0;
+        qreal max = 0.0;
+        int minRow = -1; // -1 if all values are missing
+        int maxRow = -1;
+        qreal sum = 0.0;
+        int count = 0; // number of values that are not missing
+    };
+
+    // rows per block on the lowest level; shorter ranges are cheaper to read directly
+    static const int BlockSize = 32;
+
+    bool isEmpty() const;
+    int rowCount() const;
+    void clear();
+
+    // (re)builds the pyramid over rows [0, rowCount)
+    void build(const ValueReader &value, int rowCount);
+    // extends the pyramid by the rows [rowCount(), newRowCount), only reading those
+    // and the rows of the last, incomplete block
+    void append(const ValueReader &value, int newRowCount);
+    // re-reads the blocks containing rows [firstRow, lastRow] after their values changed
+    void update(const ValueReader &value, int firstRow, int lastRow);
+
+    // aggregate of the rows [baseRow, endRow)
+    Aggregate aggregate(const ValueReader &value, int baseRow, int endRow) const;
+
+private:
+    // recompute the nodes above level 0 that cover the blocks [firstBlock, endBlock)
+    void updateLevels(int firstBlock, int endBlock);
+    Aggregate readBlock(const ValueReader &value, int block) const;
+
+    int m_rowCount = 0;
+    QVector<QVector<Aggregate>> m_levels; // level 0: BlockSize rows per node
+};
+}
+
+#endif
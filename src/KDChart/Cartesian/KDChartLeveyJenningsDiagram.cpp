@@ -14,6 +14,7 @@
 #include "KDChartAbstractGrid.h"
 #include "KDChartChart.h"
 #include "KDChartPainterSaver_p.h"
+#include "KDChartSymbolCache_p.h"
 #include "KDChartTextAttributes.h"
 
 #include <QDateTime>
@@ -22,6 +23,8 @@
 #include <QSvgRenderer>
 #include <QVector>
 
+#include <limits>
+
 #include <KDABLibFakes>
 
 using namespace KDChart;
@@ -252,6 +255,8 @@ void LeveyJenningsDiagram::setExpectedMeanValue(float meanValue)
 
     d->expectedMeanValue = meanValue;
     d->setYAxisRange();
+    // the QC values are checked in units of the expected SD
+    d->recalculate();
     update();
 }
 
@@ -273,6 +278,8 @@ void LeveyJenningsDiagram::setExpectedStandardDeviation(float sd)
 
     d->expectedStandardDeviation = sd;
     d->setYAxisRange();
+    // the QC values are checked in units of the expected SD
+    d->recalculate();
     update();
 }
 
@@ -289,7 +296,9 @@ float LeveyJenningsDiagram::expectedStandardDeviation() const
  */
 float LeveyJenningsDiagram::calculatedMeanValue() const
 {
-    return d->calculatedMeanValue;
+    if (d->valueCount == 0)
+        return std::numeric_limits<float>::quiet_NaN();
+    return d->mean;
 }
 
 /**
@@ -297,18 +306,50 @@ float LeveyJenningsDiagram::calculatedMeanValue() const
  */
 float LeveyJenningsDiagram::calculatedStandardDeviation() const
 {
-    return d->calculatedStandardDeviation;
+    if (d->valueCount < 2)
+        return std::numeric_limits<float>::quiet_NaN();
+    return sqrt(d->squaredDeviations / (d->valueCount - 1));
+}
+
+/**
+ * Sets the Westgard control \a rules the QC values are checked against.
+ */
+void LeveyJenningsDiagram::setControlRules(ControlRules rules)
+{
+    if (d->controlRules == rules)
+        return;
+
+    d->controlRules = rules;
+    d->checkAllRows();
+    update();
+}
+
+/**
+ * Returns the Westgard control rules the QC values are checked against.
+ */
+LeveyJenningsDiagram::ControlRules LeveyJenningsDiagram::controlRules() const
+{
+    return d->controlRules;
+}
+
+/**
+ * Returns the control rules violated by the QC value in \a row, out of the
+ * ones set with setControlRules().
+ */
+LeveyJenningsDiagram::ControlRules LeveyJenningsDiagram::violatedControlRules(int row) const
+{
+    return ControlRules(d->violations.value(row));
 }
 
 void LeveyJenningsDiagram::setModel(QAbstractItemModel *model)
 {
     if (this->model() != nullptr) {
         disconnect(this->model(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)),
-                   this, SLOT(calculateMeanAndStandardDeviation()));
+                   this, SLOT(slotDataChanged(const QModelIndex &, const QModelIndex &)));
         disconnect(this->model(), SIGNAL(rowsInserted(const QModelIndex &, int, int)),
-                   this, SLOT(calculateMeanAndStandardDeviation()));
-        disconnect(this->model(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
-                   this, SLOT(calculateMeanAndStandardDeviation()));
+                   this, SLOT(slotRowsInserted(const QModelIndex &, int, int)));
+        disconnect(this->model(), SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+                   this, SLOT(slotRowsAboutToBeRemoved(const QModelIndex &, int, int)));
         disconnect(this->model(), SIGNAL(columnsInserted(const QModelIndex &, int, int)),
                    this, SLOT(calculateMeanAndStandardDeviation()));
         disconnect(this->model(), SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
@@ -317,15 +358,17 @@ void LeveyJenningsDiagram::setModel(QAbstractItemModel *model)
                    this, SLOT(calculateMeanAndStandardDeviation()));
         disconnect(this->model(), SIGNAL(layoutChanged()),
                    this, SLOT(calculateMeanAndStandardDeviation()));
+        disconnect(this->model(), SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                   this, SLOT(calculateMeanAndStandardDeviation()));
     }
     LineDiagram::setModel(model);
     if (this->model() != nullptr) {
         connect(this->model(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)),
-                this, SLOT(calculateMeanAndStandardDeviation()));
+                this, SLOT(slotDataChanged(const QModelIndex &, const QModelIndex &)));
         connect(this->model(), SIGNAL(rowsInserted(const QModelIndex &, int, int)),
-                this, SLOT(calculateMeanAndStandardDeviation()));
-        connect(this->model(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
-                this, SLOT(calculateMeanAndStandardDeviation()));
+                this, SLOT(slotRowsInserted(const QModelIndex &, int, int)));
+        connect(this->model(), SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+                this, SLOT(slotRowsAboutToBeRemoved(const QModelIndex &, int, int)));
         connect(this->model(), SIGNAL(columnsInserted(const QModelIndex &, int, int)),
                 this, SLOT(calculateMeanAndStandardDeviation()));
         connect(this->model(), SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
@@ -334,41 +377,95 @@ void LeveyJenningsDiagram::setModel(QAbstractItemModel *model)
                 this, SLOT(calculateMeanAndStandardDeviation()));
         connect(this->model(), SIGNAL(layoutChanged()),
                 this, SLOT(calculateMeanAndStandardDeviation()));
+        connect(this->model(), SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                this, SLOT(calculateMeanAndStandardDeviation()));
 
         calculateMeanAndStandardDeviation();
     }
 }
 
-// TODO: This is the 'easy' solution
-// evaluate whether this is enough or we need some better one or even boost here
 void LeveyJenningsDiagram::calculateMeanAndStandardDeviation() const
 {
-    QVector<qreal> values;
-    // first fetch all values
-    const QAbstractItemModel &m = *model();
-    const int rowCount = m.rowCount(rootIndex());
+    d->recalculate();
+}
 
-    for (int row = 0; row < rowCount; ++row) {
-        const QVariant var = m.data(m.index(row, 1, rootIndex()));
-        if (!var.isValid())
-            continue;
-        const qreal value = var.toReal();
-        if (ISNAN(value))
-            continue;
-        values << value;
+void LeveyJenningsDiagram::slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (topLeft.parent() != rootIndex())
+        return;
+    if (d->values.count() != model()->rowCount(rootIndex())) {
+        d->recalculate();
+        return;
+    }
+    // the QC values in column 1, and their expected means and SDs in columns 4 and 5
+    const bool valuesChanged = topLeft.column() <= 1 && bottomRight.column() >= 1;
+    const bool expectationsChanged = topLeft.column() <= 5 && bottomRight.column() >= 4;
+    if (!valuesChanged && !expectationsChanged)
+        return;
+
+    // values filled into rows appended before, as no row from there on was checked yet
+    const bool unchecked = bottomRight.row() == d->values.count() - 1 && d->lastCheckedRow < topLeft.row();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const qreal value = d->readValue(row);
+        d->removeValue(d->values[row]);
+        d->addValue(value);
+        d->values[row] = value;
+        d->zScores[row] = d->zScore(row, value);
+        if (unchecked)
+            d->checkRow(row);
+    }
+    if (!unchecked)
+        d->checkAllRows();
+}
+
+void LeveyJenningsDiagram::slotRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent != rootIndex())
+        return;
+    const int count = last - first + 1;
+    if (d->values.count() + count != model()->rowCount(rootIndex())) {
+        d->recalculate();
+        return;
     }
 
-    qreal sum = 0.0;
-    qreal sumSquares = 0.0;
-    Q_FOREACH (qreal value, values) {
-        sum += value;
-        sumSquares += value * value;
+    const bool appended = first == d->values.count();
+    const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+    d->values.insert(first, count, nan);
+    d->zScores.insert(first, count, nan);
+    d->violations.insert(first, count, 0);
+    for (int row = first; row <= last; ++row) {
+        const qreal value = d->readValue(row);
+        d->addValue(value);
+        d->values[row] = value;
+        d->zScores[row] = d->zScore(row, value);
     }
 
-    const int N = values.count();
+    // the rules only look back, so appended values are checked on their own
+    if (appended) {
+        for (int row = first; row <= last; ++row)
+            d->checkRow(row);
+    } else {
+        d->checkAllRows();
+    }
+}
 
-    d->calculatedMeanValue = sum / N;
-    d->calculatedStandardDeviation = sqrt((static_cast<qreal>(N) * sumSquares - sum * sum) / (N * (N - 1)));
+void LeveyJenningsDiagram::slotRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent != rootIndex())
+        return;
+    if (last >= d->values.count()) {
+        // recalculated when the rows are gone
+        QMetaObject::invokeMethod(this, "calculateMeanAndStandardDeviation", Qt::QueuedConnection);
+        return;
+    }
+
+    const int count = last - first + 1;
+    for (int row = first; row <= last; ++row)
+        d->removeValue(d->values[row]);
+    d->values.remove(first, count);
+    d->zScores.remove(first, count);
+    d->violations.remove(first, count);
+    d->checkAllRows();
 }
 
 // calculates the largest QDate not greater than \a dt.
@@ -534,7 +631,7 @@ void LeveyJenningsDiagram::paint(PaintContext *ctx)
         QVariant vValue = m.data(valueIndex);
         qreal value = vValue.toReal();
         const int lot = m.data(lotIndex).toInt();
-        const bool ok = m.data(okIndex).toBool();
+        const bool ok = m.data(okIndex).toBool() && !d->violations.value(row);
         const QDateTime time = m.data(timeIndex).toDateTime();
         const qreal xValue = (time.toSecsSinceEpoch() - minTime) / static_cast<qreal>(24 * 60 * 60);
 
@@ -601,6 +698,20 @@ void LeveyJenningsDiagram::paint(PaintContext *ctx)
     ctx->setCoordinatePlane(plane);
 }
 
+// paints an SVG icon centered at the origin of painter, rendered only once per size if the
+// SymbolCache can be used
+static void drawIcon(QPainter *painter, QSvgRenderer *renderer, const QString &file, const QRectF &rect)
+{
+    SymbolCache::Private::Key key;
+    key.file = file;
+    key.size = rect.size();
+    const auto render = [renderer, &rect](QPainter *iconPainter) {
+        renderer->render(iconPainter, rect);
+    };
+    if (!SymbolCache::Private::instance()->drawSymbol(painter, QPointF(), key, 1.0, render))
+        render(painter);
+}
+
 /**
  * Draws a data point symbol for the data point at \a pos.
  * @param ok True, when the data point is ok, false otherwise (different symbol)
@@ -616,7 +727,7 @@ void LeveyJenningsDiagram::drawDataPointSymbol(PaintContext *ctx, const QPointF
     painter->translate(transPos);
 
     painter->setClipping(false);
-    iconRenderer(type)->render(painter, iconRect());
+    drawIcon(painter, iconRenderer(type), symbol(type), iconRect());
 }
 
 /**
@@ -633,7 +744,7 @@ void LeveyJenningsDiagram::drawLotChangeSymbol(PaintContext *ctx, const QPointF
     const PainterSaver ps(painter);
     painter->setClipping(false);
     painter->translate(transPos);
-    iconRenderer(LotChanged)->render(painter, iconRect());
+    drawIcon(painter, iconRenderer(LotChanged), symbol(LotChanged), iconRect());
 }
 
 /**
@@ -650,7 +761,7 @@ void LeveyJenningsDiagram::drawSensorChangedSymbol(PaintContext *ctx, const QPoi
     const PainterSaver ps(painter);
     painter->setClipping(false);
     painter->translate(transPos);
-    iconRenderer(SensorChanged)->render(painter, iconRect());
+    drawIcon(painter, iconRenderer(SensorChanged), symbol(SensorChanged), iconRect());
 }
 
 /**
@@ -667,7 +778,7 @@ void LeveyJenningsDiagram::drawFluidicsPackChangedSymbol(PaintContext *ctx, cons
     const PainterSaver ps(painter);
     painter->setClipping(false);
     painter->translate(transPos);
-    iconRenderer(FluidicsPackChanged)->render(painter, iconRect());
+    drawIcon(painter, iconRenderer(FluidicsPackChanged), symbol(FluidicsPackChanged), iconRect());
 }
 
 /**
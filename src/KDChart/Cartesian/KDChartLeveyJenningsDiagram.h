@@ -53,6 +53,22 @@ public:
         FluidicsPackChanged
     };
 
+    /**
+     * The Westgard rules a QC value can violate. The values are scaled to the
+     * expected mean value and standard deviation (SD) of their row, or of the
+     * diagram if the row has none.
+     */
+    enum ControlRule
+    {
+        NoControlRule = 0,
+        Rule1_3s = 0x1, ///< The value is more than 3 SD from the mean
+        Rule2_2s = 0x2, ///< The value and the previous one are more than 2 SD from the mean on the same side
+        RuleR_4s = 0x4, ///< The value and the previous one are more than 2 SD from the mean on opposite sides
+        Rule10x = 0x8, ///< The value and the previous nine ones are on the same side of the mean
+        AllControlRules = Rule1_3s | Rule2_2s | RuleR_4s | Rule10x
+    };
+    Q_DECLARE_FLAGS(ControlRules, ControlRule)
+
     /**
      * Returns true if both diagrams have the same settings.
      */
@@ -76,6 +92,19 @@ public:
     float calculatedMeanValue() const;
     float calculatedStandardDeviation() const;
 
+    /**
+     * Sets the Westgard rules to check the QC values against. Values violating any of
+     * them are painted with the NotOkDataPoint symbol, like values marked as not ok
+     * by the model. No rules are checked by default.
+     */
+    void setControlRules(ControlRules rules);
+    ControlRules controlRules() const;
+
+    /**
+     * Returns the control rules violated by the QC value in \a row.
+     */
+    ControlRules violatedControlRules(int row) const;
+
     void setFluidicsPackChanges(const QVector<QDateTime> &changes);
     QVector<QDateTime> fluidicsPackChanges() const;
 
@@ -112,7 +141,14 @@ protected:
 
 protected Q_SLOTS:
     void calculateMeanAndStandardDeviation() const;
+
+private Q_SLOTS:
+    void slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void slotRowsInserted(const QModelIndex &parent, int first, int last);
+    void slotRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
 }; // End of class KDChartLineDiagram
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(LeveyJenningsDiagram::ControlRules)
 }
 
 #endif // KDCHARTLINEDIAGRAM_H
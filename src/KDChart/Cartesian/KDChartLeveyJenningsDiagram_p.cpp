@@ -13,6 +13,10 @@
 
 #include "KDChartLeveyJenningsDiagram_p.h"
 
+#include <QAbstractItemModel>
+
+#include <limits>
+
 using namespace KDChart;
 
 LeveyJenningsDiagram::Private::Private(const Private &rhs)
@@ -26,6 +30,16 @@ LeveyJenningsDiagram::Private::Private(const Private &rhs)
     , icons(rhs.icons)
     , expectedMeanValue(rhs.expectedMeanValue)
     , expectedStandardDeviation(rhs.expectedStandardDeviation)
+    , values(rhs.values)
+    , valueCount(rhs.valueCount)
+    , mean(rhs.mean)
+    , squaredDeviations(rhs.squaredDeviations)
+    , controlRules(rhs.controlRules)
+    , zScores(rhs.zScores)
+    , violations(rhs.violations)
+    , lastCheckedRow(rhs.lastCheckedRow)
+    , runLength(rhs.runLength)
+    , runSide(rhs.runSide)
 {
 }
 
@@ -38,3 +52,137 @@ void LeveyJenningsDiagram::Private::setYAxisRange() const
     plane->setVerticalRange(QPair<qreal, qreal>(expectedMeanValue - 4 * expectedStandardDeviation,
                                                 expectedMeanValue + 4 * expectedStandardDeviation));
 }
+
+qreal LeveyJenningsDiagram::Private::readValue(int row) const
+{
+    const QAbstractItemModel *const m = diagram->model();
+    const QVariant var = m->data(m->index(row, 1, diagram->rootIndex()));
+    if (!var.isValid())
+        return std::numeric_limits<qreal>::quiet_NaN();
+    return var.toReal();
+}
+
+qreal LeveyJenningsDiagram::Private::zScore(int row, qreal value) const
+{
+    if (ISNAN(value))
+        return value;
+
+    // like paint(), which scales values having an expected mean and SD of their own
+    qreal expectedMean = expectedMeanValue;
+    qreal expectedSD = expectedStandardDeviation;
+    const QAbstractItemModel *const m = diagram->model();
+    const QVariant vExpectedMean = m->data(m->index(row, 4, diagram->rootIndex()));
+    const QVariant vExpectedSD = m->data(m->index(row, 5, diagram->rootIndex()));
+    if (!vExpectedMean.isNull() && !vExpectedSD.isNull()) {
+        expectedMean = vExpectedMean.toReal();
+        expectedSD = vExpectedSD.toReal();
+    }
+    if (!(expectedSD > 0.0))
+        return std::numeric_limits<qreal>::quiet_NaN();
+    return (value - expectedMean) / expectedSD;
+}
+
+void LeveyJenningsDiagram::Private::addValue(qreal value) const
+{
+    if (ISNAN(value))
+        return;
+    ++valueCount;
+    const qreal delta = value - mean;
+    mean += delta / valueCount;
+    squaredDeviations += delta * (value - mean);
+}
+
+void LeveyJenningsDiagram::Private::removeValue(qreal value) const
+{
+    if (ISNAN(value))
+        return;
+    if (valueCount <= 1) {
+        valueCount = 0;
+        mean = 0.0;
+        squaredDeviations = 0.0;
+        return;
+    }
+    --valueCount;
+    const qreal oldMean = mean;
+    mean -= (value - mean) / valueCount;
+    squaredDeviations = qMax(qreal(0.0), squaredDeviations - (value - oldMean) * (value - mean));
+}
+
+void LeveyJenningsDiagram::Private::recalculate() const
+{
+    values.clear();
+    zScores.clear();
+    valueCount = 0;
+    mean = 0.0;
+    squaredDeviations = 0.0;
+
+    if (diagram->model() != nullptr) {
+        const int rowCount = diagram->model()->rowCount(diagram->rootIndex());
+        values.reserve(rowCount);
+        zScores.reserve(rowCount);
+        for (int row = 0; row < rowCount; ++row) {
+            const qreal value = readValue(row);
+            values << value;
+            zScores << zScore(row, value);
+            addValue(value);
+        }
+    }
+    checkAllRows();
+}
+
+void LeveyJenningsDiagram::Private::checkRow(int row) const
+{
+    violations[row] = 0;
+    const qreal z = zScores[row];
+    if (!controlRules || ISNAN(z))
+        return;
+
+    int rowViolations = 0;
+    if (qAbs(z) > 3.0)
+        rowViolations |= Rule1_3s;
+
+    if (lastCheckedRow >= 0) {
+        const qreal previous = zScores[lastCheckedRow];
+        int pairViolations = 0;
+        if ((z > 2.0 && previous > 2.0) || (z < -2.0 && previous < -2.0))
+            pairViolations |= Rule2_2s;
+        if ((z > 2.0 && previous < -2.0) || (z < -2.0 && previous > 2.0))
+            pairViolations |= RuleR_4s;
+        rowViolations |= pairViolations;
+        violations[lastCheckedRow] |= pairViolations & controlRules;
+    }
+
+    const int side = z > 0.0 ? 1 : (z < 0.0 ? -1 : 0);
+    if (side != 0 && side == runSide) {
+        ++runLength;
+    } else {
+        runSide = side;
+        runLength = side != 0 ? 1 : 0;
+    }
+    if (runLength >= 10) {
+        rowViolations |= Rule10x;
+        if (runLength == 10 && controlRules & Rule10x) {
+            // the nine values before are part of the violating run too
+            int flagged = 0;
+            for (int previous = row - 1; previous >= 0 && flagged < 9; --previous) {
+                if (!ISNAN(zScores[previous])) {
+                    violations[previous] |= Rule10x;
+                    ++flagged;
+                }
+            }
+        }
+    }
+
+    violations[row] = rowViolations & controlRules;
+    lastCheckedRow = row;
+}
+
+void LeveyJenningsDiagram::Private::checkAllRows() const
+{
+    violations.fill(0, zScores.count());
+    lastCheckedRow = -1;
+    runLength = 0;
+    runSide = 0;
+    for (int row = 0; row < zScores.count(); ++row)
+        checkRow(row);
+}
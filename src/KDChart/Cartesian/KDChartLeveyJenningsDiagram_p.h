@@ -23,6 +23,7 @@
 //
 
 #include <QDateTime>
+#include <QVector>
 
 #include "KDChartLineDiagram_p.h"
 #include "KDChartThreeDLineAttributes.h"
@@ -51,6 +52,19 @@ public:
 
     void setYAxisRange() const;
 
+    // reads the QC value of row, NaN if it is missing
+    qreal readValue(int row) const;
+    // the value in units of the expected SD from the expected mean, NaN if not known
+    qreal zScore(int row, qreal value) const;
+    // running mean and variance with Welford's method
+    void addValue(qreal value) const;
+    void removeValue(qreal value) const;
+    // reads all rows again and checks them against the control rules
+    void recalculate() const;
+    // checks row against the control rules, continuing from the rows checked before it
+    void checkRow(int row) const;
+    void checkAllRows() const;
+
     Qt::Alignment lotChangedPosition;
     Qt::Alignment fluidicsPackChangedPosition;
     Qt::Alignment sensorChangedPosition;
@@ -68,8 +82,19 @@ public:
     float expectedMeanValue;
     float expectedStandardDeviation;
 
-    mutable float calculatedMeanValue;
-    mutable float calculatedStandardDeviation;
+    // statistics of the QC values, kept up to date with the changes of the model
+    mutable QVector<qreal> values; // of each row, NaN if missing
+    mutable int valueCount = 0;
+    mutable qreal mean = 0.0;
+    mutable qreal squaredDeviations = 0.0; // sum of the squared deviations from the mean
+
+    LeveyJenningsDiagram::ControlRules controlRules;
+    mutable QVector<qreal> zScores; // of each row, NaN if not checked
+    mutable QVector<quint8> violations; // LeveyJenningsDiagram::ControlRules of each row
+    // the state of the rule checks after the last checked row
+    mutable int lastCheckedRow = -1;
+    mutable int runLength = 0; // of values on the same side of the mean
+    mutable int runSide = 0;
 };
 
 KDCHART_IMPL_DERIVED_DIAGRAM(LeveyJenningsDiagram, LineDiagram, LeveyJenningsCoordinatePlane)
@@ -72,6 +72,7 @@ LineDiagram *LineDiagram::clone() const
 {
     auto *newDiagram = new LineDiagram(new Private(*d));
     newDiagram->setType(type());
+    newDiagram->setDataReductionMode(dataReductionMode());
     return newDiagram;
 }
 
@@ -118,6 +119,8 @@ void LineDiagram::setType(const LineType type)
     // d->lineType = type;
     Q_ASSERT(d->implementor->type() == type);
 
+    d->updateApproximationMode(type != LineDiagram::Normal);
+
     // AbstractAxis settings - see AbstractDiagram and CartesianAxis
     setPercentMode(type == LineDiagram::Percent);
     setDataBoundariesDirty();
@@ -163,6 +166,24 @@ bool LineDiagram::reverseDatasetOrder() const
     return d->reverseDatasetOrder;
 }
 
+void LineDiagram::setDataReductionMode(KDChartEnums::DataReductionMode mode)
+{
+    if (d->dataReductionMode == mode) {
+        return;
+    }
+
+    d->dataReductionMode = mode;
+    d->updateApproximationMode(type() != LineDiagram::Normal);
+    // picked samples and averages have different extremes
+    setDataBoundariesDirty();
+    emit propertiesChanged();
+}
+
+KDChartEnums::DataReductionMode LineDiagram::dataReductionMode() const
+{
+    return d->dataReductionMode;
+}
+
 /**
  * Sets the global line attributes to \a la
  */
@@ -412,6 +433,7 @@ void LineDiagram::paint(PaintContext *ctx)
     ctx->setCoordinatePlane(plane->sharedAxisMasterPlane(ctx->painter()));
 
     // paint different line types Normal - Stacked - Percent - Default Normal
+    d->paintAttributes.reset(attributesModel());
     d->implementor->paint(ctx);
 
     ctx->setCoordinatePlane(plane);
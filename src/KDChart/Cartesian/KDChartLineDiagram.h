@@ -12,6 +12,7 @@
 #define KDCHARTLINEDIAGRAM_H
 
 #include "KDChartAbstractCartesianDiagram.h"
+#include "KDChartEnums.h"
 #include "KDChartLineAttributes.h"
 #include "KDChartValueTrackerAttributes.h"
 
@@ -111,6 +112,22 @@ public:
     void setLineTension(qreal tenson);
     qreal lineTension() const;
 
+    /**
+     * Sets how datasets with more values than the diagram is wide in pixels
+     * are condensed before painting. The default, KDChartEnums::DataReductionAverage,
+     * averages the values of each pixel column, which flattens short spikes.
+     * KDChartEnums::DataReductionMinMax keeps them while painting at most four
+     * points per pixel column.
+     *
+     * Only normal line diagrams use this setting, stacked and percent line
+     * diagrams always average.
+     *
+     * \sa KDChartEnums::DataReductionMode
+     */
+    void setDataReductionMode(KDChartEnums::DataReductionMode mode);
+    /** \see setDataReductionMode */
+    KDChartEnums::DataReductionMode dataReductionMode() const;
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0) && defined(Q_COMPILER_MANGLES_RETURN_TYPE)
     // implement AbstractCartesianDiagram
     /* reimp */
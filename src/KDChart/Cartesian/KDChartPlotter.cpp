@@ -407,6 +407,7 @@ void Plotter::paint(PaintContext *ctx)
     ctx->setCoordinatePlane(plane->sharedAxisMasterPlane(ctx->painter()));
 
     // paint different line types Normal - Stacked - Percent - Default Normal
+    d->paintAttributes.reset(attributesModel());
     d->implementor->paint(ctx);
 
     ctx->setCoordinatePlane(plane);
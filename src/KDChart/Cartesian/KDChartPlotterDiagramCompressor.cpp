@@ -379,6 +379,7 @@ void PlotterDiagramCompressor::Iterator::invalidate()
 PlotterDiagramCompressor::Private::Private(PlotterDiagramCompressor *parent)
     : m_parent(parent)
     , m_model(nullptr)
+    , m_columnarSource(nullptr)
     , m_mergeRadius(0.1)
     , m_maxSlopeRadius(0.1)
     , m_boundary(qMakePair(QPointF(std::numeric_limits<qreal>::quiet_NaN(), std::numeric_limits<qreal>::quiet_NaN()), QPointF(std::numeric_limits<qreal>::quiet_NaN(), std::numeric_limits<qreal>::quiet_NaN())))
@@ -391,6 +392,7 @@ PlotterDiagramCompressor::Private::Private(PlotterDiagramCompressor *parent)
 void PlotterDiagramCompressor::Private::setModelToZero()
 {
     m_model = nullptr;
+    m_columnarSource = nullptr;
 }
 
 inline bool inBoundary(const QPair<qreal, qreal> &bounds, qreal value)
@@ -712,6 +714,7 @@ void PlotterDiagramCompressor::Private::clearBuffer()
     m_bufferlist.resize(m_parent->datasetCount());
     m_accumulatedDistances.clear();
     m_accumulatedDistances.resize(m_parent->datasetCount());
+    m_columnarSource = ColumnarDataSource::fromModel(m_model);
     m_timeOfLastInvalidation = QDateTime::currentDateTime();
 }
 
@@ -752,6 +755,7 @@ void PlotterDiagramCompressor::setModel(QAbstractItemModel *model)
         d->m_model->disconnect(d);
     }
     d->m_model = model;
+    d->m_columnarSource = ColumnarDataSource::fromModel(model);
     if (d->m_model) {
         d->m_bufferlist.resize(datasetCount());
         d->m_accumulatedDistances.resize(datasetCount());
@@ -765,6 +769,17 @@ void PlotterDiagramCompressor::setModel(QAbstractItemModel *model)
 PlotterDiagramCompressor::DataPoint PlotterDiagramCompressor::data(const CachePosition &pos) const
 {
     DataPoint point;
+    if (d->m_columnarSource) {
+        const double *keys = d->m_columnarSource->columnData(pos.second * 2);
+        const double *values = d->m_columnarSource->columnData(pos.second * 2 + 1);
+        if (keys && values) {
+            point.key = keys[pos.first];
+            point.value = values[pos.first];
+            point.index = d->m_model->index(pos.first, pos.second * 2, QModelIndex());
+            return point;
+        }
+    }
+
     QModelIndexList indexes = d->mapToModel(pos);
     Q_ASSERT(indexes.count() == 2);
     QVariant yValue = d->m_model->data(indexes.last());
@@ -13,6 +13,8 @@
 
 #include "KDChartPlotterDiagramCompressor.h"
 
+#include "KDChartColumnarDataSource.h"
+
 #include <QtCore/QDateTime>
 #include <QtCore/QPointF>
 
@@ -32,6 +34,7 @@ public:
     bool inBoundaries(Qt::Orientation orient, const PlotterDiagramCompressor::DataPoint &dp) const;
     PlotterDiagramCompressor *m_parent;
     QAbstractItemModel *m_model;
+    const ColumnarDataSource *m_columnarSource;
     qreal m_mergeRadius;
     qreal m_maxSlopeRadius;
     QVector<QVector<DataPoint>> m_bufferlist;
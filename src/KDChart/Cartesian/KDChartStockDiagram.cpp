@@ -285,6 +285,7 @@ void StockDiagram::paint(PaintContext *context)
     d->reverseMapper.clear();
 
     PainterSaver painterSaver(context->painter());
+    d->paintAttributes.reset(attributesModel());
     const int rowCount = attributesModel()->rowCount(attributesModelRootIndex());
     const int divisor = (d->type == OpenHighLowClose || d->type == Candlestick) ? 4 : 3;
     const int colCount = attributesModel()->columnCount(attributesModelRootIndex()) / divisor;
@@ -355,18 +356,15 @@ qreal StockDiagram::threeDItemDepth(const QModelIndex &index) const
 const QPair<QPointF, QPointF> StockDiagram::calculateDataBoundaries() const
 {
     const int rowCount = attributesModel()->rowCount(attributesModelRootIndex());
-    const int colCount = attributesModel()->columnCount(attributesModelRootIndex());
     qreal xMin = 0.0;
     qreal xMax = rowCount;
     qreal yMin = 0.0;
     qreal yMax = 0.0;
-    for (int row = 0; row < rowCount; row++) {
-        for (int col = 0; col < colCount; col++) {
-            const CartesianDiagramDataCompressor::CachePosition pos(row, col);
-            const CartesianDiagramDataCompressor::DataPoint point = d->compressor.data(pos);
-            yMax = qMax(yMax, point.value);
-            yMin = qMin(yMin, point.value); // FIXME: Can stock charts really have negative values?
-        }
+    // only the values changed since the last call are read again
+    const CartesianDiagramDataBounds::Box box = d->compressor.dataBoundingBox();
+    if (box.count > 0) {
+        yMax = qMax(yMax, box.yMax);
+        yMin = qMin(yMin, box.yMin); // FIXME: Can stock charts really have negative values?
     }
     return QPair<QPointF, QPointF>(QPointF(xMin, yMin), QPointF(xMax, yMax));
 }
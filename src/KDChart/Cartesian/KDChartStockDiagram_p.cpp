@@ -12,6 +12,8 @@
 
 #include "KDChartPainterSaver_p.h"
 
+#include <QVarLengthArray>
+
 using namespace KDChart;
 
 class StockDiagram::Private::ThreeDPainter
@@ -224,15 +226,24 @@ StockDiagram::Private::~Private()
 }
 
 /**
- * Projects a point onto the coordinate plane
+ * Projects points onto the coordinate plane, all in one go
  *
- * @param context The context to paint the point in
- * @point The point to project onto the coordinate plane
- * @return The projected point
+ * @param context The context to paint the points in
+ * @param points The points to project onto the coordinate plane
+ * @param projected Receives the projected points
+ * @param count The number of points
  */
-QPointF StockDiagram::Private::projectPoint(PaintContext *context, const QPointF &point) const
+void StockDiagram::Private::projectPoints(PaintContext *context, const QPointF *points, QPointF *projected, int count) const
 {
-    return context->coordinatePlane()->translate(QPointF(point.x() + 0.5, point.y()));
+    Q_ASSERT(dynamic_cast<CartesianCoordinatePlane *>(context->coordinatePlane()));
+    const auto *plane = static_cast<CartesianCoordinatePlane *>(context->coordinatePlane());
+    QVarLengthArray<qreal, 8> xs(count);
+    QVarLengthArray<qreal, 8> ys(count);
+    for (int i = 0; i < count; ++i) {
+        xs[i] = points[i].x();
+        ys[i] = points[i].y();
+    }
+    plane->translate(xs.constData(), ys.constData(), projected, count);
 }
 
 /**
@@ -243,9 +254,16 @@ QPointF StockDiagram::Private::projectPoint(PaintContext *context, const QPointF
  */
 QRectF StockDiagram::Private::projectCandlestick(PaintContext *context, const QPointF &open, const QPointF &close, qreal width) const
 {
-    const QPointF leftHighPoint = context->coordinatePlane()->translate(QPointF(close.x() + 0.5 - width / 2.0, close.y()));
-    const QPointF rightLowPoint = context->coordinatePlane()->translate(QPointF(open.x() + 0.5 + width / 2.0, open.y()));
-    const QPointF rightHighPoint = context->coordinatePlane()->translate(QPointF(close.x() + 0.5 + width / 2.0, close.y()));
+    const QPointF points[] = {
+        QPointF(close.x() + 0.5 - width / 2.0, close.y()),
+        QPointF(open.x() + 0.5 + width / 2.0, open.y()),
+        QPointF(close.x() + 0.5 + width / 2.0, close.y())
+    };
+    QPointF projected[3];
+    projectPoints(context, points, projected, 3);
+    const QPointF &leftHighPoint = projected[0];
+    const QPointF &rightLowPoint = projected[1];
+    const QPointF &rightHighPoint = projected[2];
 
     return QRectF(leftHighPoint, QSizeF(rightHighPoint.x() - leftHighPoint.x(), rightLowPoint.y() - leftHighPoint.y()));
 }
@@ -263,12 +281,22 @@ void StockDiagram::Private::drawOHLCBar(int dataset, const CartesianDiagramDataC
     ThreeDBarAttributes threeDAttr = stockDiagram()->threeDBarAttributes(col);
     const qreal tickLength = attr.tickLength();
 
-    const QPointF leftOpenPoint(open.key + 0.5 - tickLength, open.value);
-    const QPointF rightOpenPoint(open.key + 0.5, open.value);
-    const QPointF highPoint(high.key + 0.5, high.value);
-    const QPointF lowPoint(low.key + 0.5, low.value);
-    const QPointF leftClosePoint(close.key + 0.5, close.value);
-    const QPointF rightClosePoint(close.key + 0.5 + tickLength, close.value);
+    const QPointF points[] = {
+        QPointF(open.key + 0.5 - tickLength, open.value),
+        QPointF(open.key + 0.5, open.value),
+        QPointF(high.key + 0.5, high.value),
+        QPointF(low.key + 0.5, low.value),
+        QPointF(close.key + 0.5, close.value),
+        QPointF(close.key + 0.5 + tickLength, close.value)
+    };
+    QPointF projected[6];
+    projectPoints(context, points, projected, 6);
+    const QPointF &leftOpenPoint = projected[0];
+    const QPointF &rightOpenPoint = projected[1];
+    const QPointF &highPoint = projected[2];
+    const QPointF &lowPoint = projected[3];
+    const QPointF &leftClosePoint = projected[4];
+    const QPointF &rightClosePoint = projected[5];
 
     bool reversedOrder = false;
     // If 3D mode is enabled, we have to make sure the z-order is right
@@ -367,10 +395,18 @@ void StockDiagram::Private::drawCandlestick(int /*dataset*/, const CartesianDiag
     StockBarAttributes attr = stockDiagram()->stockBarAttributes(col);
     ThreeDBarAttributes threeDAttr = stockDiagram()->threeDBarAttributes(col);
 
-    const QPointF lowPoint = projectPoint(context, QPointF(low.key, low.value));
-    const QPointF highPoint = projectPoint(context, QPointF(high.key, high.value));
-    const QLineF lowerLine = QLineF(lowPoint, projectPoint(context, bottomCandlestickPoint));
-    const QLineF upperLine = QLineF(projectPoint(context, topCandlestickPoint), highPoint);
+    const QPointF points[] = {
+        QPointF(low.key + 0.5, low.value),
+        QPointF(high.key + 0.5, high.value),
+        QPointF(bottomCandlestickPoint.x() + 0.5, bottomCandlestickPoint.y()),
+        QPointF(topCandlestickPoint.x() + 0.5, topCandlestickPoint.y())
+    };
+    QPointF projected[4];
+    projectPoints(context, points, projected, 4);
+    const QPointF &lowPoint = projected[0];
+    const QPointF &highPoint = projected[1];
+    const QLineF lowerLine = QLineF(lowPoint, projected[2]);
+    const QLineF upperLine = QLineF(projected[3], highPoint);
 
     // Convert the data point into coordinates on the coordinate plane
     QRectF candlestick = projectCandlestick(context, bottomCandlestickPoint,
@@ -447,8 +483,8 @@ void StockDiagram::Private::drawCandlestick(int /*dataset*/, const CartesianDiag
  * Draws a line connecting two points
  *
  * @param col The column of the diagram to paint the line in
- * @param point1 The first point
- * @param point2 The second point
+ * @param point1 The first point, already projected onto the coordinate plane
+ * @param point2 The second point, already projected onto the coordinate plane
  * @param context The context to draw the low-high line in
  */
 void StockDiagram::Private::drawLine(int dataset, int col, const QPointF &point1, const QPointF &point2, PaintContext *context)
@@ -463,9 +499,7 @@ void StockDiagram::Private::drawLine(int dataset, int col, const QPointF &point1
     const QBrush brush = diagram->brush(dataset);
     const ThreeDBarAttributes threeDBarAttr = stockDiagram()->threeDBarAttributes(col);
 
-    QPointF transP1 = context->coordinatePlane()->translate(point1);
-    QPointF transP2 = context->coordinatePlane()->translate(point2);
-    QLineF line = QLineF(transP1, transP2);
+    QLineF line = QLineF(point1, point2);
 
     if (threeDBarAttr.isEnabled()) {
         ThreeDPainter::ThreeDProperties threeDProps;
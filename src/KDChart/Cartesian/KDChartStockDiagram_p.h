@@ -63,7 +63,7 @@ public:
 
 private:
     void drawLine(int dataset, int col, const QPointF &point1, const QPointF &p2, PaintContext *context);
-    QPointF projectPoint(PaintContext *context, const QPointF &point) const;
+    void projectPoints(PaintContext *context, const QPointF *points, QPointF *projected, int count) const;
     QRectF projectCandlestick(PaintContext *context, const QPointF &open, const QPointF &close, qreal width) const;
     int openValueColumn() const;
     int highValueColumn() const;
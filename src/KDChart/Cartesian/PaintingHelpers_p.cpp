@@ -19,7 +19,6 @@
 #include "KDChartLineDiagram_p.h"
 #include "KDChartPaintContext.h"
 #include "KDChartPainterSaver_p.h"
-#include "KDChartPlotter.h"
 #include "KDChartPrintingParameters.h"
 #include "KDChartThreeDLineAttributes.h"
 #include "KDChartValueTrackerAttributes.h"
@@ -101,24 +100,24 @@ void paintSpline(PaintContext *ctx, const QBrush &brush, const QPen &pen, const
     ctx->painter()->drawPath(fitPoints(points, tension, splineDirection));
 }
 
-void paintThreeDLines(PaintContext *ctx, AbstractDiagram *diagram, const QModelIndex &index,
-                      const QPointF &from, const QPointF &to, const ThreeDLineAttributes &tdAttributes,
-                      ReverseMapper *reverseMapper)
+void paintThreeDLines(PaintContext *ctx, AbstractDiagram::Private *diagramPrivate, const QModelIndex &index,
+                      const QPointF &from, const QPointF &to, const ThreeDLineAttributes &tdAttributes)
 {
+    AbstractDiagram *diagram = diagramPrivate->diagram;
     const QPointF topLeft = project(from, tdAttributes);
     const QPointF topRight = project(to, tdAttributes);
     const QPolygonF segment = QPolygonF() << from << topLeft << topRight << to;
 
-    QBrush indexBrush(diagram->brush(index));
-    indexBrush = tdAttributes.threeDBrush(indexBrush, QRectF(topLeft, topRight));
+    const QBrush indexBrush = tdAttributes.threeDBrush(diagramPrivate->paintAttributes.brush(index),
+                                                       QRectF(topLeft, topRight));
 
     const PainterSaver painterSaver(ctx->painter());
 
     ctx->painter()->setRenderHint(QPainter::Antialiasing, diagram->antiAliasing());
     ctx->painter()->setBrush(indexBrush);
-    ctx->painter()->setPen(PrintingParameters::scalePen(diagram->pen(index)));
+    ctx->painter()->setPen(PrintingParameters::scalePen(diagramPrivate->paintAttributes.pen(index)));
 
-    reverseMapper->addPolygon(index.row(), index.column(), segment);
+    diagramPrivate->reverseMapper.addPolygon(index.row(), index.column(), segment);
     ctx->painter()->drawPolygon(segment);
 }
 
@@ -202,30 +201,6 @@ void paintValueTracker(PaintContext *ctx, const ValueTrackerAttributes &vt, cons
     ctx->painter()->drawPolygon(endMarker, 3);
 }
 
-// ### for BC reasons we cannot insert a common interface for LineDiagram and Plotter into the class
-//     hierarchy, so we have to use hacks to use their common methods
-static ThreeDLineAttributes threeDLineAttributes(AbstractDiagram *diagram, const QModelIndex &index)
-{
-    if (auto *plotter = qobject_cast<Plotter *>(diagram)) {
-        return plotter->threeDLineAttributes(index);
-    } else if (auto *lineDiagram = qobject_cast<LineDiagram *>(diagram)) {
-        return lineDiagram->threeDLineAttributes(index);
-    }
-    Q_ASSERT(false);
-    return ThreeDLineAttributes();
-}
-
-static ValueTrackerAttributes valueTrackerAttributes(AbstractDiagram *diagram, const QModelIndex &index)
-{
-    if (auto *plotter = qobject_cast<Plotter *>(diagram)) {
-        return plotter->valueTrackerAttributes(index);
-    } else if (auto *lineDiagram = qobject_cast<LineDiagram *>(diagram)) {
-        return lineDiagram->valueTrackerAttributes(index);
-    }
-    Q_ASSERT(false);
-    return ValueTrackerAttributes();
-}
-
 void paintObject(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, const QBrush &brush, const QPen &pen, const QPolygonF &points)
 {
     qreal tension = 0;
@@ -258,14 +233,14 @@ void paintElements(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx,
     QPolygonF points;
     Q_FOREACH (const LineAttributesInfo &lineInfo, lineList) {
         const QModelIndex &index = lineInfo.index;
-        const ThreeDLineAttributes td = threeDLineAttributes(diagram, index);
+        const ThreeDLineAttributes &td = diagramPrivate->paintAttributes.threeDLineAttributes(index);
 
         if (td.isEnabled()) {
-            PaintingHelpers::paintThreeDLines(ctx, diagram, index, lineInfo.value,
-                                              lineInfo.nextValue, td, &diagramPrivate->reverseMapper);
+            PaintingHelpers::paintThreeDLines(ctx, diagramPrivate, index, lineInfo.value,
+                                              lineInfo.nextValue, td);
         } else {
-            const QBrush brush(diagram->brush(index));
-            const QPen pen(diagram->pen(index));
+            const QBrush &brush = diagramPrivate->paintAttributes.brush(index);
+            const QPen &pen = diagramPrivate->paintAttributes.pen(index);
 
             // line goes from lineInfo.value to lineInfo.nextValue
             // We don't want it added if we're not drawing it, since the reverse mapper is used
@@ -296,7 +271,7 @@ void paintElements(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx,
     }
 
     Q_FOREACH (const LineAttributesInfo &lineInfo, lineList) {
-        const ValueTrackerAttributes vt = valueTrackerAttributes(diagram, lineInfo.index);
+        const ValueTrackerAttributes &vt = diagramPrivate->paintAttributes.valueTrackerAttributes(lineInfo.index);
         if (vt.isEnabled()) {
             PaintingHelpers::paintValueTracker(ctx, vt, lineInfo.nextValue);
         }
@@ -318,15 +293,15 @@ void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, con
         path.closeSubpath();
     }
 
-    ThreeDLineAttributes threeDAttrs = threeDLineAttributes(diagram, index);
-    QBrush trans = diagram->brush(index);
+    const ThreeDLineAttributes &threeDAttrs = diagramPrivate->paintAttributes.threeDLineAttributes(index);
+    QBrush trans = diagramPrivate->paintAttributes.brush(index);
     if (threeDAttrs.isEnabled()) {
         trans = threeDAttrs.threeDBrush(trans, path.boundingRect());
     }
     QColor transColor = trans.color();
     transColor.setAlpha(opacity);
     trans.setColor(transColor);
-    QPen indexPen = diagram->pen(index);
+    QPen indexPen = diagramPrivate->paintAttributes.pen(index);
     indexPen.setBrush(trans);
     const PainterSaver painterSaver(ctx->painter());
 
@@ -347,11 +322,11 @@ void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, con
         // diagramPrivate->reverseMapper.addPolygon( index.row(), index.column(), p );
     }
 
-    QBrush trans = diagram->brush(index);
+    QBrush trans = diagramPrivate->paintAttributes.brush(index);
     QColor transColor = trans.color();
     transColor.setAlpha(opacity);
     trans.setColor(transColor);
-    QPen indexPen = diagram->pen(index);
+    QPen indexPen = diagramPrivate->paintAttributes.pen(index);
     indexPen.setBrush(trans);
     const PainterSaver painterSaver(ctx->painter());
 
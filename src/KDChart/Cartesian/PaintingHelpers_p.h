@@ -40,9 +40,8 @@ inline bool isFinite(const QPointF &point)
 
 const QPointF project(const QPointF &point, const ThreeDLineAttributes &tdAttributes);
 void paintPolyline(PaintContext *ctx, const QBrush &brush, const QPen &pen, const QPolygonF &points);
-void paintThreeDLines(PaintContext *ctx, AbstractDiagram *diagram, const QModelIndex &index,
-                      const QPointF &from, const QPointF &to, const ThreeDLineAttributes &tdAttributes,
-                      ReverseMapper *reverseMapper);
+void paintThreeDLines(PaintContext *ctx, AbstractDiagram::Private *diagramPrivate, const QModelIndex &index,
+                      const QPointF &from, const QPointF &to, const ThreeDLineAttributes &tdAttributes);
 void paintValueTracker(PaintContext *ctx, const ValueTrackerAttributes &vt, const QPointF &at);
 void paintElements(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx,
                    const LabelPaintCache &lpc, const LineAttributesInfoList &lineList);
@@ -23,6 +23,7 @@
 #include "KDChartDataValueAttributes.h"
 #include "KDChartMarkerAttributes.h"
 #include "KDChartPainterSaver_p.h"
+#include "KDChartSymbolCache_p.h"
 #include "KDChartTextAttributes.h"
 #include "KDChartThreeDLineAttributes.h"
 
@@ -342,6 +343,16 @@ bool AbstractDiagram::antiAliasing() const
     return d->antiAliasing;
 }
 
+void AbstractDiagram::setReverseMappingEnabled(bool enabled)
+{
+    d->reverseMapper.setEnabled(enabled);
+}
+
+bool AbstractDiagram::isReverseMappingEnabled() const
+{
+    return d->reverseMapper.isEnabled();
+}
+
 void AbstractDiagram::setPercentMode(bool percent)
 {
     d->percent = percent;
@@ -426,6 +437,149 @@ void AbstractDiagram::paintMarker(QPainter *painter,
     paintMarker(painter, dataValueAttributes(index), index, pos);
 }
 
+// paints a marker centered at the origin of painter, pen is scaled for printing already
+static void paintMarkerShape(QPainter *painter, const MarkerAttributes &markerAttributes,
+                             const QBrush &brush, const QPen &pen, const QSizeF &maSize)
+{
+    painter->setPen(pen);
+    painter->setBrush(brush);
+    painter->setRenderHint(QPainter::Antialiasing);
+    switch (markerAttributes.markerStyle()) {
+    case MarkerAttributes::MarkerCircle: {
+        if (markerAttributes.threeD()) {
+            QRadialGradient grad;
+            grad.setCoordinateMode(QGradient::ObjectBoundingMode);
+            QColor drawColor = brush.color();
+            grad.setCenter(0.5, 0.5);
+            grad.setRadius(1.0);
+            grad.setFocalPoint(0.35, 0.35);
+            grad.setColorAt(0.00, drawColor.lighter(150));
+            grad.setColorAt(0.20, drawColor);
+            grad.setColorAt(0.50, drawColor.darker(150));
+            grad.setColorAt(0.75, drawColor.darker(200));
+            grad.setColorAt(0.95, drawColor.darker(250));
+            grad.setColorAt(1.00, drawColor.darker(200));
+            QBrush newBrush(grad);
+            newBrush.setTransform(brush.transform());
+            painter->setBrush(newBrush);
+        }
+        painter->drawEllipse(QRectF(0 - maSize.height() / 2, 0 - maSize.width() / 2,
+                                    maSize.height(), maSize.width()));
+    } break;
+    case MarkerAttributes::MarkerSquare: {
+        QRectF rect(0 - maSize.width() / 2, 0 - maSize.height() / 2,
+                    maSize.width(), maSize.height());
+        painter->drawRect(rect);
+        break;
+    }
+    case MarkerAttributes::MarkerDiamond: {
+        QVector<QPointF> diamondPoints;
+        QPointF top, left, bottom, right;
+        top = QPointF(0, 0 - maSize.height() / 2);
+        left = QPointF(0 - maSize.width() / 2, 0);
+        bottom = QPointF(0, maSize.height() / 2);
+        right = QPointF(maSize.width() / 2, 0);
+        diamondPoints << top << left << bottom << right;
+        painter->drawPolygon(diamondPoints);
+        break;
+    }
+    // both painted by AbstractDiagram::paintMarker() itself:
+    case MarkerAttributes::Marker1Pixel:
+    case MarkerAttributes::Marker4Pixels:
+        break;
+    case MarkerAttributes::MarkerRing: {
+        painter->setBrush(Qt::NoBrush);
+        painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
+        painter->drawEllipse(QRectF(0 - maSize.height() / 2, 0 - maSize.width() / 2,
+                                    maSize.height(), maSize.width()));
+        break;
+    }
+    case MarkerAttributes::MarkerCross: {
+        // Note: Markers can have outline,
+        //       so just drawing two rects is NOT the solution here!
+        const qreal w02 = maSize.width() * 0.2;
+        const qreal w05 = maSize.width() * 0.5;
+        const qreal h02 = maSize.height() * 0.2;
+        const qreal h05 = maSize.height() * 0.5;
+        QVector<QPointF> crossPoints;
+        QPointF p[12];
+        p[0] = QPointF(-w02, -h05);
+        p[1] = QPointF(w02, -h05);
+        p[2] = QPointF(w02, -h02);
+        p[3] = QPointF(w05, -h02);
+        p[4] = QPointF(w05, h02);
+        p[5] = QPointF(w02, h02);
+        p[6] = QPointF(w02, h05);
+        p[7] = QPointF(-w02, h05);
+        p[8] = QPointF(-w02, h02);
+        p[9] = QPointF(-w05, h02);
+        p[10] = QPointF(-w05, -h02);
+        p[11] = QPointF(-w02, -h02);
+        for (int i = 0; i < 12; ++i)
+            crossPoints << p[i];
+        crossPoints << p[0];
+        painter->drawPolygon(crossPoints);
+        break;
+    }
+    case MarkerAttributes::MarkerFastCross: {
+        QPointF left, right, top, bottom;
+        left = QPointF(-maSize.width() / 2, 0);
+        right = QPointF(maSize.width() / 2, 0);
+        top = QPointF(0, -maSize.height() / 2);
+        bottom = QPointF(0, maSize.height() / 2);
+        painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
+        painter->drawLine(left, right);
+        painter->drawLine(top, bottom);
+        break;
+    }
+    case MarkerAttributes::NoMarker:
+        break;
+    case MarkerAttributes::PainterPathMarker: {
+        QPainterPath path = markerAttributes.customMarkerPath();
+        const QRectF pathBoundingRect = path.boundingRect();
+        const qreal xScaling = maSize.height() / pathBoundingRect.height();
+        const qreal yScaling = maSize.width() / pathBoundingRect.width();
+        const qreal scaling = qMin(xScaling, yScaling);
+        painter->scale(scaling, scaling);
+        painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
+        painter->drawPath(path);
+        break;
+    }
+    default:
+        Q_ASSERT_X(false, "paintMarkers()",
+                   "Type item does not match a defined Marker Type.");
+    }
+}
+
+// Paints markers with solid colors as sprites of the SymbolCache, returns false without
+// painting for markers that are not cached or if the cache can not be used for painter.
+static bool paintCachedMarker(QPainter *painter, const MarkerAttributes &markerAttributes,
+                              const QBrush &brush, const QPen &pen, const QPointF &pos,
+                              const QSizeF &maSize)
+{
+    const uint style = markerAttributes.markerStyle();
+    // the key does not describe custom paths, dash patterns and transformed gradients
+    if (style > MarkerAttributes::MarkerFastCross || brush.style() != Qt::SolidPattern
+        || !brush.transform().isIdentity() || pen.style() == Qt::CustomDashLine
+        || (pen.style() != Qt::NoPen && pen.brush().style() != Qt::SolidPattern))
+        return false;
+
+    SymbolCache::Private::Key key;
+    key.markerStyle = style;
+    key.threeD = style == MarkerAttributes::MarkerCircle && markerAttributes.threeD();
+    key.brushColor = brush.color().rgba();
+    key.penColor = pen.color().rgba();
+    key.penWidth = pen.widthF();
+    key.penStyle = pen.style() | pen.capStyle() | pen.joinStyle() | (pen.isCosmetic() ? 0x10000 : 0);
+    key.outlineWidth = PrintingParameters::scalePen(QPen(brush.color())).widthF();
+    key.size = maSize;
+    // room for the pen, including miter joins, and for the antialiasing
+    const qreal margin = 2.0 * qMax(qMax(key.penWidth, key.outlineWidth), qreal(1.0)) + 1.0;
+    return SymbolCache::Private::instance()->drawSymbol(painter, pos, key, margin, [&](QPainter *spritePainter) {
+        paintMarkerShape(spritePainter, markerAttributes, brush, pen, maSize);
+    });
+}
+
 void AbstractDiagram::paintMarker(QPainter *painter,
                                   const MarkerAttributes &markerAttributes,
                                   const QBrush &brush,
@@ -452,116 +606,11 @@ void AbstractDiagram::paintMarker(QPainter *painter,
         }
         painter->drawPoint(pos);
     } else {
-        const PainterSaver painterSaver(painter);
-        QPen painterPen(pen);
-        painter->setPen(PrintingParameters::scalePen(painterPen));
-        painter->setBrush(brush);
-        painter->setRenderHint(QPainter::Antialiasing);
-        painter->translate(pos);
-        switch (markerAttributes.markerStyle()) {
-        case MarkerAttributes::MarkerCircle: {
-            if (markerAttributes.threeD()) {
-                QRadialGradient grad;
-                grad.setCoordinateMode(QGradient::ObjectBoundingMode);
-                QColor drawColor = brush.color();
-                grad.setCenter(0.5, 0.5);
-                grad.setRadius(1.0);
-                grad.setFocalPoint(0.35, 0.35);
-                grad.setColorAt(0.00, drawColor.lighter(150));
-                grad.setColorAt(0.20, drawColor);
-                grad.setColorAt(0.50, drawColor.darker(150));
-                grad.setColorAt(0.75, drawColor.darker(200));
-                grad.setColorAt(0.95, drawColor.darker(250));
-                grad.setColorAt(1.00, drawColor.darker(200));
-                QBrush newBrush(grad);
-                newBrush.setTransform(brush.transform());
-                painter->setBrush(newBrush);
-            }
-            painter->drawEllipse(QRectF(0 - maSize.height() / 2, 0 - maSize.width() / 2,
-                                        maSize.height(), maSize.width()));
-        } break;
-        case MarkerAttributes::MarkerSquare: {
-            QRectF rect(0 - maSize.width() / 2, 0 - maSize.height() / 2,
-                        maSize.width(), maSize.height());
-            painter->drawRect(rect);
-            break;
-        }
-        case MarkerAttributes::MarkerDiamond: {
-            QVector<QPointF> diamondPoints;
-            QPointF top, left, bottom, right;
-            top = QPointF(0, 0 - maSize.height() / 2);
-            left = QPointF(0 - maSize.width() / 2, 0);
-            bottom = QPointF(0, maSize.height() / 2);
-            right = QPointF(maSize.width() / 2, 0);
-            diamondPoints << top << left << bottom << right;
-            painter->drawPolygon(diamondPoints);
-            break;
-        }
-        // both handled on top of the method:
-        case MarkerAttributes::Marker1Pixel:
-        case MarkerAttributes::Marker4Pixels:
-            break;
-        case MarkerAttributes::MarkerRing: {
-            painter->setBrush(Qt::NoBrush);
-            painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
-            painter->drawEllipse(QRectF(0 - maSize.height() / 2, 0 - maSize.width() / 2,
-                                        maSize.height(), maSize.width()));
-            break;
-        }
-        case MarkerAttributes::MarkerCross: {
-            // Note: Markers can have outline,
-            //       so just drawing two rects is NOT the solution here!
-            const qreal w02 = maSize.width() * 0.2;
-            const qreal w05 = maSize.width() * 0.5;
-            const qreal h02 = maSize.height() * 0.2;
-            const qreal h05 = maSize.height() * 0.5;
-            QVector<QPointF> crossPoints;
-            QPointF p[12];
-            p[0] = QPointF(-w02, -h05);
-            p[1] = QPointF(w02, -h05);
-            p[2] = QPointF(w02, -h02);
-            p[3] = QPointF(w05, -h02);
-            p[4] = QPointF(w05, h02);
-            p[5] = QPointF(w02, h02);
-            p[6] = QPointF(w02, h05);
-            p[7] = QPointF(-w02, h05);
-            p[8] = QPointF(-w02, h02);
-            p[9] = QPointF(-w05, h02);
-            p[10] = QPointF(-w05, -h02);
-            p[11] = QPointF(-w02, -h02);
-            for (int i = 0; i < 12; ++i)
-                crossPoints << p[i];
-            crossPoints << p[0];
-            painter->drawPolygon(crossPoints);
-            break;
-        }
-        case MarkerAttributes::MarkerFastCross: {
-            QPointF left, right, top, bottom;
-            left = QPointF(-maSize.width() / 2, 0);
-            right = QPointF(maSize.width() / 2, 0);
-            top = QPointF(0, -maSize.height() / 2);
-            bottom = QPointF(0, maSize.height() / 2);
-            painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
-            painter->drawLine(left, right);
-            painter->drawLine(top, bottom);
-            break;
-        }
-        case MarkerAttributes::NoMarker:
-            break;
-        case MarkerAttributes::PainterPathMarker: {
-            QPainterPath path = markerAttributes.customMarkerPath();
-            const QRectF pathBoundingRect = path.boundingRect();
-            const qreal xScaling = maSize.height() / pathBoundingRect.height();
-            const qreal yScaling = maSize.width() / pathBoundingRect.width();
-            const qreal scaling = qMin(xScaling, yScaling);
-            painter->scale(scaling, scaling);
-            painter->setPen(PrintingParameters::scalePen(QPen(brush.color())));
-            painter->drawPath(path);
-            break;
-        }
-        default:
-            Q_ASSERT_X(false, "paintMarkers()",
-                       "Type item does not match a defined Marker Type.");
+        const QPen painterPen(PrintingParameters::scalePen(pen));
+        if (!paintCachedMarker(painter, markerAttributes, brush, painterPen, pos, maSize)) {
+            const PainterSaver painterSaver(painter);
+            painter->translate(pos);
+            paintMarkerShape(painter, markerAttributes, brush, painterPen, maSize);
         }
     }
     painter->setPen(oldPen);
@@ -941,6 +990,9 @@ qreal AbstractDiagram::valueForCell(int row, int column) const
         qWarning() << "AbstractDiagram::valueForCell(): Requesting value for invalid index!";
         return std::numeric_limits<qreal>::quiet_NaN();
     }
+    if (!attributesModelRootIndex().isValid()) {
+        return d->cellValue(row, column);
+    }
     return d->attributesModel->data(
                                  d->attributesModel->index(row, column, attributesModelRootIndex()))
         .toReal(); // checked
@@ -482,6 +482,20 @@ public:
      */
     bool antiAliasing() const;
 
+    /**
+     * Set whether the diagram records where it painted each data point.
+     * indexAt(), indexesAt(), indexesIn(), visualRect() and selecting
+     * with the mouse rely on that record. Disable it for charts that are
+     * only rendered and never interacted with, to save time and memory
+     * while painting. Reverse mapping is enabled by default.
+     */
+    void setReverseMappingEnabled(bool enabled);
+
+    /**
+     * @return Whether the diagram records where it painted each data point.
+     */
+    bool isReverseMappingEnabled() const;
+
     /**
      * Set the palette to be used, for painting datasets to the default
      * palette.
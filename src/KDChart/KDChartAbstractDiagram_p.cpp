@@ -23,11 +23,13 @@
 
 #include "KDChartBarDiagram.h"
 #include "KDChartFrameAttributes.h"
+#include "KDChartLabelCache_p.h"
 #include "KDChartPainterSaver_p.h"
 
 #include <QAbstractTextDocumentLayout>
 #include <QApplication>
 #include <QTextBlock>
+#include <QThread>
 
 #include <KDABLibFakes>
 
@@ -68,6 +70,8 @@ AbstractDiagram::Private::Private()
 
 AbstractDiagram::Private::~Private()
 {
+    // The diagram, the context of the connection, outlives this object
+    QObject::disconnect(columnarSourceConnection);
     if (attributesModel && qobject_cast<PrivateAttributesModel *>(attributesModel))
         delete attributesModel;
 }
@@ -131,6 +135,12 @@ void AbstractDiagram::Private::setAttributesModel(AttributesModel *amodel)
             diagram, SIGNAL(modelDataChanged()));
 
     attributesModel = amodel;
+    columnarSource = ColumnarDataSource::fromModel(amodel);
+    // AttributesModel::setSourceModel() resets the model
+    QObject::disconnect(columnarSourceConnection);
+    columnarSourceConnection = QObject::connect(amodel, &QAbstractItemModel::modelReset, diagram, [this]() {
+        columnarSource = ColumnarDataSource::fromModel(attributesModel);
+    });
 }
 
 AbstractDiagram::Private::Private(const AbstractDiagram::Private &rhs)
@@ -146,17 +156,30 @@ AbstractDiagram::Private::Private(const AbstractDiagram::Private &rhs)
 {
     attributesModel = new PrivateAttributesModel(nullptr, nullptr);
     attributesModel->initFrom(rhs.attributesModel);
+    reverseMapper.setEnabled(rhs.reverseMapper.isEnabled());
 }
 
 // FIXME: Optimize if necessary
 qreal AbstractDiagram::Private::calcPercentValue(const QModelIndex &index) const
 {
     qreal sum = 0.0;
-    for (int col = 0; col < attributesModel->columnCount(QModelIndex()); col++)
-        sum += attributesModel->data(attributesModel->index(index.row(), col, QModelIndex())).toReal(); // checked
+    for (int col = 0; col < attributesModel->columnCount(QModelIndex()); col++) {
+        const qreal value = cellValue(index.row(), col);
+        if (!ISNAN(value))
+            sum += value;
+    }
     if (sum == 0.0)
         return 0.0;
-    return attributesModel->data(attributesModel->mapFromSource(index)).toReal() / sum * 100.0;
+    return cellValue(index.row(), index.column()) / sum * 100.0;
+}
+
+qreal AbstractDiagram::Private::cellValue(int row, int column) const
+{
+    if (columnarSource) {
+        if (const double *values = columnarSource->columnData(column))
+            return values[row];
+    }
+    return attributesModel->data(attributesModel->index(row, column, QModelIndex())).toReal(); // checked
 }
 
 void AbstractDiagram::Private::addLabel(
@@ -165,7 +188,7 @@ void AbstractDiagram::Private::addLabel(
     const CartesianDiagramDataCompressor::CachePosition *position,
     const PositionPoints &points,
     const Position &autoPositionPositive, const Position &autoPositionNegative,
-    const qreal value, qreal favoriteAngle /* = 0.0 */)
+    const qreal value, qreal favoriteAngle /* = 0.0 */, const QString &dataLabel /* = QString() */)
 {
     CartesianDiagramDataCompressor::AggregatedDataValueAttributes allAttrs(
         aggregatedAttrs(index, position));
@@ -176,6 +199,10 @@ void AbstractDiagram::Private::addLabel(
         if (!dva.isVisible()) {
             continue;
         }
+        // replaces the value, like a label set with DataValueAttributes::setDataLabel()
+        if (!dataLabel.isNull()) {
+            dva.setDataLabel(dataLabel);
+        }
 
         const bool isPositive = (value >= 0.0);
 
@@ -317,9 +344,12 @@ void AbstractDiagram::Private::addLabel(
 const QFontMetrics *AbstractDiagram::Private::cachedFontMetrics(const QFont &font,
                                                                 const QPaintDevice *paintDevice) const
 {
-    if ((font != mCachedFont) || (paintDevice != mCachedPaintDevice)) {
+    const QThread *thread = QThread::currentThread();
+    if ((font != mCachedFont) || (paintDevice != mCachedPaintDevice) || (thread != mCachedThread)) {
         mCachedFontMetrics = QFontMetrics(font, const_cast<QPaintDevice *>(paintDevice));
-        // TODO what about setting mCachedFont and mCachedPaintDevice?
+        mCachedFont = font;
+        mCachedPaintDevice = paintDevice;
+        mCachedThread = thread;
     }
     return &mCachedFontMetrics;
 }
@@ -422,12 +452,12 @@ QString AbstractDiagram::Private::formatDataValueText(const DataValueAttributes
     if (!dva.isVisible()) {
         return QString();
     }
-    if (dva.usePercentage()) {
-        value = calcPercentValue(index);
-    }
-
     QString ret;
     if (dva.dataLabel().isNull()) {
+        // a label set instead of the value may belong to no cell, like the "Other" slice of a pie
+        if (dva.usePercentage()) {
+            value = calcPercentValue(index);
+        }
         ret = formatNumber(value, dva.decimalDigits());
     } else {
         ret = dva.dataLabel();
@@ -472,66 +502,72 @@ void AbstractDiagram::Private::paintDataValueText(
     }
     prevPaintedDataValueText = text;
 
-    QTextDocument doc;
-    doc.setDocumentMargin(0.0);
-    if (Qt::mightBeRichText(text)) {
-        doc.setHtml(text);
-    } else {
-        doc.setPlainText(text);
+    const QFont calculatedFont(ta.calculatedFont(plane, KDChartEnums::MeasureOrientationMinimum));
+
+    int rotation = ta.rotation();
+    if (!valueIsPositive && attrs.mirrorNegativeValueTextRotation()) {
+        rotation *= -1;
     }
 
-    const QFont calculatedFont(ta.calculatedFont(plane, KDChartEnums::MeasureOrientationMinimum));
+    // where the label is painted once the painter's transformation is reset, see below
+    const QPointF origin = painter->transform().map(pos);
 
-    const PainterSaver painterSaver(painter);
-    painter->setPen(PrintingParameters::scalePen(ta.pen()));
+    // plain texts like numbers repeat a lot, so they are laid out and rendered once, see LabelCache
+    LabelCache::Private::Label cachedLabel;
+    const bool isCached = !Qt::mightBeRichText(text)
+        && LabelCache::Private::instance()->documentLabel(painter, pos, text, calculatedFont, ta.pen().color(),
+                                                          rotation, &cachedLabel);
 
-    doc.setDefaultFont(calculatedFont);
+    QTextDocument doc;
     QAbstractTextDocumentLayout::PaintContext context;
-    context.palette = diagram->palette();
-    context.palette.setColor(QPalette::Text, ta.pen().color());
-
     QAbstractTextDocumentLayout *const layout = doc.documentLayout();
-    layout->setPaintDevice(painter->device());
+    if (!isCached) {
+        doc.setDocumentMargin(0.0);
+        if (Qt::mightBeRichText(text)) {
+            doc.setHtml(text);
+        } else {
+            doc.setPlainText(text);
+        }
+        doc.setDefaultFont(calculatedFont);
+        context.palette = diagram->palette();
+        context.palette.setColor(QPalette::Text, ta.pen().color());
+        layout->setPaintDevice(painter->device());
+    }
+
+    const PainterSaver painterSaver(painter);
+    painter->setPen(PrintingParameters::scalePen(ta.pen()));
 
     painter->translate(pos.x(), pos.y());
-    int rotation = ta.rotation();
-    if (!valueIsPositive && attrs.mirrorNegativeValueTextRotation()) {
-        rotation *= -1;
-    }
     painter->rotate(rotation);
 
     // do overlap detection "as seen by the painter"
     QTransform transform = painter->worldTransform();
 
+    const QRectF rect = isCached ? QRectF(QPointF(0, 0), cachedLabel.textSize)
+                                 : layout->frameBoundingRect(doc.rootFrame());
+
     bool drawIt = true;
     // note: This flag can be set differently for every label text!
     // In theory a user could e.g. have some small red text on one of the
     // values that she wants to have written in any case - so we just
     // do not test if such texts would cover some of the others.
     if (!attrs.showOverlappingDataLabels()) {
-        const QRectF br(layout->frameBoundingRect(doc.rootFrame()));
-        QPolygon pr = transform.mapToPolygon(br.toRect());
+        QPolygon pr = transform.mapToPolygon(rect.toRect());
         // Using QPainterPath allows us to use intersects() (which has many early-exits)
         // instead of QPolygon::intersected (which calculates a slow and precise intersection polygon)
         QPainterPath path;
         path.addPolygon(pr);
 
-        // iterate backwards because recently added items are more likely to overlap, so we spend
-        // less time checking irrelevant items when there is overlap
-        for (int i = alreadyDrawnDataValueTexts.count() - 1; i >= 0; i--) {
-            if (alreadyDrawnDataValueTexts.at(i).intersects(path)) {
-                // qDebug() << "not painting this label due to overlap";
-                drawIt = false;
-                break;
-            }
-        }
-        if (drawIt) {
-            alreadyDrawnDataValueTexts << path;
+        // only the texts close to this one are tested, see LabelCollisionIndex
+        if (alreadyDrawnDataValueTexts.intersects(path)) {
+            // qDebug() << "not painting this label due to overlap";
+            drawIt = false;
+        } else {
+            alreadyDrawnDataValueTexts.insert(path);
         }
     }
 
     if (drawIt) {
-        QRectF rect = layout->frameBoundingRect(doc.rootFrame());
         if (cumulatedBoundingRect) {
             (*cumulatedBoundingRect) |= transform.mapRect(rect);
         }
@@ -557,7 +593,13 @@ void AbstractDiagram::Private::paintDataValueText(
                 QRectF borderRect(QPointF(0, 0), rect.size());
                 painter->drawRoundedRect(borderRect, radius, radius);
             }
-            layout->draw(painter, context);
+            if (isCached) {
+                // the label is rotated already
+                painter->setTransform(QTransform());
+                LabelCache::Private::drawLabel(painter, origin, cachedLabel);
+            } else {
+                layout->draw(painter, context);
+            }
         }
     }
 }
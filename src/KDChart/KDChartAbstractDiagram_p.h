@@ -24,9 +24,12 @@
 
 #include "KDChartAbstractCoordinatePlane.h"
 #include "KDChartAbstractDiagram.h"
+#include "KDChartAttributeSnapshot_p.h"
 #include "KDChartBackgroundAttributes.h"
 #include "KDChartChart.h"
+#include "KDChartColumnarDataSource.h"
 #include "KDChartDataValueAttributes.h"
+#include "KDChartLabelCollisionIndex_p.h"
 #include "KDChartPaintContext.h"
 #include "KDChartPosition.h"
 #include "KDChartPrintingParameters.h"
@@ -43,6 +46,10 @@
 #include <QPoint>
 #include <QPointer>
 
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
 namespace KDChart {
 class LabelPaintInfo
 {
@@ -105,13 +112,19 @@ public:
     // FIXME: Optimize if necessary
     virtual qreal calcPercentValue(const QModelIndex &index) const;
 
+    /**
+     * Returns the display value of the top-level cell at @p row and @p column, read from the
+     * ColumnarDataSource if the model implements one, or through the attributes model otherwise.
+     */
+    qreal cellValue(int row, int column) const;
+
     // this should possibly be virtual so it can be overridden
     void addLabel(LabelPaintCache *cache,
                   const QModelIndex &index,
                   const CartesianDiagramDataCompressor::CachePosition *position,
                   const PositionPoints &points, const Position &autoPositionPositive,
                   const Position &autoPositionNegative, const qreal value,
-                  qreal favoriteAngle = 0.0);
+                  qreal favoriteAngle = 0.0, const QString &dataLabel = QString());
 
     const QFontMetrics *cachedFontMetrics(const QFont &font, const QPaintDevice *paintDevice) const;
     const QFontMetrics cachedFontMetrics() const;
@@ -186,6 +199,8 @@ public:
 
     AbstractDiagram *diagram = nullptr;
     ReverseMapper reverseMapper;
+    // attributes resolved per dataset, reset at the start of each paint()
+    AttributeSnapshot paintAttributes;
     bool doDumpPaintTime = false; // for use in performance testing code
 
 protected:
@@ -195,6 +210,8 @@ protected:
     QPointer<AbstractCoordinatePlane> plane;
     mutable QModelIndex attributesModelRootIndex;
     QPointer<AttributesModel> attributesModel;
+    const ColumnarDataSource *columnarSource = nullptr;
+    QMetaObject::Connection columnarSourceConnection;
     bool allowOverlappingDataValueTexts = false;
     bool antiAliasing = true;
     bool percent = false;
@@ -206,13 +223,15 @@ protected:
     QMap<Qt::Orientation, QString> unitPrefix;
     QMap<int, QMap<Qt::Orientation, QString>> unitSuffixMap;
     QMap<int, QMap<Qt::Orientation, QString>> unitPrefixMap;
-    QList<QPainterPath> alreadyDrawnDataValueTexts;
+    LabelCollisionIndex alreadyDrawnDataValueTexts;
 
 private:
     QString prevPaintedDataValueText;
     mutable QFontMetrics mCachedFontMetrics;
     mutable QFont mCachedFont;
-    mutable QPaintDevice *mCachedPaintDevice;
+    mutable const QPaintDevice *mCachedPaintDevice = nullptr;
+    // metrics are not shared between threads, a ChartRenderer may paint the diagram on a pool thread
+    mutable const QThread *mCachedThread = nullptr;
 };
 
 inline AbstractDiagram::AbstractDiagram(Private *p)
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartAttributeSnapshot_p.h"
+
+#include "KDChartGlobal.h"
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+AttributeSnapshot::AttributeSnapshot()
+    : m_pen(DatasetPenRole)
+    , m_brush(DatasetBrushRole)
+    , m_lineAttributes(LineAttributesRole)
+    , m_threeDLineAttributes(ThreeDLineAttributesRole)
+    , m_valueTrackerAttributes(ValueTrackerAttributesRole)
+    , m_barAttributes(BarAttributesRole)
+    , m_threeDBarAttributes(ThreeDBarAttributesRole)
+    , m_dataValueAttributes(DataValueLabelAttributesRole)
+{
+}
+
+AttributeSnapshot::AttributeSnapshot(const AttributesModel *model)
+    : AttributeSnapshot()
+{
+    m_model = model;
+}
+
+void AttributeSnapshot::reset(const AttributesModel *model)
+{
+    m_model = model;
+    m_pen.clear();
+    m_brush.clear();
+    m_lineAttributes.clear();
+    m_threeDLineAttributes.clear();
+    m_valueTrackerAttributes.clear();
+    m_barAttributes.clear();
+    m_threeDBarAttributes.clear();
+    m_dataValueAttributes.clear();
+}
+
+const AttributesModel *AttributeSnapshot::model() const
+{
+    return m_model;
+}
+
+QPen AttributeSnapshot::pen(const QModelIndex &index) const
+{
+    return m_pen.value(m_model, index);
+}
+
+QBrush AttributeSnapshot::brush(const QModelIndex &index) const
+{
+    return m_brush.value(m_model, index);
+}
+
+LineAttributes AttributeSnapshot::lineAttributes(const QModelIndex &index) const
+{
+    return m_lineAttributes.value(m_model, index);
+}
+
+ThreeDLineAttributes AttributeSnapshot::threeDLineAttributes(const QModelIndex &index) const
+{
+    return m_threeDLineAttributes.value(m_model, index);
+}
+
+ValueTrackerAttributes AttributeSnapshot::valueTrackerAttributes(const QModelIndex &index) const
+{
+    return m_valueTrackerAttributes.value(m_model, index);
+}
+
+BarAttributes AttributeSnapshot::barAttributes(const QModelIndex &index) const
+{
+    return m_barAttributes.value(m_model, index);
+}
+
+ThreeDBarAttributes AttributeSnapshot::threeDBarAttributes(const QModelIndex &index) const
+{
+    return m_threeDBarAttributes.value(m_model, index);
+}
+
+DataValueAttributes AttributeSnapshot::dataValueAttributes(const QModelIndex &index) const
+{
+    return m_dataValueAttributes.value(m_model, index);
+}
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTATTRIBUTESNAPSHOT_P_H
+#define KDCHARTATTRIBUTESNAPSHOT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QBrush>
+#include <QModelIndex>
+#include <QPen>
+#include <QVector>
+
+#include "KDChartAttributesModel.h"
+#include "KDChartBarAttributes.h"
+#include "KDChartDataValueAttributes.h"
+#include "KDChartLineAttributes.h"
+#include "KDChartThreeDBarAttributes.h"
+#include "KDChartThreeDLineAttributes.h"
+#include "KDChartValueTrackerAttributes.h"
+
+namespace KDChart {
+
+// - resolves the attributes that the painters query for every data point once per
+// dataset, instead of going through AttributesModel::data() and a QVariant for each cell
+// - per cell values (set with setData() or provided by the source model) still take
+// precedence, and are only converted for the cells that have them
+// - meant to live for the duration of one paint(); call reset() before painting since
+// it does not track changes of the model
+// - the values are returned by copy, the attribute classes are implicitly shared or small
+class AttributeSnapshot
+{
+public:
+    AttributeSnapshot();
+    explicit AttributeSnapshot(const AttributesModel *model);
+
+    // forgets all resolved values, and resolves the ones of @p model from now on
+    void reset(const AttributesModel *model);
+    const AttributesModel *model() const;
+
+    // @p index may belong to the attributes model or to its source model
+    QPen pen(const QModelIndex &index) const;
+    QBrush brush(const QModelIndex &index) const;
+    LineAttributes lineAttributes(const QModelIndex &index) const;
+    ThreeDLineAttributes threeDLineAttributes(const QModelIndex &index) const;
+    ValueTrackerAttributes valueTrackerAttributes(const QModelIndex &index) const;
+    BarAttributes barAttributes(const QModelIndex &index) const;
+    ThreeDBarAttributes threeDBarAttributes(const QModelIndex &index) const;
+    DataValueAttributes dataValueAttributes(const QModelIndex &index) const;
+
+private:
+    template<typename T>
+    class RoleCache
+    {
+    public:
+        explicit RoleCache(int role)
+            : m_role(role)
+        {
+        }
+
+        void clear()
+        {
+            m_datasetValues.clear();
+            m_resolved.clear();
+        }
+
+        T value(const AttributesModel *model, const QModelIndex &index)
+        {
+            if (!model) {
+                return T();
+            }
+            const QModelIndex attributesIndex = index.model() == model ? index : model->mapFromSource(index);
+            const QVariant cellValue = model->cellData(attributesIndex, m_role);
+            if (cellValue.isValid() || !attributesIndex.isValid()) {
+                return cellValue.value<T>();
+            }
+
+            const int column = attributesIndex.column();
+            if (column >= m_resolved.size()) {
+                m_datasetValues.resize(column + 1);
+                m_resolved.resize(column + 1);
+            }
+            if (!m_resolved.at(column)) {
+                m_datasetValues[column] = model->data(column, m_role).value<T>();
+                m_resolved[column] = true;
+            }
+            return m_datasetValues.at(column);
+        }
+
+    private:
+        int m_role;
+        QVector<T> m_datasetValues;
+        QVector<bool> m_resolved;
+    };
+
+    const AttributesModel *m_model = nullptr;
+    mutable RoleCache<QPen> m_pen;
+    mutable RoleCache<QBrush> m_brush;
+    mutable RoleCache<LineAttributes> m_lineAttributes;
+    mutable RoleCache<ThreeDLineAttributes> m_threeDLineAttributes;
+    mutable RoleCache<ValueTrackerAttributes> m_valueTrackerAttributes;
+    mutable RoleCache<BarAttributes> m_barAttributes;
+    mutable RoleCache<ThreeDBarAttributes> m_threeDBarAttributes;
+    mutable RoleCache<DataValueAttributes> m_dataValueAttributes;
+};
+}
+
+#endif
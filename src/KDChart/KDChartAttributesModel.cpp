@@ -13,6 +13,7 @@
 #include "KDChartPalette.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QPen>
 #include <QPointer>
 
@@ -36,12 +37,83 @@
 
 using namespace KDChart;
 
+namespace {
+// position of an attribute set for a single cell
+class CellKey
+{
+public:
+    int role;
+    int column;
+    int row;
+
+    bool operator==(const CellKey &other) const
+    {
+        return role == other.role && column == other.column && row == other.row;
+    }
+};
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+inline uint qHash(const CellKey &key, uint seed = 0)
+#else
+inline size_t qHash(const CellKey &key, size_t seed = 0)
+#endif
+{
+    return ::qHash(key.role, seed) ^ ::qHash((uint(key.column) << 16) ^ uint(key.row), seed);
+}
+
+// a bit per known attributes role, 0 for all other roles
+quint32 roleBit(int role)
+{
+    switch (role) {
+    case DataValueLabelAttributesRole:
+        return 1u << 0;
+    case DatasetBrushRole:
+        return 1u << 1;
+    case DatasetPenRole:
+        return 1u << 2;
+    case ThreeDAttributesRole:
+        return 1u << 3;
+    case LineAttributesRole:
+        return 1u << 4;
+    case ThreeDLineAttributesRole:
+        return 1u << 5;
+    case BarAttributesRole:
+        return 1u << 6;
+    case StockBarAttributesRole:
+        return 1u << 7;
+    case ThreeDBarAttributesRole:
+        return 1u << 8;
+    case PieAttributesRole:
+        return 1u << 9;
+    case ThreeDPieAttributesRole:
+        return 1u << 10;
+    case ValueTrackerAttributesRole:
+        return 1u << 11;
+    case DataHiddenRole:
+        return 1u << 12;
+    default:
+        return 0;
+    }
+}
+}
+
 class AttributesModel::Private
 {
 public:
     Private();
 
-    QMap<int, QMap<int, QMap<int, QVariant>>> dataMap;
+    void setCellData(const CellKey &key, const QVariant &value);
+    // recount cellDataCount and rolesWithCellData from cellData
+    void updateCellDataCounts();
+
+    // Attributes set for single cells, in one flat hash instead of maps nested by
+    // column, row and role. Only valid values are stored.
+    QHash<CellKey, QVariant> cellData;
+    // number of entries in cellData per role
+    QHash<int, int> cellDataCount;
+    // the roleBit()s of the roles that have entries in cellData; usually none are
+    // set per cell, and data() goes straight to the dataset and global attributes
+    quint32 rolesWithCellData = 0;
     QMap<int, QMap<int, QVariant>> horizontalHeaderDataMap;
     QMap<int, QMap<int, QVariant>> verticalHeaderDataMap;
     QMap<int, QVariant> modelDataMap;
@@ -56,6 +128,35 @@ AttributesModel::Private::Private()
 {
 }
 
+void AttributesModel::Private::setCellData(const CellKey &key, const QVariant &value)
+{
+    if (value.isValid()) {
+        QHash<CellKey, QVariant>::iterator it = cellData.find(key);
+        if (it != cellData.end()) {
+            it.value() = value;
+            return;
+        }
+        cellData.insert(key, value);
+        ++cellDataCount[key.role];
+        rolesWithCellData |= roleBit(key.role);
+    } else if (cellData.remove(key)) {
+        if (--cellDataCount[key.role] == 0) {
+            cellDataCount.remove(key.role);
+            rolesWithCellData &= ~roleBit(key.role);
+        }
+    }
+}
+
+void AttributesModel::Private::updateCellDataCounts()
+{
+    cellDataCount.clear();
+    rolesWithCellData = 0;
+    for (QHash<CellKey, QVariant>::const_iterator it = cellData.constBegin(); it != cellData.constEnd(); ++it) {
+        ++cellDataCount[it.key().role];
+        rolesWithCellData |= roleBit(it.key().role);
+    }
+}
+
 #define d d_func()
 
 AttributesModel::AttributesModel(QAbstractItemModel *model, QObject *parent /* = 0 */)
@@ -114,31 +215,17 @@ bool AttributesModel::compare(const AttributesModel *other) const
     }
 
     {
-        if (d->dataMap.count() != other->d->dataMap.count()) {
+        if (d->cellData.count() != other->d->cellData.count()) {
             return false;
         }
-        QMap<int, QMap<int, QMap<int, QVariant>>>::const_iterator itA = d->dataMap.constBegin();
-        QMap<int, QMap<int, QMap<int, QVariant>>>::const_iterator itB = other->d->dataMap.constBegin();
-        for (; itA != d->dataMap.constEnd(); ++itA, ++itB) {
-            if (itA->count() != itB->count()) {
+        QHash<CellKey, QVariant>::const_iterator itA = d->cellData.constBegin();
+        for (; itA != d->cellData.constEnd(); ++itA) {
+            QHash<CellKey, QVariant>::const_iterator itB = other->d->cellData.constFind(itA.key());
+            if (itB == other->d->cellData.constEnd()) {
                 return false;
             }
-            QMap<int, QMap<int, QVariant>>::const_iterator it2A = itA->constBegin();
-            QMap<int, QMap<int, QVariant>>::const_iterator it2B = itB->constBegin();
-            for (; it2A != itA->constEnd(); ++it2A, ++it2B) {
-                if (it2A->count() != it2B->count()) {
-                    return false;
-                }
-                QMap<int, QVariant>::const_iterator it3A = it2A->constBegin();
-                QMap<int, QVariant>::const_iterator it3B = it2B->constBegin();
-                for (; it3A != it2A->constEnd(); ++it3A, ++it3B) {
-                    if (it3A.key() != it3B.key()) {
-                        return false;
-                    }
-                    if (!compareAttributes(it3A.key(), it3A.value(), it3B.value())) {
-                        return false;
-                    }
-                }
+            if (!compareAttributes(itA.key().role, itA.value(), itB.value())) {
+                return false;
             }
         }
     }
@@ -292,7 +379,7 @@ QVariant AttributesModel::data(int column, int role) const
     return QVariant();
 }
 
-QVariant AttributesModel::data(const QModelIndex &index, int role) const
+QVariant AttributesModel::cellData(const QModelIndex &index, int role) const
 {
     if (index.isValid()) {
         Q_ASSERT(index.model() == this);
@@ -309,18 +396,25 @@ QVariant AttributesModel::data(const QModelIndex &index, int role) const
     }
 
     // check if we are storing a value for this role at this cell index
-    if (d->dataMap.contains(index.column())) {
-        const QMap<int, QMap<int, QVariant>> &colDataMap = d->dataMap[index.column()];
-        if (colDataMap.contains(index.row())) {
-            const QMap<int, QVariant> &dataMap = colDataMap[index.row()];
-            if (dataMap.contains(role)) {
-                const QVariant v = dataMap[role];
-                if (v.isValid()) {
-                    return v;
-                }
-            }
+    if (d->rolesWithCellData & roleBit(role)) {
+        QHash<CellKey, QVariant>::const_iterator it = d->cellData.constFind(CellKey {role, index.column(), index.row()});
+        if (it != d->cellData.constEnd()) {
+            return it.value();
         }
     }
+    return QVariant();
+}
+
+QVariant AttributesModel::data(const QModelIndex &index, int role) const
+{
+    if (!sourceModel()) {
+        return QVariant();
+    }
+
+    const QVariant v = cellData(index, role);
+    if (v.isValid()) {
+        return v;
+    }
     // check if there is something set for the column (dataset), or at global level
     if (index.isValid()) {
         return data(index.column(), role); // includes automatic fallback to default
@@ -363,9 +457,7 @@ bool AttributesModel::setData(const QModelIndex &index, const QVariant &value, i
     if (!isKnownAttributesRole(role)) {
         return sourceModel()->setData(mapToSource(index), value, role);
     } else {
-        QMap<int, QMap<int, QVariant>> &colDataMap = d->dataMap[index.column()];
-        QMap<int, QVariant> &dataMap = colDataMap[index.row()];
-        dataMap.insert(role, value);
+        d->setCellData(CellKey {role, index.column(), index.row()}, value);
         emit attributesChanged(index, index);
         return true;
     }
@@ -505,7 +597,11 @@ void AttributesModel::setSourceModel(QAbstractItemModel *sourceModel)
         disconnect(this->sourceModel(), SIGNAL(layoutChanged()),
                    this, SIGNAL(layoutChanged()));
     }
+    // Reset, so that views and the caches of the diagrams, such as the
+    // columnar data source of the model, do not refer to the old model
+    beginResetModel();
     QAbstractProxyModel::setSourceModel(sourceModel);
+    endResetModel();
     if (this->sourceModel() != nullptr) {
         connect(this->sourceModel(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)),
                 this, SLOT(slotDataChanged(const QModelIndex &, const QModelIndex &)));
@@ -578,25 +674,24 @@ void AttributesModel::slotRowsRemoved(const QModelIndex &parent, int start, int
 
 void AttributesModel::removeEntriesFromDataMap(int start, int end)
 {
-    QMap<int, QMap<int, QMap<int, QVariant>>>::iterator it = d->dataMap.find(end);
-    // check that the element was found
-    if (it != d->dataMap.end()) {
-        ++it;
-        QVector<int> indexesToDel;
-        for (int i = start; i < end && it != d->dataMap.end(); ++i) {
-            d->dataMap[i] = it.value();
-            indexesToDel << it.key();
-            ++it;
-        }
-        if (indexesToDel.isEmpty()) {
-            for (int i = start; i < end; ++i) {
-                indexesToDel << i;
-            }
-        }
-        for (int i = 0; i < indexesToDel.count(); ++i) {
-            d->dataMap.remove(indexesToDel[i]);
+    if (d->cellData.isEmpty()) {
+        return;
+    }
+    // drop the cells of the removed columns, the cells of the columns behind them move left
+    const int removedColumns = end - start + 1;
+    QHash<CellKey, QVariant> cellData;
+    cellData.reserve(d->cellData.count());
+    for (QHash<CellKey, QVariant>::const_iterator it = d->cellData.constBegin(); it != d->cellData.constEnd(); ++it) {
+        CellKey key = it.key();
+        if (key.column < start) {
+            cellData.insert(key, it.value());
+        } else if (key.column > end) {
+            key.column -= removedColumns;
+            cellData.insert(key, it.value());
         }
     }
+    d->cellData = cellData;
+    d->updateCellDataCounts();
 }
 
 void AttributesModel::removeEntriesFromDirectionDataMaps(Qt::Orientation dir, int start, int end)
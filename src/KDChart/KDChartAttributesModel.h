@@ -80,6 +80,12 @@ public:
      */
     QVariant data(int column, int role) const;
 
+    /** Returns the data that were specified for the cell at \a index, either by the
+     * source model or with setData(), or QVariant(). Unlike data(), this does not
+     * fall back to the per column, global or default data.
+     */
+    QVariant cellData(const QModelIndex &index, int role) const;
+
     /** \reimp */
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     /** \reimp */
@@ -21,6 +21,8 @@
 #include <QPaintEvent>
 #include <QPainter>
 #include <QPushButton>
+#include <QScreen>
+#include <QTimer>
 #include <QToolTip>
 #include <QtDebug>
 
@@ -31,6 +33,8 @@
 #include "KDChartLayoutItems.h"
 #include "KDChartLegend.h"
 #include "KDChartPainterSaver_p.h"
+#include "KDChartParallel_p.h"
+#include "KDChartPieDiagram.h"
 #include "KDChartPrintingParameters.h"
 #include <KDChartMarkerAttributes.h>
 #include <KDChartTextAttributes.h>
@@ -270,6 +274,8 @@ void Chart::Private::slotUnregisterDestroyedHeaderFooter(HeaderFooter *hf)
 void Chart::Private::slotUnregisterDestroyedPlane(AbstractCoordinatePlane *plane)
 {
     coordinatePlanes.removeAll(plane);
+    layers.planes.remove(plane);
+    updates.dirtyPlanes.remove(plane);
     Q_FOREACH (AbstractCoordinatePlane *p, coordinatePlanes) {
         if (p->referenceCoordinatePlane() == plane) {
             p->setReferenceCoordinatePlane(nullptr);
@@ -305,6 +311,10 @@ Chart::Private::Private(Chart *chart_)
             }
         }
     }
+    updates.timer = new QTimer(this);
+    updates.timer->setSingleShot(true);
+    updates.timer->setTimerType(Qt::PreciseTimer);
+    connect(updates.timer, SIGNAL(timeout()), this, SLOT(slotPerformScheduledUpdates()));
 }
 
 Chart::Private::~Private()
@@ -616,7 +626,7 @@ QHash<AbstractCoordinatePlane *, PlaneInfo> Chart::Private::buildPlaneLayoutInfo
         // Create a new grid layout for each plane that has no reference.
         p = planeInfos[plane];
         if (p.referencePlane == nullptr) {
-            p.gridLayout = new QGridLayout();
+            p.gridLayout = adoptLayout(new QGridLayout(), chart);
             p.gridLayout->setContentsMargins(0, 0, 0, 0);
             planeInfos[plane] = p;
         }
@@ -626,6 +636,7 @@ QHash<AbstractCoordinatePlane *, PlaneInfo> Chart::Private::buildPlaneLayoutInfo
 
 void Chart::Private::slotLayoutPlanes()
 {
+    layers.invalidate();
     /*TODO make sure this is really needed */
     const QBoxLayout::Direction oldPlanesDirection = planesLayout ? planesLayout->direction()
                                                                   : QBoxLayout::TopToBottom;
@@ -650,12 +661,12 @@ void Chart::Private::slotLayoutPlanes()
     delete planesLayout;
     // hint: The direction is configurable by the user now, as
     //       we are using a QBoxLayout rather than a QVBoxLayout.  (khz, 2007/04/25)
-    planesLayout = new QBoxLayout(oldPlanesDirection);
+    planesLayout = adoptLayout(new QBoxLayout(oldPlanesDirection), chart);
 
     isPlanesLayoutDirty = true; // here we create the layouts; we need to "run" them before painting
 
     if (useNewLayoutSystem) {
-        gridPlaneLayout = new QGridLayout;
+        gridPlaneLayout = adoptLayout(new QGridLayout, chart);
         planesLayout->addLayout(gridPlaneLayout);
 
         if (hadPlanesLayout)
@@ -711,25 +722,25 @@ void Chart::Private::slotLayoutPlanes()
                                 switch (axis->position()) {
                                 case (CartesianAxis::Top):
                                     if (!topLayout)
-                                        topLayout = new QVBoxLayout;
+                                        topLayout = adoptLayout(new QVBoxLayout, chart);
                                     topLayout->addItem(axis);
                                     axis->setParentLayout(topLayout);
                                     break;
                                 case (CartesianAxis::Bottom):
                                     if (!bottomLayout)
-                                        bottomLayout = new QVBoxLayout;
+                                        bottomLayout = adoptLayout(new QVBoxLayout, chart);
                                     bottomLayout->addItem(axis);
                                     axis->setParentLayout(bottomLayout);
                                     break;
                                 case (CartesianAxis::Left):
                                     if (!leftLayout)
-                                        leftLayout = new QHBoxLayout;
+                                        leftLayout = adoptLayout(new QHBoxLayout, chart);
                                     leftLayout->addItem(axis);
                                     axis->setParentLayout(leftLayout);
                                     break;
                                 case (CartesianAxis::Right):
                                     if (!rightLayout) {
-                                        rightLayout = new QHBoxLayout;
+                                        rightLayout = adoptLayout(new QHBoxLayout, chart);
                                     }
                                     rightLayout->addItem(axis);
                                     axis->setParentLayout(rightLayout);
@@ -850,22 +861,22 @@ void Chart::Private::slotLayoutPlanes()
 
                 // collect all axes of a kind into sublayouts
                 if (pi.topAxesLayout == nullptr) {
-                    pi.topAxesLayout = new QVBoxLayout;
+                    pi.topAxesLayout = adoptLayout(new QVBoxLayout, chart);
                     pi.topAxesLayout->setContentsMargins(0, 0, 0, 0);
                     pi.topAxesLayout->setObjectName(QString::fromLatin1("topAxesLayout"));
                 }
                 if (pi.bottomAxesLayout == nullptr) {
-                    pi.bottomAxesLayout = new QVBoxLayout;
+                    pi.bottomAxesLayout = adoptLayout(new QVBoxLayout, chart);
                     pi.bottomAxesLayout->setContentsMargins(0, 0, 0, 0);
                     pi.bottomAxesLayout->setObjectName(QString::fromLatin1("bottomAxesLayout"));
                 }
                 if (pi.leftAxesLayout == nullptr) {
-                    pi.leftAxesLayout = new QHBoxLayout;
+                    pi.leftAxesLayout = adoptLayout(new QHBoxLayout, chart);
                     pi.leftAxesLayout->setContentsMargins(0, 0, 0, 0);
                     pi.leftAxesLayout->setObjectName(QString::fromLatin1("leftAxesLayout"));
                 }
                 if (pi.rightAxesLayout == nullptr) {
-                    pi.rightAxesLayout = new QHBoxLayout;
+                    pi.rightAxesLayout = adoptLayout(new QHBoxLayout, chart);
                     pi.rightAxesLayout->setContentsMargins(0, 0, 0, 0);
                     pi.rightAxesLayout->setObjectName(QString::fromLatin1("rightAxesLayout"));
                 }
@@ -1048,7 +1059,9 @@ void Chart::Private::updateDirtyLayouts()
     if (isPlanesLayoutDirty) {
         Q_FOREACH (AbstractCoordinatePlane *p, coordinatePlanes) {
             p->setGridNeedsRecalculate();
-            p->layoutPlanes();
+            // what p->layoutPlanes() leads to, but not through its signal, which is queued
+            // while a ChartRenderer lays out the chart on a pool thread
+            slotLayoutPlanes();
             p->layoutDiagrams();
         }
     }
@@ -1098,6 +1111,227 @@ void Chart::Private::paintAll(QPainter *painter)
     }
 }
 
+QImage Chart::Private::createLayer() const
+{
+    // same resolution as the widget, so fonts and measures get the same size
+    QImage image(chart->size() * chart->devicePixelRatioF(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(chart->devicePixelRatioF());
+    image.setDotsPerMeterX(qRound(chart->logicalDpiX() / 0.0254));
+    image.setDotsPerMeterY(qRound(chart->logicalDpiY() / 0.0254));
+    image.fill(Qt::transparent);
+    return image;
+}
+
+QVector<QRect> Chart::Private::layoutGeometries() const
+{
+    QVector<QRect> geometries;
+    Q_FOREACH (AbstractLayoutItem *planeLayoutItem, planeLayoutItems) {
+        geometries << planeLayoutItem->geometry();
+    }
+    Q_FOREACH (TextArea *textLayoutItem, textLayoutItems) {
+        geometries << textLayoutItem->geometry();
+    }
+    Q_FOREACH (Legend *legend, legends) {
+        const bool hidden = legend->isHidden() && legend->testAttribute(Qt::WA_WState_ExplicitShowHide);
+        geometries << (hidden ? QRect() : legend->geometry());
+    }
+    return geometries;
+}
+
+QVector<Chart::Private::TextAreaState> Chart::Private::textAreaStates() const
+{
+    QVector<TextAreaState> states;
+    Q_FOREACH (TextArea *textLayoutItem, textLayoutItems) {
+        states << TextAreaState{textLayoutItem->text(), textLayoutItem->textAttributes(),
+                                textLayoutItem->backgroundAttributes(), textLayoutItem->frameAttributes()};
+    }
+    return states;
+}
+
+// Like paintAll(), but renders into the cached layers first, and only those
+// that were invalidated since the last paint event.
+void Chart::Private::paintLayers(QPainter *painter)
+{
+    updateDirtyLayouts();
+    chart->reLayoutFloatingLegends();
+
+    const QRect rect(QPoint(0, 0), chart->size());
+    const qreal devicePixelRatio = chart->devicePixelRatioF();
+    const QVector<QRect> geometries = layoutGeometries();
+    if (!layers.hasTrackedChange || layers.size != rect.size()
+        || layers.devicePixelRatio != devicePixelRatio || layers.geometries != geometries) {
+        layers.invalidate();
+    }
+    const QVector<TextAreaState> textAreas = textAreaStates();
+    if (layers.textAreas != textAreas) {
+        layers.decorations = QImage();
+    }
+    layers.hasTrackedChange = false;
+    layers.size = rect.size();
+    layers.devicePixelRatio = devicePixelRatio;
+    layers.geometries = geometries;
+    layers.textAreas = textAreas;
+
+    // what QPainter takes from the widget when painting on it directly
+    auto initPainter = [this](QPainter *layerPainter) {
+        layerPainter->setFont(chart->font());
+        layerPainter->setPen(chart->palette().color(chart->foregroundRole()));
+        layerPainter->setBrush(chart->palette().brush(chart->backgroundRole()));
+    };
+
+    if (layers.background.isNull()) {
+        layers.background = createLayer();
+        QPainter layerPainter(&layers.background);
+        initPainter(&layerPainter);
+        AbstractAreaBase::paintBackgroundAttributes(layerPainter, rect, backgroundAttributes);
+        AbstractAreaBase::paintFrameAttributes(layerPainter, rect, frameAttributes);
+    }
+    painter->drawImage(QPoint(0, 0), layers.background);
+
+    Q_FOREACH (AbstractLayoutItem *planeLayoutItem, planeLayoutItems) {
+        auto *plane = dynamic_cast<AbstractCoordinatePlane *>(planeLayoutItem);
+        if (!plane) {
+            continue;
+        }
+        QImage &layer = layers.planes[plane];
+        if (layer.isNull()) {
+            layer = createLayer();
+            QPainter layerPainter(&layer);
+            initPainter(&layerPainter);
+            plane->paintAll(layerPainter);
+        }
+        painter->drawImage(QPoint(0, 0), layer);
+    }
+
+    if (layers.decorations.isNull()) {
+        layers.decorations = createLayer();
+        QPainter layerPainter(&layers.decorations);
+        initPainter(&layerPainter);
+        // axes and spacers
+        Q_FOREACH (AbstractLayoutItem *planeLayoutItem, planeLayoutItems) {
+            if (!dynamic_cast<AbstractCoordinatePlane *>(planeLayoutItem)) {
+                planeLayoutItem->paintAll(layerPainter);
+            }
+        }
+        Q_FOREACH (TextArea *textLayoutItem, textLayoutItems) {
+            textLayoutItem->paintAll(layerPainter);
+        }
+        Q_FOREACH (Legend *legend, legends) {
+            const bool hidden = legend->isHidden() && legend->testAttribute(Qt::WA_WState_ExplicitShowHide);
+            if (!hidden) {
+                legend->paintIntoRect(layerPainter, legend->geometry());
+            }
+        }
+    }
+    painter->drawImage(QPoint(0, 0), layers.decorations);
+}
+
+void Chart::Private::slotInvalidatePlaneLayer()
+{
+    invalidatePlaneLayer(qobject_cast<AbstractCoordinatePlane *>(sender()));
+}
+
+void Chart::Private::invalidatePlaneLayer(AbstractCoordinatePlane *plane)
+{
+    // the axes show the data of the plane's diagrams, and planes may share them
+    layers.planes.remove(plane);
+    Q_FOREACH (AbstractCoordinatePlane *other, coordinatePlanes) {
+        if (other->referenceCoordinatePlane() == plane || (plane && plane->referenceCoordinatePlane() == other)) {
+            layers.planes.remove(other);
+        }
+    }
+    layers.decorations = QImage();
+    layers.hasTrackedChange = true;
+}
+
+void Chart::Private::slotInvalidateDecorationsLayer()
+{
+    layers.decorations = QImage();
+}
+
+void Chart::Private::slotPlaneNeedsUpdate()
+{
+    auto *plane = qobject_cast<AbstractCoordinatePlane *>(sender());
+    if (updates.enabled) {
+        scheduleUpdate(plane, false, true);
+    } else {
+        invalidatePlaneLayer(plane);
+        chart->update();
+    }
+}
+
+void Chart::Private::slotPlaneNeedsRelayout()
+{
+    auto *plane = qobject_cast<AbstractCoordinatePlane *>(sender());
+    if (updates.enabled) {
+        scheduleUpdate(plane, true, false);
+    } else {
+        invalidatePlaneLayer(plane);
+        slotResizePlanes();
+    }
+}
+
+void Chart::Private::scheduleUpdate(AbstractCoordinatePlane *plane, bool resize, bool repaint)
+{
+    updates.dirtyPlanes.insert(plane);
+    updates.needsResize = updates.needsResize || resize;
+    updates.needsRepaint = updates.needsRepaint || repaint;
+    if (updates.timer->isActive()) {
+        ++updates.coalescedCount;
+        return;
+    }
+    const int interval = frameInterval();
+    const qint64 elapsed = updates.lastFrame.isValid() ? updates.lastFrame.elapsed() : interval;
+    updates.timer->start(int(qMax(qint64(0), interval - elapsed)));
+}
+
+int Chart::Private::frameInterval() const
+{
+    qreal frameRate = updates.maximumFrameRate;
+    if (const QScreen *screen = chart->screen()) {
+        const qreal refreshRate = screen->refreshRate();
+        if (refreshRate > 0 && (frameRate <= 0 || refreshRate < frameRate)) {
+            frameRate = refreshRate;
+        }
+    }
+    return frameRate > 0 ? qRound(1000 / frameRate) : 0;
+}
+
+bool Chart::Private::performScheduledUpdates()
+{
+    // a ChartRenderer performs them before painting the chart on a pool thread,
+    // where the timer can't be stopped
+    if (updates.timer->isActive())
+        updates.timer->stop();
+    if (updates.dirtyPlanes.isEmpty()) {
+        return false;
+    }
+    ++updates.frameCount;
+    updates.lastFrame.start();
+
+    const QSet<AbstractCoordinatePlane *> dirtyPlanes = updates.dirtyPlanes;
+    updates.dirtyPlanes.clear();
+    Q_FOREACH (AbstractCoordinatePlane *plane, coordinatePlanes) {
+        if (dirtyPlanes.contains(plane)) {
+            invalidatePlaneLayer(plane);
+        }
+    }
+    if (updates.needsResize) {
+        updates.needsResize = false;
+        slotResizePlanes();
+    }
+    const bool repaint = updates.needsRepaint;
+    updates.needsRepaint = false;
+    return repaint;
+}
+
+void Chart::Private::slotPerformScheduledUpdates()
+{
+    if (performScheduledUpdates()) {
+        chart->update();
+    }
+}
+
 // ******** Chart interface implementation ***********
 
 #define d d_func()
@@ -1130,6 +1364,7 @@ Chart::~Chart()
 void Chart::setFrameAttributes(const FrameAttributes &a)
 {
     d->frameAttributes = a;
+    d->layers.background = QImage();
 }
 
 FrameAttributes Chart::frameAttributes() const
@@ -1140,6 +1375,7 @@ FrameAttributes Chart::frameAttributes() const
 void Chart::setBackgroundAttributes(const BackgroundAttributes &a)
 {
     d->backgroundAttributes = a;
+    d->layers.background = QImage();
 }
 
 BackgroundAttributes Chart::backgroundAttributes() const
@@ -1198,8 +1434,9 @@ void Chart::insertCoordinatePlane(int index, AbstractCoordinatePlane *plane)
 
     connect(plane, SIGNAL(destroyedCoordinatePlane(AbstractCoordinatePlane *)),
             d, SLOT(slotUnregisterDestroyedPlane(AbstractCoordinatePlane *)));
-    connect(plane, SIGNAL(needUpdate()), this, SLOT(update()));
-    connect(plane, SIGNAL(needRelayout()), d, SLOT(slotResizePlanes()));
+    connect(plane, SIGNAL(needUpdate()), d, SLOT(slotPlaneNeedsUpdate()));
+    connect(plane, SIGNAL(needRelayout()), d, SLOT(slotPlaneNeedsRelayout()));
+    connect(plane, SIGNAL(propertiesChanged()), d, SLOT(slotInvalidatePlaneLayer()));
     connect(plane, SIGNAL(needLayoutPlanes()), d, SLOT(slotLayoutPlanes()));
     connect(plane, SIGNAL(propertiesChanged()), this, SIGNAL(propertiesChanged()));
     d->coordinatePlanes.insert(index, plane);
@@ -1304,6 +1541,11 @@ void Chart::paint(QPainter *painter, const QRect &target)
         return;
     }
 
+    // the widget shows the pending changes too, once it repaints
+    if (d->performScheduledUpdates()) {
+        update();
+    }
+
     QPaintDevice *prevDevice = GlobalMeasureScaling::paintDevice();
     GlobalMeasureScaling::setPaintDevice(painter->device());
 
@@ -1360,6 +1602,22 @@ void Chart::paint(QPainter *painter, const QRect &target)
     GlobalMeasureScaling::setPaintDevice(prevDevice);
 }
 
+void Chart::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::FontChange:
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+    case QEvent::LayoutDirectionChange:
+        // what the layers take from the widget
+        d->layers.invalidate();
+        break;
+    default:
+        break;
+    }
+    QWidget::changeEvent(event);
+}
+
 void Chart::resizeEvent(QResizeEvent *event)
 {
     d->isPlanesLayoutDirty = true;
@@ -1398,10 +1656,82 @@ void Chart::reLayoutFloatingLegends()
     }
 }
 
+void Chart::setLayerCachingEnabled(bool enabled)
+{
+    d->layers.enabled = enabled;
+    d->layers.invalidate();
+    update();
+}
+
+bool Chart::isLayerCachingEnabled() const
+{
+    return d->layers.enabled;
+}
+
+void Chart::invalidateLayers()
+{
+    d->layers.invalidate();
+    update();
+}
+
+void Chart::setUpdateCoalescingEnabled(bool enabled)
+{
+    if (!enabled && d->performScheduledUpdates()) {
+        update();
+    }
+    d->updates.enabled = enabled;
+}
+
+bool Chart::isUpdateCoalescingEnabled() const
+{
+    return d->updates.enabled;
+}
+
+void Chart::setMaximumFrameRate(int framesPerSecond)
+{
+    d->updates.maximumFrameRate = qMax(0, framesPerSecond);
+}
+
+int Chart::maximumFrameRate() const
+{
+    return d->updates.maximumFrameRate;
+}
+
+int Chart::coalescedUpdateCount() const
+{
+    return d->updates.coalescedCount;
+}
+
+int Chart::updateFrameCount() const
+{
+    return d->updates.frameCount;
+}
+
+void Chart::resetUpdateStatistics()
+{
+    d->updates.coalescedCount = 0;
+    d->updates.frameCount = 0;
+}
+
+void Chart::updateOverlay()
+{
+    d->layers.hasTrackedChange = true;
+    update();
+}
+
 void Chart::paintEvent(QPaintEvent *)
 {
+    d->performScheduledUpdates();
     QPainter painter(this);
-    d->paintAll(&painter);
+    // QWidget::render() redirects the painter, e.g. to a printer or an SVG generator;
+    // those get the chart itself, not images of it
+    const QPaintEngine *const engine = painter.paintEngine();
+    if (d->layers.enabled && engine && engine->type() == QPaintEngine::Raster && painter.device() == this) {
+        d->paintLayers(&painter);
+    } else {
+        d->paintAll(&painter);
+    }
+    emit overlayPaintRequested(&painter);
     emit finishedDrawing();
 }
 
@@ -1605,6 +1935,7 @@ void Chart::addLegendInternal(Legend *legend, bool setMeasures)
     connect(legend, SIGNAL(positionChanged(AbstractAreaWidget *)),
             d, SLOT(slotLegendPositionChanged(AbstractAreaWidget *)));
     connect(legend, SIGNAL(propertiesChanged()), this, SIGNAL(propertiesChanged()));
+    connect(legend, SIGNAL(propertiesChanged()), d, SLOT(slotInvalidateDecorationsLayer()));
 
     d->slotResizePlanes();
 }
@@ -1738,6 +2069,18 @@ bool Chart::event(QEvent *event)
             Q_FOREACH (const AbstractCoordinatePlane *const plane, d->coordinatePlanes) {
                 Q_FOREACH (const AbstractDiagram *diagram, plane->diagrams()) {
 
+                    // the "Other" slice of a pie has no index, and no tool tip in the model
+                    const PieDiagram *pie = qobject_cast<const PieDiagram *>(diagram);
+                    if (stage == 0 && pie && pie->isOtherSliceAt(helpEvent->pos())) {
+                        const QString toolTip = pie->otherSliceToolTip();
+                        if (!toolTip.isEmpty()) {
+                            const QPoint pos = mapFromGlobal(helpEvent->pos());
+                            const QRect rect(pos - QPoint(1, 1), QSize(3, 3));
+                            QToolTip::showText(QCursor::pos(), toolTip, this, rect);
+                            return true;
+                        }
+                    }
+
                     QModelIndex index;
                     if (stage == 0) {
                         // First search at the exact position
@@ -91,6 +91,7 @@ class KDCHART_EXPORT Chart : public QWidget
     Q_PROPERTY(bool useNewLayoutSystem READ useNewLayoutSystem WRITE setUseNewLayoutSystem)
 
     KDCHART_DECLARE_PRIVATE_BASE_POLYMORPHIC_QWIDGET(Chart)
+    friend class ChartRenderer;
 
 public:
     explicit Chart(QWidget *parent = nullptr);
@@ -428,19 +429,121 @@ public:
      */
     void paint(QPainter *painter, const QRect &target);
 
+    /**
+     * Enables or disables caching the chart in layers when it is painted as a widget.
+     *
+     * With caching enabled, paintEvent() renders the background, each coordinate plane
+     * with its grid and diagrams, and the axes, headers, footers and legends into
+     * offscreen images, and composes the chart of them. When a diagram changes its
+     * data or attributes, only the layer of its coordinate plane and the layer of
+     * the axes, headers, footers and legends are rendered again; the background and
+     * the other planes are reused. Repaints requested by updateOverlay() render
+     * no layer at all.
+     *
+     * All other repaints, e.g. after calling update(), a resize or changes of the
+     * layout, render all layers again. Changes of the chart's background or frame
+     * attributes, its font or palette, a header's or footer's text or attributes and
+     * legend changes drop their layers as well, also when they are repainted together
+     * with a diagram change. Other changes that are repainted together with a diagram
+     * change or updateOverlay(), e.g. those of a subclass that paints state of its own,
+     * should call invalidateLayers().
+     *
+     * Layers are only used when the chart paints itself on screen. Calling paint(),
+     * and QWidget::render() with a printer, an SVG generator or a QPicture, always
+     * paint the chart itself.
+     *
+     * This costs four bytes per pixel of the chart for each layer. It is disabled by
+     * default.
+     *
+     * \sa overlayPaintRequested(), invalidateLayers()
+     */
+    void setLayerCachingEnabled(bool enabled);
+    bool isLayerCachingEnabled() const;
+
+    /**
+     * Drops all cached layers and repaints the chart, for changes the layers don't
+     * track. Does nothing but repaint when layer caching is disabled.
+     *
+     * \sa setLayerCachingEnabled()
+     */
+    void invalidateLayers();
+
+    /**
+     * Enables or disables merging the updates requested by changes of the diagrams.
+     *
+     * Normally, each change of a diagram's model lays out the coordinate planes again
+     * and requests a repaint right away, so a model emitting thousands of small changes
+     * per second causes as many rounds of layouting. With coalescing enabled, the chart
+     * only records which planes changed, and lays them out and repaints them once per
+     * frame, i.e. at most at the refresh rate of the screen and at maximumFrameRate().
+     * Painting the chart performs the pending updates first, so it never shows outdated
+     * content.
+     *
+     * It is disabled by default.
+     *
+     * \sa coalescedUpdateCount()
+     */
+    void setUpdateCoalescingEnabled(bool enabled);
+    bool isUpdateCoalescingEnabled() const;
+
+    /**
+     * Limits the merged updates to @p framesPerSecond frames per second. 0, the default,
+     * only limits them to the refresh rate of the screen.
+     *
+     * \sa setUpdateCoalescingEnabled()
+     */
+    void setMaximumFrameRate(int framesPerSecond);
+    int maximumFrameRate() const;
+
+    /**
+     * Returns the number of update requests that were merged into a frame that was
+     * scheduled already, since the last call of resetUpdateStatistics().
+     */
+    int coalescedUpdateCount() const;
+    /**
+     * Returns the number of frames the merged updates were performed in, since the
+     * last call of resetUpdateStatistics().
+     */
+    int updateFrameCount() const;
+    void resetUpdateStatistics();
+
     void reLayoutFloatingLegends();
 
+public Q_SLOTS:
+    /**
+     * Repaints the chart to update what the slots connected to overlayPaintRequested()
+     * paint, e.g. a crosshair following the mouse. With layer caching enabled, the
+     * cached layers are reused as they are.
+     *
+     * \sa setLayerCachingEnabled()
+     */
+    void updateOverlay();
+
 Q_SIGNALS:
     /** Emitted upon change of a property of the Chart or any of its components. */
     void propertiesChanged();
     void finishedDrawing();
 
+    /**
+     * Emitted at the end of paintEvent(), to paint on top of the chart with @p painter,
+     * e.g. a value tracker or crosshair. Connect to it with a direct connection.
+     *
+     * Call updateOverlay() to repaint the overlay when only it has changed.
+     */
+    void overlayPaintRequested(QPainter *painter);
+
 protected:
     /**
      * Adjusts the internal layout when the chart is resized.
      */
     /* reimp */ void resizeEvent(QResizeEvent *event) override;
 
+    /**
+     * Drops the cached layers when the font, palette, style or layout direction
+     * of the chart changes.
+     */
+    /* reimp */ void changeEvent(QEvent *event) override;
+
     /**
      * @brief Draws the background and frame, then calls paint().
      *
@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartChartRenderer.h"
+
+#include "KDChartChart.h"
+#include "KDChartChart_p.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QPainter>
+#include <QSemaphore>
+#include <QSvgGenerator>
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+class ChartRenderer::Private
+{
+public:
+    QThreadPool *pool() const
+    {
+        return threadPool ? threadPool : QThreadPool::globalInstance();
+    }
+
+    // lay out and paint chart in the calling thread
+    QImage render(Chart *chart) const;
+    bool write(Chart *chart, const QString &fileName) const;
+    void paint(Chart *chart, QPainter *painter) const;
+
+    // calls work with the position of every chart on the thread pool, and returns when all
+    // calls are done; see the class documentation for the charts kept in the calling thread
+    void forEachChart(const QList<Chart *> &charts, const std::function<void(int)> &work) const;
+
+    QSize size = QSize(800, 600);
+    QBrush background = QBrush(Qt::white);
+    QImage::Format imageFormat = QImage::Format_ARGB32_Premultiplied;
+    QThreadPool *threadPool = nullptr;
+};
+
+void ChartRenderer::Private::paint(Chart *chart, QPainter *painter) const
+{
+    const QRect rect(QPoint(0, 0), size);
+    painter->fillRect(rect, background);
+    if (chart)
+        chart->paint(painter, rect);
+}
+
+QImage ChartRenderer::Private::render(Chart *chart) const
+{
+    QImage image(size, imageFormat);
+    if (image.isNull())
+        return image;
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    paint(chart, &painter);
+    return image;
+}
+
+bool ChartRenderer::Private::write(Chart *chart, const QString &fileName) const
+{
+    if (fileName.endsWith(QLatin1String(".svg"), Qt::CaseInsensitive)) {
+        QSvgGenerator generator;
+        generator.setFileName(fileName);
+        generator.setSize(size);
+        generator.setViewBox(QRect(QPoint(0, 0), size));
+        // lay the chart out like on screen, and not for the generator's 72 dpi
+        if (chart)
+            generator.setResolution(chart->logicalDpiX());
+        QPainter painter;
+        if (!painter.begin(&generator))
+            return false;
+        paint(chart, &painter);
+        return painter.end();
+    }
+    return render(chart).save(fileName);
+}
+
+void ChartRenderer::Private::forEachChart(const QList<Chart *> &charts, const std::function<void(int)> &work) const
+{
+    // a chart that is in the list several times is laid out and painted by one task, one position
+    // after the other, never by two threads at once
+    QVector<Chart *> distinctCharts;
+    QHash<Chart *, QVector<int>> positions;
+    for (int i = 0; i < charts.size(); ++i) {
+        Chart *const chart = charts.at(i);
+        if (!positions.contains(chart))
+            distinctCharts << chart;
+        positions[chart] << i;
+    }
+
+    QSemaphore done;
+    int tasks = 0;
+    QVector<int> inCallingThread;
+    for (Chart *chart : qAsConst(distinctCharts)) {
+        const QVector<int> chartPositions = positions.value(chart);
+        if (chart) {
+            // the update timer belongs to this thread
+            if (chart->d_func()->performScheduledUpdates())
+                chart->update();
+            if (chart->testAttribute(Qt::WA_WState_Created)) {
+                inCallingThread += chartPositions;
+                continue;
+            }
+        }
+        pool()->start([&work, &done, chartPositions]() {
+            for (int i : chartPositions)
+                work(i);
+            done.release();
+        });
+        ++tasks;
+    }
+    for (int i : qAsConst(inCallingThread))
+        work(i);
+    done.acquire(tasks);
+}
+
+#define d d_func()
+
+ChartRenderer::ChartRenderer()
+    : _d(new Private)
+{
+}
+
+ChartRenderer::~ChartRenderer()
+{
+    delete _d;
+    _d = nullptr;
+}
+
+void ChartRenderer::setSize(const QSize &size)
+{
+    d->size = size;
+}
+
+QSize ChartRenderer::size() const
+{
+    return d->size;
+}
+
+void ChartRenderer::setBackground(const QBrush &background)
+{
+    d->background = background;
+}
+
+QBrush ChartRenderer::background() const
+{
+    return d->background;
+}
+
+void ChartRenderer::setImageFormat(QImage::Format format)
+{
+    d->imageFormat = format;
+}
+
+QImage::Format ChartRenderer::imageFormat() const
+{
+    return d->imageFormat;
+}
+
+void ChartRenderer::setThreadPool(QThreadPool *pool)
+{
+    d->threadPool = pool;
+}
+
+QThreadPool *ChartRenderer::threadPool() const
+{
+    return d->threadPool;
+}
+
+QPicture ChartRenderer::record(Chart *chart) const
+{
+    QPicture picture;
+    if (!chart || d->size.isEmpty())
+        return picture;
+    QPainter painter(&picture);
+    chart->paint(&painter, QRect(QPoint(0, 0), d->size));
+    painter.end();
+    return picture;
+}
+
+QImage ChartRenderer::render(Chart *chart) const
+{
+    return d->render(chart);
+}
+
+QList<QImage> ChartRenderer::render(const QList<Chart *> &charts) const
+{
+    QVector<QImage> images(charts.size());
+    // every worker writes to its own element, the vector itself is not touched until all are done
+    QImage *const targets = images.data();
+    d->forEachChart(charts, [this, &charts, targets](int i) {
+        targets[i] = d->render(charts.at(i));
+    });
+
+    QList<QImage> result;
+    result.reserve(images.size());
+    for (const QImage &image : images)
+        result.append(image);
+    return result;
+}
+
+bool ChartRenderer::renderToFiles(const QList<Chart *> &charts, const QStringList &fileNames) const
+{
+    Q_ASSERT(charts.size() == fileNames.size());
+    if (charts.size() != fileNames.size())
+        return false;
+
+    QAtomicInt failures;
+    d->forEachChart(charts, [this, &charts, &fileNames, &failures](int i) {
+        if (!d->write(charts.at(i), fileNames.at(i)))
+            failures.ref();
+    });
+    return failures.loadAcquire() == 0;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTCHARTRENDERER_H
+#define KDCHARTCHARTRENDERER_H
+
+#include <QBrush>
+#include <QImage>
+#include <QList>
+#include <QPicture>
+#include <QSize>
+#include <QStringList>
+
+#include "KDChartGlobal.h"
+
+QT_BEGIN_NAMESPACE
+class QThreadPool;
+QT_END_NAMESPACE
+
+namespace KDChart {
+
+class Chart;
+
+/**
+ * @brief Renders charts into images and files without showing them, for many charts at once
+ *
+ * ChartRenderer lays out and paints every chart of a batch on a worker thread of a
+ * QThreadPool, directly into its image or SVG file, and encodes the image there. Several
+ * charts are therefore laid out, painted and encoded at the same time. The state used
+ * while painting is safe for that: measure scaling, printing parameters and diagram font
+ * metrics are per thread, the label and symbol caches are locked, and the palettes are
+ * never modified.
+ *
+ * The calling thread performs the updates a chart has scheduled (see
+ * Chart::setUpdateCoalescingEnabled()) before handing it to a worker, and it waits until
+ * every chart of the batch is done. While a batch renders:
+ * \li each chart is laid out and painted by one thread at a time, even if it is in the
+ *     batch several times;
+ * \li charts that have been shown, or whose window was created otherwise, are laid out
+ *     and painted in the calling thread, since resizing them sends events to them;
+ * \li models shared by several charts of the batch are read by several threads at once.
+ *
+ * \code
+ * KDChart::ChartRenderer renderer;
+ * renderer.setSize( QSize( 800, 600 ) );
+ * renderer.renderToFiles( charts, fileNames ); // e.g. "report1.png", "report2.svg"
+ * \endcode
+ */
+class KDCHART_EXPORT ChartRenderer
+{
+    Q_DISABLE_COPY(ChartRenderer)
+    KDCHART_DECLARE_PRIVATE_BASE_VALUE(ChartRenderer)
+
+public:
+    ChartRenderer();
+    ~ChartRenderer();
+
+    /**
+     * Sets the size of the rendered images, in pixels. The default is 800x600.
+     */
+    void setSize(const QSize &size);
+    QSize size() const;
+
+    /**
+     * Sets the brush the images are filled with before the chart is drawn.
+     * The default is white; use Qt::transparent for images with an alpha channel.
+     */
+    void setBackground(const QBrush &background);
+    QBrush background() const;
+
+    /**
+     * Sets the format of the rendered images. The default is QImage::Format_ARGB32_Premultiplied.
+     */
+    void setImageFormat(QImage::Format format);
+    QImage::Format imageFormat() const;
+
+    /**
+     * Sets the thread pool that renders the charts. The default, nullptr,
+     * uses QThreadPool::globalInstance(). The pool is not owned by the renderer.
+     */
+    void setThreadPool(QThreadPool *pool);
+    QThreadPool *threadPool() const;
+
+    /**
+     * Records what @p chart paints at size(). Call this in the thread that owns @p chart.
+     * The returned picture can be replayed in any thread.
+     */
+    QPicture record(Chart *chart) const;
+
+    /**
+     * Renders @p chart in the calling thread.
+     */
+    QImage render(Chart *chart) const;
+
+    /**
+     * Renders @p charts in parallel on threadPool(). Call this in the thread that owns the charts.
+     * The images are in the order of @p charts, and equal to what render() returns for each one.
+     */
+    QList<QImage> render(const QList<Chart *> &charts) const;
+
+    /**
+     * Renders @p charts like render(), and writes each one to the file of the same
+     * position in @p fileNames. Files ending in ".svg" are written as SVG drawings,
+     * all others as images in the format their suffix stands for (see QImage::save()).
+     * Encoding and writing happen on threadPool() as well.
+     *
+     * @return whether all files were written
+     */
+    bool renderToFiles(const QList<Chart *> &charts, const QStringList &fileNames) const;
+};
+}
+
+#endif
@@ -22,16 +22,25 @@
 // We mean it.
 //
 
+#include <QElapsedTimer>
 #include <QHBoxLayout>
+#include <QHash>
+#include <QImage>
 #include <QObject>
+#include <QSet>
 #include <QVBoxLayout>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 #include "KDChartAbstractArea.h"
 #include "KDChartBackgroundAttributes.h"
 #include "KDChartChart.h"
 #include "KDChartFrameAttributes.h"
 #include "KDChartLayoutItems.h"
 #include "KDChartTextArea.h"
+#include "KDChartTextAttributes.h"
 
 #include <KDABLibFakes>
 
@@ -141,6 +150,65 @@ public:
 
     Qt::LayoutDirection layoutDirection;
 
+    // what a header or footer shows; they do not notify the chart of changes, so the
+    // decorations layer compares these
+    struct TextAreaState
+    {
+        QString text;
+        TextAttributes textAttributes;
+        BackgroundAttributes backgroundAttributes;
+        FrameAttributes frameAttributes;
+
+        bool operator==(const TextAreaState &other) const
+        {
+            return text == other.text && textAttributes == other.textAttributes
+                && backgroundAttributes == other.backgroundAttributes && frameAttributes == other.frameAttributes;
+        }
+    };
+
+    // the images paintEvent() composes the chart of, see Chart::setLayerCachingEnabled()
+    struct Layers
+    {
+        bool enabled = false;
+        // set when a change that invalidates only its own layers requests a repaint;
+        // repaints without one may be caused by any change, so they render all layers.
+        // Changes known to affect other layers, like the chart's background attributes,
+        // a header's text or a legend, drop those layers themselves, because a tracked
+        // change may be pending in the same repaint.
+        bool hasTrackedChange = false;
+        QSize size;
+        qreal devicePixelRatio = 1.0;
+        QVector<QRect> geometries; // of all layout items, the layers are rendered for
+        QVector<TextAreaState> textAreas; // the headers and footers are rendered with
+        QImage background; // background and frame of the chart
+        QHash<AbstractCoordinatePlane *, QImage> planes; // with their grids and diagrams
+        QImage decorations; // axes, headers, footers and legends
+
+        void invalidate()
+        {
+            background = QImage();
+            planes.clear();
+            decorations = QImage();
+        }
+    };
+    Layers layers;
+
+    // merges the update and relayout requests of the planes into one per frame,
+    // see Chart::setUpdateCoalescingEnabled()
+    struct UpdateScheduler
+    {
+        bool enabled = false;
+        int maximumFrameRate = 0;
+        QTimer *timer = nullptr;
+        QElapsedTimer lastFrame;
+        QSet<AbstractCoordinatePlane *> dirtyPlanes;
+        bool needsResize = false;
+        bool needsRepaint = false;
+        int coalescedCount = 0;
+        int frameCount = 0;
+    };
+    UpdateScheduler updates;
+
     Private(Chart *);
 
     ~Private() override;
@@ -149,6 +217,17 @@ public:
     void updateDirtyLayouts();
     void reapplyInternalLayouts(); // TODO: see if this can be merged with updateDirtyLayouts()
     void paintAll(QPainter *painter);
+    void paintLayers(QPainter *painter);
+    QImage createLayer() const;
+    QVector<QRect> layoutGeometries() const;
+    QVector<TextAreaState> textAreaStates() const;
+    void invalidatePlaneLayer(AbstractCoordinatePlane *plane);
+
+    void scheduleUpdate(AbstractCoordinatePlane *plane, bool resize, bool repaint);
+    // the shortest time between two frames, from the maximum frame rate and the screen
+    int frameInterval() const;
+    // runs the work merged since the last frame, returns whether it requested a repaint
+    bool performScheduledUpdates();
 
     struct AxisInfo
     {
@@ -168,6 +247,11 @@ public Q_SLOTS:
     void slotUnregisterDestroyedLegend(Legend *legend);
     void slotUnregisterDestroyedHeaderFooter(HeaderFooter *headerFooter);
     void slotUnregisterDestroyedPlane(AbstractCoordinatePlane *plane);
+    void slotInvalidatePlaneLayer();
+    void slotInvalidateDecorationsLayer();
+    void slotPlaneNeedsUpdate();
+    void slotPlaneNeedsRelayout();
+    void slotPerformScheduledUpdates();
 };
 }
 
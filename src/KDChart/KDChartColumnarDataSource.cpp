@@ -0,0 +1,29 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartColumnarDataSource.h"
+
+#include "KDChartAttributesModel.h"
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+ColumnarDataSource::~ColumnarDataSource()
+{
+}
+
+const ColumnarDataSource *ColumnarDataSource::fromModel(const QAbstractItemModel *model)
+{
+    if (const auto *attributesModel = qobject_cast<const AttributesModel *>(model)) {
+        model = attributesModel->sourceModel();
+    }
+    return dynamic_cast<const ColumnarDataSource *>(model);
+}
@@ -0,0 +1,71 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTCOLUMNARDATASOURCE_H
+#define KDCHARTCOLUMNARDATASOURCE_H
+
+#include "kdchart_export.h"
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+QT_END_NAMESPACE
+
+namespace KDChart {
+
+/**
+ * @brief Optional bulk data interface for item models that store their values in arrays
+ *
+ * Diagrams normally read every value through QAbstractItemModel::data(), which costs
+ * a QModelIndex and a QVariant conversion per cell. A model that keeps its values in
+ * contiguous arrays of doubles can additionally inherit ColumnarDataSource. Diagrams
+ * detect this and read the arrays directly, skipping the per-cell index() and data()
+ * calls for the Qt::DisplayRole values.
+ *
+ * Only the values of the top-level table are read that way; diagrams that use a valid
+ * root index keep going through the model. The model must still emit the regular
+ * QAbstractItemModel change signals, since these are what tells the diagrams that
+ * the arrays have changed.
+ *
+ * \code
+ * class SampleModel : public QAbstractTableModel, public KDChart::ColumnarDataSource
+ * {
+ * public:
+ *     const double *columnData( int column ) const override
+ *     {
+ *         return m_columns.at( column ).constData();
+ *     }
+ *     ...
+ * };
+ * \endcode
+ */
+class KDCHART_EXPORT ColumnarDataSource
+{
+public:
+    virtual ~ColumnarDataSource();
+
+    /**
+     * Returns a pointer to the Qt::DisplayRole values of @p column, with one value
+     * per row of the model's top-level table. Missing values are represented by NaN.
+     *
+     * The pointer has to stay valid until the model emits its next change signal.
+     * Return nullptr if the column can not be provided as an array, the values are
+     * then read through QAbstractItemModel::data() as usual.
+     */
+    virtual const double *columnData(int column) const = 0;
+
+    /**
+     * Returns the ColumnarDataSource implemented by @p model, or nullptr.
+     * If @p model is an AttributesModel, its source model is checked instead.
+     */
+    static const ColumnarDataSource *fromModel(const QAbstractItemModel *model);
+};
+}
+
+#endif
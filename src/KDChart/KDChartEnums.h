@@ -337,6 +337,25 @@ public:
         // default, should not happen
         return MeasureOrientationAuto;
     }
+
+    /**
+      Data reduction mode: how line and bar diagrams condense datasets that have
+      more values than the diagram is wide in pixels.
+
+      \li \c DataReductionAverage Each pixel column shows the average of the values falling into it. Short spikes get flattened.
+      \li \c DataReductionMinMax Each pixel column shows its first, minimum, maximum and last value (also known as M4).
+      The resulting line looks exactly like the line through all values, using at most four points per pixel column.
+      \li \c DataReductionLargestTriangle Two points per pixel column are selected by the Largest-Triangle-Three-Buckets
+      algorithm, which keeps the points that shape the line the most. Cheaper to paint than DataReductionMinMax, but not exact.
+
+      \sa KDChart::LineDiagram::setDataReductionMode, KDChart::BarDiagram::setDataReductionMode
+      */
+    enum DataReductionMode
+    {
+        DataReductionAverage,
+        DataReductionMinMax,
+        DataReductionLargestTriangle
+    };
 };
 
 #endif
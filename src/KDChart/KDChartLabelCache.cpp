@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartLabelCache.h"
+#include "KDChartLabelCache_p.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QHash>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QTextDocument>
+
+#include <KDABLibFakes>
+
+#define d d_func()
+
+using namespace KDChart;
+
+bool LabelCache::Private::Key::operator==(const Key &other) const
+{
+    return text == other.text && font == other.font && color == other.color
+        && flags == other.flags && rect == other.rect && rotation == other.rotation
+        && devicePixelRatio == other.devicePixelRatio && dpiX == other.dpiX
+        && dpiY == other.dpiY && antialiased == other.antialiased && phase == other.phase;
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint KDChart::qHash(const LabelCache::Private::Key &key, uint seed)
+#else
+size_t KDChart::qHash(const LabelCache::Private::Key &key, size_t seed)
+#endif
+{
+    auto hash = ::qHash(key.text, seed);
+    hash = 31 * hash + ::qHash(key.font, seed);
+    hash = 31 * hash + key.color;
+    hash = 31 * hash + uint(key.flags);
+    hash = 31 * hash + ::qHash(key.rotation, seed);
+    hash = 31 * hash + ::qHash(key.rect.width(), seed);
+    hash = 31 * hash + ::qHash(key.rect.height(), seed);
+    hash = 31 * hash + uint(key.phase.x() * LabelCache::Private::PhaseSteps + key.phase.y());
+    return hash;
+}
+
+LabelCache::Private *LabelCache::Private::instance()
+{
+    return LabelCache::instance()->_d;
+}
+
+LabelCache::Private::Key LabelCache::Private::key(QPainter *painter, const QPointF &origin, const QString &text,
+                                                  const QFont &font, const QColor &color, int flags,
+                                                  const QRectF &rect, qreal rotation) const
+{
+    const QPaintDevice *const device = painter->device();
+    Key key;
+    key.text = text;
+    key.font = font.key();
+    key.color = color.rgba();
+    key.flags = flags;
+    key.rect = rect;
+    key.rotation = rotation;
+    key.devicePixelRatio = device->devicePixelRatioF();
+    key.dpiX = device->logicalDpiX();
+    key.dpiY = device->logicalDpiY();
+    key.antialiased = painter->testRenderHint(QPainter::TextAntialiasing);
+    key.phase = Cache::phase(painter, origin, PhaseSteps);
+    return key;
+}
+
+// an image with the resolution of the paint device the label is for, so fonts get the same size
+static QImage labelImage(const LabelCache::Private::Key &key, const QSize &size)
+{
+    QImage image(size * key.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(key.devicePixelRatio);
+    image.setDotsPerMeterX(qRound(key.dpiX / 0.0254));
+    image.setDotsPerMeterY(qRound(key.dpiY / 0.0254));
+    image.fill(Qt::transparent);
+    return image;
+}
+
+LabelCache::Private::Label LabelCache::Private::lookup(const Key &key, const QFont &font)
+{
+    if (const Label *cached = cache.find(key))
+        return *cached;
+
+    // lay out the text unrotated, to find the rotated rect covered by the image
+    QTextDocument document;
+    QRectF textRect = key.rect;
+    if (key.flags == DocumentLayout) {
+        // like AbstractDiagram::Private::paintDataValueText() does for rich text
+        QImage probe = labelImage(key, QSize(1, 1));
+        document.setDocumentMargin(0.0);
+        document.setPlainText(key.text);
+        document.setDefaultFont(font);
+        document.documentLayout()->setPaintDevice(&probe);
+        textRect = document.documentLayout()->frameBoundingRect(document.rootFrame());
+    }
+    QTransform rotation;
+    rotation.rotate(key.rotation);
+    // the text is painted at the sub-pixel position it has on the device
+    const QPointF phase = QPointF(key.phase) / (PhaseSteps * key.devicePixelRatio);
+    // one more pixel for the antialiasing on each side
+    const QRect bounds = rotation.mapRect(textRect).translated(phase).adjusted(-1.0, -1.0, 1.0, 1.0).toAlignedRect();
+
+    Label label;
+    label.image = labelImage(key, bounds.size());
+    label.topLeft = bounds.topLeft();
+    label.phase = phase;
+    label.textSize = textRect.size();
+    {
+        QPainter painter(&label.image);
+        painter.setRenderHint(QPainter::TextAntialiasing, key.antialiased);
+        painter.translate(phase - bounds.topLeft());
+        painter.rotate(key.rotation);
+        const QColor color = QColor::fromRgba(key.color);
+        painter.setPen(color);
+        if (key.flags == DocumentLayout) {
+            document.documentLayout()->setPaintDevice(&label.image);
+            QAbstractTextDocumentLayout::PaintContext context;
+            context.palette.setColor(QPalette::Text, color);
+            document.documentLayout()->draw(&painter, context);
+        } else {
+            painter.setFont(font);
+            painter.drawText(key.rect, key.flags, key.text);
+        }
+    }
+
+    cache.insert(key, label);
+    return label;
+}
+
+bool LabelCache::Private::drawText(QPainter *painter, const QPointF &origin, qreal rotation,
+                                   const QRectF &rect, int flags, const QString &text)
+{
+    const QPen pen = painter->pen();
+    if (pen.style() == Qt::NoPen || pen.brush().style() != Qt::SolidPattern)
+        return false;
+
+    Label label;
+    {
+        const QMutexLocker locker(&cache.mutex);
+        if (!cache.isUsable(painter))
+            return false;
+        label = lookup(key(painter, origin, text, painter->font(), pen.color(), flags, rect, rotation),
+                       painter->font());
+    }
+    drawLabel(painter, origin, label);
+    return true;
+}
+
+bool LabelCache::Private::documentLabel(QPainter *painter, const QPointF &origin, const QString &text,
+                                        const QFont &font, const QColor &color, qreal rotation, Label *label)
+{
+    const QMutexLocker locker(&cache.mutex);
+    if (!cache.isUsable(painter))
+        return false;
+    *label = lookup(key(painter, origin, text, font, color, DocumentLayout, QRectF(), rotation), font);
+    return true;
+}
+
+void LabelCache::Private::drawLabel(QPainter *painter, const QPointF &origin, const Label &label)
+{
+    Cache::draw(painter, origin, label);
+}
+
+LabelCache::LabelCache()
+    : _d(new Private)
+{
+    d->cache.sprites.setMaxCost(4096);
+}
+
+LabelCache::~LabelCache()
+{
+    delete _d;
+    _d = nullptr;
+}
+
+LabelCache *LabelCache::instance()
+{
+    static LabelCache cache;
+    return &cache;
+}
+
+void LabelCache::setEnabled(bool enabled)
+{
+    d->cache.setEnabled(enabled);
+}
+
+bool LabelCache::isEnabled() const
+{
+    return d->cache.isEnabled();
+}
+
+void LabelCache::setMaximumSize(int kiloBytes)
+{
+    d->cache.setMaximumSize(kiloBytes);
+}
+
+int LabelCache::maximumSize() const
+{
+    return d->cache.maximumSize();
+}
+
+int LabelCache::size() const
+{
+    return d->cache.size();
+}
+
+int LabelCache::count() const
+{
+    return d->cache.count();
+}
+
+void LabelCache::clear()
+{
+    d->cache.clear();
+}
+
+int LabelCache::hitCount() const
+{
+    return d->cache.hits();
+}
+
+int LabelCache::missCount() const
+{
+    return d->cache.misses();
+}
+
+void LabelCache::resetStatistics()
+{
+    d->cache.resetStatistics();
+}
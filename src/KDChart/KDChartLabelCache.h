@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTLABELCACHE_H
+#define KDCHARTLABELCACHE_H
+
+#include "KDChartGlobal.h"
+
+namespace KDChart {
+
+/**
+ * @brief Process-wide cache of prerendered text labels
+ *
+ * Charts paint the same few strings over and over: axis tick labels like "0.5",
+ * legend entries, headers and data value texts. Shaping and rasterizing these
+ * texts again on every repaint is a large part of the painting time of charts
+ * with many labels.
+ *
+ * LabelCache keeps the rasterized images of recently painted labels, keyed by
+ * their text, font, color, rotation and the resolution and device pixel ratio of
+ * the paint device, and reuses them for all charts of the application. When the
+ * images take more memory than maximumSize(), the least recently used ones are
+ * dropped. The position of a label within its device pixel is part of the key too,
+ * so that cached labels look exactly like directly painted ones; labels at the same
+ * positions, as on every repaint of an unchanged chart, always hit the cache.
+ *
+ * Cached images are only used when painting on a raster device, e.g. a widget,
+ * QImage or QPixmap, with a transformation that is a translation. Printing, SVG and
+ * PDF output and QPicture recordings always paint the text itself, so they stay
+ * vector graphics. Rich text is never cached.
+ *
+ * \code
+ * KDChart::LabelCache *cache = KDChart::LabelCache::instance();
+ * cache->setMaximumSize( 16 * 1024 ); // 16 MB for many dashboards
+ * ...
+ * qDebug() << cache->hitCount() << "hits," << cache->missCount() << "misses";
+ * \endcode
+ */
+class KDCHART_EXPORT LabelCache
+{
+    Q_DISABLE_COPY(LabelCache)
+    KDCHART_DECLARE_PRIVATE_BASE_VALUE(LabelCache)
+
+public:
+    /**
+     * Returns the cache used by all charts of the application.
+     */
+    static LabelCache *instance();
+
+    /**
+     * Turns caching on or off. When turned off, the cache is cleared and all labels
+     * are painted directly. It is on by default.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * Sets the memory the cached images may take, in kilobytes. The default is 4096.
+     * Least recently used labels are dropped right away if the cache is larger.
+     */
+    void setMaximumSize(int kiloBytes);
+    int maximumSize() const;
+
+    /**
+     * Returns the memory taken by the cached images, in kilobytes.
+     */
+    int size() const;
+
+    /**
+     * Returns the number of cached labels.
+     */
+    int count() const;
+
+    /**
+     * Drops all cached labels. The statistics are kept.
+     */
+    void clear();
+
+    /**
+     * Returns how many labels were painted from the cache since the last
+     * call of resetStatistics().
+     */
+    int hitCount() const;
+
+    /**
+     * Returns how many labels had to be rendered because they were not in the
+     * cache, since the last call of resetStatistics().
+     */
+    int missCount() const;
+
+    void resetStatistics();
+
+private:
+    LabelCache();
+    ~LabelCache();
+};
+}
+
+#endif
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTLABELCACHE_P_H
+#define KDCHARTLABELCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "KDChartLabelCache.h"
+#include "KDChartSpriteCache_p.h"
+
+#include <QColor>
+#include <QFont>
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+#include <QSizeF>
+#include <QString>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+namespace KDChart {
+
+/**
+ * \internal
+ */
+class LabelCache::Private
+{
+public:
+    // everything that changes the pixels of a label
+    struct Key
+    {
+        QString text;
+        QString font; // QFont::key()
+        QRgb color;
+        int flags; // Qt::AlignmentFlag and Qt::TextFlag, or DocumentLayout
+        QRectF rect; // the rect of QPainter::drawText(), unused for DocumentLayout
+        qreal rotation;
+        qreal devicePixelRatio;
+        int dpiX;
+        int dpiY;
+        bool antialiased;
+        // the position of the origin within its device pixel, in 1/PhaseSteps pixels: glyphs
+        // are placed with that precision, so a label matches direct painting only at its phase
+        QPoint phase;
+
+        bool operator==(const Key &other) const;
+    };
+
+    struct Label : Sprite
+    {
+        QSizeF textSize; // unrotated
+    };
+
+    typedef SpriteCache<Key, Label> Cache;
+
+    static const int PhaseSteps = 64;
+
+    // the flags of labels that are laid out like a QTextDocument with plain text
+    static const int DocumentLayout = -1;
+
+    static Private *instance();
+
+    // Paints text as if painter->translate(origin); painter->rotate(rotation);
+    // painter->drawText(rect, flags, text) was called, with the painter's font and pen.
+    // Returns false without painting if the cache can not be used for painter.
+    bool drawText(QPainter *painter, const QPointF &origin, qreal rotation,
+                  const QRectF &rect, int flags, const QString &text);
+
+    // Looks up plain text laid out by a QTextDocument without margin, with its top left
+    // corner at the origin. Returns false if the cache can not be used for painter.
+    bool documentLabel(QPainter *painter, const QPointF &origin, const QString &text, const QFont &font,
+                       const QColor &color, qreal rotation, Label *label);
+    // paints a label returned by documentLabel() for origin
+    static void drawLabel(QPainter *painter, const QPointF &origin, const Label &label);
+
+    Cache cache;
+
+private:
+    Key key(QPainter *painter, const QPointF &origin, const QString &text, const QFont &font,
+            const QColor &color, int flags, const QRectF &rect, qreal rotation) const;
+    // the cached label for key, rendered first on a miss
+    Label lookup(const Key &key, const QFont &font);
+};
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint qHash(const LabelCache::Private::Key &key, uint seed = 0);
+#else
+size_t qHash(const LabelCache::Private::Key &key, size_t seed = 0);
+#endif
+}
+
+#endif
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartLabelCollisionIndex_p.h"
+
+#include <cmath>
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+static quint64 cellKey(int column, int row)
+{
+    return (quint64(quint32(column)) << 32) | quint32(row);
+}
+
+// the test that QPainterPath::intersects() starts with; unlike QRectF::intersects(),
+// touching and empty rects pass
+static bool mayIntersect(const QRectF &r1, const QRectF &r2)
+{
+    return qMax(r1.left(), r2.left()) <= qMin(r1.right(), r2.right())
+        && qMax(r1.top(), r2.top()) <= qMin(r1.bottom(), r2.bottom());
+}
+
+void LabelCollisionIndex::clear()
+{
+    m_entries.clear();
+    m_cellSize = 0.0;
+    m_cells.clear();
+    m_unbucketed.clear();
+    m_lastTested.clear();
+    m_query = 0;
+}
+
+bool LabelCollisionIndex::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+int LabelCollisionIndex::count() const
+{
+    return m_entries.count();
+}
+
+bool LabelCollisionIndex::cellRange(const QRectF &rect, int *left, int *top, int *right, int *bottom) const
+{
+    if (m_cellSize <= 0.0)
+        return false;
+    const qreal l = std::floor(rect.left() / m_cellSize);
+    const qreal t = std::floor(rect.top() / m_cellSize);
+    const qreal r = std::floor(rect.right() / m_cellSize);
+    const qreal b = std::floor(rect.bottom() / m_cellSize);
+    // also rejects NaN and infinite coordinates
+    if (!((r - l + 1) * (b - t + 1) <= MaxCellsPerEntry)
+        || qAbs(l) > 1e9 || qAbs(t) > 1e9 || qAbs(r) > 1e9 || qAbs(b) > 1e9)
+        return false;
+    *left = int(l);
+    *top = int(t);
+    *right = int(r);
+    *bottom = int(b);
+    return true;
+}
+
+bool LabelCollisionIndex::intersects(int entry, const QPainterPath &outline, const QRectF &boundingRect) const
+{
+    if (m_lastTested.at(entry) == m_query)
+        return false;
+    m_lastTested[entry] = m_query;
+    const Entry &e = m_entries.at(entry);
+    // QPainterPath::intersects() computes the bounding rects of both paths for every call
+    return mayIntersect(e.boundingRect, boundingRect) && e.outline.intersects(outline);
+}
+
+bool LabelCollisionIndex::intersects(const QPainterPath &outline) const
+{
+    if (m_entries.isEmpty())
+        return false;
+
+    ++m_query;
+    if (m_query == 0) {
+        // wrapped around, forget the old queries
+        m_lastTested.fill(0);
+        m_query = 1;
+    }
+
+    const QRectF boundingRect = outline.controlPointRect();
+    for (int entry : m_unbucketed) {
+        if (intersects(entry, outline, boundingRect))
+            return true;
+    }
+
+    int left, top, right, bottom;
+    if (!cellRange(boundingRect, &left, &top, &right, &bottom)) {
+        // too large to look up cell by cell, test everything
+        for (int entry = m_entries.count() - 1; entry >= 0; --entry) {
+            if (intersects(entry, outline, boundingRect))
+                return true;
+        }
+        return false;
+    }
+
+    for (int row = top; row <= bottom; ++row) {
+        for (int column = left; column <= right; ++column) {
+            const auto it = m_cells.constFind(cellKey(column, row));
+            if (it == m_cells.constEnd())
+                continue;
+            const QVector<int> &entries = it.value();
+            // recently added texts are more likely to overlap
+            for (int i = entries.count() - 1; i >= 0; --i) {
+                if (intersects(entries.at(i), outline, boundingRect))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void LabelCollisionIndex::insert(const QPainterPath &outline)
+{
+    const int entry = m_entries.count();
+    const QRectF boundingRect = outline.controlPointRect();
+    m_entries.append({ outline, boundingRect });
+    m_lastTested.append(0);
+
+    if (m_cellSize <= 0.0) {
+        const qreal size = 2.0 * qMax(boundingRect.width(), boundingRect.height());
+        if (size > 0.0 && !ISINF(size))
+            m_cellSize = size;
+    }
+
+    int left, top, right, bottom;
+    if (!cellRange(boundingRect, &left, &top, &right, &bottom)) {
+        m_unbucketed.append(entry);
+        return;
+    }
+    for (int row = top; row <= bottom; ++row) {
+        for (int column = left; column <= right; ++column) {
+            m_cells[cellKey(column, row)].append(entry);
+        }
+    }
+}
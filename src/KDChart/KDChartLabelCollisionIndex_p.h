@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTLABELCOLLISIONINDEX_P_H
+#define KDCHARTLABELCOLLISIONINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QHash>
+#include <QPainterPath>
+#include <QRectF>
+#include <QVector>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+// - the outlines of the data value texts painted so far, to skip texts that would overlap
+// - the outlines are bucketed into a uniform grid by their bounding rects, so a new text is
+// only tested against the outlines that share a grid cell with it, and those are compared by
+// their bounding rects before the exact (and expensive) QPainterPath::intersects()
+// - the cell size is taken from the first outline, data value texts are mostly of similar size
+class KDCHART_EXPORT LabelCollisionIndex
+{
+public:
+    void clear();
+    bool isEmpty() const;
+    int count() const;
+
+    // same as QPainterPath::intersects() with any of the inserted outlines
+    bool intersects(const QPainterPath &outline) const;
+    void insert(const QPainterPath &outline);
+
+private:
+    struct Entry
+    {
+        QPainterPath outline;
+        QRectF boundingRect;
+    };
+
+    // cells of a rect, false if it covers too many of them to be worth bucketing
+    bool cellRange(const QRectF &rect, int *left, int *top, int *right, int *bottom) const;
+    bool intersects(int entry, const QPainterPath &outline, const QRectF &boundingRect) const;
+
+    // outlines larger than this many cells are kept in m_unbucketed and always tested
+    static const int MaxCellsPerEntry = 64;
+
+    QVector<Entry> m_entries;
+    qreal m_cellSize = 0.0;
+    QHash<quint64, QVector<int>> m_cells;
+    QVector<int> m_unbucketed;
+    // the query that last tested an entry, so entries spanning several cells are tested once
+    mutable QVector<quint32> m_lastTested;
+    mutable quint32 m_query = 0;
+};
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include "KDChartAbstractDiagram.h"
 #include "KDChartBackgroundAttributes.h"
 #include "KDChartFrameAttributes.h"
+#include "KDChartLabelCache_p.h"
 #include "KDChartPaintContext.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPrintingParameters.h"
@@ -482,6 +483,18 @@ void KDChart::TextLayoutItem::paint(QPainter *painter)
     QSize innerSize = unrotatedTextSize();
     QRectF rect = QRectF(QPointF(0, 0), innerSize);
     rect.translate(-rect.center());
+
+    QTextDocument *document = mAttributes.textDocument();
+#ifndef DEBUG_ITEMS_PAINT
+    if (!document) {
+        painter->setPen(PrintingParameters::scalePen(mAttributes.pen()));
+        // tick labels and legend texts repeat a lot, see LabelCache
+        if (LabelCache::Private::instance()->drawText(painter, mRect.center(), mAttributes.rotation(),
+                                                     rect, mTextAlignment, mText))
+            return;
+    }
+#endif
+
     painter->translate(mRect.center());
     painter->rotate(mAttributes.rotation());
 #ifdef DEBUG_ITEMS_PAINT
@@ -490,7 +503,6 @@ void KDChart::TextLayoutItem::paint(QPainter *painter)
 #endif
 
     painter->setPen(PrintingParameters::scalePen(mAttributes.pen()));
-    QTextDocument *document = mAttributes.textDocument();
     if (document) {
         document->setPageSize(rect.size());
         document->setHtml(mText);
@@ -11,6 +11,7 @@
 #include "KDChartLegend.h"
 #include "KDChartLayoutItems.h"
 #include "KDChartLegend_p.h"
+#include "KDChartParallel_p.h"
 #include "KDTextDocument.h"
 #include <KDChartAbstractDiagram.h>
 #include <KDChartDiagramObserver.h>
@@ -23,11 +24,13 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QPainter>
+#include <QSet>
 #include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextDocumentFragment>
 #include <QTextTableCell>
 #include <QTimer>
+#include <QWheelEvent>
 #include <QtDebug>
 
 #include <KDABLibFakes>
@@ -198,7 +201,7 @@ bool Legend::compare(const Legend *other) const
         return false;
     }
 
-    return (AbstractAreaBase::compare(other)) && (isVisible() == other->isVisible()) && (position() == other->position()) && (alignment() == other->alignment()) && (textAlignment() == other->textAlignment()) && (floatingPosition() == other->floatingPosition()) && (orientation() == other->orientation()) && (showLines() == other->showLines()) && (texts() == other->texts()) && (brushes() == other->brushes()) && (pens() == other->pens()) && (markerAttributes() == other->markerAttributes()) && (useAutomaticMarkerSize() == other->useAutomaticMarkerSize()) && (textAttributes() == other->textAttributes()) && (titleText() == other->titleText()) && (titleTextAttributes() == other->titleTextAttributes()) && (spacing() == other->spacing()) && (legendStyle() == other->legendStyle());
+    return (AbstractAreaBase::compare(other)) && (isVisible() == other->isVisible()) && (position() == other->position()) && (alignment() == other->alignment()) && (textAlignment() == other->textAlignment()) && (floatingPosition() == other->floatingPosition()) && (orientation() == other->orientation()) && (showLines() == other->showLines()) && (texts() == other->texts()) && (brushes() == other->brushes()) && (pens() == other->pens()) && (markerAttributes() == other->markerAttributes()) && (useAutomaticMarkerSize() == other->useAutomaticMarkerSize()) && (textAttributes() == other->textAttributes()) && (titleText() == other->titleText()) && (titleTextAttributes() == other->titleTextAttributes()) && (spacing() == other->spacing()) && (legendStyle() == other->legendStyle()) && (maximumVisibleEntries() == other->maximumVisibleEntries());
 }
 
 void Legend::paint(QPainter *painter)
@@ -823,11 +826,11 @@ QSizeF Legend::Private::markerSize(Legend *q, int dataset, qreal fontHeight) con
     }
 }
 
-QSizeF Legend::Private::maxMarkerSize(Legend *q, qreal fontHeight) const
+QSizeF Legend::Private::maxMarkerSize(Legend *q, qreal fontHeight, int first, int end) const
 {
     QSizeF ret(1.0, 1.0);
     if (q->legendStyle() != LinesOnly) {
-        for (int dataset = 0; dataset < modelLabels.count(); ++dataset) {
+        for (int dataset = first; dataset < end; ++dataset) {
             ret = ret.expandedTo(markerSize(q, dataset, fontHeight));
         }
     }
@@ -838,6 +841,13 @@ HDatasetItem::HDatasetItem()
 {
 }
 
+bool DatasetSymbol::operator==(const DatasetSymbol &other) const
+{
+    return diagram == other.diagram && legendStyle == other.legendStyle
+        && markerAttributes == other.markerAttributes && markerBrush == other.markerBrush
+        && pen == other.pen && lineLength == other.lineLength && lineAlignment == other.lineAlignment;
+}
+
 static void updateToplevelLayout(QWidget *w)
 {
     while (w) {
@@ -875,6 +885,16 @@ void Legend::buildLegend()
         orientation() == Qt::Vertical ? KDChartEnums::MeasureOrientationMinimum
                                       : KDChartEnums::MeasureOrientationHorizontal;
 
+    // the range of entries to lay out, all of them unless scrolling through them
+    int first = 0;
+    int end = d->modelLabels.count();
+    if (d->maximumVisibleEntries > 0 && end > d->maximumVisibleEntries) {
+        d->firstVisibleEntry = qBound(0, d->firstVisibleEntry, end - d->maximumVisibleEntries);
+        first = d->firstVisibleEntry;
+        end = first + d->maximumVisibleEntries;
+    }
+    const int entryCount = end - first;
+
     // legend caption
     if (!titleText().isEmpty() && titleTextAttributes().isVisible()) {
         auto *titleItem =
@@ -886,7 +906,7 @@ void Legend::buildLegend()
         d->layout->addItem(titleItem, 0, 0, 1, 5, Qt::AlignCenter);
 
         // The line between the title and the legend items, if any.
-        if (showLines() && d->modelLabels.count()) {
+        if (showLines() && entryCount) {
             auto *lineItem = new HorizontalLineLayoutItem;
             d->paintItems << lineItem;
             d->layout->addItem(lineItem, 1, 0, 1, 5, Qt::AlignCenter);
@@ -904,7 +924,7 @@ void Legend::buildLegend()
         }
     }
 
-    const QSizeF maxMarkerSize = d->maxMarkerSize(this, fontHeight);
+    const QSizeF maxMarkerSize = d->maxMarkerSize(this, fontHeight, first, end);
 
     // If we show a marker on a line, we paint it after 8 pixels
     // of the line have been painted. This allows to see the line style
@@ -916,7 +936,7 @@ void Legend::buildLegend()
     int maxLineLength = 18;
     {
         bool hasComplexPenStyle = false;
-        for (int dataset = 0; dataset < d->modelLabels.count(); ++dataset) {
+        for (int dataset = first; dataset < end; ++dataset) {
             const QPen pn = pen(dataset);
             const Qt::PenStyle ps = pn.style();
             if (ps != Qt::NoPen) {
@@ -933,8 +953,8 @@ void Legend::buildLegend()
 
     // for all datasets: add (line)marker items and text items to the layout;
     // actual layout happens in flowHDatasetItems() for horizontal layout, here for vertical
-    for (int dataset = 0; dataset < d->modelLabels.count(); ++dataset) {
-        const int vLayoutRow = 2 + dataset * 2;
+    for (int dataset = first; dataset < end; ++dataset) {
+        const int vLayoutRow = 2 + (dataset - first) * 2;
         HDatasetItem dsItem;
 
         // It is possible to set the marker brush through markerAttributes as well as
@@ -943,27 +963,60 @@ void Legend::buildLegend()
         markerAttrs.setMarkerSize(d->markerSize(this, dataset, fontHeight));
         const QBrush markerBrush = markerAttrs.markerColor().isValid() ? QBrush(markerAttrs.markerColor()) : brush(dataset);
 
-        switch (legendStyle()) {
-        case MarkersOnly:
-            dsItem.markerLine = new MarkerLayoutItem(diagram(), markerAttrs, markerBrush,
-                                                     markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter);
-            break;
-        case LinesOnly:
-            dsItem.markerLine = new LineLayoutItem(diagram(), maxLineLength, pen(dataset),
-                                                   d->legendLineSymbolAlignment, Qt::AlignCenter);
-            break;
-        case MarkersAndLines:
-            dsItem.markerLine = new LineWithMarkerLayoutItem(
-                diagram(), maxLineLength, pen(dataset), lineLengthLeftOfMarker, markerAttrs,
-                markerBrush, markerAttrs.pen(), Qt::AlignCenter);
-            break;
-        default:
-            Q_ASSERT(false);
+        DatasetSymbol symbol;
+        symbol.diagram = diagram();
+        symbol.legendStyle = legendStyle();
+        symbol.markerAttributes = markerAttrs;
+        symbol.markerBrush = markerBrush;
+        symbol.pen = pen(dataset);
+        symbol.lineLength = maxLineLength;
+        symbol.lineAlignment = d->legendLineSymbolAlignment;
+
+        const QString labelText = text(dataset);
+        DatasetItems items = d->takeReusableItems(labelText);
+        if (items.markerLine && !(items.symbol == symbol)) {
+            delete items.markerLine;
+            items.markerLine = nullptr;
+        }
+        if (items.label && (items.measureOrientation != measureOrientation
+                            || items.label->textAttributes() != textAttributes()
+                            || items.label->autoReferenceArea() != referenceArea())) {
+            delete items.label;
+            items.label = nullptr;
+        }
+        items.symbol = symbol;
+        items.measureOrientation = measureOrientation;
+
+        if (!items.markerLine) {
+            switch (legendStyle()) {
+            case MarkersOnly:
+                items.markerLine = new MarkerLayoutItem(diagram(), markerAttrs, markerBrush,
+                                                        markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter);
+                break;
+            case LinesOnly:
+                items.markerLine = new LineLayoutItem(diagram(), maxLineLength, pen(dataset),
+                                                      d->legendLineSymbolAlignment, Qt::AlignCenter);
+                break;
+            case MarkersAndLines:
+                items.markerLine = new LineWithMarkerLayoutItem(
+                    diagram(), maxLineLength, pen(dataset), lineLengthLeftOfMarker, markerAttrs,
+                    markerBrush, markerAttrs.pen(), Qt::AlignCenter);
+                break;
+            default:
+                Q_ASSERT(false);
+            }
         }
 
-        dsItem.label = new TextLayoutItem(text(dataset), textAttributes(), referenceArea(),
-                                          measureOrientation, d->textAlignment);
-        dsItem.label->setParentWidget(this);
+        if (items.label) {
+            items.label->setTextAlignment(d->textAlignment);
+        } else {
+            items.label = new TextLayoutItem(labelText, textAttributes(), referenceArea(),
+                                             measureOrientation, d->textAlignment);
+            items.label->setParentWidget(this);
+        }
+        d->datasetItems << items;
+        dsItem.markerLine = items.markerLine;
+        dsItem.label = items.label;
 
         // horizontal layout is deferred to flowDatasetItems()
 
@@ -982,22 +1035,25 @@ void Legend::buildLegend()
         d->paintItems << dsItem.label;
 
         // horizontal separator line, only between items
-        if (showLines() && dataset != d->modelLabels.count() - 1) {
+        if (showLines() && dataset != end - 1) {
             auto *lineItem = new HorizontalLineLayoutItem;
             d->layout->addItem(lineItem, vLayoutRow + 1, 0, 1, 5, Qt::AlignCenter);
             d->paintItems << lineItem;
         }
     }
 
+    // the items of datasets that are gone or not shown anymore
+    d->deleteReusableItems();
+
     if (orientation() == Qt::Horizontal) {
         d->flowHDatasetItems(this);
     }
 
     // vertical line (only in vertical mode)
-    if (orientation() == Qt::Vertical && showLines() && d->modelLabels.count()) {
+    if (orientation() == Qt::Vertical && showLines() && entryCount) {
         auto *lineItem = new VerticalLineLayoutItem;
         d->paintItems << lineItem;
-        d->layout->addItem(lineItem, 2, 2, d->modelLabels.count() * 2, 1);
+        d->layout->addItem(lineItem, 2, 2, entryCount * 2, 1);
     }
 
     updateToplevelLayout(this);
@@ -1051,7 +1107,7 @@ void Legend::Private::flowHDatasetItems(Legend *q)
 
     const int allowedWidth = q->areaGeometry().width();
 
-    auto *currentLine = new QHBoxLayout;
+    auto *currentLine = adoptLayout(new QHBoxLayout, q);
     int mainLayoutRow = 1;
     layout->addItem(currentLine, mainLayoutRow++, /*column*/ 0,
                     /*rowSpan*/ 1, /*columnSpan*/ 5, Qt::AlignLeft | Qt::AlignVCenter);
@@ -1072,7 +1128,7 @@ void Legend::Private::flowHDatasetItems(Legend *q)
                          << currentLine->sizeHint().width() + separatorWidth + payloadWidth
                          << allowedWidth;
 #endif
-                currentLine = new QHBoxLayout;
+                currentLine = adoptLayout(new QHBoxLayout, q);
                 layout->addItem(currentLine, mainLayoutRow++, /*column*/ 0,
                                 /*rowSpan*/ 1, /*columnSpan*/ 5, Qt::AlignLeft | Qt::AlignVCenter);
             } else {
@@ -1163,16 +1219,112 @@ int Legend::heightForWidth(int width) const
 
 void Legend::Private::destroyOldLayout()
 {
-    // in the horizontal layout case, the QHBoxLayout destructor also deletes child layout items
-    // (it isn't documented that QLayoutItems delete their children)
+    // keep the items of the datasets for the next build, and delete all others;
+    // in the horizontal layout case, the QHBoxLayout destructor would also delete
+    // its child layout items (it isn't documented that QLayoutItems delete their children)
+    QSet<QLayoutItem *> datasetLayoutItems;
+    Q_FOREACH (const DatasetItems &items, datasetItems) {
+        datasetLayoutItems << items.markerLine << items.label;
+    }
+    QSet<QLayoutItem *> keptItems;
+    auto keepOrDelete = [&datasetLayoutItems, &keptItems](QLayoutItem *item) {
+        if (datasetLayoutItems.contains(item)) {
+            keptItems << item;
+        } else {
+            delete item;
+        }
+    };
     for (int i = layout->count() - 1; i >= 0; i--) {
-        delete layout->takeAt(i);
+        QLayoutItem *const item = layout->takeAt(i);
+        if (QLayout *const hbox = item->layout()) {
+            for (int j = hbox->count() - 1; j >= 0; j--) {
+                keepOrDelete(hbox->takeAt(j));
+            }
+        }
+        keepOrDelete(item);
     }
     Q_ASSERT(!layout->count());
+
+    // items not found in the layout belong to another legend this one was cloned from
+    Q_FOREACH (const DatasetItems &items, datasetItems) {
+        if (keptItems.contains(items.markerLine) && keptItems.contains(items.label)) {
+            reusableItems.insert(items.label->text(), items);
+        } else if (keptItems.contains(items.markerLine)) {
+            delete items.markerLine;
+        } else if (keptItems.contains(items.label)) {
+            delete items.label;
+        }
+    }
+    datasetItems.clear();
     hLayoutDatasets.clear();
     paintItems.clear();
 }
 
+DatasetItems Legend::Private::takeReusableItems(const QString &text)
+{
+    const auto it = reusableItems.find(text);
+    if (it == reusableItems.end()) {
+        return DatasetItems();
+    }
+    const DatasetItems items = it.value();
+    reusableItems.erase(it);
+    return items;
+}
+
+void Legend::Private::deleteReusableItems()
+{
+    Q_FOREACH (const DatasetItems &items, reusableItems) {
+        delete items.markerLine;
+        delete items.label;
+    }
+    reusableItems.clear();
+}
+
+void Legend::setMaximumVisibleEntries(int count)
+{
+    count = qMax(0, count);
+    if (d->maximumVisibleEntries == count) {
+        return;
+    }
+    d->maximumVisibleEntries = count;
+    setNeedRebuild();
+    update();
+}
+
+int Legend::maximumVisibleEntries() const
+{
+    return d->maximumVisibleEntries;
+}
+
+void Legend::setFirstVisibleEntry(int index)
+{
+    index = qMax(0, index);
+    if (d->firstVisibleEntry == index) {
+        return;
+    }
+    d->firstVisibleEntry = index;
+    if (d->maximumVisibleEntries > 0) {
+        setNeedRebuild();
+        update();
+    }
+}
+
+int Legend::firstVisibleEntry() const
+{
+    return d->firstVisibleEntry;
+}
+
+void Legend::wheelEvent(QWheelEvent *event)
+{
+    const int steps = event->angleDelta().y() / 120;
+    if (d->maximumVisibleEntries <= 0 || steps == 0) {
+        AbstractAreaWidget::wheelEvent(event);
+        return;
+    }
+    setFirstVisibleEntry(d->firstVisibleEntry - steps);
+    event->accept();
+}
+
 void Legend::setHiddenDatasets(const QList<uint> &hiddenDatasets)
 {
     d->hiddenDatasets = hiddenDatasets;
@@ -369,6 +369,26 @@ m_legend->setFloatingPosition( relativePosition );
     void setSpacing(uint space);
     uint spacing() const;
 
+    /**
+     * Shows at most \a count entries at a time, for diagrams with many datasets.
+     *
+     * Only the shown entries are laid out and measured, so the cost of building
+     * the legend does not grow with the number of datasets. The shown entries can
+     * be scrolled with the mouse wheel or with setFirstVisibleEntry().
+     *
+     * The default is 0, which shows all entries.
+     */
+    void setMaximumVisibleEntries(int count);
+    int maximumVisibleEntries() const;
+
+    /**
+     * Sets the index of the first shown entry, in the order the legend shows them,
+     * if the number of shown entries is limited by setMaximumVisibleEntries().
+     * The index is kept in the range that fills the legend.
+     */
+    void setFirstVisibleEntry(int index);
+    int firstVisibleEntry() const;
+
     // called internally by KDChart::Chart, when painting into a custom QPainter
     void forceRebuild() override;
 
@@ -379,6 +399,9 @@ m_legend->setFloatingPosition( relativePosition );
     void needSizeHint() override;
     void resizeLayout(const QSize &size) override;
 
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+
 Q_SIGNALS:
     void destroyedLegend(Legend *);
     /** Emitted upon change of a property of the Legend or any of its components. */
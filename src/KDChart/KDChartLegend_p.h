@@ -28,8 +28,11 @@
 #include <KDChartMarkerAttributes.h>
 #include <KDChartTextAttributes.h>
 #include <QAbstractTextDocumentLayout>
+#include <QBrush>
+#include <QHash>
 #include <QList>
 #include <QPainter>
+#include <QPen>
 #include <QVector>
 
 #include <KDABLibFakes>
@@ -57,6 +60,30 @@ struct HDatasetItem
     QSpacerItem *spacer = nullptr;
 };
 
+// what the marker or line item of a dataset shows
+struct DatasetSymbol
+{
+    const AbstractDiagram *diagram = nullptr;
+    int legendStyle = 0;
+    MarkerAttributes markerAttributes;
+    QBrush markerBrush;
+    QPen pen;
+    int lineLength = 0;
+    Qt::Alignment lineAlignment;
+
+    bool operator==(const DatasetSymbol &other) const;
+};
+
+// the layout items of a dataset, reused by the next build of the legend if they
+// still show the same, so unchanged texts are not measured again
+struct DatasetItems
+{
+    DatasetSymbol symbol;
+    KDChartEnums::MeasureOrientation measureOrientation = KDChartEnums::MeasureOrientationMinimum;
+    AbstractLayoutItem *markerLine = nullptr;
+    TextLayoutItem *label = nullptr;
+};
+
 class DiagramsObserversList : public QList<DiagramObserver *>
 {
 };
@@ -84,10 +111,18 @@ public:
 
     void fetchPaintOptions(Legend *q);
     QSizeF markerSize(Legend *q, int dataset, qreal fontHeight) const;
-    QSizeF maxMarkerSize(Legend *q, qreal fontHeight) const;
+    QSizeF maxMarkerSize(Legend *q, qreal fontHeight, int first, int end) const;
     void reflowHDatasetItems(Legend *q);
     void flowHDatasetItems(Legend *q);
     void destroyOldLayout();
+    DatasetItems takeReusableItems(const QString &text);
+    void deleteReusableItems();
+
+    // the items of the shown entries, as built last
+    const QList<DatasetItems> &shownDatasetItems() const
+    {
+        return datasetItems;
+    }
 
 private:
     // user-settable
@@ -111,6 +146,8 @@ private:
     uint spacing = 1;
     bool useAutomaticMarkerSize = true;
     LegendStyle legendStyle = MarkersOnly;
+    int maximumVisibleEntries = 0;
+    int firstVisibleEntry = 0;
 
     // internal
     mutable QStringList modelLabels;
@@ -121,6 +158,8 @@ private:
     QVector<AbstractLayoutItem *> paintItems;
     QGridLayout *layout;
     QList<HDatasetItem> hLayoutDatasets;
+    QList<DatasetItems> datasetItems; // of the shown entries, in the layout
+    QMultiHash<QString, DatasetItems> reusableItems; // by text, while building the legend
     DiagramsObserversList observers;
 };
 
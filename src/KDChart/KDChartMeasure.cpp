@@ -171,7 +171,8 @@ GlobalMeasureScaling::~GlobalMeasureScaling()
 
 GlobalMeasureScaling *GlobalMeasureScaling::instance()
 {
-    static GlobalMeasureScaling instance;
+    // one per thread, a ChartRenderer paints charts on several threads at once
+    static thread_local GlobalMeasureScaling instance;
     return &instance;
 }
 
@@ -149,6 +149,9 @@ private:
  * rectangle's size.
  *
  * Default factors are (1.0, 1.0)
+ *
+ * The factors and the paint device are per thread, so charts can be
+ * painted in several threads at the same time.
  */
 class GlobalMeasureScaling
 {
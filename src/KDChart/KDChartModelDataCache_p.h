@@ -15,8 +15,10 @@
 
 #include <QModelIndex>
 #include <QObject>
+#include <QVariant>
 #include <QVector>
 
+#include "KDChartColumnarDataSource.h"
 #include "kdchart_export.h"
 
 QT_BEGIN_NAMESPACE
@@ -82,6 +84,18 @@ inline qreal nan<qreal>()
 {
     return std::numeric_limits<qreal>::quiet_NaN();
 }
+
+template<class T>
+T fromColumnarValue(double value)
+{
+    return QVariant::fromValue(value).value<T>();
+}
+
+template<>
+inline qreal fromColumnarValue<qreal>(double value)
+{
+    return value;
+}
 }
 
 template<class T, int ROLE>
@@ -102,6 +116,9 @@ public:
         if (!index.isValid() || index.parent() != m_rootIndex || index.row() >= m_model->rowCount(m_rootIndex) || index.column() >= m_model->columnCount(m_rootIndex))
             return ModelDataCachePrivate::nan<T>();
 
+        if (m_columnarSource)
+            return data(index.row(), index.column());
+
         if (index.row() >= m_data.count()) {
             qWarning("KDChart didn't receive signal rowsInserted, resetModel or layoutChanged, "
                      "but an index with a row outside of the known bounds.");
@@ -135,6 +152,16 @@ public:
         Q_ASSERT(row < m_model->rowCount(m_rootIndex));
         Q_ASSERT(column < m_model->columnCount(m_rootIndex));
 
+        if (m_columnarSource) {
+            // no need to cache anything, the source hands out its arrays directly
+            if (const double *values = m_columnarSource->columnData(column))
+                return ModelDataCachePrivate::fromColumnarValue<T>(values[row]);
+            // the column is not available as an array; nothing is cached for columnar
+            // sources, which keeps appending and removing rows cheap
+            const QVariant data = m_model->index(row, column, m_rootIndex).data(ROLE);
+            return data.isNull() ? ModelDataCachePrivate::nan<T>() : data.value<T>();
+        }
+
         Q_ASSERT(row < m_data.count());
         Q_ASSERT(column < m_data.first().count());
 
@@ -175,6 +202,14 @@ public:
     }
 
 protected:
+    void updateColumnarSource()
+    {
+        // columnar sources only provide the display values of the top-level table
+        m_columnarSource = (ROLE == Qt::DisplayRole && !m_rootIndex.isValid())
+            ? ColumnarDataSource::fromModel(m_model)
+            : nullptr;
+    }
+
     bool isCached(int row, int column) const
     {
         return m_cacheValid.at(row).at(column);
@@ -200,7 +235,7 @@ protected:
         Q_ASSERT(m_model != nullptr);
         Q_ASSERT(parent.model() == m_model || !parent.isValid());
 
-        if (parent != m_rootIndex)
+        if (parent != m_rootIndex || m_columnarSource)
             return;
 
         Q_ASSERT(start <= end);
@@ -220,7 +255,7 @@ protected:
         Q_ASSERT(m_model != nullptr);
         Q_ASSERT(parent.model() == m_model || !parent.isValid());
 
-        if (parent != m_rootIndex)
+        if (parent != m_rootIndex || m_columnarSource)
             return;
 
         Q_ASSERT(start <= end);
@@ -241,7 +276,7 @@ protected:
         Q_ASSERT(m_model != nullptr);
         Q_ASSERT(topLeft.parent() == bottomRight.parent());
 
-        if (!topLeft.isValid() || !bottomRight.isValid() || topLeft.parent() != m_rootIndex)
+        if (!topLeft.isValid() || !bottomRight.isValid() || topLeft.parent() != m_rootIndex || m_columnarSource)
             return;
 
         Q_ASSERT(topLeft.model() == m_model && bottomRight.model() == m_model);
@@ -273,8 +308,9 @@ protected:
     {
         m_data.clear();
         m_cacheValid.clear();
+        updateColumnarSource();
 
-        if (m_model == nullptr)
+        if (m_model == nullptr || m_columnarSource)
             return;
 
         m_data.fill(QVector<T>(m_model->columnCount(m_rootIndex)), m_model->rowCount(m_rootIndex));
@@ -289,7 +325,7 @@ protected:
         Q_ASSERT(m_model != nullptr);
         Q_ASSERT(parent.model() == m_model || !parent.isValid());
 
-        if (parent != m_rootIndex || start >= m_model->rowCount(m_rootIndex))
+        if (parent != m_rootIndex || start >= m_model->rowCount(m_rootIndex) || m_columnarSource)
             return;
 
         Q_ASSERT(start <= end);
@@ -307,7 +343,7 @@ protected:
         Q_ASSERT(m_model != nullptr);
         Q_ASSERT(parent.model() == m_model || !parent.isValid());
 
-        if (parent != m_rootIndex || start >= m_data.count())
+        if (parent != m_rootIndex || start >= m_data.count() || m_columnarSource)
             return;
 
         Q_ASSERT(start <= end);
@@ -329,6 +365,7 @@ protected:
 private:
     QAbstractItemModel *m_model = nullptr;
     QModelIndex m_rootIndex;
+    const ColumnarDataSource *m_columnarSource = nullptr;
     ModelDataCachePrivate::ModelSignalMapperConnector m_connector;
     mutable QVector<QVector<T>> m_data;
     mutable QVector<QVector<bool>> m_cacheValid;
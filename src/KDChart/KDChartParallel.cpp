@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartParallel_p.h"
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <memory>
+
+#include <KDABLibFakes>
+
+namespace KDChart {
+
+void parallelFor(int count, int threshold, const std::function<void(int begin, int end)> &work)
+{
+    if (count <= 0)
+        return;
+    const int chunkCount = count < threshold ? 1 : qBound(1, QThread::idealThreadCount(), count);
+    if (chunkCount == 1) {
+        work(0, count);
+        return;
+    }
+
+    // The chunks are claimed from a shared counter, by the pool threads and by the calling
+    // thread, which does not wait for a chunk no thread has started. So all chunks run in
+    // the calling thread if the pool is busy, or if this is called from a pool thread,
+    // instead of waiting for threads that never come. The state outlives this call for
+    // pool threads that start only after all chunks were claimed; those do not touch work.
+    struct State
+    {
+        QAtomicInt next;
+        QSemaphore done;
+    };
+    const auto state = std::make_shared<State>();
+    const int chunkSize = (count + chunkCount - 1) / chunkCount;
+    const auto runChunks = [state, &work, chunkCount, chunkSize, count]() {
+        int ran = 0;
+        for (int chunk = state->next.fetchAndAddOrdered(1); chunk < chunkCount;
+             chunk = state->next.fetchAndAddOrdered(1)) {
+            work(chunk * chunkSize, qMin((chunk + 1) * chunkSize, count));
+            ++ran;
+        }
+        return ran;
+    };
+
+    QThreadPool *const pool = QThreadPool::globalInstance();
+    for (int helper = 1; helper < chunkCount; ++helper) {
+        // no queuing behind other work, a chunk without a free thread is done here
+        if (!pool->tryStart([state, runChunks]() { state->done.release(runChunks()); }))
+            break;
+    }
+    const int ranHere = runChunks();
+    // the remaining chunks were claimed by threads that are running them
+    state->done.acquire(chunkCount - ranHere);
+}
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTPARALLEL_P_H
+#define KDCHARTPARALLEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QObject>
+#include <QThread>
+
+#include <functional>
+
+namespace KDChart {
+
+// Calls work(begin, end) for consecutive chunks that together cover [0, count), and returns
+// when all of them are done. With count >= threshold the chunks run on the free threads of
+// QThreadPool::globalInstance() and in the calling thread, else there is a single chunk
+// that runs in the calling thread. It never waits for a busy pool, so it may be called
+// from pool threads. work must not touch models, diagrams or other QObjects.
+void parallelFor(int count, int threshold, const std::function<void(int begin, int end)> &work);
+
+// Returns layout, which was just created, after moving it to the thread of owner. A chart
+// rebuilds parts of its layout tree while it is painted, and a ChartRenderer paints charts
+// on pool threads; QObject refuses to parent the new layouts to ones of another thread.
+template<typename Layout>
+Layout *adoptLayout(Layout *layout, const QObject *owner)
+{
+    if (layout->thread() != owner->thread())
+        layout->moveToThread(owner->thread());
+    return layout;
+}
+}
+
+#endif
@@ -18,7 +18,8 @@ PrintingParameters::PrintingParameters()
 
 PrintingParameters *PrintingParameters::instance()
 {
-    static PrintingParameters instance;
+    // one per thread, like GlobalMeasureScaling::instance()
+    static thread_local PrintingParameters instance;
     return &instance;
 }
 
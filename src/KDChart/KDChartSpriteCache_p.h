@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTSPRITECACHE_P_H
+#define KDCHARTSPRITECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPaintDevice>
+#include <QPaintEngine>
+#include <QPainter>
+#include <QPoint>
+#include <QPointF>
+#include <QTransform>
+
+#include <cmath>
+
+namespace KDChart {
+
+/**
+ * \internal
+ *
+ * An image painted at a point, e.g. a label at its origin or a symbol at its center.
+ * Sprites are rendered for the position of the point within its device pixel, its
+ * phase, so that a copy blitted to whole device pixels looks like painting the
+ * original there directly.
+ */
+struct Sprite
+{
+    QImage image;
+    QPointF topLeft; // of the image, relative to the point moved back by phase
+    QPointF phase; // the offset of the point in the image, less than a device pixel
+};
+
+/**
+ * \internal
+ *
+ * The state of a process-wide cache of sprites, shared by LabelCache and SymbolCache.
+ * Key describes everything that changes the pixels of a sprite, including its phase,
+ * Value is a Sprite. The members without a lock of their own must be used with mutex
+ * locked.
+ */
+template<typename Key, typename Value>
+class SpriteCache
+{
+public:
+    // Other engines (printers, SVG, PDF, QPicture) keep vector graphics,
+    // and sprites can only be placed with translations.
+    bool isUsable(QPainter *painter) const
+    {
+        const QPaintEngine *const engine = painter->paintEngine();
+        return enabled && engine && engine->type() == QPaintEngine::Raster
+            && painter->combinedTransform().type() <= QTransform::TxTranslate;
+    }
+
+    // the cached sprite for key, or nullptr if it has to be rendered and inserted
+    const Value *find(const Key &key)
+    {
+        const Value *const cached = sprites.object(key);
+        if (cached)
+            ++hitCount;
+        else
+            ++missCount;
+        return cached;
+    }
+
+    void insert(const Key &key, const Value &sprite)
+    {
+        // sprites larger than the whole cache are not kept, QCache deletes them right away
+        const int cost = qMax(1, int(sprite.image.sizeInBytes() / 1024));
+        sprites.insert(key, new Value(sprite), cost);
+    }
+
+    // The position of point within its device pixel on the device of painter,
+    // in 1/steps of a device pixel
+    static QPoint phase(QPainter *painter, const QPointF &point, int steps)
+    {
+        const QPointF devicePoint = painter->combinedTransform().map(point) * painter->device()->devicePixelRatioF();
+        const int x = qRound(devicePoint.x() * steps);
+        const int y = qRound(devicePoint.y() * steps);
+        return QPoint(((x % steps) + steps) % steps, ((y % steps) + steps) % steps);
+    }
+
+    // Paints sprite for point. The image starts on a device pixel, the point in it
+    // is at the point's offset within its pixel.
+    static void draw(QPainter *painter, const QPointF &point, const Sprite &sprite)
+    {
+        const QPointF position = point - sprite.phase + sprite.topLeft;
+        const qreal ratio = painter->device()->devicePixelRatioF();
+        const QPointF devicePosition = painter->combinedTransform().map(position) * ratio;
+        const QPointF snapped(std::round(devicePosition.x()), std::round(devicePosition.y()));
+        painter->drawImage(position + (snapped - devicePosition) / ratio, sprite.image);
+    }
+
+    // the public API of the caches
+    void setEnabled(bool on)
+    {
+        const QMutexLocker locker(&mutex);
+        enabled = on;
+        if (!on)
+            sprites.clear();
+    }
+
+    bool isEnabled() const
+    {
+        const QMutexLocker locker(&mutex);
+        return enabled;
+    }
+
+    void setMaximumSize(int kiloBytes)
+    {
+        const QMutexLocker locker(&mutex);
+        sprites.setMaxCost(qMax(0, kiloBytes));
+    }
+
+    int maximumSize() const
+    {
+        const QMutexLocker locker(&mutex);
+        return sprites.maxCost();
+    }
+
+    int size() const
+    {
+        const QMutexLocker locker(&mutex);
+        return sprites.totalCost();
+    }
+
+    int count() const
+    {
+        const QMutexLocker locker(&mutex);
+        return sprites.count();
+    }
+
+    void clear()
+    {
+        const QMutexLocker locker(&mutex);
+        sprites.clear();
+    }
+
+    int hits() const
+    {
+        const QMutexLocker locker(&mutex);
+        return hitCount;
+    }
+
+    int misses() const
+    {
+        const QMutexLocker locker(&mutex);
+        return missCount;
+    }
+
+    void resetStatistics()
+    {
+        const QMutexLocker locker(&mutex);
+        hitCount = 0;
+        missCount = 0;
+    }
+
+    mutable QMutex mutex;
+    QCache<Key, Value> sprites; // cost in kilobytes
+    bool enabled = true;
+    int hitCount = 0;
+    int missCount = 0;
+};
+}
+
+#endif
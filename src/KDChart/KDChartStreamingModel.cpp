@@ -0,0 +1,380 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartStreamingModel.h"
+
+#include "KDChartAttributesModel.h"
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+class StreamingModel::Private
+{
+public:
+    // A queue of the samples pushed to one dataset, with one producer (the thread that
+    // pushes) and one consumer (the thread of the model). Each side only writes its own
+    // index; the indices count samples and wrap around, the buffer size is a power of two.
+    struct SampleRing
+    {
+        std::unique_ptr<double[]> samples;
+        QAtomicInteger<uint> head; // the next sample to write
+        QAtomicInteger<uint> tail; // the next sample to read
+    };
+
+    // grows all buffers to hold rowCount rows, new rows are missing values
+    void resizeRows(int rowCount);
+    // one empty ring per dataset with ingestionBufferSize samples each
+    void allocateRings();
+
+    // The rows of the model are [offset, offset + rowCount) of each buffer. Removed rows
+    // only move the offset; the buffers are compacted once the unused part at their start
+    // is larger than the used one, which keeps removal at O(1) amortized.
+    QVector<QVector<double>> buffers;
+    QVector<int> lengths; // the number of rows filled by each dataset
+    int offset = 0;
+    int rowCount = 0;
+    int maximumHistory = 0;
+    qint64 evicted = 0;
+
+    std::vector<std::unique_ptr<SampleRing>> rings;
+    uint ingestionBufferSize = 0;
+    int ingestionInterval = 16;
+    QAtomicInt flushScheduled;
+    QTimer *flushTimer = nullptr;
+    QElapsedTimer lastFlush;
+};
+
+void StreamingModel::Private::resizeRows(int newRowCount)
+{
+    const bool compact = offset > 0 && offset >= rowCount;
+    for (QVector<double> &buffer : buffers) {
+        if (compact) {
+            std::copy(buffer.constBegin() + offset, buffer.constBegin() + offset + rowCount, buffer.begin());
+        }
+        const int oldSize = (compact ? 0 : offset) + rowCount;
+        buffer.resize((compact ? 0 : offset) + newRowCount);
+        std::fill(buffer.begin() + oldSize, buffer.end(), std::numeric_limits<double>::quiet_NaN());
+    }
+    if (compact) {
+        offset = 0;
+    }
+}
+
+void StreamingModel::Private::allocateRings()
+{
+    rings.clear();
+    if (ingestionBufferSize == 0) {
+        return;
+    }
+    for (int dataset = 0; dataset < buffers.size(); ++dataset) {
+        rings.emplace_back(new SampleRing);
+        rings.back()->samples.reset(new double[ingestionBufferSize]);
+    }
+}
+
+#define d d_func()
+
+StreamingModel::StreamingModel(int datasetCount, QObject *parent)
+    : QAbstractTableModel(parent)
+    , _d(new Private)
+{
+    d->buffers.resize(qMax(0, datasetCount));
+    d->lengths.resize(qMax(0, datasetCount));
+    d->flushTimer = new QTimer(this);
+    d->flushTimer->setSingleShot(true);
+    connect(d->flushTimer, SIGNAL(timeout()), this, SLOT(flushPushedSamples()));
+}
+
+StreamingModel::~StreamingModel()
+{
+    delete _d;
+    _d = nullptr;
+}
+
+void StreamingModel::setDatasetCount(int count)
+{
+    count = qMax(0, count);
+    if (count == d->buffers.size()) {
+        return;
+    }
+    beginResetModel();
+    const int oldCount = d->buffers.size();
+    d->buffers.resize(count);
+    d->lengths.resize(count);
+    // new datasets get the layout of the others, with all rows missing
+    for (int dataset = oldCount; dataset < count; ++dataset) {
+        d->buffers[dataset].fill(std::numeric_limits<double>::quiet_NaN(), d->offset + d->rowCount);
+    }
+    d->allocateRings();
+    endResetModel();
+}
+
+int StreamingModel::datasetCount() const
+{
+    return d->buffers.size();
+}
+
+void StreamingModel::setMaximumHistory(int rows)
+{
+    d->maximumHistory = qMax(0, rows);
+    removeEvictedRows();
+}
+
+int StreamingModel::maximumHistory() const
+{
+    return d->maximumHistory;
+}
+
+void StreamingModel::appendSamples(int dataset, const double *samples, int count)
+{
+    if (dataset < 0 || dataset >= d->buffers.size() || count <= 0) {
+        return;
+    }
+
+    const int oldLength = d->lengths.at(dataset);
+    const int newLength = oldLength + count;
+    // rows that exist already because other datasets have been filled further
+    const int changedRows = qMin(newLength, d->rowCount) - oldLength;
+    const bool insertsRows = newLength > d->rowCount;
+
+    if (insertsRows) {
+        beginInsertRows(QModelIndex(), d->rowCount, newLength - 1);
+        d->resizeRows(newLength);
+        d->rowCount = newLength;
+    }
+    std::copy(samples, samples + count, d->buffers[dataset].begin() + d->offset + oldLength);
+    d->lengths[dataset] = newLength;
+    if (insertsRows) {
+        endInsertRows();
+    }
+
+    if (changedRows > 0) {
+        emit dataChanged(index(oldLength, dataset), index(oldLength + changedRows - 1, dataset));
+    }
+    removeEvictedRows();
+}
+
+void StreamingModel::appendSamples(int dataset, const QVector<double> &samples)
+{
+    appendSamples(dataset, samples.constData(), samples.size());
+}
+
+qint64 StreamingModel::evictedSampleCount() const
+{
+    return d->evicted;
+}
+
+void StreamingModel::setIngestionBufferSize(int samples)
+{
+    const uint size = samples <= 0 ? 0 : qNextPowerOfTwo(quint32(qMin(samples, 1 << 30) - 1));
+    if (size == d->ingestionBufferSize) {
+        return;
+    }
+    flushPushedSamples();
+    d->ingestionBufferSize = size;
+    d->allocateRings();
+}
+
+int StreamingModel::ingestionBufferSize() const
+{
+    return int(d->ingestionBufferSize);
+}
+
+void StreamingModel::setIngestionInterval(int msecs)
+{
+    d->ingestionInterval = qMax(0, msecs);
+}
+
+int StreamingModel::ingestionInterval() const
+{
+    return d->ingestionInterval;
+}
+
+int StreamingModel::pushSamples(int dataset, const double *samples, int count)
+{
+    if (dataset < 0 || dataset >= int(d->rings.size()) || count <= 0) {
+        return 0;
+    }
+
+    Private::SampleRing &ring = *d->rings[dataset];
+    const uint size = d->ingestionBufferSize;
+    const uint head = ring.head.loadRelaxed();
+    // acquire, so that the consumer has finished reading the samples before they are overwritten
+    const uint space = size - (head - ring.tail.loadAcquire());
+    const uint queued = qMin(uint(count), space);
+    if (queued == 0) {
+        return 0;
+    }
+
+    const uint start = head & (size - 1);
+    const uint beforeWrap = qMin(queued, size - start);
+    std::copy(samples, samples + beforeWrap, ring.samples.get() + start);
+    std::copy(samples + beforeWrap, samples + queued, ring.samples.get());
+    ring.head.storeRelease(head + queued);
+
+    // the first push after a flush schedules the next one, the others ride along with it
+    if (d->flushScheduled.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+    }
+    return int(queued);
+}
+
+void StreamingModel::scheduleFlush()
+{
+    const qint64 elapsed = d->lastFlush.isValid() ? d->lastFlush.elapsed() : d->ingestionInterval;
+    if (!d->flushTimer->isActive()) {
+        d->flushTimer->start(int(qMax(qint64(0), d->ingestionInterval - elapsed)));
+    }
+}
+
+void StreamingModel::flushPushedSamples()
+{
+    d->flushTimer->stop();
+    // samples pushed from here on schedule another flush
+    d->flushScheduled.storeRelease(0);
+    d->lastFlush.start();
+
+    const int ringCount = int(d->rings.size());
+    QVector<uint> available(ringCount);
+    const int oldRowCount = d->rowCount;
+    int newRowCount = oldRowCount;
+    int firstChangedRow = oldRowCount;
+    int lastChangedRow = -1;
+    int firstDataset = -1;
+    int lastDataset = -1;
+    for (int dataset = 0; dataset < ringCount; ++dataset) {
+        const Private::SampleRing &ring = *d->rings[dataset];
+        available[dataset] = ring.head.loadAcquire() - ring.tail.loadRelaxed();
+        if (available[dataset] == 0) {
+            continue;
+        }
+        const int oldLength = d->lengths.at(dataset);
+        const int newLength = oldLength + int(available[dataset]);
+        newRowCount = qMax(newRowCount, newLength);
+        firstChangedRow = qMin(firstChangedRow, oldLength);
+        lastChangedRow = qMax(lastChangedRow, qMin(newLength, oldRowCount) - 1);
+        if (firstDataset < 0) {
+            firstDataset = dataset;
+        }
+        lastDataset = dataset;
+    }
+    if (lastDataset < 0) {
+        return;
+    }
+
+    // one insertion and one change for all datasets, so that diagrams update once
+    const bool insertsRows = newRowCount > oldRowCount;
+    if (insertsRows) {
+        beginInsertRows(QModelIndex(), oldRowCount, newRowCount - 1);
+        d->resizeRows(newRowCount);
+        d->rowCount = newRowCount;
+    }
+    const uint mask = d->ingestionBufferSize - 1;
+    for (int dataset = firstDataset; dataset <= lastDataset; ++dataset) {
+        const uint count = available.at(dataset);
+        if (count == 0) {
+            continue;
+        }
+        Private::SampleRing &ring = *d->rings[dataset];
+        const uint tail = ring.tail.loadRelaxed();
+        const double *const samples = ring.samples.get();
+        const uint start = tail & mask;
+        const uint beforeWrap = qMin(count, mask + 1 - start);
+        double *const target = d->buffers[dataset].data() + d->offset + d->lengths.at(dataset);
+        std::copy(samples + start, samples + start + beforeWrap, target);
+        std::copy(samples, samples + count - beforeWrap, target + beforeWrap);
+        // release, so that the producer overwrites the samples only after they were read
+        ring.tail.storeRelease(tail + count);
+        d->lengths[dataset] += int(count);
+    }
+    if (insertsRows) {
+        endInsertRows();
+    }
+
+    if (firstChangedRow <= lastChangedRow) {
+        emit dataChanged(index(firstChangedRow, firstDataset), index(lastChangedRow, lastDataset));
+    }
+    removeEvictedRows();
+}
+
+void StreamingModel::clear()
+{
+    beginResetModel();
+    for (QVector<double> &buffer : d->buffers) {
+        buffer.clear();
+    }
+    d->lengths.fill(0);
+    for (const auto &ring : d->rings) {
+        ring->tail.storeRelease(ring->head.loadAcquire());
+    }
+    d->offset = 0;
+    d->rowCount = 0;
+    d->evicted = 0;
+    endResetModel();
+}
+
+const StreamingModel *StreamingModel::fromModel(const QAbstractItemModel *model)
+{
+    if (const auto *attributesModel = qobject_cast<const AttributesModel *>(model)) {
+        model = attributesModel->sourceModel();
+    }
+    return qobject_cast<const StreamingModel *>(model);
+}
+
+int StreamingModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : d->rowCount;
+}
+
+int StreamingModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : d->buffers.size();
+}
+
+QVariant StreamingModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+    const double value = d->buffers.at(index.column()).at(d->offset + index.row());
+    return ISNAN(value) ? QVariant() : QVariant(value);
+}
+
+const double *StreamingModel::columnData(int column) const
+{
+    return d->buffers.at(column).constData() + d->offset;
+}
+
+void StreamingModel::removeEvictedRows()
+{
+    if (d->maximumHistory == 0 || d->rowCount <= d->maximumHistory) {
+        return;
+    }
+    const int excess = d->rowCount - d->maximumHistory;
+    beginRemoveRows(QModelIndex(), 0, excess - 1);
+    d->offset += excess;
+    d->rowCount -= excess;
+    d->evicted += excess;
+    for (int &length : d->lengths) {
+        length = qMax(0, length - excess);
+    }
+    endRemoveRows();
+}
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTSTREAMINGMODEL_H
+#define KDCHARTSTREAMINGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include "KDChartColumnarDataSource.h"
+#include "KDChartGlobal.h"
+
+namespace KDChart {
+
+/**
+ * @brief Table model for datasets that grow continuously, e.g. live measurements
+ *
+ * Each column of the model is one dataset, each row one sample. Samples are added
+ * with appendSamples(), which inserts rows at the end of the model as needed. With
+ * setMaximumHistory(), the oldest rows are removed once the model has grown beyond
+ * the given number of rows, so that the chart scrolls along with the data.
+ *
+ * Line and bar diagrams recognize this model: they only process the rows that were
+ * appended or removed since the last update, instead of re-reading the whole model,
+ * and they do not need to re-layout the chart for every new sample.
+ *
+ * \code
+ * KDChart::StreamingModel model(16);
+ * model.setMaximumHistory(100000);
+ * diagram->setModel(&model);
+ * ...
+ * model.appendSamples(channel, buffer.constData(), buffer.size());
+ * \endcode
+ *
+ * Acquisition threads can hand their samples over with pushSamples() instead, which
+ * queues them without locking. The model appends the queued samples of all datasets
+ * together in its own thread, at most once per ingestionInterval(), so that diagrams
+ * process them in one update and repaint once.
+ *
+ * \code
+ * model.setIngestionBufferSize(65536);
+ * ...
+ * // in the acquisition thread of channel
+ * model.pushSamples(channel, buffer.constData(), buffer.size());
+ * \endcode
+ */
+class KDCHART_EXPORT StreamingModel : public QAbstractTableModel, public ColumnarDataSource
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(StreamingModel)
+    KDCHART_DECLARE_PRIVATE_BASE_POLYMORPHIC(StreamingModel)
+
+public:
+    explicit StreamingModel(int datasetCount = 1, QObject *parent = nullptr);
+    ~StreamingModel() override;
+
+    /**
+     * Sets the number of datasets (columns) to @p count. This resets the model and
+     * discards the samples queued by pushSamples().
+     */
+    void setDatasetCount(int count);
+    int datasetCount() const;
+
+    /**
+     * Limits the model to the latest @p rows rows; older rows are removed from the
+     * start of the model. 0, the default, keeps all samples.
+     */
+    void setMaximumHistory(int rows);
+    int maximumHistory() const;
+
+    /**
+     * Appends @p count values from @p samples to @p dataset. The model grows by
+     * the rows that this dataset has more samples than any other dataset had; the
+     * rows that other datasets have not filled yet are missing values (NaN).
+     */
+    void appendSamples(int dataset, const double *samples, int count);
+    /** \overload */
+    void appendSamples(int dataset, const QVector<double> &samples);
+
+    /**
+     * Returns the number of rows removed from the start of the model since the last
+     * reset, i.e. the sample number of row 0.
+     */
+    qint64 evictedSampleCount() const;
+
+    /**
+     * Sets the number of samples per dataset that pushSamples() can queue until they
+     * are appended to the model to @p samples, rounded up to a power of two. Samples
+     * queued already are appended first. 0, the default, disables pushSamples().
+     *
+     * Call this in the thread of the model while no thread is pushing samples.
+     */
+    void setIngestionBufferSize(int samples);
+    int ingestionBufferSize() const;
+
+    /**
+     * Sets the shortest time between two appends of the samples queued by
+     * pushSamples() to @p msecs. The default, 16 ms, appends them once per frame.
+     */
+    void setIngestionInterval(int msecs);
+    int ingestionInterval() const;
+
+    /**
+     * Queues @p count values from @p samples to be appended to @p dataset in the thread
+     * of the model, as if by appendSamples().
+     *
+     * This function is thread-safe for one producer per dataset: each dataset may be
+     * pushed to by only one thread at a time, but different datasets may be pushed to
+     * from different threads. It never blocks. The producers must be stopped before
+     * the dataset count or the ingestion buffer size are changed, or the model is deleted.
+     *
+     * Returns the number of samples queued, which is less than @p count if the buffer
+     * of @p dataset is full; the remaining samples can be pushed again later.
+     *
+     * \sa setIngestionBufferSize(), flushPushedSamples()
+     */
+    int pushSamples(int dataset, const double *samples, int count);
+
+    /**
+     * Removes all samples, including those queued by pushSamples(). This resets the model.
+     */
+    void clear();
+
+    /**
+     * Returns @p model as StreamingModel, or nullptr if it is none.
+     * If @p model is an AttributesModel, its source model is checked instead.
+     */
+    static const StreamingModel *fromModel(const QAbstractItemModel *model);
+
+    /** \reimp */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    /** \reimp */
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    /** \reimp */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    /** \reimp */
+    const double *columnData(int column) const override;
+
+public Q_SLOTS:
+    /**
+     * Appends the samples queued by pushSamples() to the model right away, instead of
+     * waiting for the ingestion interval to elapse.
+     */
+    void flushPushedSamples();
+
+private Q_SLOTS:
+    void scheduleFlush();
+
+private:
+    void removeEvictedRows();
+};
+}
+
+#endif
@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartSymbolCache.h"
+#include "KDChartSymbolCache_p.h"
+
+#include <QHash>
+#include <QMutexLocker>
+#include <QPainter>
+
+#include <cmath>
+
+#include <KDABLibFakes>
+
+#define d d_func()
+
+using namespace KDChart;
+
+bool SymbolCache::Private::Key::operator==(const Key &other) const
+{
+    return file == other.file && markerStyle == other.markerStyle && threeD == other.threeD
+        && brushColor == other.brushColor && penColor == other.penColor
+        && penWidth == other.penWidth && penStyle == other.penStyle
+        && outlineWidth == other.outlineWidth && size == other.size
+        && devicePixelRatio == other.devicePixelRatio && antialiased == other.antialiased
+        && phase == other.phase;
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint KDChart::qHash(const SymbolCache::Private::Key &key, uint seed)
+#else
+size_t KDChart::qHash(const SymbolCache::Private::Key &key, size_t seed)
+#endif
+{
+    auto hash = ::qHash(key.file, seed);
+    hash = 31 * hash + uint(key.markerStyle);
+    hash = 31 * hash + key.brushColor;
+    hash = 31 * hash + key.penColor;
+    hash = 31 * hash + ::qHash(key.size.width(), seed);
+    hash = 31 * hash + ::qHash(key.size.height(), seed);
+    hash = 31 * hash + uint(key.phase.x() * SymbolCache::Private::PhaseSteps + key.phase.y());
+    return hash;
+}
+
+SymbolCache::Private *SymbolCache::Private::instance()
+{
+    return SymbolCache::instance()->_d;
+}
+
+Sprite SymbolCache::Private::lookup(const Key &key, qreal margin, const Renderer &render)
+{
+    if (const Sprite *cached = cache.find(key))
+        return *cached;
+
+    // the symbol is rendered at the sub-pixel position it has on the device, the
+    // extra pixel on the right and bottom holds the shifted antialiasing
+    const int halfWidth = int(std::ceil((key.size.width() / 2.0 + margin) * key.devicePixelRatio));
+    const int halfHeight = int(std::ceil((key.size.height() / 2.0 + margin) * key.devicePixelRatio));
+    const QPointF corner(halfWidth / key.devicePixelRatio, halfHeight / key.devicePixelRatio);
+
+    Sprite sprite;
+    sprite.image = QImage(2 * halfWidth + 1, 2 * halfHeight + 1, QImage::Format_ARGB32_Premultiplied);
+    sprite.image.setDevicePixelRatio(key.devicePixelRatio);
+    sprite.image.fill(Qt::transparent);
+    sprite.topLeft = -corner;
+    sprite.phase = QPointF(key.phase) / (PhaseSteps * key.devicePixelRatio);
+    {
+        QPainter painter(&sprite.image);
+        painter.setRenderHint(QPainter::Antialiasing, key.antialiased);
+        painter.translate(corner + sprite.phase);
+        render(&painter);
+    }
+
+    cache.insert(key, sprite);
+    return sprite;
+}
+
+bool SymbolCache::Private::drawSymbol(QPainter *painter, const QPointF &center, Key key,
+                                      qreal margin, const Renderer &render)
+{
+    Sprite sprite;
+    {
+        const QMutexLocker locker(&cache.mutex);
+        if (!cache.isUsable(painter))
+            return false;
+        key.devicePixelRatio = painter->device()->devicePixelRatioF();
+        key.antialiased = painter->testRenderHint(QPainter::Antialiasing);
+        key.phase = Cache::phase(painter, center, PhaseSteps);
+        sprite = lookup(key, margin, render);
+    }
+    Cache::draw(painter, center, sprite);
+    return true;
+}
+
+SymbolCache::SymbolCache()
+    : _d(new Private)
+{
+    d->cache.sprites.setMaxCost(2048);
+}
+
+SymbolCache::~SymbolCache()
+{
+    delete _d;
+    _d = nullptr;
+}
+
+SymbolCache *SymbolCache::instance()
+{
+    static SymbolCache cache;
+    return &cache;
+}
+
+void SymbolCache::setEnabled(bool enabled)
+{
+    d->cache.setEnabled(enabled);
+}
+
+bool SymbolCache::isEnabled() const
+{
+    return d->cache.isEnabled();
+}
+
+void SymbolCache::setMaximumSize(int kiloBytes)
+{
+    d->cache.setMaximumSize(kiloBytes);
+}
+
+int SymbolCache::maximumSize() const
+{
+    return d->cache.maximumSize();
+}
+
+int SymbolCache::size() const
+{
+    return d->cache.size();
+}
+
+int SymbolCache::count() const
+{
+    return d->cache.count();
+}
+
+void SymbolCache::clear()
+{
+    d->cache.clear();
+}
+
+int SymbolCache::hitCount() const
+{
+    return d->cache.hits();
+}
+
+int SymbolCache::missCount() const
+{
+    return d->cache.misses();
+}
+
+void SymbolCache::resetStatistics()
+{
+    d->cache.resetStatistics();
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTSYMBOLCACHE_H
+#define KDCHARTSYMBOLCACHE_H
+
+#include "KDChartGlobal.h"
+
+namespace KDChart {
+
+/**
+ * @brief Process-wide atlas of prerendered data point symbols
+ *
+ * Point charts paint the same symbol at thousands of positions: the markers of
+ * line and plotter diagrams and the SVG icons of Levey-Jennings diagrams. Filling an
+ * antialiased outline or rendering an SVG document again for every data point takes
+ * most of the painting time of such charts.
+ *
+ * SymbolCache rasterizes each symbol once per size and device pixel ratio and then
+ * copies the image to every position it is painted at. Marker sprites are keyed by
+ * the marker style, size, brush color and pen, SVG icons by their file name. Symbols
+ * are rendered for the position of their center within its device pixel, rounded to
+ * a quarter pixel, so a symbol takes up to 16 images. When the images take more
+ * memory than maximumSize(), the least recently used ones are dropped. Call clear()
+ * after the contents of an SVG file in use were changed.
+ *
+ * Cached images are only used when painting on a raster device, e.g. a widget,
+ * QImage or QPixmap, with a transformation that is a translation. Printing, SVG
+ * and PDF output and QPicture recordings always paint the symbols themselves, so
+ * they stay vector graphics. Markers with a gradient or texture brush and
+ * MarkerAttributes::PainterPathMarker markers are never cached.
+ *
+ * \code
+ * KDChart::SymbolCache *cache = KDChart::SymbolCache::instance();
+ * cache->setMaximumSize( 8 * 1024 ); // 8 MB for many differently colored datasets
+ * \endcode
+ */
+class KDCHART_EXPORT SymbolCache
+{
+    Q_DISABLE_COPY(SymbolCache)
+    KDCHART_DECLARE_PRIVATE_BASE_VALUE(SymbolCache)
+
+public:
+    /**
+     * Returns the cache used by all charts of the application.
+     */
+    static SymbolCache *instance();
+
+    /**
+     * Turns caching on or off. When turned off, the cache is cleared and all symbols
+     * are painted directly. It is on by default.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * Sets the memory the cached images may take, in kilobytes. The default is 2048.
+     * Least recently used symbols are dropped right away if the cache is larger.
+     */
+    void setMaximumSize(int kiloBytes);
+    int maximumSize() const;
+
+    /**
+     * Returns the memory taken by the cached images, in kilobytes.
+     */
+    int size() const;
+
+    /**
+     * Returns the number of cached symbols.
+     */
+    int count() const;
+
+    /**
+     * Drops all cached symbols. The statistics are kept.
+     */
+    void clear();
+
+    /**
+     * Returns how many symbols were painted from the cache since the last
+     * call of resetStatistics().
+     */
+    int hitCount() const;
+
+    /**
+     * Returns how many symbols had to be rendered because they were not in the
+     * cache, since the last call of resetStatistics().
+     */
+    int missCount() const;
+
+    void resetStatistics();
+
+private:
+    SymbolCache();
+    ~SymbolCache();
+};
+}
+
+#endif
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTSYMBOLCACHE_P_H
+#define KDCHARTSYMBOLCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "KDChartSymbolCache.h"
+#include "KDChartSpriteCache_p.h"
+
+#include <QColor>
+#include <QPoint>
+#include <QPointF>
+#include <QSizeF>
+#include <QString>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+namespace KDChart {
+
+/**
+ * \internal
+ */
+class SymbolCache::Private
+{
+public:
+    // everything that changes the pixels of a symbol
+    struct Key
+    {
+        QString file; // of SVG symbols, empty for markers
+        int markerStyle = -1; // MarkerAttributes::MarkerStyle, -1 for SVG symbols
+        bool threeD = false;
+        QRgb brushColor = 0;
+        QRgb penColor = 0;
+        qreal penWidth = 0.0;
+        int penStyle = 0; // Qt::PenStyle, Qt::PenCapStyle and Qt::PenJoinStyle
+        qreal outlineWidth = 0.0; // of the pens made from the brush color
+        QSizeF size;
+        qreal devicePixelRatio = 1.0;
+        bool antialiased = false;
+        // the position of the center within its device pixel, in 1/PhaseSteps pixels
+        QPoint phase;
+
+        bool operator==(const Key &other) const;
+    };
+
+    typedef SpriteCache<Key, Sprite> Cache;
+
+    // symbols are rendered for quarter pixel positions, so each symbol has up to 16 sprites
+    static const int PhaseSteps = 4;
+
+    // paints a symbol centered at the origin of painter
+    typedef std::function<void(QPainter *painter)> Renderer;
+
+    static Private *instance();
+
+    // Paints the symbol described by key centered at center, as if painter->translate(center)
+    // and render(painter) were called. render must not paint outside of key.size grown by
+    // margin on each side. The device pixel ratio, antialiasing and phase of key are set from
+    // painter. Returns false without painting if the cache can not be used for painter.
+    bool drawSymbol(QPainter *painter, const QPointF &center, Key key, qreal margin,
+                    const Renderer &render);
+
+    Cache cache;
+
+private:
+    // the cached sprite for key, rendered first on a miss
+    Sprite lookup(const Key &key, qreal margin, const Renderer &render);
+};
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint qHash(const SymbolCache::Private::Key &key, uint seed = 0);
+#else
+size_t qHash(const SymbolCache::Private::Key &key, size_t seed = 0);
+#endif
+}
+
+#endif
@@ -15,6 +15,9 @@
 #include "KDChartPieDiagram.h"
 #include "KDChartPieDiagram_p.h"
 
+#include "KDChartAttributesModel.h"
+#include "KDChartColumnarDataSource.h"
+#include "KDChartDataValueAttributes.h"
 #include "KDChartPaintContext.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPieAttributes.h"
@@ -26,7 +29,9 @@
 using namespace KDChart;
 
 PieDiagram::Private::Private()
-    : labelDecorations(PieDiagram::NoDecoration)
+    : otherSliceLabel(PieDiagram::tr("Other"))
+    , otherSliceBrush(Qt::lightGray)
+    , labelDecorations(PieDiagram::NoDecoration)
 {
 }
 
@@ -34,6 +39,17 @@ PieDiagram::Private::~Private()
 {
 }
 
+CartesianDiagramDataCompressor::AggregatedDataValueAttributes PieDiagram::Private::aggregatedAttrs(
+    const QModelIndex &index,
+    const CartesianDiagramDataCompressor::CachePosition *position) const
+{
+    if (index.isValid())
+        return AbstractPieDiagram::Private::aggregatedAttrs(index, position);
+    CartesianDiagramDataCompressor::AggregatedDataValueAttributes allAttrs;
+    allAttrs[index] = diagram->dataValueAttributes();
+    return allAttrs;
+}
+
 #define d d_func()
 
 PieDiagram::PieDiagram(QWidget *parent, PolarCoordinatePlane *plane)
@@ -48,6 +64,39 @@ PieDiagram::~PieDiagram()
 
 void PieDiagram::init()
 {
+    // the slices are computed once and kept until the values change
+    connect(this, SIGNAL(attributesModelAboutToChange(AttributesModel *, AttributesModel *)),
+            this, SLOT(slotAttributesModelAboutToChange(AttributesModel *, AttributesModel *)));
+    connect(this, SIGNAL(modelsChanged()), this, SLOT(slotInvalidateSlices()));
+    slotAttributesModelAboutToChange(attributesModel(), nullptr);
+}
+
+void PieDiagram::slotAttributesModelAboutToChange(AttributesModel *newModel, AttributesModel *oldModel)
+{
+    if (oldModel)
+        disconnect(oldModel, nullptr, this, SLOT(slotInvalidateSlices()));
+    if (newModel) {
+        connect(newModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(rowsInserted(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(columnsInserted(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(rowsRemoved(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(columnsRemoved(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(modelReset()),
+                this, SLOT(slotInvalidateSlices()));
+        connect(newModel, SIGNAL(layoutChanged()),
+                this, SLOT(slotInvalidateSlices()));
+    }
+    slotInvalidateSlices();
+}
+
+void PieDiagram::slotInvalidateSlices()
+{
+    d->slicesDirty = true;
 }
 
 /**
@@ -78,6 +127,97 @@ bool PieDiagram::isLabelCollisionAvoidanceEnabled() const
     return d->isCollisionAvoidanceEnabled;
 }
 
+void PieDiagram::setOtherSliceThreshold(qreal degrees)
+{
+    if (d->otherSliceThreshold == degrees)
+        return;
+    d->otherSliceThreshold = degrees;
+    d->slicesDirty = true;
+    emit layoutChanged(this);
+}
+
+qreal PieDiagram::otherSliceThreshold() const
+{
+    return d->otherSliceThreshold;
+}
+
+void PieDiagram::setOtherSliceLabel(const QString &label)
+{
+    if (d->otherSliceLabel == label)
+        return;
+    d->otherSliceLabel = label;
+    emit layoutChanged(this);
+}
+
+QString PieDiagram::otherSliceLabel() const
+{
+    return d->otherSliceLabel;
+}
+
+void PieDiagram::setOtherSliceBrush(const QBrush &brush)
+{
+    if (d->otherSliceBrush == brush)
+        return;
+    d->otherSliceBrush = brush;
+    emit propertiesChanged();
+}
+
+QBrush PieDiagram::otherSliceBrush() const
+{
+    return d->otherSliceBrush;
+}
+
+void PieDiagram::setOtherSlicePen(const QPen &pen)
+{
+    if (d->hasOtherSlicePen && d->otherSlicePen == pen)
+        return;
+    d->otherSlicePen = pen;
+    d->hasOtherSlicePen = true;
+    emit propertiesChanged();
+}
+
+QPen PieDiagram::otherSlicePen() const
+{
+    return d->hasOtherSlicePen ? d->otherSlicePen : QPen(d->otherSliceBrush.color());
+}
+
+void PieDiagram::setOtherSliceToolTip(const QString &toolTip)
+{
+    d->otherSliceToolTip = toolTip;
+}
+
+QString PieDiagram::otherSliceToolTip() const
+{
+    if (!d->otherSliceToolTip.isEmpty())
+        return d->otherSliceToolTip;
+    updateSlices();
+    if (d->otherSlice < 0)
+        return QString();
+    const DataValueAttributes dva(dataValueAttributes());
+    return d->otherSliceLabel + QLatin1Char(' ')
+        + d->formatNumber(d->sliceValues[d->otherSlice], dva.decimalDigits());
+}
+
+QModelIndexList PieDiagram::otherSliceIndexes() const
+{
+    QModelIndexList indexes;
+    if (!model())
+        return indexes;
+    updateSlices();
+    for (int column : qAsConst(d->otherSliceColumns))
+        indexes << model()->index(0, column, rootIndex()); // checked
+    return indexes;
+}
+
+bool PieDiagram::isOtherSliceAt(const QPoint &point) const
+{
+    for (const QPolygonF &shape : qAsConst(d->otherSliceShapes)) {
+        if (shape.containsPoint(point, Qt::OddEvenFill))
+            return true;
+    }
+    return false;
+}
+
 const QPair<QPointF, QPointF> PieDiagram::calculateDataBoundaries() const
 {
     if (!checkInvariants(true) || model()->rowCount() < 1)
@@ -130,34 +270,98 @@ void PieDiagram::paint(PaintContext *ctx)
     paintInternal(ctx);
 }
 
+// reads the values of the first row and aggregates the narrow slices, if the values changed
+void PieDiagram::updateSlices() const
+{
+    if (!d->slicesDirty && d->slicesRootIndex == rootIndex())
+        return;
+    d->slicesDirty = false;
+    d->slicesRootIndex = rootIndex();
+
+    const int colCount = model() && model()->rowCount(rootIndex()) > 0 ? columnCount() : 0;
+    // models that keep their values in arrays are read without going through data()
+    const ColumnarDataSource *columnarSource = rootIndex().isValid() ? nullptr : d->columnarSource;
+    QVector<qreal> values(colCount);
+    d->valueTotal = 0.0;
+    d->hasValues = false; // guard against completely empty tables
+    for (int iColumn = 0; iColumn < colCount; ++iColumn) {
+        bool isOk = false;
+        qreal cellValue = 0.0;
+        if (const double *columnData = columnarSource ? columnarSource->columnData(iColumn) : nullptr) {
+            isOk = !ISNAN(columnData[0]);
+            cellValue = isOk ? columnData[0] : 0.0;
+        } else {
+            // toReal() returns 0.0 if there was no value or a non-numeric value
+            cellValue = model()->data(model()->index(0, iColumn, rootIndex())).toReal(&isOk); // checked
+        }
+        d->hasValues = d->hasValues || isOk;
+        values[iColumn] = qAbs(cellValue);
+        d->valueTotal += values[iColumn];
+    }
+
+    // slices narrower than the threshold go into the "Other" slice, if there are several
+    QVector<bool> isNarrow(colCount, false);
+    int narrowCount = 0;
+    if (d->otherSliceThreshold > 0.0 && d->valueTotal > 0.0) {
+        const qreal minimumValue = d->otherSliceThreshold / 360.0 * d->valueTotal;
+        for (int iColumn = 0; iColumn < colCount; ++iColumn) {
+            isNarrow[iColumn] = values[iColumn] != 0.0 && values[iColumn] < minimumValue;
+            if (isNarrow[iColumn])
+                ++narrowCount;
+        }
+    }
+
+    d->sliceColumns.clear();
+    d->sliceValues.clear();
+    d->otherSliceColumns.clear();
+    d->otherSlice = -1;
+    qreal otherValue = 0.0;
+    for (int iColumn = 0; iColumn < colCount; ++iColumn) {
+        if (narrowCount > 1 && isNarrow[iColumn]) {
+            d->otherSliceColumns.append(iColumn);
+            otherValue += values[iColumn];
+        } else {
+            d->sliceColumns.append(iColumn);
+            d->sliceValues.append(values[iColumn]);
+        }
+    }
+    if (!d->otherSliceColumns.isEmpty()) {
+        d->otherSlice = d->sliceColumns.count();
+        d->sliceColumns.append(-1);
+        d->sliceValues.append(otherValue);
+    }
+}
+
+// the index of the dataset of slice, an invalid index for the "Other" slice
+QModelIndex PieDiagram::sliceIndex(uint slice) const
+{
+    if (int(slice) == d->otherSlice)
+        return QModelIndex();
+    return model()->index(0, d->sliceColumns[slice], rootIndex()); // checked
+}
+
 void PieDiagram::calcSliceAngles()
 {
     // determine slice positions and sizes
-    const qreal sum = valueTotals();
+    updateSlices();
+    const qreal sum = d->valueTotal;
     const qreal sectorsPerValue = 360.0 / sum;
     const PolarCoordinatePlane *plane = polarCoordinatePlane();
     qreal currentValue = plane ? plane->startPosition() : 0.0;
 
-    const int colCount = columnCount();
-    d->startAngles.resize(colCount);
-    d->angleLens.resize(colCount);
+    const int sliceCount = d->sliceValues.count();
+    d->startAngles.resize(sliceCount);
+    d->angleLens.resize(sliceCount);
 
-    bool atLeastOneValue = false; // guard against completely empty tables
-    for (int iColumn = 0; iColumn < colCount; ++iColumn) {
-        bool isOk;
-        const qreal cellValue = qAbs(model()->data(model()->index(0, iColumn, rootIndex())) // checked
-                                         .toReal(&isOk));
-        // toReal() returns 0.0 if there was no value or a non-numeric value
-        atLeastOneValue = atLeastOneValue || isOk;
+    for (int slice = 0; slice < sliceCount; ++slice) {
+        d->startAngles[slice] = currentValue;
+        d->angleLens[slice] = d->sliceValues[slice] * sectorsPerValue;
 
-        d->startAngles[iColumn] = currentValue;
-        d->angleLens[iColumn] = cellValue * sectorsPerValue;
-
-        currentValue = d->startAngles[iColumn] + d->angleLens[iColumn];
+        currentValue = d->startAngles[slice] + d->angleLens[slice];
     }
 
     // If there was no value at all, this is the sign for other code to bail out
-    if (!atLeastOneValue) {
+    if (!d->hasValues) {
         d->startAngles.clear();
         d->angleLens.clear();
     }
@@ -168,11 +372,15 @@ void PieDiagram::calcPieSize(const QRectF &contentsRect)
     d->size = qMin(contentsRect.width(), contentsRect.height());
 
     // if any slice explodes, the whole pie needs additional space so we make the basic size smaller
+    // the explosion of each slice is looked up once here, and used for all of this paint
     qreal maxExplode = 0.0;
-    const int colCount = columnCount();
-    for (int j = 0; j < colCount; ++j) {
-        const PieAttributes columnAttrs(pieAttributes(model()->index(0, j, rootIndex()))); // checked
-        maxExplode = qMax(maxExplode, columnAttrs.explodeFactor());
+    const int sliceCount = d->startAngles.count();
+    d->explodeFactors.resize(sliceCount);
+    for (int slice = 0; slice < sliceCount; ++slice) {
+        const PieAttributes sliceAttrs(slice == d->otherSlice ? pieAttributes()
+                                                              : pieAttributes(sliceIndex(slice)));
+        d->explodeFactors[slice] = sliceAttrs.explodeFactor();
+        maxExplode = qMax(maxExplode, d->explodeFactors[slice]);
     }
     d->size /= (1.0 + 1.0 * maxExplode);
 
@@ -223,9 +431,9 @@ void PieDiagram::placeLabels(PaintContext *paintContext)
     }
 
     const ThreeDPieAttributes threeDAttrs(threeDPieAttributes());
-    const int colCount = columnCount();
 
     d->reverseMapper.clear(); // on first call, this sets up the internals of the ReverseMapper.
+    d->otherSliceShapes.clear();
 
     calcSliceAngles();
     if (d->startAngles.isEmpty()) {
@@ -233,6 +441,7 @@ void PieDiagram::placeLabels(PaintContext *paintContext)
     }
 
     calcPieSize(paintContext->rectangle());
+    const int sliceCount = d->startAngles.count();
 
     // keep resizing the pie until the labels and the pie fit into paintContext->rectangle()
 
@@ -244,7 +453,7 @@ void PieDiagram::placeLabels(PaintContext *paintContext)
         d->forgetAlreadyPaintedDataValues();
         d->labelPaintCache.clear();
 
-        for (int slice = 0; slice < colCount; slice++) {
+        for (int slice = 0; slice < sliceCount; slice++) {
             if (d->angleLens[slice] != 0.0) {
                 const QRectF explodedPieRect = explodedDrawPosition(pieRect, slice);
                 addSliceLabel(&d->labelPaintCache, explodedPieRect, slice);
@@ -308,6 +517,26 @@ void PieDiagram::shuffleLabels(QRectF *textBoundingRect)
     QVector<qreal> offsets;
     offsets.fill(0.0, n);
 
+    // the direction each label moves in and its bounds are computed once, the bounds rule
+    // out most pairs of labels before their outlines are intersected
+    QVector<int> columnSlices(columnCount(), -1);
+    for (int slice = 0; slice < d->sliceColumns.count(); ++slice) {
+        if (slice != d->otherSlice)
+            columnSlices[d->sliceColumns[slice]] = slice;
+    }
+    QVector<QPointF> moveDirections(n);
+    QVector<QRectF> bounds(n);
+    for (int i = 0; i < n; i++) {
+        const QModelIndex &index = lpc.paintReplay[i].index;
+        const int slice = index.isValid() ? columnSlices.value(index.column(), -1) : d->otherSlice;
+        if (slice >= 0) {
+            const qreal angle = DEGTORAD(d->startAngles[slice] + d->angleLens[slice] / 2.0);
+            moveDirections[i] = QPointF(cos(angle), -sin(angle));
+        }
+        // touching outlines count as intersecting
+        bounds[i] = lpc.paintReplay[i].labelArea.boundingRect().adjusted(-1.0, -1.0, 1.0, 1.0);
+    }
+
     for (bool lastRoundModified = true; lastRoundModified;) {
         lastRoundModified = false;
 
@@ -324,19 +553,18 @@ void PieDiagram::shuffleLabels(QRectF *textBoundingRect)
                 }
                 QPainterPath &otherPath = lpc.paintReplay[j].labelArea;
 
-                while ((offsets[i] + direction > 0) && otherPath.intersects(path)) {
+                while ((offsets[i] + direction > 0) && bounds[j].intersects(bounds[i])
+                       && otherPath.intersects(path)) {
 #ifdef SHUFFLE_DEBUG
                     qDebug() << "collision involving" << j << "and" << i << " -- n =" << n;
                     TextAttributes ta = lpc.paintReplay[i].attrs.textAttributes();
                     ta.setPen(QPen(Qt::white));
                     lpc.paintReplay[i].attrs.setTextAttributes(ta);
 #endif
-                    uint slice = lpc.paintReplay[i].index.column();
-                    qreal angle = DEGTORAD(d->startAngles[slice] + d->angleLens[slice] / 2.0);
-                    qreal dx = cos(angle) * direction;
-                    qreal dy = -sin(angle) * direction;
+                    const QPointF offset = moveDirections[i] * direction;
                     offsets[i] += direction;
-                    path.translate(dx, dy);
+                    path.translate(offset);
+                    bounds[i].translate(offset);
                     lastRoundModified = true;
                 }
             }
@@ -438,28 +666,28 @@ void PieDiagram::paintInternal(PaintContext *paintContext)
     }
 
     const ThreeDPieAttributes threeDAttrs(threeDPieAttributes());
-    const int colCount = columnCount();
+    const int sliceCount = d->startAngles.count();
 
     // Paint from back to front ("painter's algorithm") - first draw the backmost slice,
     // then the slices on the left and right from back to front, then the frontmost one.
 
     QRectF pieRect = twoDPieRect(paintContext->rectangle(), threeDAttrs);
-    const int backmostSlice = findSliceAt(90, colCount);
-    const int frontmostSlice = findSliceAt(270, colCount);
+    const int backmostSlice = findSliceAt(90, sliceCount);
+    const int frontmostSlice = findSliceAt(270, sliceCount);
     int currentLeftSlice = backmostSlice;
     int currentRightSlice = backmostSlice;
 
     drawSlice(paintContext->painter(), pieRect, backmostSlice);
 
     if (backmostSlice == frontmostSlice) {
-        const int rightmostSlice = findSliceAt(0, colCount);
-        const int leftmostSlice = findSliceAt(180, colCount);
+        const int rightmostSlice = findSliceAt(0, sliceCount);
+        const int leftmostSlice = findSliceAt(180, sliceCount);
 
         if (backmostSlice == leftmostSlice) {
-            currentLeftSlice = findLeftSlice(currentLeftSlice, colCount);
+            currentLeftSlice = findLeftSlice(currentLeftSlice, sliceCount);
         }
         if (backmostSlice == rightmostSlice) {
-            currentRightSlice = findRightSlice(currentRightSlice, colCount);
+            currentRightSlice = findRightSlice(currentRightSlice, sliceCount);
         }
     }
 
@@ -467,14 +695,14 @@ void PieDiagram::paintInternal(PaintContext *paintContext)
         if (currentLeftSlice != backmostSlice) {
             drawSlice(paintContext->painter(), pieRect, currentLeftSlice);
         }
-        currentLeftSlice = findLeftSlice(currentLeftSlice, colCount);
+        currentLeftSlice = findLeftSlice(currentLeftSlice, sliceCount);
     }
 
     while (currentRightSlice != frontmostSlice) {
         if (currentRightSlice != backmostSlice) {
             drawSlice(paintContext->painter(), pieRect, currentRightSlice);
         }
-        currentRightSlice = findRightSlice(currentRightSlice, colCount);
+        currentRightSlice = findRightSlice(currentRightSlice, sliceCount);
     }
 
     // if the backmost slice is not the frontmost slice, we draw the frontmost one last
@@ -495,19 +723,25 @@ void PieDiagram::paintInternal(PaintContext *paintContext)
             continue;
         }
 
-        paintContext->painter()->setPen(pen(pi.index));
+        const bool isOtherSlice = !pi.index.isValid();
+        paintContext->painter()->setPen(isOtherSlice ? otherSlicePen() : pen(pi.index));
         if (d->labelDecorations & LineFromSliceDecoration) {
             paintContext->painter()->drawLine(labelAttachmentLine(center, pi.markerPos, pi.labelArea));
         }
         if (d->labelDecorations & FrameDecoration) {
             paintContext->painter()->drawPath(pi.labelArea);
         }
-        d->reverseMapper.addPolygon(pi.index.row(), pi.index.column(),
-                                    polygonFromPainterPath(pi.labelArea));
+        if (isOtherSlice) {
+            d->otherSliceShapes.append(polygonFromPainterPath(pi.labelArea));
+        } else {
+            d->reverseMapper.addPolygon(pi.index.row(), pi.index.column(),
+                                        polygonFromPainterPath(pi.labelArea));
+        }
     }
     d->labelPaintCache.clear();
     d->startAngles.clear();
     d->angleLens.clear();
+    d->explodeFactors.clear();
 }
 
 #if defined(Q_OS_WIN)
@@ -516,15 +750,13 @@ void PieDiagram::paintInternal(PaintContext *paintContext)
 
 QRectF PieDiagram::explodedDrawPosition(const QRectF &drawPosition, uint slice) const
 {
-    const QModelIndex index(model()->index(0, slice, rootIndex())); // checked
-    const PieAttributes attrs(pieAttributes(index));
-
     QRectF adjustedDrawPosition = drawPosition;
-    if (attrs.explode()) {
+    const qreal explodeFactor = d->explodeFactors[slice];
+    if (explodeFactor != 0.0) {
         qreal startAngle = d->startAngles[slice];
         qreal angleLen = d->angleLens[slice];
         qreal explodeAngle = (DEGTORAD(startAngle + angleLen / 2.0));
-        qreal explodeDistance = attrs.explodeFactor() * d->size / 2.0;
+        qreal explodeDistance = explodeFactor * d->size / 2.0;
 
         adjustedDrawPosition.translate(explodeDistance * cos(explodeAngle),
                                        explodeDistance * -sin(explodeAngle));
@@ -563,19 +795,19 @@ void PieDiagram::drawSliceSurface(QPainter *painter, const QRectF &drawPosition,
     // Is there anything to draw at all?
     const qreal angleLen = d->angleLens[slice];
     const qreal startAngle = d->startAngles[slice];
-    const QModelIndex index(model()->index(0, slice, rootIndex())); // checked
+    const QModelIndex index(sliceIndex(slice));
+    const bool isOtherSlice = int(slice) == d->otherSlice;
 
-    const PieAttributes attrs(pieAttributes(index));
-    const ThreeDPieAttributes threeDAttrs(threeDPieAttributes(index));
+    const ThreeDPieAttributes threeDAttrs(isOtherSlice ? threeDPieAttributes() : threeDPieAttributes(index));
 
     painter->setRenderHint(QPainter::Antialiasing);
-    QBrush br = brush(index);
+    QBrush br = isOtherSlice ? d->otherSliceBrush : brush(index);
     if (threeDAttrs.isEnabled()) {
         br = threeDAttrs.threeDBrush(br, drawPosition);
     }
     painter->setBrush(br);
 
-    QPen pen = this->pen(index);
+    QPen pen = isOtherSlice ? otherSlicePen() : this->pen(index);
     if (threeDAttrs.isEnabled()) {
         pen.setColor(Qt::black);
     }
@@ -587,7 +819,11 @@ void PieDiagram::drawSliceSurface(QPainter *painter, const QRectF &drawPosition,
 
         // Add polygon to Reverse mapper for showing tool tips.
         QPolygonF poly(drawPosition);
-        d->reverseMapper.addPolygon(index.row(), index.column(), poly);
+        if (isOtherSlice) {
+            d->otherSliceShapes.append(poly);
+        } else {
+            d->reverseMapper.addPolygon(index.row(), index.column(), poly);
+        }
     } else {
         // draw the top of this piece
         // Start with getting the points for the arc.
@@ -615,7 +851,11 @@ void PieDiagram::drawSliceSurface(QPainter *painter, const QRectF &drawPosition,
         }
         // find the value and paint it
         // fix value position
-        d->reverseMapper.addPolygon(index.row(), index.column(), poly);
+        if (isOtherSlice) {
+            d->otherSliceShapes.append(poly);
+        } else {
+            d->reverseMapper.addPolygon(index.row(), index.column(), poly);
+        }
 
         painter->drawPolygon(poly);
     }
@@ -626,8 +866,8 @@ void PieDiagram::addSliceLabel(LabelPaintCache *lpc, const QRectF &drawPosition,
 {
     const qreal angleLen = d->angleLens[slice];
     const qreal startAngle = d->startAngles[slice];
-    const QModelIndex index(model()->index(0, slice, rootIndex())); // checked
-    const qreal sum = valueTotals();
+    const QModelIndex index(sliceIndex(slice));
+    const qreal sum = d->valueTotal;
 
     // Position points are calculated relative to the slice.
     // They are calculated as if the slice was 'standing' on its tip and the rim was up,
@@ -673,8 +913,16 @@ void PieDiagram::addSliceLabel(LabelPaintCache *lpc, const QRectF &drawPosition,
         }
     }
 
+    QString dataLabel;
+    if (int(slice) == d->otherSlice) {
+        // the label would show no value otherwise, the slice has no index
+        const DataValueAttributes dva(dataValueAttributes());
+        const qreal value = dva.usePercentage() ? d->sliceValues[slice] / sum * 100.0 : d->sliceValues[slice];
+        dataLabel = d->otherSliceLabel + QLatin1Char(' ') + d->formatNumber(value, dva.decimalDigits());
+    }
+
     d->addLabel(lpc, index, nullptr, points, Position::Center, Position::Center,
-                angleLen * sum / 360, favoriteTextAngle);
+                angleLen * sum / 360, favoriteTextAngle, dataLabel);
 }
 
 static bool doSpansOverlap(qreal s1Start, qreal s1End, qreal s2Start, qreal s2End)
@@ -716,8 +964,9 @@ static bool doArcsOverlap(qreal a1Start, qreal a1End, qreal a2Start, qreal a2End
   */
 void PieDiagram::draw3DEffect(QPainter *painter, const QRectF &drawPosition, uint slice)
 {
-    const QModelIndex index(model()->index(0, slice, rootIndex())); // checked
-    const ThreeDPieAttributes threeDAttrs(threeDPieAttributes(index));
+    const QModelIndex index(sliceIndex(slice));
+    const bool isOtherSlice = int(slice) == d->otherSlice;
+    const ThreeDPieAttributes threeDAttrs(isOtherSlice ? threeDPieAttributes() : threeDPieAttributes(index));
     if (!threeDAttrs.isEnabled()) {
         return;
     }
@@ -730,7 +979,7 @@ void PieDiagram::draw3DEffect(QPainter *painter, const QRectF &drawPosition, uin
 
     // No need to save the brush, will be changed on return from this
     // method anyway.
-    const QBrush brush = this->brush(model()->index(0, slice, rootIndex())); // checked
+    const QBrush brush = isOtherSlice ? d->otherSliceBrush : this->brush(index);
     if (threeDAttrs.useShadowColors()) {
         painter->setBrush(QBrush(brush.color().darker()));
     } else {
@@ -857,9 +1106,9 @@ void PieDiagram::draw3dOuterRim(QPainter *painter,
   \param angle the angle at which to search for a slice
   \return the number of the slice found
   */
-uint PieDiagram::findSliceAt(qreal angle, int colCount)
+uint PieDiagram::findSliceAt(qreal angle, int sliceCount)
 {
-    for (int i = 0; i < colCount; ++i) {
+    for (int i = 0; i < sliceCount; ++i) {
         qreal endseg = d->startAngles[i] + d->angleLens[i];
         if (d->startAngles[i] <= angle && endseg >= angle) {
             return i;
@@ -869,7 +1118,7 @@ uint PieDiagram::findSliceAt(qreal angle, int colCount)
     // If we have not found it, try wrap around
     // but only if the current searched angle is < 360 degree
     if (angle < 360)
-        return findSliceAt(angle + 360, colCount);
+        return findSliceAt(angle + 360, sliceCount);
     // otherwise - what ever went wrong - we return 0
     return 0;
 }
@@ -880,11 +1129,11 @@ uint PieDiagram::findSliceAt(qreal angle, int colCount)
   \param slice the slice to start the search from
   \return the number of the pie to the left of \c pie
   */
-uint PieDiagram::findLeftSlice(uint slice, int colCount)
+uint PieDiagram::findLeftSlice(uint slice, int sliceCount)
 {
     if (slice == 0) {
-        if (colCount > 1) {
-            return colCount - 1;
+        if (sliceCount > 1) {
+            return sliceCount - 1;
         } else {
             return 0;
         }
@@ -899,10 +1148,10 @@ uint PieDiagram::findLeftSlice(uint slice, int colCount)
   \param slice the slice to start the search from
   \return the number of the slice to the right of \c slice
   */
-uint PieDiagram::findRightSlice(uint slice, int colCount)
+uint PieDiagram::findRightSlice(uint slice, int sliceCount)
 {
     int rightSlice = slice + 1;
-    if (rightSlice == colCount) {
+    if (rightSlice == sliceCount) {
         rightSlice = 0;
     }
     return rightSlice;
@@ -928,13 +1177,9 @@ qreal PieDiagram::valueTotals() const
 {
     if (!model())
         return 0;
-    const int colCount = columnCount();
-    qreal total = 0.0;
     Q_ASSERT(model()->rowCount() >= 1);
-    for (int j = 0; j < colCount; ++j) {
-        total += qAbs(model()->data(model()->index(0, j, rootIndex())).toReal()); // checked
-    }
-    return total;
+    updateSlices();
+    return d->valueTotal;
 }
 
 /*virtual*/
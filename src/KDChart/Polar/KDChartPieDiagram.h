@@ -61,6 +61,64 @@ public:
     /// Return whether overlapping labels will be moved to until they don't overlap anymore.
     bool isLabelCollisionAvoidanceEnabled() const;
 
+    /**
+     * Aggregates all slices that would be narrower than @p degrees into one slice, painted
+     * after all other slices and labeled with otherSliceLabel() followed by the sum of their
+     * values. Pies of many small values stay readable that way, and only the remaining
+     * slices get a label.
+     *
+     * The aggregated slice does not belong to any of its datasets: it is painted with
+     * otherSliceBrush() and otherSlicePen(), uses the diagram-wide pie, 3D and data value
+     * attributes, and indexAt() does not return an index for it. Use isOtherSliceAt() and
+     * otherSliceIndexes() to find it and its datasets. A single narrow slice is not aggregated.
+     *
+     * The default is 0.0, which turns the aggregation off.
+     */
+    void setOtherSliceThreshold(qreal degrees);
+    qreal otherSliceThreshold() const;
+
+    /**
+     * Sets the label of the slice aggregating the slices narrower than otherSliceThreshold().
+     * The default is "Other".
+     */
+    void setOtherSliceLabel(const QString &label);
+    QString otherSliceLabel() const;
+
+    /**
+     * Sets the brush of the slice aggregating the slices narrower than otherSliceThreshold().
+     * The default is a light gray brush.
+     */
+    void setOtherSliceBrush(const QBrush &brush);
+    QBrush otherSliceBrush() const;
+
+    /**
+     * Sets the pen of the slice aggregating the slices narrower than otherSliceThreshold(),
+     * also used for the decorations of its label.
+     * The default is a pen of the color of otherSliceBrush(), like the default pen of a dataset.
+     */
+    void setOtherSlicePen(const QPen &pen);
+    QPen otherSlicePen() const;
+
+    /**
+     * Sets the tool tip the chart shows for the slice aggregating the slices narrower than
+     * otherSliceThreshold(). If no tool tip was set, the tool tip is otherSliceLabel()
+     * followed by the sum of the aggregated values.
+     */
+    void setOtherSliceToolTip(const QString &toolTip);
+    QString otherSliceToolTip() const;
+
+    /**
+     * Returns the indexes of the datasets aggregated into the "Other" slice, which is
+     * empty if there is no such slice.
+     */
+    QModelIndexList otherSliceIndexes() const;
+
+    /**
+     * Returns true if the "Other" slice or its label was painted at @p point the last
+     * time this diagram was painted.
+     */
+    bool isOtherSliceAt(const QPoint &point) const;
+
     /** \reimp */
     void resize(const QSizeF &area) override;
 
@@ -80,8 +138,14 @@ protected:
     void paintEvent(QPaintEvent *) override;
     void resizeEvent(QResizeEvent *) override;
 
+private Q_SLOTS:
+    void slotAttributesModelAboutToChange(AttributesModel *newModel, AttributesModel *oldModel);
+    void slotInvalidateSlices();
+
 private:
     // ### move to private class?
+    void updateSlices() const;
+    QModelIndex sliceIndex(uint slice) const;
     void placeLabels(PaintContext *paintContext);
     // Solve problems with label overlap by changing label positions inside d->labelPaintCache.
     void shuffleLabels(QRectF *textBoundingRect);
@@ -103,9 +167,9 @@ private:
     void calcPieSize(const QRectF &contentsRect);
     QRectF twoDPieRect(const QRectF &contentsRect, const ThreeDPieAttributes &threeDAttrs) const;
     QRectF explodedDrawPosition(const QRectF &drawPosition, uint slice) const;
-    uint findSliceAt(qreal angle, int columnCount);
-    uint findLeftSlice(uint slice, int columnCount);
-    uint findRightSlice(uint slice, int columnCount);
+    uint findSliceAt(qreal angle, int sliceCount);
+    uint findLeftSlice(uint slice, int sliceCount);
+    uint findRightSlice(uint slice, int sliceCount);
     QPointF pointOnEllipse(const QRectF &boundingBox, qreal angle);
 }; // End of class KDChartPieDiagram
 
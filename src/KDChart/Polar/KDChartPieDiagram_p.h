@@ -24,6 +24,13 @@
 
 #include "KDChartAbstractPieDiagram_p.h"
 
+#include <QBrush>
+#include <QPen>
+#include <QPersistentModelIndex>
+#include <QPolygonF>
+#include <QString>
+#include <QVector>
+
 #include <KDABLibFakes>
 
 namespace KDChart {
@@ -41,6 +48,12 @@ public:
 
     Private(const Private &rhs)
         : AbstractPieDiagram::Private(rhs)
+        , otherSliceThreshold(rhs.otherSliceThreshold)
+        , otherSliceLabel(rhs.otherSliceLabel)
+        , otherSliceBrush(rhs.otherSliceBrush)
+        , otherSlicePen(rhs.otherSlicePen)
+        , hasOtherSlicePen(rhs.hasOtherSlicePen)
+        , otherSliceToolTip(rhs.otherSliceToolTip)
         , startAngles()
         , angleLens()
         , size(0)
@@ -50,10 +63,34 @@ public:
         // just for consistency
     }
 
+    // the "Other" slice is labeled with an invalid index, it gets the diagram-wide attributes
+    CartesianDiagramDataCompressor::AggregatedDataValueAttributes aggregatedAttrs(
+        const QModelIndex &index,
+        const CartesianDiagramDataCompressor::CachePosition *position) const override;
+
 protected:
-    // this information needed temporarily at drawing time
+    // the slices of the first row, kept until the model or the slice settings change
+    mutable QVector<int> sliceColumns; // -1 for the "Other" slice
+    mutable QVector<int> otherSliceColumns; // the columns aggregated into the "Other" slice
+    mutable QVector<qreal> sliceValues; // absolute values, the sum of the aggregated ones for "Other"
+    mutable qreal valueTotal = 0.0;
+    mutable bool hasValues = false; // false if no cell had a numeric value
+    mutable int otherSlice = -1;
+    mutable bool slicesDirty = true;
+    mutable QPersistentModelIndex slicesRootIndex;
+    qreal otherSliceThreshold = 0.0;
+    QString otherSliceLabel;
+    QBrush otherSliceBrush;
+    QPen otherSlicePen;
+    bool hasOtherSlicePen = false;
+    QString otherSliceToolTip;
+    // the shapes of the "Other" slice and its label painted last, it has no model index
+    QVector<QPolygonF> otherSliceShapes;
+
+    // this information needed temporarily at drawing time, per slice
     QVector<qreal> startAngles;
     QVector<qreal> angleLens;
+    QVector<qreal> explodeFactors;
     qreal size;
     LabelPaintCache labelPaintCache;
     PieDiagram::LabelDecorations labelDecorations;
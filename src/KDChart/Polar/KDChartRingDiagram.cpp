@@ -21,6 +21,8 @@
 
 #include <QPainter>
 
+#include <limits>
+
 #include <KDABLibFakes>
 
 using namespace KDChart;
@@ -47,6 +49,62 @@ RingDiagram::~RingDiagram()
 
 void RingDiagram::init()
 {
+    // the values are read once and kept until they change
+    connect(this, SIGNAL(attributesModelAboutToChange(AttributesModel *, AttributesModel *)),
+            this, SLOT(slotAttributesModelAboutToChange(AttributesModel *, AttributesModel *)));
+    connect(this, SIGNAL(modelsChanged()), this, SLOT(slotInvalidateValues()));
+    slotAttributesModelAboutToChange(attributesModel(), nullptr);
+}
+
+void RingDiagram::slotAttributesModelAboutToChange(AttributesModel *newModel, AttributesModel *oldModel)
+{
+    if (oldModel)
+        disconnect(oldModel, nullptr, this, SLOT(slotInvalidateValues()));
+    if (newModel) {
+        connect(newModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(rowsInserted(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(columnsInserted(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(rowsRemoved(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(columnsRemoved(QModelIndex, int, int)),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(modelReset()),
+                this, SLOT(slotInvalidateValues()));
+        connect(newModel, SIGNAL(layoutChanged()),
+                this, SLOT(slotInvalidateValues()));
+    }
+    slotInvalidateValues();
+}
+
+void RingDiagram::slotInvalidateValues()
+{
+    d->valuesDirty = true;
+}
+
+// reads the values of all rings and sums them up, if the values changed
+void RingDiagram::updateValues() const
+{
+    if (!d->valuesDirty && d->valuesRootIndex == rootIndex())
+        return;
+    d->valuesDirty = false;
+    d->valuesRootIndex = rootIndex();
+
+    const int rCount = model() ? rowCount() : 0;
+    const int colCount = model() ? columnCount() : 0;
+    d->values = QVector<QVector<qreal>>(rCount, QVector<qreal>(colCount));
+    d->valueTotals = QVector<qreal>(rCount, 0.0);
+    for (int iRow = 0; iRow < rCount; ++iRow) {
+        for (int iColumn = 0; iColumn < colCount; ++iColumn) {
+            bool bOK;
+            const qreal cellValue = qAbs(model()->data(model()->index(iRow, iColumn, rootIndex())) // checked
+                                             .toReal(&bOK));
+            d->values[iRow][iColumn] = bOK ? cellValue : std::numeric_limits<qreal>::quiet_NaN();
+            d->valueTotals[iRow] += cellValue;
+        }
+    }
 }
 
 /**
@@ -158,8 +216,11 @@ void RingDiagram::paint(PaintContext *ctx)
     if (contentsRect.isEmpty())
         return;
 
+    updateValues();
     d->startAngles = QVector<QVector<qreal>>(rCount, QVector<qreal>(colCount));
     d->angleLens = QVector<QVector<qreal>>(rCount, QVector<qreal>(colCount));
+    d->maxExplodeFactors = QVector<qreal>(rCount, 0.0);
+    d->maxGapFactors = QVector<qreal>(rCount, 0.0);
 
     // compute position
     d->size = qMin(contentsRect.width(), contentsRect.height()); // initial size
@@ -174,6 +235,9 @@ void RingDiagram::paint(PaintContext *ctx)
             // qDebug() << cellAttrs.explodeFactor();
             const qreal explode = cellAttrs.explode() ? cellAttrs.explodeFactor() : 0.0;
             maxOffsetInThisRow = qMax(maxOffsetInThisRow, cellAttrs.gapFactor(false) + explode);
+            // for the radial offsets of the rings inside of this one
+            d->maxExplodeFactors[i] = qMax(d->maxExplodeFactors[i], explode);
+            d->maxGapFactors[i] = qMax(d->maxGapFactors[i], cellAttrs.gapFactor(false));
         }
         if (!d->expandWhenExploded) {
             maxOffsetInThisRow -= qreal(i);
@@ -200,7 +264,7 @@ void RingDiagram::paint(PaintContext *ctx)
 
     d->forgetAlreadyPaintedDataValues();
     for (int iRow = 0; iRow < rCount; ++iRow) {
-        const qreal sum = valueTotals(iRow);
+        const qreal sum = d->valueTotals.value(iRow);
         if (sum == 0.0) // nothing to draw
             continue;
         qreal currentValue = plane ? plane->startPosition() : 0.0;
@@ -208,11 +272,9 @@ void RingDiagram::paint(PaintContext *ctx)
 
         for (int iColumn = 0; iColumn < colCount; ++iColumn) {
             // is there anything at all at this column?
-            bool bOK;
-            const qreal cellValue = qAbs(model()->data(model()->index(iRow, iColumn, rootIndex())) // checked
-                                             .toReal(&bOK));
+            const qreal cellValue = d->values[iRow][iColumn];
 
-            if (bOK) {
+            if (!ISNAN(cellValue)) {
                 d->startAngles[iRow][iColumn] = currentValue;
                 d->angleLens[iRow][iColumn] = cellValue * sectorsPerValue;
             } else { // mark as non-existent
@@ -272,7 +334,6 @@ void RingDiagram::drawPieSurface(QPainter *painter, uint dataset, uint slice, qr
         const ThreeDPieAttributes threeDAttrs(threeDPieAttributes(index));
 
         const int rCount = rowCount();
-        const int colCount = columnCount();
 
         int iPoint = 0;
 
@@ -315,21 +376,11 @@ void RingDiagram::drawPieSurface(QPainter *painter, uint dataset, uint slice, qr
             qreal totalRadialGap = 0.0;
             qreal maxRadialGap = 0.0;
             for (uint i = rCount - 1; i > dataset; --i) {
-                qreal maxRadialExplodeInThisRow = 0.0;
-                qreal maxRadialGapInThisRow = 0.0;
-                for (int j = 0; j < colCount; ++j) {
-                    const PieAttributes cellAttrs(pieAttributes(model()->index(i, j, rootIndex()))); // checked
-                    if (d->expandWhenExploded) {
-                        maxRadialGapInThisRow = qMax(maxRadialGapInThisRow, cellAttrs.gapFactor(false));
-                    }
-
-                    // Don't use a gap for the very inner circle
-                    if (cellAttrs.explode() && d->expandWhenExploded) {
-                        maxRadialExplodeInThisRow = qMax(maxRadialExplodeInThisRow, cellAttrs.explodeFactor());
-                    }
+                // Don't use a gap for the very inner circle
+                if (d->expandWhenExploded) {
+                    maxRadialExplode += d->maxExplodeFactors[i];
+                    maxRadialGap += d->maxGapFactors[i];
                 }
-                maxRadialExplode += maxRadialExplodeInThisRow;
-                maxRadialGap += maxRadialGapInThisRow;
 
                 // FIXME: What if explode factor of inner ring is > 1.0 ?
                 // if ( !d->expandWhenExploded )
@@ -379,7 +430,7 @@ void RingDiagram::drawPieSurface(QPainter *painter, uint dataset, uint slice, qr
             // qDebug() << poly;
             // find the value and paint it
             // fix value position
-            const qreal sum = valueTotals(dataset);
+            const qreal sum = d->valueTotals[dataset];
             painter->drawPolygon(poly);
 
             d->reverseMapper.addPolygon(index.row(), index.column(), poly);
@@ -438,26 +489,18 @@ QPointF RingDiagram::pointOnEllipse(const QRectF &rect, int dataset, int slice,
 /*virtual*/
 qreal RingDiagram::valueTotals() const
 {
-    const int rCount = rowCount();
-    const int colCount = columnCount();
+    updateValues();
     qreal total = 0.0;
-    for (int i = 0; i < rCount; ++i) {
-        for (int j = 0; j < colCount; ++j) {
-            total += qAbs(model()->data(model()->index(i, j, rootIndex())).toReal()); // checked
-        }
-    }
+    Q_FOREACH (qreal datasetTotal, d->valueTotals)
+        total += datasetTotal;
     return total;
 }
 
 qreal RingDiagram::valueTotals(int dataset) const
 {
     Q_ASSERT(dataset < model()->rowCount());
-    const int colCount = columnCount();
-    qreal total = 0.0;
-    for (int j = 0; j < colCount; ++j) {
-        total += qAbs(model()->data(model()->index(dataset, j, rootIndex())).toReal()); // checked
-    }
-    return total;
+    updateValues();
+    return d->valueTotals.value(dataset);
 }
 
 /*virtual*/
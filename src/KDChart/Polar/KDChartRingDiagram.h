@@ -17,6 +17,11 @@ namespace KDChart {
 
 /**
  * @brief RingDiagram defines a common ring diagram
+ *
+ * Each row of the model is a ring, each column a slice of every ring. Unlike
+ * PieDiagram, rings do not aggregate narrow slices into an "Other" slice: a
+ * slice has the same brush and legend entry in all rings, which an aggregate
+ * of different columns in each ring would not.
  */
 class KDCHART_EXPORT RingDiagram : public AbstractPieDiagram
 {
@@ -69,7 +74,12 @@ protected:
     void paintEvent(QPaintEvent *) override;
     void resizeEvent(QResizeEvent *) override;
 
+private Q_SLOTS:
+    void slotAttributesModelAboutToChange(AttributesModel *newModel, AttributesModel *oldModel);
+    void slotInvalidateValues();
+
 private:
+    void updateValues() const;
     void drawOneSlice(QPainter *painter, uint dataset, uint slice, qreal granularity);
     void drawPieSurface(QPainter *painter, uint dataset, uint slice, qreal granularity);
     QPointF pointOnEllipse(const QRectF &rect, int dataset, int slice, bool outer, qreal angle,
@@ -24,6 +24,9 @@
 
 #include "KDChartAbstractPieDiagram_p.h"
 
+#include <QPersistentModelIndex>
+#include <QVector>
+
 #include <KDABLibFakes>
 
 namespace KDChart {
@@ -55,6 +58,15 @@ protected:
     // this information needed temporarily at drawing time
     QVector<QVector<qreal>> startAngles;
     QVector<QVector<qreal>> angleLens;
+    // the absolute values of each dataset, NaN where a cell has no numeric value,
+    // kept until the model changes
+    mutable QVector<QVector<qreal>> values;
+    mutable QVector<qreal> valueTotals; // of each dataset
+    mutable bool valuesDirty = true;
+    mutable QPersistentModelIndex valuesRootIndex;
+    // the largest explode and gap factors of each dataset, looked up once per paint
+    QVector<qreal> maxExplodeFactors;
+    QVector<qreal> maxGapFactors;
     QRectF position;
     qreal size;
     bool relativeThickness = false;
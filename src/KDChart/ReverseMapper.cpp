@@ -10,9 +10,10 @@
 
 #include "ReverseMapper.h"
 
+#include <algorithm>
+#include <functional>
 #include <math.h>
 
-#include <QGraphicsScene>
 #include <QPainterPath>
 #include <QPolygonF>
 #include <QRect>
@@ -23,6 +24,27 @@
 
 using namespace KDChart;
 
+namespace {
+// the grid gets about this many shapes per cell
+const int ShapesPerGridCell = 4;
+const int MaxGridCells = 1 << 16;
+
+// odd-even rule, like the QGraphicsPolygonItem that used to be hit-tested here
+bool polygonContains(const QPointF *points, int count, const QPointF &point)
+{
+    bool inside = false;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        const QPointF &a = points[i];
+        const QPointF &b = points[j];
+        if ((a.y() > point.y()) != (b.y() > point.y())
+            && point.x() < (b.x() - a.x()) * (point.y() - a.y()) / (b.y() - a.y()) + a.x()) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+}
+
 ReverseMapper::ReverseMapper()
 {
 }
@@ -34,8 +56,6 @@ ReverseMapper::ReverseMapper(AbstractDiagram *diagram)
 
 ReverseMapper::~ReverseMapper()
 {
-    delete m_scene;
-    m_scene = nullptr;
 }
 
 void ReverseMapper::setDiagram(AbstractDiagram *diagram)
@@ -43,73 +63,198 @@ void ReverseMapper::setDiagram(AbstractDiagram *diagram)
     m_diagram = diagram;
 }
 
+void ReverseMapper::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled)
+        clear();
+}
+
+bool ReverseMapper::isEnabled() const
+{
+    return m_enabled;
+}
+
 void ReverseMapper::clear()
 {
-    m_itemMap.clear();
-    delete m_scene;
-    m_scene = new QGraphicsScene();
+    // resize() instead of clear() keeps the allocations for the next paint
+    m_shapes.resize(0);
+    m_points.resize(0);
+    m_indexDirty = true;
 }
 
-QModelIndexList ReverseMapper::indexesIn(const QRect &rect) const
+QPolygonF ReverseMapper::shapePolygon(const Shape &shape) const
 {
-    Q_ASSERT(m_diagram);
-    if (m_scene && m_scene->sceneRect().intersects(rect)) {
-        QList<QGraphicsItem *> items = m_scene->items(rect);
-        QModelIndexList indexes;
-        Q_FOREACH (QGraphicsItem *item, items) {
-            auto *i = qgraphicsitem_cast<ChartGraphicsItem *>(item);
-            if (i) {
-                QModelIndex index(m_diagram->model()->index(i->row(), i->column(), m_diagram->rootIndex())); // checked
-                indexes << index;
+    return QPolygonF(m_points.mid(shape.firstPoint, shape.pointCount));
+}
+
+QModelIndex ReverseMapper::modelIndex(const Shape &shape) const
+{
+    return m_diagram->model()->index(shape.row, shape.column, m_diagram->rootIndex()); // checked
+}
+
+int ReverseMapper::lastShape(int row, int column) const
+{
+    buildIndex();
+    return m_lastShape.value(qMakePair(row, column), -1);
+}
+
+int ReverseMapper::gridColumn(qreal x) const
+{
+    return qBound(0, int(floor((x - m_bounds.left()) / m_cellWidth)), m_gridColumns - 1);
+}
+
+int ReverseMapper::gridRow(qreal y) const
+{
+    return qBound(0, int(floor((y - m_bounds.top()) / m_cellHeight)), m_gridRows - 1);
+}
+
+void ReverseMapper::buildIndex() const
+{
+    if (!m_indexDirty)
+        return;
+    m_indexDirty = false;
+
+    m_lastShape.clear();
+    m_cellStart.clear();
+    m_cellShapes.clear();
+    m_gridColumns = 0;
+    m_gridRows = 0;
+    m_bounds = QRectF();
+    if (m_shapes.isEmpty())
+        return;
+
+    qreal left = m_shapes.first().boundingRect.left();
+    qreal top = m_shapes.first().boundingRect.top();
+    qreal right = m_shapes.first().boundingRect.right();
+    qreal bottom = m_shapes.first().boundingRect.bottom();
+    for (int i = 0; i < m_shapes.size(); ++i) {
+        const Shape &shape = m_shapes.at(i);
+        m_lastShape.insert(qMakePair(shape.row, shape.column), i);
+        left = qMin(left, shape.boundingRect.left());
+        top = qMin(top, shape.boundingRect.top());
+        right = qMax(right, shape.boundingRect.right());
+        bottom = qMax(bottom, shape.boundingRect.bottom());
+    }
+    m_bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+
+    // roughly square cells
+    const qreal width = qMax(m_bounds.width(), qreal(1.0));
+    const qreal height = qMax(m_bounds.height(), qreal(1.0));
+    const int cellCount = qBound(1, m_shapes.size() / ShapesPerGridCell, MaxGridCells);
+    m_gridColumns = qBound(1, qRound(sqrt(cellCount * width / height)), cellCount);
+    m_gridRows = qMax(1, cellCount / m_gridColumns);
+    m_cellWidth = width / m_gridColumns;
+    m_cellHeight = height / m_gridRows;
+
+    // counting sort of the shapes into the cells they overlap, keeping the order they were added in
+    m_cellStart.fill(0, m_gridColumns * m_gridRows + 1);
+    for (const Shape &shape : m_shapes) {
+        const QRectF &rect = shape.boundingRect;
+        for (int row = gridRow(rect.top()); row <= gridRow(rect.bottom()); ++row) {
+            for (int column = gridColumn(rect.left()); column <= gridColumn(rect.right()); ++column) {
+                ++m_cellStart[row * m_gridColumns + column + 1];
             }
         }
-        return indexes;
-    } else {
+    }
+    for (int cell = 1; cell < m_cellStart.size(); ++cell)
+        m_cellStart[cell] += m_cellStart[cell - 1];
+
+    m_cellShapes.resize(m_cellStart.last());
+    QVector<int> next = m_cellStart;
+    for (int i = 0; i < m_shapes.size(); ++i) {
+        const QRectF &rect = m_shapes.at(i).boundingRect;
+        for (int row = gridRow(rect.top()); row <= gridRow(rect.bottom()); ++row) {
+            for (int column = gridColumn(rect.left()); column <= gridColumn(rect.right()); ++column) {
+                m_cellShapes[next[row * m_gridColumns + column]++] = i;
+            }
+        }
+    }
+}
+
+QVector<int> ReverseMapper::candidates(const QRectF &rect) const
+{
+    QVector<int> ids;
+    for (int row = gridRow(rect.top()); row <= gridRow(rect.bottom()); ++row) {
+        for (int column = gridColumn(rect.left()); column <= gridColumn(rect.right()); ++column) {
+            const int cell = row * m_gridColumns + column;
+            for (int i = m_cellStart.at(cell); i < m_cellStart.at(cell + 1); ++i)
+                ids << m_cellShapes.at(i);
+        }
+    }
+    // like QGraphicsScene::items(), the topmost (last added) shape comes first
+    std::sort(ids.begin(), ids.end(), std::greater<int>());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+QModelIndexList ReverseMapper::indexesIn(const QRect &rect) const
+{
+    Q_ASSERT(m_diagram);
+    buildIndex();
+    const QRectF area(rect);
+    if (m_shapes.isEmpty() || !m_bounds.intersects(area))
         return QModelIndexList();
+
+    QModelIndexList indexes;
+    Q_FOREACH (int id, candidates(area)) {
+        const Shape &shape = m_shapes.at(id);
+        if (!shape.boundingRect.intersects(area))
+            continue;
+        if (!area.contains(shape.boundingRect)) {
+            QPainterPath path;
+            path.addPolygon(shapePolygon(shape));
+            path.closeSubpath();
+            if (!path.intersects(area))
+                continue;
+        }
+        indexes << modelIndex(shape);
     }
+    return indexes;
 }
 
 QModelIndexList ReverseMapper::indexesAt(const QPointF &point) const
 {
     Q_ASSERT(m_diagram);
-    if (m_scene && m_scene->sceneRect().contains(point)) {
-        QList<QGraphicsItem *> items = m_scene->items(point);
-        QModelIndexList indexes;
-        Q_FOREACH (QGraphicsItem *item, items) {
-            auto *i = qgraphicsitem_cast<ChartGraphicsItem *>(item);
-            if (i) {
-                QModelIndex index(m_diagram->model()->index(i->row(), i->column(), m_diagram->rootIndex())); // checked
-                if (!indexes.contains(index))
-                    indexes << index;
-            }
-        }
-        return indexes;
-    } else {
+    buildIndex();
+    if (m_shapes.isEmpty() || !m_bounds.contains(point))
         return QModelIndexList();
+
+    QModelIndexList indexes;
+    const int cell = gridRow(point.y()) * m_gridColumns + gridColumn(point.x());
+    // the shapes of a cell are in the order they were added, the topmost comes first in the result
+    for (int i = m_cellStart.at(cell + 1) - 1; i >= m_cellStart.at(cell); --i) {
+        const Shape &shape = m_shapes.at(m_cellShapes.at(i));
+        if (!shape.boundingRect.contains(point)
+            || !polygonContains(m_points.constData() + shape.firstPoint, shape.pointCount, point))
+            continue;
+        const QModelIndex index = modelIndex(shape);
+        if (!indexes.contains(index))
+            indexes << index;
     }
+    return indexes;
 }
 
 QPolygonF ReverseMapper::polygon(int row, int column) const
 {
     if (!m_diagram->model()->hasIndex(row, column, m_diagram->rootIndex()))
         return QPolygon();
-    const QModelIndex index = m_diagram->model()->index(row, column, m_diagram->rootIndex()); // checked
-    return m_itemMap.contains(index) ? m_itemMap[index]->polygon() : QPolygon();
+    const int shape = lastShape(row, column);
+    return shape >= 0 ? shapePolygon(m_shapes.at(shape)) : QPolygonF();
 }
 
 QRectF ReverseMapper::boundingRect(int row, int column) const
 {
     if (!m_diagram->model()->hasIndex(row, column, m_diagram->rootIndex()))
         return QRectF();
-    const QModelIndex index = m_diagram->model()->index(row, column, m_diagram->rootIndex()); // checked
-    return m_itemMap.contains(index) ? m_itemMap[index]->polygon().boundingRect() : QRectF();
+    const int shape = lastShape(row, column);
+    return shape >= 0 ? m_shapes.at(shape).boundingRect : QRectF();
 }
 
 void ReverseMapper::addItem(ChartGraphicsItem *item)
 {
-    Q_ASSERT(m_scene);
-    m_scene->addItem(item);
-    m_itemMap.insert(m_diagram->model()->index(item->row(), item->column(), m_diagram->rootIndex()), item); // checked
+    addPolygon(item->row(), item->column(), item->polygon());
+    delete item;
 }
 
 void ReverseMapper::addRect(int row, int column, const QRectF &rect)
@@ -119,13 +264,23 @@ void ReverseMapper::addRect(int row, int column, const QRectF &rect)
 
 void ReverseMapper::addPolygon(int row, int column, const QPolygonF &polygon)
 {
-    auto *item = new ChartGraphicsItem(row, column);
-    item->setPolygon(polygon);
-    addItem(item);
+    if (!m_enabled)
+        return;
+    Shape shape;
+    shape.boundingRect = polygon.boundingRect();
+    shape.row = row;
+    shape.column = column;
+    shape.firstPoint = m_points.size();
+    shape.pointCount = polygon.size();
+    m_points += polygon;
+    m_shapes.append(shape);
+    m_indexDirty = true;
 }
 
 void ReverseMapper::addCircle(int row, int column, const QPointF &location, const QSizeF &diameter)
 {
+    if (!m_enabled)
+        return;
     QPainterPath path;
     QPointF ossfet(-0.5 * diameter.width(), -0.5 * diameter.height());
     path.addEllipse(QRectF(location + ossfet, diameter));
@@ -134,6 +289,8 @@ void ReverseMapper::addCircle(int row, int column, const QPointF &location, cons
 
 void ReverseMapper::addLine(int row, int column, const QPointF &from, const QPointF &to)
 {
+    if (!m_enabled)
+        return;
     // that's no line, dude... make a small circle around that point, instead
     if (from == to) {
         addCircle(row, column, from, QSizeF(1.5, 1.5));
@@ -13,10 +13,12 @@
 
 #include <QHash>
 #include <QModelIndex>
+#include <QPair>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
-class QRectF;
-class QGraphicsScene;
 class QPolygonF;
 QT_END_NAMESPACE
 
@@ -27,6 +29,9 @@ class ChartGraphicsItem;
 
 /**
  * @brief The ReverseMapper stores information about objects on a chart and their respective model indexes
+ *
+ * The shapes are stored in flat arrays while painting; the spatial index that answers
+ * indexesAt() and indexesIn() is only built on the first query after painting.
  * \internal
  */
 class ReverseMapper
@@ -39,6 +44,10 @@ public:
 
     void setDiagram(AbstractDiagram *diagram);
 
+    // a disabled ReverseMapper ignores all shapes added to it, so all queries come back empty
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
     void clear();
 
     QModelIndexList indexesAt(const QPointF &point) const;
@@ -47,6 +56,7 @@ public:
     QPolygonF polygon(int row, int column) const;
     QRectF boundingRect(int row, int column) const;
 
+    // takes ownership of item, only its polygon, row and column are kept
     void addItem(ChartGraphicsItem *item);
 
     // convenience methods:
@@ -56,9 +66,41 @@ public:
     void addLine(int row, int column, const QPointF &from, const QPointF &to);
 
 private:
-    QGraphicsScene *m_scene = nullptr;
+    struct Shape
+    {
+        QRectF boundingRect;
+        int row;
+        int column;
+        int firstPoint; // into m_points
+        int pointCount;
+    };
+
+    QPolygonF shapePolygon(const Shape &shape) const;
+    QModelIndex modelIndex(const Shape &shape) const;
+    int lastShape(int row, int column) const;
+    void buildIndex() const;
+    int gridColumn(qreal x) const;
+    int gridRow(qreal y) const;
+    // ids of the shapes in the grid cells touching rect, in descending order
+    QVector<int> candidates(const QRectF &rect) const;
+
     AbstractDiagram *m_diagram = nullptr;
-    QHash<QModelIndex, ChartGraphicsItem *> m_itemMap;
+    bool m_enabled = true;
+    QVector<Shape> m_shapes;
+    QVector<QPointF> m_points;
+
+    // uniform grid over all shapes: the shapes overlapping grid cell i are
+    // m_cellShapes[m_cellStart[i]] .. m_cellShapes[m_cellStart[i + 1] - 1]
+    mutable bool m_indexDirty = false;
+    mutable QRectF m_bounds;
+    mutable int m_gridColumns = 0;
+    mutable int m_gridRows = 0;
+    mutable qreal m_cellWidth = 1.0;
+    mutable qreal m_cellHeight = 1.0;
+    mutable QVector<int> m_cellStart;
+    mutable QVector<int> m_cellShapes;
+    // the most recently added shape of each (row, column)
+    mutable QHash<QPair<int, int>, int> m_lastShape;
 };
 }
 
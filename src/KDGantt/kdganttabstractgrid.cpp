@@ -104,6 +104,33 @@ QVariant AbstractGrid::mapFromChart(qreal x) const
     return QVariant();
 }
 
+/*!
+ * If the grid maps the data in the model linearly to the view, stores
+ * the location of the item \a idx in units that do not depend on the
+ * settings of the grid, like a zoom factor, in \a span and returns true.
+ * Returns false otherwise.
+ *
+ * The scene caches these spans and moves the items by
+ * timelineTransform() when the grid changes, without reading the model.
+ * Of the grids in KD Gantt, DateTimeGrid maps the model linearly.
+ * \sa DateTimeGrid::setLinearTimeline()
+ */
+bool AbstractGrid::mapToTimeline(const QModelIndex &idx, Span *span) const
+{
+    return d->mapToTimeline(this, idx, span);
+}
+
+/*!
+ * If the grid maps the data in the model linearly to the view, stores
+ * the values mapping a location x returned by mapToTimeline() to the
+ * view, as ( x - \a origin ) * \a scale, and returns true.
+ * Returns false otherwise.
+ */
+bool AbstractGrid::timelineTransform(qreal *origin, qreal *scale) const
+{
+    return d->timelineTransform(this, origin, scale);
+}
+
 /*!\fn virtual Span AbstractGrid::mapToChart( const QModelIndex& idx ) const
  * Implement this to map from the data in the model to the location of
  * the corresponding item in the view.
@@ -43,6 +43,8 @@ public:
                               const QList<Constraint> &constraints = QList<Constraint>()) const = 0;
     virtual qreal mapToChart(const QVariant &value) const;
     virtual QVariant mapFromChart(qreal x) const;
+    bool mapToTimeline(const QModelIndex &idx, Span *span) const;
+    bool timelineTransform(qreal *origin, qreal *scale) const;
     bool isSatisfiedConstraint(const Constraint &c) const;
 
     virtual void paintGrid(QPainter *painter, const QRectF &sceneRect, const QRectF &exposedRect,
@@ -21,6 +21,27 @@ namespace KDGantt {
 class AbstractGrid::Private
 {
 public:
+    virtual ~Private()
+    {
+    }
+
+    /* See AbstractGrid::mapToTimeline(), only grids mapping the model
+     * linearly to the view reimplement these */
+    virtual bool mapToTimeline(const AbstractGrid *grid, const QModelIndex &idx, Span *span) const
+    {
+        Q_UNUSED(grid);
+        Q_UNUSED(idx);
+        Q_UNUSED(span);
+        return false;
+    }
+    virtual bool timelineTransform(const AbstractGrid *grid, qreal *origin, qreal *scale) const
+    {
+        Q_UNUSED(grid);
+        Q_UNUSED(origin);
+        Q_UNUSED(scale);
+        return false;
+    }
+
     QPointer<QAbstractItemModel> model;
     QPersistentModelIndex root;
 };
@@ -56,6 +56,121 @@ void ConstraintModel::Private::removeConstraintFromIndex(const QModelIndex &idx,
     }
 }
 
+void ConstraintModel::Private::watchModel(const QAbstractItemModel *model)
+{
+    if (!model || watchedModels.contains(model))
+        return;
+    watchedModels.insert(model);
+
+    auto *m = const_cast<QAbstractItemModel *>(model);
+    QObject::connect(m, SIGNAL(rowsAboutToBeInserted(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(rowsAboutToBeMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(columnsAboutToBeInserted(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(columnsInserted(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(columnsAboutToBeRemoved(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(columnsRemoved(const QModelIndex &, int, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(columnsAboutToBeMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(columnsMoved(const QModelIndex &, int, int, const QModelIndex &, int)),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(layoutAboutToBeChanged()),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(layoutChanged()),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(modelAboutToBeReset()),
+                     q, SLOT(slotModelAboutToChange()));
+    QObject::connect(m, SIGNAL(modelReset()),
+                     q, SLOT(slotModelChanged()));
+    QObject::connect(m, SIGNAL(destroyed(QObject *)),
+                     q, SLOT(slotModelDestroyed(QObject *)));
+}
+
+/* Between the "about to" signal of a model and the change itself, the
+ * persistent indexes still point to the old rows; some of the views'
+ * own slots run before ours, so the map is not trusted until we heard
+ * of the change.
+ */
+bool ConstraintModel::Private::isIndexMapUsable() const
+{
+    if (pendingModelChanges > 0)
+        return false;
+    if (indexMapDirty)
+        rebuildIndexMap();
+    return true;
+}
+
+void ConstraintModel::Private::rebuildIndexMap() const
+{
+    indexMap.clear();
+    indexMap.reserve(2 * constraints.size());
+    Q_FOREACH (const Constraint &c, constraints) {
+        indexMap.insert(c.startIndex(), c);
+        if (c.endIndex() != c.startIndex())
+            indexMap.insert(c.endIndex(), c);
+    }
+    indexMapDirty = false;
+}
+
+/* Looks for a constraint between the same indexes as \a c, among the
+ * constraints of its start index when possible.
+ */
+bool ConstraintModel::Private::containsConstraint(const Constraint &c, Constraint *found) const
+{
+    // Invalid indexes do not compare equal to each other as keys, see constraintsForIndex()
+    if (c.startIndex().isValid() && c.endIndex().isValid() && isIndexMapUsable()) {
+        IndexType::const_iterator it = indexMap.constFind(c.startIndex());
+        for (; it != indexMap.constEnd() && it.key() == c.startIndex(); ++it) {
+            if (c.compareIndexes(*it)) {
+                if (found)
+                    *found = *it;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (int i = 0; i < constraints.count(); i++) {
+        if (c.compareIndexes(constraints.at(i))) {
+            if (found)
+                *found = constraints.at(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConstraintModel::Private::slotModelAboutToChange()
+{
+    ++pendingModelChanges;
+    indexMapDirty = true;
+}
+
+void ConstraintModel::Private::slotModelChanged()
+{
+    pendingModelChanges = qMax(0, pendingModelChanges - 1);
+    indexMapDirty = true;
+}
+
+void ConstraintModel::Private::slotModelDestroyed(QObject *model)
+{
+    watchedModels.remove(static_cast<QAbstractItemModel *>(model));
+    indexMapDirty = true;
+}
+
 /*! Constructor. Creates an empty ConstraintModel with parent \a parent
  */
 ConstraintModel::ConstraintModel(QObject *parent)
@@ -83,6 +198,7 @@ ConstraintModel::~ConstraintModel()
 
 void ConstraintModel::init()
 {
+    d->q = this;
 }
 
 namespace {
@@ -108,21 +224,28 @@ struct compare_constraint_indexes_to
 void ConstraintModel::addConstraint(const Constraint &c)
 {
     // qDebug() << "ConstraintModel::addConstraint("<<c<<") (this="<<this<<") items=" << d->constraints.size();
-    QList<Constraint>::iterator it = std::find_if(d->constraints.begin(),
-                                                  d->constraints.end(),
-                                                  compare_constraint_indexes_to(c));
+    Constraint existing;
+    const bool hasExisting = d->containsConstraint(c, &existing);
 
-    if (it == d->constraints.end()) {
+    if (!hasExisting) {
         d->constraints.push_back(c);
-        d->addConstraintToIndex(c.startIndex(), c);
-        d->addConstraintToIndex(c.endIndex(), c);
+        d->watchModel(c.startIndex().model());
+        d->watchModel(c.endIndex().model());
+        if (d->isIndexMapUsable()) {
+            d->addConstraintToIndex(c.startIndex(), c);
+            d->addConstraintToIndex(c.endIndex(), c);
+        }
         emit constraintAdded(c);
-    } else if ((*it).dataMap() != c.dataMap()) {
-        Constraint tmp(*it); // save to avoid re-entrancy issues
+    } else if (existing.dataMap() != c.dataMap()) {
+        Constraint tmp(existing); // save to avoid re-entrancy issues
         removeConstraint(tmp);
         d->constraints.push_back(c);
-        d->addConstraintToIndex(c.startIndex(), c);
-        d->addConstraintToIndex(c.endIndex(), c);
+        d->watchModel(c.startIndex().model());
+        d->watchModel(c.endIndex().model());
+        if (d->isIndexMapUsable()) {
+            d->addConstraintToIndex(c.startIndex(), c);
+            d->addConstraintToIndex(c.endIndex(), c);
+        }
         emit constraintAdded(c);
     }
 }
@@ -136,6 +259,9 @@ void ConstraintModel::addConstraint(const Constraint &c)
  */
 bool ConstraintModel::removeConstraint(const Constraint &c)
 {
+    if (!d->containsConstraint(c))
+        return false;
+
     bool rc = false;
 
     for (int i = 0; i < d->constraints.count(); i++) {
@@ -146,8 +272,10 @@ bool ConstraintModel::removeConstraint(const Constraint &c)
     }
 
     if (rc) {
-        d->removeConstraintFromIndex(c.startIndex(), c);
-        d->removeConstraintFromIndex(c.endIndex(), c);
+        if (d->isIndexMapUsable()) {
+            d->removeConstraintFromIndex(c.startIndex(), c);
+            d->removeConstraintFromIndex(c.endIndex(), c);
+        }
         emit constraintRemoved(c);
     }
 
@@ -194,7 +322,7 @@ QList<Constraint> ConstraintModel::constraints() const
 QList<Constraint> ConstraintModel::constraintsForIndex(const QModelIndex &idx) const
 {
     // TODO: @Steffen: Please comment on this assert, it's long and not obvious (Johannes)
-    assert(!idx.isValid() || d->indexMap.isEmpty() || !d->indexMap.keys().front().model() || idx.model() == d->indexMap.keys().front().model());
+    assert(!idx.isValid() || d->indexMap.isEmpty() || !d->indexMap.constBegin().key().model() || idx.model() == d->indexMap.constBegin().key().model());
     if (!idx.isValid()) {
         // Because of a Qt bug we need to treat this as a special case
         QSet<Constraint> result;
@@ -203,6 +331,8 @@ QList<Constraint> ConstraintModel::constraintsForIndex(const QModelIndex &idx) c
                 result.insert(c);
         }
         return result.values();
+    } else if (d->isIndexMapUsable()) {
+        return d->indexMap.values(idx);
     } else {
         QList<Constraint> result;
         Q_FOREACH (const Constraint &c, d->constraints) {
@@ -211,8 +341,6 @@ QList<Constraint> ConstraintModel::constraintsForIndex(const QModelIndex &idx) c
         }
         return result;
     }
-
-    // return d->indexMap.values( idx );
 }
 
 /*! Returns true if a Constraint with start \a s and end \a e
@@ -227,13 +355,7 @@ bool ConstraintModel::hasConstraint(const Constraint &c) const
     }
     return false;
     */
-    bool hc = false;
-
-    for (int i = 0; i < d->constraints.count(); i++)
-        if (c.compareIndexes(d->constraints.at(i)))
-            hc = true;
-
-    return hc;
+    return d->containsConstraint(c);
 }
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -250,6 +372,8 @@ QDebug operator<<(QDebug dbg, const KDGantt::ConstraintModel &model)
 
 #endif /* QT_NO_DEBUG_STREAM */
 
+#include "moc_kdganttconstraintmodel.cpp"
+
 #undef d
 
 #ifndef KDAB_NO_UNIT_TESTS
@@ -315,6 +439,50 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintModel, "test")
     assertTrue(model.hasConstraint(Constraint(idx1, idx2)));
 }
 
-#endif /* KDAB_NO_UNIT_TESTS */
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintModelIndexMap, "test")
+{
+    QStandardItemModel dummyModel(100, 1);
+    for (int row = 0; row < 100; ++row)
+        dummyModel.setData(dummyModel.index(row, 0), row);
+    ConstraintModel model;
+    for (int row = 0; row + 1 < 100; ++row)
+        model.addConstraint(Constraint(dummyModel.index(row, 0), dummyModel.index(row + 1, 0)));
+    assertEqual(model.constraints().count(), 99);
+    assertEqual(model.constraintsForIndex(dummyModel.index(0, 0)).count(), 1);
+    assertEqual(model.constraintsForIndex(dummyModel.index(50, 0)).count(), 2);
+
+    // The lookup follows the rows when they are moved around
+    const QPersistentModelIndex idx50 = dummyModel.index(50, 0);
+    const QPersistentModelIndex idx51 = dummyModel.index(51, 0);
+    dummyModel.sort(0, Qt::DescendingOrder);
+    assertEqual(idx50.row(), 49);
+    assertEqual(model.constraintsForIndex(idx50).count(), 2);
+    assertEqual(model.constraintsForIndex(dummyModel.index(99, 0)).count(), 1);
+    assertTrue(model.hasConstraint(Constraint(idx50, idx51)));
+    assertFalse(model.hasConstraint(Constraint(idx51, idx50)));
+
+    dummyModel.insertRows(10, 5);
+    assertEqual(model.constraintsForIndex(idx50).count(), 2);
+    assertEqual(model.constraintsForIndex(dummyModel.index(10, 0)).count(), 0);
+
+    // Removed rows leave constraints with an invalid end behind
+    dummyModel.removeRows(0, 20);
+    assertEqual(model.constraintsForIndex(idx50).count(), 2);
+    assertEqual(model.constraintsForIndex(dummyModel.index(0, 0)).count(), 2);
+
+    for (int row = 0; row < dummyModel.rowCount(); ++row) {
+        const QModelIndex idx = dummyModel.index(row, 0);
+        int expected = 0;
+        Q_FOREACH (const Constraint &c, model.constraints()) {
+            if (c.startIndex() == idx || c.endIndex() == idx)
+                ++expected;
+        }
+        assertEqual(model.constraintsForIndex(idx).count(), expected);
+    }
 
-#include "moc_kdganttconstraintmodel.cpp"
+    model.removeConstraint(Constraint(idx50, idx51));
+    assertEqual(model.constraintsForIndex(idx50).count(), 1);
+    assertFalse(model.hasConstraint(Constraint(idx50, idx51)));
+}
+
+#endif /* KDAB_NO_UNIT_TESTS */
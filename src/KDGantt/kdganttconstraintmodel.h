@@ -22,6 +22,11 @@ class KDGANTT_EXPORT ConstraintModel : public QObject
 {
     Q_OBJECT
     KDGANTT_DECLARE_PRIVATE_DERIVED_PARENT(ConstraintModel, QObject *)
+
+    /* slots for QAbstractItemModel signals */
+    Q_PRIVATE_SLOT(d, void slotModelAboutToChange())
+    Q_PRIVATE_SLOT(d, void slotModelChanged())
+    Q_PRIVATE_SLOT(d, void slotModelDestroyed(QObject *))
 public:
     explicit ConstraintModel(QObject *parent = nullptr);
     ~ConstraintModel() override;
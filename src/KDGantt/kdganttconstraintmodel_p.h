@@ -16,6 +16,7 @@
 #include <QList>
 #include <QMultiHash>
 #include <QPersistentModelIndex>
+#include <QSet>
 
 namespace KDGantt {
 class ConstraintModel::Private
@@ -26,10 +27,27 @@ public:
     void addConstraintToIndex(const QModelIndex &idx, const Constraint &c);
     void removeConstraintFromIndex(const QModelIndex &idx, const Constraint &c);
 
+    void watchModel(const QAbstractItemModel *model);
+    bool isIndexMapUsable() const;
+    void rebuildIndexMap() const;
+    bool containsConstraint(const Constraint &c, Constraint *found = nullptr) const;
+
+    void slotModelAboutToChange();
+    void slotModelChanged();
+    void slotModelDestroyed(QObject *model);
+
     typedef QMultiHash<QPersistentModelIndex, Constraint> IndexType;
 
+    ConstraintModel *q = nullptr;
     QList<Constraint> constraints;
-    IndexType indexMap;
+    /* The hash of a QPersistentModelIndex is the hash of the index it currently
+     * points to, so the keys are filed under stale hashes once rows move.
+     * The map is rebuilt after any structural change of a model the constraints
+     * point into, and not used at all while such a change is in progress. */
+    mutable IndexType indexMap;
+    mutable bool indexMapDirty = false;
+    int pendingModelChanges = 0;
+    QSet<const QAbstractItemModel *> watchedModels;
 };
 }
 
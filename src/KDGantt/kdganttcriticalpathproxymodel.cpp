@@ -0,0 +1,802 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "kdganttcriticalpathproxymodel.h"
+#include "kdganttcriticalpathproxymodel_p.h"
+
+#include <QSet>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+using namespace KDGantt;
+
+/*!\class KDGantt::CriticalPathProxyModel
+ * \brief Proxy model computing the critical path of the tasks in its source model.
+ *
+ * The tasks are the items of the source model having a start time that
+ * are neither summaries nor multi items, and the dependencies between
+ * them are the constraints of the constraint model set with
+ * setConstraintModel(). Tasks without predecessors start at their start
+ * time, the others as early as their constraints allow; the latest start
+ * of a task is the latest one that does not delay the end of the project.
+ *
+ * The results are provided in the roles KDGantt::EarliestStartRole,
+ * KDGantt::LatestStartRole, KDGantt::TotalSlackRole,
+ * KDGantt::FreeSlackRole and KDGantt::CriticalRole. They are invalid
+ * for items that are not tasks, and for tasks on a cycle of
+ * constraints or depending on one. ItemDelegate paints the tasks on the
+ * critical path with its critical path pen.
+ *
+ * The schedule is computed the first time it is asked for. When the
+ * times of tasks change, only the tasks depending on them, or that they
+ * depend on, are computed again.
+ *
+ * \see GraphicsView::setModel, ItemDelegate::setCriticalPathPen
+ */
+
+typedef ForwardingProxyModel BASE;
+
+static const qint64 MSECS_PER_DAY = 86400000;
+
+static qint64 wallClockMSecs(const QDateTime &dt)
+{
+    return dt.date().toJulianDay() * MSECS_PER_DAY + dt.time().msecsSinceStartOfDay();
+}
+
+static QDateTime fromWallClockMSecs(qint64 msecs)
+{
+    qint64 day = msecs / MSECS_PER_DAY;
+    qint64 msecsOfDay = msecs % MSECS_PER_DAY;
+    if (msecsOfDay < 0) {
+        msecsOfDay += MSECS_PER_DAY;
+        --day;
+    }
+    return QDateTime(QDate::fromJulianDay(day), QTime::fromMSecsSinceStartOfDay(static_cast<int>(msecsOfDay)));
+}
+
+/* Sorts the edges from rows[i] to columns[i] into compressed sparse rows */
+static void compressRows(int rowCount, const QVector<int> &rows, const QVector<int> &columns,
+                         const QVector<qint8> &relations,
+                         QVector<int> *offsets, QVector<int> *targets, QVector<qint8> *targetRelations)
+{
+    offsets->fill(0, rowCount + 1);
+    int *o = offsets->data();
+    for (int row : rows)
+        ++o[row + 1];
+    for (int row = 0; row < rowCount; ++row)
+        o[row + 1] += o[row];
+
+    targets->resize(rows.size());
+    targetRelations->resize(rows.size());
+    int *t = targets->data();
+    qint8 *r = targetRelations->data();
+    QVector<int> next(*offsets);
+    for (int e = 0; e < rows.size(); ++e) {
+        const int slot = next[rows[e]]++;
+        t[slot] = columns[e];
+        r[slot] = relations[e];
+    }
+}
+
+/* Reads the start time and duration of \a sourceIdx. Returns false if
+ * it is not a task. */
+bool CriticalPathProxyModel::Private::readTask(const QModelIndex &sourceIdx, qint64 *start, qint64 *duration) const
+{
+    const int typ = sourceIdx.data(ItemTypeRole).toInt();
+    if (typ == TypeNone || typ == TypeSummary || typ == TypeMulti)
+        return false;
+    const QDateTime st = sourceIdx.data(StartTimeRole).toDateTime();
+    if (!st.isValid())
+        return false;
+    const QDateTime et = sourceIdx.data(EndTimeRole).toDateTime();
+    *start = wallClockMSecs(st);
+    *duration = et.isValid() ? qMax<qint64>(0, wallClockMSecs(et) - *start) : 0;
+    return true;
+}
+
+/* Returns the task of \a idx, an index of the source model or of this
+ * proxy as found in constraints, or -1 */
+int CriticalPathProxyModel::Private::taskFor(const QModelIndex &idx) const
+{
+    if (!idx.isValid())
+        return -1;
+    const QModelIndex sourceIdx = idx.model() == q ? q->mapToSource(idx) : idx;
+    if (sourceIdx.model() != q->sourceModel())
+        return -1;
+    return taskOf.value(sourceIdx.sibling(sourceIdx.row(), 0), -1);
+}
+
+void CriticalPathProxyModel::Private::ensureSchedule() const
+{
+    shown = true;
+    if (tasksDirty) {
+        tasks.clear();
+        taskOf.clear();
+        starts.clear();
+        durations.clear();
+        if (q->sourceModel())
+            buildTasks(QModelIndex());
+        tasksDirty = false;
+        dependenciesDirty = true;
+    }
+    if (dependenciesDirty) {
+        buildDependencies();
+        sortTopologically();
+        computeSchedule();
+        dependenciesDirty = false;
+    }
+}
+
+void CriticalPathProxyModel::Private::buildTasks(const QModelIndex &sourceParent) const
+{
+    const QAbstractItemModel *model = q->sourceModel();
+    const int rows = model->rowCount(sourceParent);
+    for (int row = 0; row < rows; ++row) {
+        const QModelIndex idx = model->index(row, 0, sourceParent);
+        qint64 start;
+        qint64 duration;
+        if (readTask(idx, &start, &duration)) {
+            taskOf.insert(idx, tasks.size());
+            tasks.append(idx);
+            starts.append(start);
+            durations.append(duration);
+        }
+        if (model->hasChildren(idx))
+            buildTasks(idx);
+    }
+}
+
+void CriticalPathProxyModel::Private::buildDependencies() const
+{
+    QVector<int> from;
+    QVector<int> to;
+    QVector<qint8> relations;
+    if (constraintModel) {
+        const QList<Constraint> constraints = constraintModel->constraints();
+        from.reserve(constraints.size());
+        to.reserve(constraints.size());
+        relations.reserve(constraints.size());
+        Q_FOREACH (const Constraint &c, constraints) {
+            const int f = taskFor(c.startIndex());
+            const int t = taskFor(c.endIndex());
+            if (f < 0 || t < 0 || f == t)
+                continue;
+            from.append(f);
+            to.append(t);
+            relations.append(c.relationType());
+        }
+    }
+    compressRows(tasks.size(), from, to, relations, &successorOffsets, &successors, &successorRelations);
+    compressRows(tasks.size(), to, from, relations, &predecessorOffsets, &predecessors, &predecessorRelations);
+}
+
+/* Kahn's algorithm. The tasks on a cycle, and the ones depending on
+ * them, never lose all their predecessors and are left out. */
+void CriticalPathProxyModel::Private::sortTopologically() const
+{
+    const int taskCount = tasks.size();
+    QVector<int> pending(taskCount);
+    order.clear();
+    order.reserve(taskCount);
+    for (int task = 0; task < taskCount; ++task) {
+        pending[task] = predecessorOffsets[task + 1] - predecessorOffsets[task];
+        if (pending[task] == 0)
+            order.append(task);
+    }
+    for (int i = 0; i < order.size(); ++i) {
+        const int task = order[i];
+        for (int e = successorOffsets[task]; e < successorOffsets[task + 1]; ++e) {
+            const int successor = successors[e];
+            if (--pending[successor] == 0)
+                order.append(successor);
+        }
+    }
+    position.fill(-1, taskCount);
+    for (int i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+}
+
+void CriticalPathProxyModel::Private::computeSchedule() const
+{
+    const int taskCount = tasks.size();
+    earliest.fill(0, taskCount);
+    latest.fill(0, taskCount);
+    freeSlack.fill(0, taskCount);
+    for (int task : qAsConst(order))
+        earliest[task] = pullEarliest(task);
+    finish = latestFinish();
+    for (int i = order.size() - 1; i >= 0; --i)
+        latest[order[i]] = pullLatest(order[i]);
+    for (int task : qAsConst(order))
+        freeSlack[task] = pullFreeSlack(task);
+}
+
+qint64 CriticalPathProxyModel::Private::latestFinish() const
+{
+    qint64 result = std::numeric_limits<qint64>::min();
+    for (int task : qAsConst(order))
+        result = qMax(result, earliest[task] + durations[task]);
+    return order.isEmpty() ? 0 : result;
+}
+
+/* Returns the least difference between the starts of \a to and of
+ * \a from allowed by a constraint of type \a relation between them */
+qint64 CriticalPathProxyModel::Private::weight(int from, int to, int relation) const
+{
+    switch (relation) {
+    case Constraint::FinishStart:
+        return durations[from];
+    case Constraint::FinishFinish:
+        return durations[from] - durations[to];
+    case Constraint::StartFinish:
+        return -durations[to];
+    default:
+        return 0;
+    }
+}
+
+qint64 CriticalPathProxyModel::Private::pullEarliest(int task) const
+{
+    const int first = predecessorOffsets[task];
+    const int last = predecessorOffsets[task + 1];
+    if (first == last)
+        return starts[task];
+    qint64 result = std::numeric_limits<qint64>::min();
+    for (int e = first; e < last; ++e) {
+        const int predecessor = predecessors[e];
+        result = qMax(result, earliest[predecessor] + weight(predecessor, task, predecessorRelations[e]));
+    }
+    return result;
+}
+
+qint64 CriticalPathProxyModel::Private::pullLatest(int task) const
+{
+    qint64 result = finish - durations[task];
+    for (int e = successorOffsets[task]; e < successorOffsets[task + 1]; ++e) {
+        const int successor = successors[e];
+        if (position[successor] >= 0)
+            result = qMin(result, latest[successor] - weight(task, successor, successorRelations[e]));
+    }
+    return result;
+}
+
+qint64 CriticalPathProxyModel::Private::pullFreeSlack(int task) const
+{
+    qint64 result = finish - earliest[task] - durations[task];
+    for (int e = successorOffsets[task]; e < successorOffsets[task + 1]; ++e) {
+        const int successor = successors[e];
+        if (position[successor] >= 0)
+            result = qMin(result, earliest[successor] - earliest[task] - weight(task, successor, successorRelations[e]));
+    }
+    return result;
+}
+
+/* Computes the schedule again after the start or duration of the
+ * \a moved tasks changed. The earliest starts are propagated to the
+ * successors in topological order, and the latest starts to the
+ * predecessors in reverse order, as far as they change. Returns the
+ * tasks whose results changed, or sets \a all if the end of the project
+ * moved, which changes the latest starts of all tasks.
+ */
+QVector<int> CriticalPathProxyModel::Private::updateTasks(const QVector<int> &moved, bool *all)
+{
+    QSet<int> seeds;
+    QSet<int> changed;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> forward;
+    for (int task : moved) {
+        if (position[task] >= 0 && !seeds.contains(task)) {
+            seeds.insert(task);
+            forward.push(position[task]);
+        }
+    }
+    if (seeds.isEmpty())
+        return QVector<int>();
+
+    // Positions come out in increasing order, repeated ones one after the other
+    int previous = -1;
+    while (!forward.empty()) {
+        const int pos = forward.top();
+        forward.pop();
+        if (pos == previous)
+            continue;
+        previous = pos;
+        const int task = order[pos];
+        const qint64 start = pullEarliest(task);
+        if (start == earliest[task] && !seeds.contains(task))
+            continue;
+        if (start != earliest[task]) {
+            earliest[task] = start;
+            changed.insert(task);
+        }
+        for (int e = successorOffsets[task]; e < successorOffsets[task + 1]; ++e) {
+            if (position[successors[e]] >= 0)
+                forward.push(position[successors[e]]);
+        }
+    }
+
+    const qint64 newFinish = latestFinish();
+    if (newFinish != finish) {
+        finish = newFinish;
+        for (int i = order.size() - 1; i >= 0; --i)
+            latest[order[i]] = pullLatest(order[i]);
+        for (int task : qAsConst(order))
+            freeSlack[task] = pullFreeSlack(task);
+        *all = true;
+        return QVector<int>();
+    }
+
+    std::priority_queue<int> backward;
+    for (int task : qAsConst(seeds))
+        backward.push(position[task]);
+    previous = -1;
+    while (!backward.empty()) {
+        const int pos = backward.top();
+        backward.pop();
+        if (pos == previous)
+            continue;
+        previous = pos;
+        const int task = order[pos];
+        const qint64 start = pullLatest(task);
+        if (start == latest[task] && !seeds.contains(task))
+            continue;
+        if (start != latest[task]) {
+            latest[task] = start;
+            changed.insert(task);
+        }
+        for (int e = predecessorOffsets[task]; e < predecessorOffsets[task + 1]; ++e)
+            backward.push(position[predecessors[e]]);
+    }
+
+    // The free slack of a task depends on the earliest starts of its successors
+    QSet<int> candidates = changed;
+    candidates.unite(seeds);
+    Q_FOREACH (int task, candidates) {
+        for (int e = predecessorOffsets[task]; e < predecessorOffsets[task + 1]; ++e)
+            candidates.insert(predecessors[e]);
+    }
+    for (int task : qAsConst(candidates)) {
+        const qint64 slack = pullFreeSlack(task);
+        if (slack != freeSlack[task]) {
+            freeSlack[task] = slack;
+            changed.insert(task);
+        }
+    }
+
+    QVector<int> result;
+    result.reserve(changed.size());
+    for (int task : qAsConst(changed))
+        result.append(task);
+    return result;
+}
+
+QVariant CriticalPathProxyModel::Private::scheduleData(const QModelIndex &sourceIdx, int role) const
+{
+    ensureSchedule();
+    const int task = taskOf.value(sourceIdx.sibling(sourceIdx.row(), 0), -1);
+    if (task < 0 || position[task] < 0)
+        return QVariant();
+    switch (role) {
+    case EarliestStartRole:
+        return fromWallClockMSecs(earliest[task]);
+    case LatestStartRole:
+        return fromWallClockMSecs(latest[task]);
+    case TotalSlackRole:
+        return static_cast<qlonglong>((latest[task] - earliest[task]) / 1000);
+    case FreeSlackRole:
+        return static_cast<qlonglong>(freeSlack[task] / 1000);
+    default:
+        return latest[task] == earliest[task];
+    }
+}
+
+/* Emits dataChanged() for the rows of the \a changed tasks, one signal
+ * for the ones sharing a parent */
+void CriticalPathProxyModel::Private::emitChanged(QVector<int> changed)
+{
+    std::sort(changed.begin(), changed.end());
+    for (int i = 0; i < changed.size();) {
+        const QModelIndex first = tasks[changed[i]];
+        const QModelIndex parentIdx = first.parent();
+        QModelIndex last = first;
+        for (++i; i < changed.size() && tasks[changed[i]].parent() == parentIdx; ++i)
+            last = tasks[changed[i]];
+        const int lastColumn = q->sourceModel()->columnCount(parentIdx) - 1;
+        emit q->dataChanged(q->mapFromSource(first), q->mapFromSource(last.sibling(last.row(), lastColumn)));
+    }
+}
+
+void CriticalPathProxyModel::Private::emitAllChanged(const QModelIndex &parent)
+{
+    if (!q->sourceModel())
+        return;
+    const int rows = q->rowCount(parent);
+    if (rows == 0)
+        return;
+    emit q->dataChanged(q->index(0, 0, parent), q->index(rows - 1, q->columnCount(parent) - 1, parent));
+    for (int row = 0; row < rows; ++row) {
+        const QModelIndex idx = q->index(row, 0, parent);
+        if (q->hasChildren(idx))
+            emitAllChanged(idx);
+    }
+}
+
+/* Forgets the tasks after a structural change of the source model. If
+ * \a refresh is set and results were handed out, all rows are reported
+ * changed once control returns to the event loop. */
+void CriticalPathProxyModel::Private::invalidate(bool refresh)
+{
+    tasksDirty = true;
+    snapshot = Snapshot();
+    if (refresh && shown)
+        scheduleRefresh(true);
+}
+
+void CriticalPathProxyModel::Private::scheduleRefresh(bool all)
+{
+    refreshAll = refreshAll || all;
+    if (!refreshPending) {
+        refreshPending = true;
+        QMetaObject::invokeMethod(q, "slotRefresh", Qt::QueuedConnection);
+    }
+}
+
+void CriticalPathProxyModel::Private::slotConstraintsChanged()
+{
+    // Constraints are often added one by one, the graph is built again
+    // once for all of them
+    if (!tasksDirty && !dependenciesDirty) {
+        snapshot.position = position;
+        snapshot.earliest = earliest;
+        snapshot.latest = latest;
+        snapshot.freeSlack = freeSlack;
+        scheduleRefresh(false);
+    }
+    dependenciesDirty = true;
+}
+
+void CriticalPathProxyModel::Private::slotRefresh()
+{
+    refreshPending = false;
+    if (refreshAll) {
+        refreshAll = false;
+        snapshot = Snapshot();
+        emitAllChanged(QModelIndex());
+        return;
+    }
+    if (snapshot.position.isEmpty())
+        return;
+
+    const Snapshot old = snapshot;
+    snapshot = Snapshot();
+    ensureSchedule();
+    QVector<int> changed;
+    for (int task = 0; task < tasks.size(); ++task) {
+        const bool scheduled = position[task] >= 0;
+        if (scheduled != (old.position[task] >= 0)
+            || (scheduled
+                && (earliest[task] != old.earliest[task] || latest[task] != old.latest[task]
+                    || freeSlack[task] != old.freeSlack[task])))
+            changed.append(task);
+    }
+    emitChanged(changed);
+}
+
+/*! Constructor. Creates a new CriticalPathProxyModel with
+ * parent \a parent
+ */
+CriticalPathProxyModel::CriticalPathProxyModel(QObject *parent)
+    : BASE(parent)
+    , _d(new Private(this))
+{
+    init();
+}
+
+#define d d_func()
+CriticalPathProxyModel::~CriticalPathProxyModel()
+{
+    delete _d;
+}
+
+void CriticalPathProxyModel::init()
+{
+}
+
+/*! Sets the model to be used as the source model for this proxy.
+ * The proxy does not take ownership of the model.
+ * \see QAbstractProxyModel::setSourceModel
+ */
+void CriticalPathProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    BASE::setSourceModel(model);
+    d->invalidate(false);
+    d->shown = false;
+}
+
+/*! Sets the constraint model holding the dependencies between the
+ * tasks to \a model. The constraints may refer to indexes of this proxy
+ * or of its source model. The proxy does not take ownership of the
+ * model.
+ * \see GraphicsView::constraintModel
+ */
+void CriticalPathProxyModel::setConstraintModel(ConstraintModel *model)
+{
+    if (d->constraintModel == model)
+        return;
+    if (d->constraintModel)
+        d->constraintModel->disconnect(this);
+    d->constraintModel = model;
+    if (model) {
+        connect(model, SIGNAL(constraintAdded(KDGantt::Constraint)),
+                this, SLOT(slotConstraintsChanged()));
+        connect(model, SIGNAL(constraintRemoved(KDGantt::Constraint)),
+                this, SLOT(slotConstraintsChanged()));
+        connect(model, SIGNAL(destroyed()),
+                this, SLOT(slotConstraintsChanged()));
+    }
+    d->slotConstraintsChanged();
+}
+
+/*!\returns The constraint model holding the dependencies between the tasks */
+ConstraintModel *CriticalPathProxyModel::constraintModel() const
+{
+    return d->constraintModel;
+}
+
+/*!\returns The time at which the last task ends at the earliest, or
+ * an invalid QDateTime if no task can be scheduled */
+QDateTime CriticalPathProxyModel::projectFinish() const
+{
+    d->ensureSchedule();
+    return d->order.isEmpty() ? QDateTime() : fromWallClockMSecs(d->finish);
+}
+
+/*!\returns The tasks without slack, in the order they can be started */
+QModelIndexList CriticalPathProxyModel::criticalPath() const
+{
+    d->ensureSchedule();
+    QModelIndexList result;
+    for (int task : qAsConst(d->order)) {
+        if (d->latest[task] == d->earliest[task])
+            result.append(mapFromSource(d->tasks[task]));
+    }
+    return result;
+}
+
+/*! \see QAbstractItemModel::data */
+QVariant CriticalPathProxyModel::data(const QModelIndex &proxyIndex, int role) const
+{
+    switch (role) {
+    case EarliestStartRole:
+    case LatestStartRole:
+    case TotalSlackRole:
+    case FreeSlackRole:
+    case CriticalRole:
+        return d->scheduleData(mapToSource(proxyIndex), role);
+    default:
+        return BASE::data(proxyIndex, role);
+    }
+}
+
+void CriticalPathProxyModel::sourceModelReset()
+{
+    d->invalidate(false);
+    d->shown = false;
+    BASE::sourceModelReset();
+}
+
+void CriticalPathProxyModel::sourceLayoutChanged()
+{
+    // The results of the rows do not change, and views read them again
+    d->invalidate(false);
+    BASE::sourceLayoutChanged();
+}
+
+void CriticalPathProxyModel::sourceDataChanged(const QModelIndex &from, const QModelIndex &to)
+{
+    QVector<int> changed;
+    bool all = false;
+    if (!d->tasksDirty) {
+        QAbstractItemModel *model = sourceModel();
+        const QModelIndex parentIdx = model->parent(from);
+        QVector<int> moved;
+        for (int row = from.row(); row <= to.row(); ++row) {
+            const QModelIndex idx = model->index(row, 0, parentIdx);
+            const int task = d->taskOf.value(idx, -1);
+            qint64 start;
+            qint64 duration;
+            if (d->readTask(idx, &start, &duration) != (task >= 0)) {
+                // Became a task, or is none anymore
+                d->invalidate(true);
+                break;
+            }
+            if (task >= 0 && (start != d->starts[task] || duration != d->durations[task])) {
+                d->starts[task] = start;
+                d->durations[task] = duration;
+                moved.append(task);
+            }
+        }
+        // While the dependencies are rebuilt, the schedule is computed
+        // again from the new times and the pending refresh reports the
+        // rows that changed
+        if (!d->tasksDirty && !d->dependenciesDirty && !moved.isEmpty())
+            changed = d->updateTasks(moved, &all);
+    }
+
+    BASE::sourceDataChanged(from, to);
+    if (all)
+        d->emitAllChanged(QModelIndex());
+    else
+        d->emitChanged(changed);
+}
+
+void CriticalPathProxyModel::sourceRowsInserted(const QModelIndex &parentIdx, int start, int end)
+{
+    d->invalidate(true);
+    BASE::sourceRowsInserted(parentIdx, start, end);
+}
+
+void CriticalPathProxyModel::sourceRowsRemoved(const QModelIndex &parentIdx, int start, int end)
+{
+    d->invalidate(true);
+    BASE::sourceRowsRemoved(parentIdx, start, end);
+}
+
+#undef d
+
+#ifndef KDAB_NO_UNIT_TESTS
+
+#include "unittest/test.h"
+
+#include <QStandardItemModel>
+
+static std::ostream &operator<<(std::ostream &os, const QDateTime &dt)
+{
+#ifdef QT_NO_STL
+    os << dt.toString().toLatin1().constData();
+#else
+    os << dt.toString().toStdString();
+#endif
+    return os;
+}
+
+namespace {
+class ScheduleReadCountingModel : public QStandardItemModel
+{
+public:
+    QVariant data(const QModelIndex &idx, int role) const override
+    {
+        if (role == KDGantt::StartTimeRole || role == KDGantt::EndTimeRole)
+            ++timeReads;
+        return QStandardItemModel::data(idx, role);
+    }
+
+    mutable int timeReads = 0;
+};
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, CriticalPathProxyModel, "test")
+{
+    CriticalPathProxyModel model;
+    ScheduleReadCountingModel sourceModel;
+    ConstraintModel constraints;
+    model.setSourceModel(&sourceModel);
+    model.setConstraintModel(&constraints);
+
+    // A and B lead to C, which leads to D
+    const QDateTime startdt(QDate(2020, 1, 6), QTime(8, 0));
+    const int hours[] = {10, 4, 6, 2};
+    for (int hour : hours) {
+        auto *task = new QStandardItem(QString::fromLatin1("Task"));
+        task->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        task->setData(startdt, KDGantt::StartTimeRole);
+        task->setData(startdt.addSecs(hour * 3600), KDGantt::EndTimeRole);
+        sourceModel.appendRow(task);
+    }
+    auto *summary = new QStandardItem(QString::fromLatin1("Summary"));
+    summary->setData(KDGantt::TypeSummary, KDGantt::ItemTypeRole);
+    summary->setData(startdt, KDGantt::StartTimeRole);
+    sourceModel.appendRow(summary);
+
+    const QModelIndex taskA = model.index(0, 0);
+    const QModelIndex taskB = model.index(1, 0);
+    const QModelIndex taskC = model.index(2, 0);
+    const QModelIndex taskD = model.index(3, 0);
+    constraints.addConstraint(Constraint(taskA, taskC));
+    // Constraints may refer to the source model as well
+    constraints.addConstraint(Constraint(sourceModel.index(1, 0), sourceModel.index(2, 0)));
+    constraints.addConstraint(Constraint(taskC, taskD));
+
+    assertEqual(model.projectFinish(), startdt.addSecs(18 * 3600));
+    assertEqual(model.data(taskC, KDGantt::EarliestStartRole).toDateTime(), startdt.addSecs(10 * 3600));
+    assertEqual(model.data(taskD, KDGantt::EarliestStartRole).toDateTime(), startdt.addSecs(16 * 3600));
+    assertEqual(model.data(taskB, KDGantt::LatestStartRole).toDateTime(), startdt.addSecs(6 * 3600));
+    assertEqual(model.data(taskB, KDGantt::TotalSlackRole).toLongLong(), 6 * 3600);
+    assertEqual(model.data(taskB, KDGantt::FreeSlackRole).toLongLong(), 6 * 3600);
+    assertEqual(model.data(taskA, KDGantt::TotalSlackRole).toLongLong(), 0);
+    assertTrue(model.data(taskA, KDGantt::CriticalRole).toBool());
+    assertFalse(model.data(taskB, KDGantt::CriticalRole).toBool());
+    assertFalse(model.data(model.index(4, 0), KDGantt::CriticalRole).isValid());
+    assertEqual(model.criticalPath().size(), 3);
+    assertEqual(model.criticalPath().at(1), taskC);
+
+    int changedRows = 0;
+    QObject::connect(&model, &QAbstractItemModel::dataChanged,
+                     [&changedRows](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                         changedRows += bottomRight.row() - topLeft.row() + 1;
+                     });
+
+    // Moving a task reads its own times only
+    sourceModel.timeReads = 0;
+    sourceModel.setData(sourceModel.index(1, 0), startdt.addSecs(8 * 3600), KDGantt::EndTimeRole);
+    assertEqual(model.data(taskB, KDGantt::TotalSlackRole).toLongLong(), 2 * 3600);
+    assertEqual(model.data(taskC, KDGantt::EarliestStartRole).toDateTime(), startdt.addSecs(10 * 3600));
+    assertEqual(sourceModel.timeReads, 2);
+    assertTrue(changedRows <= 2);
+
+    // Making B the longest one moves the end of the project
+    sourceModel.setData(sourceModel.index(1, 0), startdt.addSecs(12 * 3600), KDGantt::EndTimeRole);
+    assertEqual(model.projectFinish(), startdt.addSecs(20 * 3600));
+    assertTrue(model.data(taskB, KDGantt::CriticalRole).toBool());
+    assertFalse(model.data(taskA, KDGantt::CriticalRole).toBool());
+    assertEqual(model.data(taskA, KDGantt::TotalSlackRole).toLongLong(), 2 * 3600);
+    assertEqual(model.data(taskD, KDGantt::LatestStartRole).toDateTime(), startdt.addSecs(18 * 3600));
+
+    // A start-start constraint lets D start with B
+    constraints.removeConstraint(Constraint(taskC, taskD));
+    constraints.addConstraint(Constraint(taskB, taskD, Constraint::TypeSoft, Constraint::StartStart));
+    assertEqual(model.data(taskD, KDGantt::EarliestStartRole).toDateTime(), startdt);
+    assertEqual(model.data(taskD, KDGantt::FreeSlackRole).toLongLong(), 16 * 3600);
+    assertEqual(model.projectFinish(), startdt.addSecs(18 * 3600));
+
+    // Tasks on a cycle and depending on one have no schedule
+    constraints.addConstraint(Constraint(taskC, taskA));
+    assertFalse(model.data(taskA, KDGantt::CriticalRole).isValid());
+    assertFalse(model.data(taskC, KDGantt::EarliestStartRole).isValid());
+    assertTrue(model.data(taskB, KDGantt::CriticalRole).toBool());
+    assertEqual(model.projectFinish(), startdt.addSecs(12 * 3600));
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, CriticalPathProxyModelPendingConstraints, "test")
+{
+    CriticalPathProxyModel model;
+    QStandardItemModel sourceModel;
+    ConstraintModel constraints;
+    model.setSourceModel(&sourceModel);
+    model.setConstraintModel(&constraints);
+
+    const QDateTime startdt(QDate(2020, 1, 6), QTime(8, 0));
+    const int hours[] = {4, 6};
+    for (int hour : hours) {
+        auto *task = new QStandardItem(QString::fromLatin1("Task"));
+        task->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        task->setData(startdt, KDGantt::StartTimeRole);
+        task->setData(startdt.addSecs(hour * 3600), KDGantt::EndTimeRole);
+        sourceModel.appendRow(task);
+    }
+    const QModelIndex taskA = model.index(0, 0);
+    const QModelIndex taskB = model.index(1, 0);
+    assertEqual(model.projectFinish(), startdt.addSecs(6 * 3600));
+
+    // A task moved before the new constraint is applied keeps its new times
+    constraints.addConstraint(Constraint(taskA, taskB));
+    sourceModel.setData(sourceModel.index(0, 0), startdt.addSecs(8 * 3600), KDGantt::EndTimeRole);
+    assertEqual(model.data(taskB, KDGantt::EarliestStartRole).toDateTime(), startdt.addSecs(8 * 3600));
+    assertEqual(model.projectFinish(), startdt.addSecs(14 * 3600));
+    assertEqual(model.criticalPath().size(), 2);
+    assertTrue(model.data(taskA, KDGantt::CriticalRole).toBool());
+}
+
+#endif /* KDAB_NO_UNIT_TESTS */
+
+#include "moc_kdganttcriticalpathproxymodel.cpp"
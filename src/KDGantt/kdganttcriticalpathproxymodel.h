@@ -0,0 +1,51 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDGANTTCRITICALPATHPROXYMODEL_H
+#define KDGANTTCRITICALPATHPROXYMODEL_H
+
+#include <QDateTime>
+
+#include "kdganttforwardingproxymodel.h"
+
+namespace KDGantt {
+class ConstraintModel;
+
+class KDGANTT_EXPORT CriticalPathProxyModel : public ForwardingProxyModel
+{
+    Q_OBJECT
+    KDGANTT_DECLARE_PRIVATE_BASE_POLYMORPHIC(CriticalPathProxyModel)
+
+    Q_PRIVATE_SLOT(d, void slotConstraintsChanged())
+    Q_PRIVATE_SLOT(d, void slotRefresh())
+public:
+    explicit CriticalPathProxyModel(QObject *parent = nullptr);
+    ~CriticalPathProxyModel() override;
+
+    /*reimp*/ void setSourceModel(QAbstractItemModel *model) override;
+
+    void setConstraintModel(ConstraintModel *model);
+    ConstraintModel *constraintModel() const;
+
+    QDateTime projectFinish() const;
+    QModelIndexList criticalPath() const;
+
+    /*reimp*/ QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const override;
+
+protected:
+    /*reimp*/ void sourceModelReset() override;
+    /*reimp*/ void sourceLayoutChanged() override;
+    /*reimp*/ void sourceDataChanged(const QModelIndex &from, const QModelIndex &to) override;
+    /*reimp*/ void sourceRowsInserted(const QModelIndex &idx, int start, int end) override;
+    /*reimp*/ void sourceRowsRemoved(const QModelIndex &, int start, int end) override;
+};
+}
+
+#endif /* KDGANTTCRITICALPATHPROXYMODEL_H */
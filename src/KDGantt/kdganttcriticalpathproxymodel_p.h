@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDGANTTCRITICALPATHPROXYMODEL_P_H
+#define KDGANTTCRITICALPATHPROXYMODEL_P_H
+
+#include "kdganttcriticalpathproxymodel.h"
+
+#include "kdganttconstraintmodel.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QVector>
+
+namespace KDGantt {
+/* The tasks are numbered in depth-first order of the source model. The
+ * dependencies are kept in compressed sparse rows, the successors and
+ * the predecessors of task n being at [offsets[n], offsets[n+1]) of the
+ * respective arrays. Times are wall clock milliseconds, like the ones
+ * DateTimeGrid maps to the timeline, so that the schedule matches what
+ * is drawn.
+ */
+class CriticalPathProxyModel::Private
+{
+public:
+    explicit Private(CriticalPathProxyModel *qq)
+        : q(qq)
+    {
+    }
+
+    /* The results handed out, kept while the dependencies are rebuilt
+     * to find the tasks whose results changed. */
+    struct Snapshot
+    {
+        QVector<int> position;
+        QVector<qint64> earliest;
+        QVector<qint64> latest;
+        QVector<qint64> freeSlack;
+    };
+
+    bool readTask(const QModelIndex &sourceIdx, qint64 *start, qint64 *duration) const;
+    int taskFor(const QModelIndex &idx) const;
+
+    void ensureSchedule() const;
+    void buildTasks(const QModelIndex &sourceParent) const;
+    void buildDependencies() const;
+    void sortTopologically() const;
+    void computeSchedule() const;
+
+    qint64 latestFinish() const;
+    qint64 weight(int from, int to, int relation) const;
+    qint64 pullEarliest(int task) const;
+    qint64 pullLatest(int task) const;
+    qint64 pullFreeSlack(int task) const;
+    QVector<int> updateTasks(const QVector<int> &moved, bool *all);
+
+    QVariant scheduleData(const QModelIndex &sourceIdx, int role) const;
+    void emitChanged(QVector<int> changed);
+    void emitAllChanged(const QModelIndex &parent);
+
+    void invalidate(bool refresh);
+    void scheduleRefresh(bool all);
+    void slotConstraintsChanged();
+    void slotRefresh();
+
+    CriticalPathProxyModel *q;
+    QPointer<ConstraintModel> constraintModel;
+
+    mutable bool tasksDirty = true;
+    mutable bool dependenciesDirty = true;
+    mutable bool shown = false; // results were handed out since the last reset
+    bool refreshPending = false;
+    bool refreshAll = false;
+    Snapshot snapshot;
+
+    mutable QVector<QModelIndex> tasks; // source indexes in column 0
+    mutable QHash<QModelIndex, int> taskOf;
+    mutable QVector<qint64> starts;
+    mutable QVector<qint64> durations;
+
+    mutable QVector<int> successorOffsets;
+    mutable QVector<int> successors;
+    mutable QVector<qint8> successorRelations;
+    mutable QVector<int> predecessorOffsets;
+    mutable QVector<int> predecessors;
+    mutable QVector<qint8> predecessorRelations;
+
+    mutable QVector<int> order; // topological order of the tasks not on a cycle
+    mutable QVector<int> position; // of each task in order, -1 on a cycle
+    mutable QVector<qint64> earliest;
+    mutable QVector<qint64> latest;
+    mutable QVector<qint64> freeSlack;
+    mutable qint64 finish = 0;
+};
+}
+
+#endif /* KDGANTTCRITICALPATHPROXYMODEL_P_H */
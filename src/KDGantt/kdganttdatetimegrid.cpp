@@ -25,6 +25,7 @@
 #include <QWidget>
 
 #include <cassert>
+#include <typeinfo>
 
 using namespace KDGantt;
 
@@ -520,6 +521,34 @@ QVariant DateTimeGrid::mapFromChart(qreal x) const
     return d->chartXtoDateTime(x);
 }
 
+/* Reads the start and end time of \a idx. \a et is invalid for
+ * events with only a start time. */
+static bool timesForIndex(const QAbstractItemModel *model, const QModelIndex &idx, QDateTime *st, QDateTime *et)
+{
+    const QVariant sv = model->data(idx, StartTimeRole);
+    const QVariant ev = model->data(idx, EndTimeRole);
+    if (sv.canConvert(QVariant::DateTime) && ev.canConvert(QVariant::DateTime) && !(sv.type() == QVariant::String && sv.toString().isEmpty()) && !(ev.type() == QVariant::String && ev.toString().isEmpty())) {
+        *st = sv.toDateTime();
+        *et = ev.toDateTime();
+        if (et->isValid() && st->isValid())
+            return true;
+    }
+    // Special case for Events with only a start date
+    if (sv.canConvert(QVariant::DateTime) && !(sv.type() == QVariant::String && sv.toString().isEmpty())) {
+        *st = sv.toDateTime();
+        *et = QDateTime();
+        return st->isValid();
+    }
+    return false;
+}
+
+/* Milliseconds since the start of the julian calendar, on the wall
+ * clock like dateTimeToChartX() */
+static qreal dateTimeToTimeline(const QDateTime &dt)
+{
+    return dt.date().toJulianDay() * (24. * 60. * 60. * 1000.) + dt.time().msecsSinceStartOfDay();
+}
+
 /*! \param idx The index to get the Span for.
  * \returns The start and end pixels, in a Span, of the specified index.
  */
@@ -529,27 +558,71 @@ Span DateTimeGrid::mapToChart(const QModelIndex &idx) const
     if (!idx.isValid())
         return Span();
     assert(idx.model() == model());
-    const QVariant sv = model()->data(idx, StartTimeRole);
-    const QVariant ev = model()->data(idx, EndTimeRole);
-    if (sv.canConvert(QVariant::DateTime) && ev.canConvert(QVariant::DateTime) && !(sv.type() == QVariant::String && sv.toString().isEmpty()) && !(ev.type() == QVariant::String && ev.toString().isEmpty())) {
-        QDateTime st = sv.toDateTime();
-        QDateTime et = ev.toDateTime();
-        if (et.isValid() && st.isValid()) {
-            qreal sx = d->dateTimeToChartX(st);
-            qreal ex = d->dateTimeToChartX(et) - sx;
-            // qDebug() << "DateTimeGrid::mapToChart("<<st<<et<<") => "<< Span( sx, ex );
-            return Span(sx, ex);
-        }
-    }
-    // Special case for Events with only a start date
-    if (sv.canConvert(QVariant::DateTime) && !(sv.type() == QVariant::String && sv.toString().isEmpty())) {
-        QDateTime st = sv.toDateTime();
-        if (st.isValid()) {
-            qreal sx = d->dateTimeToChartX(st);
-            return Span(sx, 0);
-        }
-    }
-    return Span();
+    QDateTime st;
+    QDateTime et;
+    if (!timesForIndex(model(), idx, &st, &et))
+        return Span();
+    const qreal sx = d->dateTimeToChartX(st);
+    if (!et.isValid())
+        return Span(sx, 0);
+    return Span(sx, d->dateTimeToChartX(et) - sx);
+}
+
+/*! Declares that this grid maps the times of the items to the chart
+ * like DateTimeGrid does, linearly from the start date time with the
+ * day width. Subclasses reimplementing mapToChart() that way call this
+ * with \a linear true, so that the scene moves their items with
+ * AbstractGrid::mapToTimeline() and AbstractGrid::timelineTransform()
+ * on zoom and scale changes.
+ * Other subclasses leave it false, the default, and their items are
+ * updated with mapToChart(). A DateTimeGrid that is not subclassed is
+ * always linear.
+ */
+void DateTimeGrid::setLinearTimeline(bool linear)
+{
+    d->linearTimeline = linear;
+}
+
+/*! \returns true if this grid maps times linearly.
+ * \sa setLinearTimeline()
+ */
+bool DateTimeGrid::isLinearTimeline() const
+{
+    return d->linearTimeline || typeid(*this) == typeid(DateTimeGrid);
+}
+
+/* Sets span to the start and length of idx in milliseconds,
+ * independent of the start date time and the day width of the grid.
+ * Returns false if idx has no start time, or the grid does not map
+ * times linearly.
+ */
+bool DateTimeGrid::Private::mapToTimeline(const AbstractGrid *grid, const QModelIndex &idx, Span *span) const
+{
+    const auto *dtgrid = static_cast<const DateTimeGrid *>(grid);
+    assert(dtgrid->model());
+    if (!idx.isValid() || !dtgrid->isLinearTimeline())
+        return false;
+    assert(idx.model() == dtgrid->model());
+    QDateTime st;
+    QDateTime et;
+    if (!timesForIndex(dtgrid->model(), idx, &st, &et))
+        return false;
+    const qreal start = dateTimeToTimeline(st);
+    *span = Span(start, et.isValid() ? dateTimeToTimeline(et) - start : 0.);
+    return true;
+}
+
+/* Sets origin to the start date time and scale to the day width per
+ * millisecond. Returns false if the grid does not map times linearly.
+ */
+bool DateTimeGrid::Private::timelineTransform(const AbstractGrid *grid, qreal *origin, qreal *scale) const
+{
+    if (!static_cast<const DateTimeGrid *>(grid)->isLinearTimeline())
+        return false;
+    assert(startDateTime.isValid());
+    *origin = dateTimeToTimeline(startDateTime);
+    *scale = dayWidth / (24. * 60. * 60. * 1000.);
+    return true;
 }
 
 #if 0
@@ -1415,6 +1488,69 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, DateTimeGrid, "test")
     }
 }
 
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, DateTimeGridTimeline, "test")
+{
+    QStandardItemModel model(3, 1);
+    DateTimeGrid grid;
+    const QDateTime dt(QDate(2007, 3, 1), QTime(9, 30, 15, 250));
+    grid.setModel(&model);
+    grid.setStartDateTime(dt.addDays(-3));
+
+    model.setData(model.index(0, 0), dt, StartTimeRole);
+    model.setData(model.index(0, 0), dt.addSecs(36 * 3600 + 17), EndTimeRole);
+    model.setData(model.index(1, 0), dt.addDays(2), StartTimeRole);
+
+    Q_FOREACH (qreal dayWidth, QList<qreal>() << 100. << 3.7 << 850.) {
+        grid.setDayWidth(dayWidth);
+        qreal origin = 0.;
+        qreal scale = 0.;
+        assertTrue(grid.timelineTransform(&origin, &scale));
+        for (int row = 0; row < 2; ++row) {
+            Span timeline;
+            assertTrue(grid.mapToTimeline(model.index(row, 0), &timeline));
+            const Span s = grid.mapToChart(model.index(row, 0));
+            assertTrue(qAbs((timeline.start() - origin) * scale - s.start()) < 1e-6);
+            assertTrue(qAbs(timeline.length() * scale - s.length()) < 1e-6);
+        }
+    }
+    Span timeline;
+    assertFalse(grid.mapToTimeline(model.index(2, 0), &timeline));
+}
+
+class ShiftedDateTimeGrid : public DateTimeGrid
+{
+public:
+    /*reimp*/ Span mapToChart(const QModelIndex &idx) const override
+    {
+        const Span s = DateTimeGrid::mapToChart(idx);
+        return Span(s.start() + 10., s.length());
+    }
+
+    void setLinear(bool linear)
+    {
+        setLinearTimeline(linear);
+    }
+};
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, DateTimeGridLinearTimeline, "test")
+{
+    QStandardItemModel model(1, 1);
+    model.setData(model.index(0, 0), QDateTime(QDate(2007, 3, 1), QTime(9, 30)), StartTimeRole);
+    ShiftedDateTimeGrid grid;
+    grid.setModel(&model);
+
+    // subclasses have to opt in, their mapToChart() may not be linear
+    qreal origin = 0.;
+    qreal scale = 0.;
+    Span timeline;
+    assertFalse(grid.timelineTransform(&origin, &scale));
+    assertFalse(grid.mapToTimeline(model.index(0, 0), &timeline));
+
+    grid.setLinear(true);
+    assertTrue(grid.timelineTransform(&origin, &scale));
+    assertTrue(grid.mapToTimeline(model.index(0, 0), &timeline));
+}
+
 #endif /* KDAB_NO_UNIT_TESTS */
 
 #include "moc_kdganttdatetimegrid.cpp"
@@ -84,6 +84,9 @@ public:
                                qreal offset, QWidget *widget = nullptr) override;
 
 protected:
+    void setLinearTimeline(bool linear);
+    bool isLinearTimeline() const;
+
     virtual void paintHourScaleHeader(QPainter *painter,
                                       const QRectF &headerRect, const QRectF &exposedRect,
                                       qreal offset, QWidget *widget = nullptr);
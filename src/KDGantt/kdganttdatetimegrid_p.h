@@ -71,6 +71,9 @@ public:
     qreal dateTimeToChartX(const QDateTime &dt) const;
     QDateTime chartXtoDateTime(qreal x) const;
 
+    bool mapToTimeline(const AbstractGrid *grid, const QModelIndex &idx, Span *span) const override;
+    bool timelineTransform(const AbstractGrid *grid, qreal *origin, qreal *scale) const override;
+
     int tabHeight(const QString &txt, QWidget *widget = nullptr) const;
     void getAutomaticFormatters(DateTimeScaleFormatter **lower, DateTimeScaleFormatter **upper);
 
@@ -124,6 +127,8 @@ public:
     Qt::DayOfWeek weekStart = Qt::Monday;
     QSet<Qt::DayOfWeek> freeDays;
     bool rowSeparators = false;
+    // whether a subclass maps the times like DateTimeGrid, see setLinearTimeline()
+    bool linearTimeline = false;
     QBrush noInformationBrush;
     QBrush freeDaysBrush;
 
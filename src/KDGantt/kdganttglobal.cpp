@@ -46,6 +46,31 @@ using namespace KDGantt;
  * and the default values is Right.
  */
 
+/*!\enum KDGantt::ItemDataRole KDGantt::EarliestStartRole
+ * The earliest time a task can start given its dependencies.
+ * \see KDGantt::CriticalPathProxyModel
+ */
+
+/*!\enum KDGantt::ItemDataRole KDGantt::LatestStartRole
+ * The latest time a task can start without delaying the end of
+ * the project. \see KDGantt::CriticalPathProxyModel
+ */
+
+/*!\enum KDGantt::ItemDataRole KDGantt::TotalSlackRole
+ * The number of seconds a task can be delayed without delaying
+ * the end of the project. \see KDGantt::CriticalPathProxyModel
+ */
+
+/*!\enum KDGantt::ItemDataRole KDGantt::FreeSlackRole
+ * The number of seconds a task can be delayed without delaying
+ * any other task. \see KDGantt::CriticalPathProxyModel
+ */
+
+/*!\enum KDGantt::ItemDataRole KDGantt::CriticalRole
+ * True if the task is on the critical path, having no slack.
+ * \see KDGantt::CriticalPathProxyModel
+ */
+
 /*!\enum KDGantt::ItemType
  *\ingroup KDGantt
  * The values of this enum are used to represent the different
@@ -115,6 +140,21 @@ QDebug operator<<(QDebug dbg, KDGantt::ItemDataRole r)
     case KDGantt::LegendRole:
         dbg << "KDGantt::LegendRole";
         break;
+    case KDGantt::EarliestStartRole:
+        dbg << "KDGantt::EarliestStartRole";
+        break;
+    case KDGantt::LatestStartRole:
+        dbg << "KDGantt::LatestStartRole";
+        break;
+    case KDGantt::TotalSlackRole:
+        dbg << "KDGantt::TotalSlackRole";
+        break;
+    case KDGantt::FreeSlackRole:
+        dbg << "KDGantt::FreeSlackRole";
+        break;
+    case KDGantt::CriticalRole:
+        dbg << "KDGantt::CriticalRole";
+        break;
     default:
         dbg << static_cast<Qt::ItemDataRole>(r);
     }
@@ -269,7 +269,12 @@ enum ItemDataRole
     TaskCompletionRole = KDGanttRoleBase + 3,
     ItemTypeRole = KDGanttRoleBase + 4,
     LegendRole = KDGanttRoleBase + 5,
-    TextPositionRole = KDGanttRoleBase + 6
+    TextPositionRole = KDGanttRoleBase + 6,
+    EarliestStartRole = KDGanttRoleBase + 7,
+    LatestStartRole = KDGanttRoleBase + 8,
+    TotalSlackRole = KDGanttRoleBase + 9,
+    FreeSlackRole = KDGanttRoleBase + 10,
+    CriticalRole = KDGanttRoleBase + 11
 };
 enum ItemType
 {
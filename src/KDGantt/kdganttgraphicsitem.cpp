@@ -285,7 +285,8 @@ void GraphicsItem::updateItem(const Span &rowGeometry, const QPersistentModelInd
 {
     // qDebug() << "GraphicsItem::updateItem("<<rowGeometry<<idx<<")";
     Updater updater(&m_isupdating);
-    if (!idx.isValid() || idx.data(ItemTypeRole) == TypeMulti) {
+    const QVariant type = idx.isValid() ? idx.data(ItemTypeRole) : QVariant();
+    if (!idx.isValid() || type == TypeMulti) {
         setRect(QRectF());
         hide();
         return;
@@ -319,6 +320,24 @@ void GraphicsItem::updateItem(const Span &rowGeometry, const QPersistentModelInd
     // updateConstraintItems();
 }
 
+/* Moves and resizes the item for a change of the grid from \a timeline,
+ * the span of the item returned by AbstractGrid::mapToTimeline(), and
+ * the transform returned by AbstractGrid::timelineTransform(), keeping
+ * the space taken by the label around the bar.
+ */
+void GraphicsItem::updateItemFromTimeline(const Span &timeline, qreal origin, qreal scale)
+{
+    Updater updater(&m_isupdating);
+    const qreal labelLeft = m_rect.left() - m_boundingrect.left();
+    const qreal labelRight = m_boundingrect.right() - m_rect.right();
+    setPos(QPointF((timeline.start() - origin) * scale, pos().y()));
+    QRectF r(m_rect);
+    r.setWidth(timeline.length() * scale);
+    setRect(r);
+    setBoundingRect(QRectF(r.left() - labelLeft, m_boundingrect.top(),
+                           r.width() + labelLeft + labelRight, m_boundingrect.height()));
+}
+
 QVariant GraphicsItem::itemChange(GraphicsItemChange change, const QVariant &value)
 {
     if (!isUpdating() && change == ItemPositionChange && scene()) {
@@ -43,6 +43,7 @@ public:
     /*reimp (non-virtual)*/ GraphicsScene *scene() const;
 
     void updateItem(const Span &rowgeometry, const QPersistentModelIndex &idx);
+    void updateItemFromTimeline(const Span &timeline, qreal origin, qreal scale);
 
     // virtual ItemType itemType() const = 0;
 
@@ -23,6 +23,7 @@
 #include <QPainter>
 #include <QPrinter>
 #include <QSet>
+#include <QStyleOptionGraphicsItem>
 #include <QTextDocument>
 #include <QToolTip>
 
@@ -59,6 +60,15 @@ GraphicsScene::Private::Private(GraphicsScene *_q)
     , labelsWidth(0.0)
     , summaryHandlingModel(new SummaryHandlingProxyModel(_q))
     , selectionModel(nullptr)
+    , timelinesStale(false)
+    , virtualized(false)
+    , virtualizationMargin(300.)
+    , bandTop(0.)
+    , bandBottom(-1.)
+    , constraintSpansDirty(true)
+    , extentDirty(true)
+    , extentLeft(0.)
+    , extentRight(0.)
 {
     default_grid.setStartDateTime(QDateTime::currentDateTime().addDays(-1));
 }
@@ -85,6 +95,12 @@ void GraphicsScene::Private::createConstraintItem(const Constraint &c)
         sitem->addStartConstraint(citem);
         eitem->addEndConstraint(citem);
         q->addItem(citem);
+    } else if (virtualized && (sitem || eitem)) {
+        if (!offscreenConstraints.contains(sitem ? sitem : eitem, c))
+            offscreenConstraints.insert(sitem ? sitem : eitem, c);
+    } else if (virtualized && spansBand(c)) {
+        if (!spanningConstraints.contains(c))
+            spanningConstraints.append(c);
     }
 
     // q->insertConstraintItem( c, citem );
@@ -143,6 +159,333 @@ ConstraintGraphicsItem *GraphicsScene::Private::findConstraintItem(const Constra
     return nullptr;
 }
 
+/* Returns an item from the pool of recycled items, or a new one */
+GraphicsItem *GraphicsScene::Private::takeItem(ItemType type)
+{
+    if (!virtualized || itemPool.isEmpty())
+        return q->createItem(type);
+    GraphicsItem *item = itemPool.takeLast();
+    item->show();
+    return item;
+}
+
+void GraphicsScene::Private::recycleItem(GraphicsItem *item)
+{
+    timelines.remove(item);
+    if (!virtualized) {
+        delete item;
+        return;
+    }
+    if (dragSource == item)
+        dragSource = nullptr;
+    // Drop the index first, so that deselecting does not touch the selection model
+    item->setIndex(QPersistentModelIndex());
+    item->updateItem(Span(), QPersistentModelIndex()); // hides it
+    item->setSelected(false);
+    item->setBoundingRect(QRectF());
+    itemPool.push_back(item);
+}
+
+/* Caches the span of the item for the index idx it was just updated
+ * from, if the grid maps it linearly, for updateItems(). */
+void GraphicsScene::Private::updateTimeline(GraphicsItem *item, const QModelIndex &idx)
+{
+    Span timeline;
+    const int type = idx.isValid() ? idx.data(ItemTypeRole).toInt() : TypeNone;
+    // The bounding span of events does not grow with their length
+    if (type != TypeNone && type != TypeMulti && type != TypeEvent && grid->mapToTimeline(idx, &timeline))
+        timelines.insert(item, timeline);
+    else
+        timelines.remove(item);
+}
+
+bool GraphicsScene::Private::isInBand(const Span &rowGeometry) const
+{
+    return rowGeometry.end() >= bandTop && rowGeometry.start() <= bandBottom;
+}
+
+void GraphicsScene::Private::resetBand()
+{
+    spanningConstraints.clear();
+    // the rows moved
+    constraintSpansDirty = true;
+    bandTop = 0.;
+    bandBottom = -1.;
+    bandFirstRow = QPersistentModelIndex();
+}
+
+/* Moves the band of rows with items to the exposed rect, once the
+ * exposed rect left it. Only the rows entering and leaving the band
+ * are visited, so scrolling does not depend on the number of rows.
+ */
+void GraphicsScene::Private::updateBand()
+{
+    if (!virtualized || !rowController || !q->model())
+        return;
+    const bool hasBand = bandTop <= bandBottom;
+    if (hasBand && exposedRect.top() >= bandTop && exposedRect.bottom() <= bandBottom
+        && bandBottom - bandTop <= exposedRect.height() + 4. * virtualizationMargin)
+        return;
+
+    const qreal oldTop = bandTop;
+    const qreal oldBottom = bandBottom;
+    bandTop = exposedRect.top() - virtualizationMargin;
+    bandBottom = exposedRect.bottom() + virtualizationMargin;
+
+    QList<QModelIndex> leaving;
+    for (QHash<QPersistentModelIndex, GraphicsItem *>::const_iterator it = items.constBegin();
+         it != items.constEnd(); ++it) {
+        const GraphicsItem *item = *it;
+        // Hidden items (expanded multi items) were never positioned
+        const Span rg = item->isVisible() ? Span(item->pos().y(), item->boundingRect().height())
+                                          : rowController->rowGeometry(summaryHandlingModel->mapToSource(it.key()));
+        if (!isInBand(rg))
+            leaving << it.key();
+    }
+    Q_FOREACH (const QModelIndex &idx, leaving) {
+        q->removeItem(idx);
+    }
+
+    const QModelIndex first = firstRowAt(bandTop);
+    bandFirstRow = first;
+    for (QModelIndex idx = first; idx.isValid() && rowController->isRowVisible(idx);
+         idx = rowController->indexBelow(idx)) {
+        const Span rg = rowController->rowGeometry(idx);
+        if (rg.start() > bandBottom)
+            break;
+        // Rows that were in the band already have their items
+        if (hasBand && rg.end() >= oldTop && rg.start() <= oldBottom)
+            continue;
+        q->updateRow(summaryHandlingModel->mapFromSource(idx));
+    }
+    collectSpanningConstraints();
+}
+
+/* Whether the rows of the constraint c lie above and below the band,
+ * so that it crosses the band without having an item in it. */
+bool GraphicsScene::Private::spansBand(const Constraint &c) const
+{
+    if (!rowController || bandTop > bandBottom || !c.startIndex().isValid() || !c.endIndex().isValid())
+        return false;
+    const Span startRow = rowController->rowGeometry(c.startIndex());
+    const Span endRow = rowController->rowGeometry(c.endIndex());
+    return qMin(startRow.start(), endRow.start()) < bandTop && qMax(startRow.end(), endRow.end()) > bandBottom;
+}
+
+/* Sorts the rows covered by each constraint by their top, so that
+ * collectSpanningConstraints() does not need to look up the rows of
+ * all constraints whenever the band moves. */
+void GraphicsScene::Private::buildConstraintSpans()
+{
+    constraintSpansDirty = false;
+    constraintSpans.clear();
+    constraintSpansBottom.clear();
+    if (constraintModel.isNull() || !rowController)
+        return;
+    const QList<Constraint> constraints = constraintModel->constraints();
+    constraintSpans.reserve(constraints.size());
+    Q_FOREACH (const Constraint &c, constraints) {
+        if (!c.startIndex().isValid() || !c.endIndex().isValid())
+            continue;
+        const Span startRow = rowController->rowGeometry(c.startIndex());
+        const Span endRow = rowController->rowGeometry(c.endIndex());
+        const ConstraintSpan span = {qMin(startRow.start(), endRow.start()),
+                                     qMax(startRow.end(), endRow.end()), c};
+        constraintSpans.append(span);
+    }
+    std::sort(constraintSpans.begin(), constraintSpans.end(),
+              [](const ConstraintSpan &a, const ConstraintSpan &b) { return a.top < b.top; });
+    constraintSpansBottom.resize(constraintSpans.size());
+    qreal bottom = 0.;
+    for (int i = 0; i < constraintSpans.size(); ++i) {
+        bottom = i == 0 ? constraintSpans.at(i).bottom : qMax(bottom, constraintSpans.at(i).bottom);
+        constraintSpansBottom[i] = bottom;
+    }
+}
+
+/* Finds the constraints crossing the band, whenever the band moved.
+ * Only the constraints starting above the band are visited, from the
+ * band upwards until none of the remaining ones reaches below it. */
+void GraphicsScene::Private::collectSpanningConstraints()
+{
+    spanningConstraints.clear();
+    if (constraintModel.isNull() || bandTop > bandBottom)
+        return;
+    if (constraintSpansDirty)
+        buildConstraintSpans();
+    const QVector<ConstraintSpan>::const_iterator above =
+        std::lower_bound(constraintSpans.constBegin(), constraintSpans.constEnd(), bandTop,
+                         [](const ConstraintSpan &span, qreal top) { return span.top < top; });
+    for (int i = int(above - constraintSpans.constBegin()) - 1;
+         i >= 0 && constraintSpansBottom.at(i) > bandBottom; --i) {
+        const ConstraintSpan &span = constraintSpans.at(i);
+        if (span.bottom > bandBottom
+            && !items.contains(summaryHandlingModel->mapFromSource(span.constraint.startIndex()))
+            && !items.contains(summaryHandlingModel->mapFromSource(span.constraint.endIndex())))
+            spanningConstraints.append(span.constraint);
+    }
+}
+
+/* The first row ending below y, found by stepping from the first row
+ * of the band when it is close, so that scrolling is cheap even with
+ * row controllers where indexAt() walks the rows from the top.
+ */
+QModelIndex GraphicsScene::Private::firstRowAt(qreal y) const
+{
+    QModelIndex idx = bandFirstRow;
+    const qreal stepLimit = 4. * (exposedRect.height() + 2. * virtualizationMargin);
+    if (!idx.isValid() || qAbs(rowController->rowGeometry(idx).start() - y) > stepLimit) {
+        idx = rowController->indexAt(qMax(0, static_cast<int>(y)));
+        if (!idx.isValid())
+            return QModelIndex();
+    }
+    while (rowController->rowGeometry(idx).start() > y) {
+        const QModelIndex above = rowController->indexAbove(idx);
+        if (!above.isValid())
+            break;
+        idx = above;
+    }
+    while (idx.isValid() && rowController->rowGeometry(idx).end() <= y) {
+        idx = rowController->indexBelow(idx);
+    }
+    return idx;
+}
+
+/* Widens the horizontal extent of the items by the items of the row
+ * \a rowidx, without creating them.
+ */
+void GraphicsScene::Private::extendExtent(const QModelIndex &rowidx)
+{
+    if (extentDirty)
+        return;
+    for (int col = 0; col < summaryHandlingModel->columnCount(rowidx.parent()); ++col) {
+        const QModelIndex idx = summaryHandlingModel->index(rowidx.row(), col, rowidx.parent());
+        const int itemtype = summaryHandlingModel->data(idx, ItemTypeRole).toInt();
+        if (itemtype == TypeNone || itemtype == TypeMulti)
+            continue;
+        const Span s = grid->mapToChart(idx);
+        if (s.length() < 0.)
+            continue;
+        if (extentLeft > extentRight) {
+            extentLeft = s.start();
+            extentRight = s.end();
+        } else {
+            extentLeft = qMin(extentLeft, s.start());
+            extentRight = qMax(extentRight, s.end());
+        }
+    }
+}
+
+void GraphicsScene::Private::scanExtent()
+{
+    extentDirty = false;
+    extentLeft = 0.;
+    extentRight = -1.;
+    if (!rowController || !q->model())
+        return;
+    QModelIndex idx = q->model()->index(0, 0, q->rootIndex());
+    if (!idx.isValid())
+        return;
+    do {
+        extendExtent(summaryHandlingModel->mapFromSource(idx));
+    } while ((idx = rowController->indexBelow(idx)) != QModelIndex() && rowController->isRowVisible(idx));
+}
+
+void GraphicsScene::Private::removeOffscreenConstraint(const Constraint &c)
+{
+    spanningConstraints.removeAll(c);
+    if (GraphicsItem *item = items.value(summaryHandlingModel->mapFromSource(c.startIndex()), 0))
+        offscreenConstraints.remove(item, c);
+    if (GraphicsItem *item = items.value(summaryHandlingModel->mapFromSource(c.endIndex()), 0))
+        offscreenConstraints.remove(item, c);
+}
+
+/* Same as GraphicsItem::startConnector() and GraphicsItem::endConnector() */
+QPointF GraphicsScene::Private::itemConnector(const GraphicsItem *item, bool isStart, int relationType) const
+{
+    const QRectF r = item->mapRectToScene(item->rect());
+    bool left;
+    if (isStart)
+        left = relationType == Constraint::StartStart || relationType == Constraint::StartFinish;
+    else
+        left = relationType != Constraint::FinishFinish && relationType != Constraint::StartFinish;
+    return QPointF(left ? r.left() : r.right(), r.center().y());
+}
+
+/* The connector the item of the row \a sidx would have, computed from
+ * the model like GraphicsItem::updateItem() does.
+ */
+bool GraphicsScene::Private::rowConnector(const QModelIndex &sidx, bool isStart, int relationType, QPointF *point) const
+{
+    if (!sidx.isValid())
+        return false;
+    const QModelIndex idx = summaryHandlingModel->mapFromSource(sidx);
+    const Span s = grid->mapToChart(idx);
+    if (s.length() < 0.)
+        return false;
+    const Span rg = rowController->rowGeometry(sidx);
+    qreal y = rg.start() + rg.length() / 2.;
+    const int maxh = rowController->maximumItemHeight();
+    if (maxh < rg.length()) {
+        const QVariant da = summaryHandlingModel->data(idx, Qt::TextAlignmentRole);
+        const Qt::Alignment align = da.isValid() ? static_cast<Qt::Alignment>(da.toInt()) : Qt::AlignVCenter;
+        if (align & Qt::AlignTop)
+            y = rg.start() + maxh / 2.;
+        else if (align & Qt::AlignBottom)
+            y = rg.end() - maxh / 2.;
+    }
+    bool left;
+    if (isStart)
+        left = relationType == Constraint::StartStart || relationType == Constraint::StartFinish;
+    else
+        left = relationType != Constraint::FinishFinish && relationType != Constraint::StartFinish;
+    *point = QPointF(left ? s.start() : s.end(), y);
+    return true;
+}
+
+void GraphicsScene::Private::paintOffscreenConstraints(QPainter *painter, const QRectF &exposed)
+{
+    if ((offscreenConstraints.isEmpty() && spanningConstraints.isEmpty()) || itemDelegate.isNull())
+        return;
+    QStyleOptionGraphicsItem opt;
+    opt.exposedRect = exposed;
+    // both ends of these are outside of the band
+    Q_FOREACH (const Constraint &c, spanningConstraints) {
+        QPointF start;
+        QPointF end;
+        if (!rowConnector(c.startIndex(), true, c.relationType(), &start)
+            || !rowConnector(c.endIndex(), false, c.relationType(), &end))
+            continue;
+        if (!itemDelegate->constraintBoundingRect(start, end, c).intersects(exposed))
+            continue;
+        painter->save();
+        itemDelegate->paintConstraintItem(painter, opt, start, end, c);
+        painter->restore();
+    }
+    for (QMultiHash<GraphicsItem *, Constraint>::const_iterator it = offscreenConstraints.constBegin();
+         it != offscreenConstraints.constEnd(); ++it) {
+        const GraphicsItem *item = it.key();
+        const Constraint &c = it.value();
+        const bool itemIsStart = item->index() == summaryHandlingModel->mapFromSource(c.startIndex());
+        QPointF start;
+        QPointF end;
+        if (itemIsStart) {
+            start = itemConnector(item, true, c.relationType());
+            if (!rowConnector(c.endIndex(), false, c.relationType(), &end))
+                continue;
+        } else {
+            end = itemConnector(item, false, c.relationType());
+            if (!rowConnector(c.startIndex(), true, c.relationType(), &start))
+                continue;
+        }
+        if (!itemDelegate->constraintBoundingRect(start, end, c).intersects(exposed))
+            continue;
+        painter->save();
+        itemDelegate->paintConstraintItem(painter, opt, start, end, c);
+        painter->restore();
+    }
+}
+
 GraphicsScene::GraphicsScene(QObject *parent)
     : QGraphicsScene(parent)
     , _d(new Private(this))
@@ -175,6 +518,8 @@ void GraphicsScene::setItemDelegate(ItemDelegate *delegate)
     if (!d->itemDelegate.isNull() && d->itemDelegate->parent() == this)
         delete d->itemDelegate;
     d->itemDelegate = delegate;
+    // The labels may take another space around the bars
+    d->timelinesStale = true;
     update();
 }
 
@@ -229,6 +574,7 @@ void GraphicsScene::setConstraintModel(ConstraintModel *cm)
         d->constraintModel->disconnect(this);
     }
     d->constraintModel = cm;
+    d->constraintSpansDirty = true;
 
     connect(cm, SIGNAL(constraintAdded(const KDGantt::Constraint &)),
             this, SLOT(slotConstraintAdded(const KDGantt::Constraint &)));
@@ -251,6 +597,7 @@ QItemSelectionModel *GraphicsScene::selectionModel() const
 void GraphicsScene::setRowController(AbstractRowController *rc)
 {
     d->rowController = rc;
+    d->constraintSpansDirty = true;
 }
 
 AbstractRowController *GraphicsScene::rowController() const
@@ -270,6 +617,7 @@ void GraphicsScene::setGrid(AbstractGrid *grid)
     d->grid = grid;
     connect(d->grid, SIGNAL(gridChanged()), this, SLOT(slotGridChanged()));
     d->grid->setModel(model);
+    d->timelinesStale = true;
     slotGridChanged();
 }
 
@@ -288,6 +636,80 @@ bool GraphicsScene::isReadOnly() const
     return d->readOnly;
 }
 
+/*! Enables or disables virtualization. When enabled, items are only
+ * created for the rows intersecting exposedRect() plus
+ * virtualizationMargin() above and below it, and the items of rows
+ * scrolled away are reused. Constraints to rows without items are
+ * painted along with the background.
+ *
+ * The view using the scene has to call setExposedRect() when its
+ * visible part changes.
+ */
+void GraphicsScene::setVirtualizationEnabled(bool enable)
+{
+    if (d->virtualized == enable)
+        return;
+    d->virtualized = enable;
+    if (!enable) {
+        qDeleteAll(d->itemPool);
+        d->itemPool.clear();
+        d->offscreenConstraints.clear();
+    }
+    d->resetBand();
+    d->extentDirty = true;
+}
+
+bool GraphicsScene::isVirtualizationEnabled() const
+{
+    return d->virtualized;
+}
+
+/*! Sets the height of the rows created above and below the exposed rect
+ * when virtualization is enabled to  margin. The default is 300. */
+void GraphicsScene::setVirtualizationMargin(qreal margin)
+{
+    d->virtualizationMargin = qMax(qreal(0.), margin);
+}
+
+qreal GraphicsScene::virtualizationMargin() const
+{
+    return d->virtualizationMargin;
+}
+
+/*! Sets the visible part of the scene to  rect. With virtualization
+ * enabled, the items of rows leaving it are reused for the rows
+ * entering it. */
+void GraphicsScene::setExposedRect(const QRectF &rect)
+{
+    d->exposedRect = rect;
+    d->updateBand();
+}
+
+QRectF GraphicsScene::exposedRect() const
+{
+    return d->exposedRect;
+}
+
+/*! Returns the bounding rect of all the items, including the ones that
+ * are not created because virtualization is enabled. */
+QRectF GraphicsScene::virtualItemsBoundingRect()
+{
+    QRectF r = itemsBoundingRect();
+    if (!d->virtualized || !d->rowController)
+        return r;
+    if (d->extentDirty)
+        d->scanExtent();
+    if (d->extentLeft <= d->extentRight) {
+        const qreal left = r.isNull() ? d->extentLeft : qMin(r.left(), d->extentLeft);
+        const qreal right = r.isNull() ? d->extentRight : qMax(r.right(), d->extentRight);
+        r.setLeft(left);
+        r.setRight(right);
+    }
+    r.setTop(0.);
+    r.setBottom(qMax(r.bottom(), qreal(d->rowController->totalHeight())));
+    return r;
+}
+
 /* Returns the index with column=0 from the
  * same row as idx and with the same parent.
  * This is used to traverse the tree-structure
@@ -349,11 +771,12 @@ void GraphicsScene::Private::recursiveUpdateMultiItem(const Span &span, const QM
     GraphicsItem *item = q->findItem(idx);
     const int itemtype = summaryHandlingModel->data(idx, ItemTypeRole).toInt();
     if (!item) {
-        item = q->createItem(static_cast<ItemType>(itemtype));
+        item = takeItem(static_cast<ItemType>(itemtype));
         item->setIndex(idx);
         q->insertItem(idx, item);
     }
     item->updateItem(span, idx);
+    updateTimeline(item, idx);
     QModelIndex child;
     int cr = 0;
     while ((child = idx.model()->index(cr, 0, idx)).isValid()) {
@@ -383,6 +806,14 @@ void GraphicsScene::updateRow(const QModelIndex &rowidx)
         }
     }
 
+    if (d->virtualized && !d->isInBand(rg)) {
+        for (int col = 0; col < summaryHandlingModel()->columnCount(rowidx.parent()); ++col) {
+            removeItem(summaryHandlingModel()->index(rowidx.row(), col, rowidx.parent()));
+        }
+        d->extendExtent(rowidx);
+        return;
+    }
+
     bool blocked = blockSignals(true);
     for (int col = 0; col < summaryHandlingModel()->columnCount(rowidx.parent()); ++col) {
         const QModelIndex idx = summaryHandlingModel()->index(rowidx.row(), col, rowidx.parent());
@@ -402,12 +833,13 @@ void GraphicsScene::updateRow(const QModelIndex &rowidx)
 
             GraphicsItem *item = findItem(idx);
             if (!item) {
-                item = createItem(static_cast<ItemType>(itemtype));
+                item = d->takeItem(static_cast<ItemType>(itemtype));
                 item->setIndex(idx);
                 insertItem(idx, item);
             }
             const Span span = rowController()->rowGeometry(sidx);
             item->updateItem(span, idx);
+            d->updateTimeline(item, idx);
         }
     }
     blockSignals(blocked);
@@ -424,8 +856,12 @@ void GraphicsScene::insertItem(const QPersistentModelIndex &idx, GraphicsItem *i
             if (c.startIndex() == sidx) {
                 other_idx = c.endIndex();
                 GraphicsItem *other_item = d->items.value(summaryHandlingModel()->mapFromSource(other_idx), 0);
-                if (!other_item)
+                if (!other_item) {
+                    if (d->virtualized)
+                        d->offscreenConstraints.insert(item, c);
                     continue;
+                }
+                d->offscreenConstraints.remove(other_item, c);
                 auto *citem = new ConstraintGraphicsItem(c);
                 item->addStartConstraint(citem);
                 other_item->addEndConstraint(citem);
@@ -433,8 +869,12 @@ void GraphicsScene::insertItem(const QPersistentModelIndex &idx, GraphicsItem *i
             } else if (c.endIndex() == sidx) {
                 other_idx = c.startIndex();
                 GraphicsItem *other_item = d->items.value(summaryHandlingModel()->mapFromSource(other_idx), 0);
-                if (!other_item)
+                if (!other_item) {
+                    if (d->virtualized)
+                        d->offscreenConstraints.insert(item, c);
                     continue;
+                }
+                d->offscreenConstraints.remove(other_item, c);
                 auto *citem = new ConstraintGraphicsItem(c);
                 other_item->addStartConstraint(citem);
                 item->addEndConstraint(citem);
@@ -445,7 +885,8 @@ void GraphicsScene::insertItem(const QPersistentModelIndex &idx, GraphicsItem *i
         }
     }
     d->items.insert(idx, item);
-    addItem(item);
+    if (item->QGraphicsItem::scene() != this)
+        addItem(item);
 }
 
 void GraphicsScene::removeItem(const QModelIndex &idx)
@@ -470,11 +911,24 @@ void GraphicsScene::removeItem(const QModelIndex &idx)
 #endif
 
             Q_FOREACH (ConstraintGraphicsItem *citem, clst) {
+                if (d->virtualized) {
+                    // The other end stays, and keeps the constraint as an off-screen one
+                    const Constraint c = citem->constraint();
+                    const bool isStart = startConstraints.contains(citem);
+                    if (isStart)
+                        item->removeStartConstraint(citem);
+                    else
+                        item->removeEndConstraint(citem);
+                    const QModelIndex other_idx = isStart ? c.endIndex() : c.startIndex();
+                    if (GraphicsItem *other_item = d->items.value(summaryHandlingModel()->mapFromSource(other_idx), 0))
+                        d->offscreenConstraints.insert(other_item, c);
+                }
                 d->deleteConstraintItem(citem);
             }
         }
+        d->offscreenConstraints.remove(item);
         // Get rid of the item
-        delete item;
+        d->recycleItem(item);
     }
 }
 
@@ -503,19 +957,41 @@ void GraphicsScene::clearItems()
         delete *it;
     }
     d->items.clear();
+    d->timelines.clear();
 
-    // Clear constraints
+    // Clear constraints, and the pooled items
     QList<QGraphicsItem *> items = d->q->items();
     qDeleteAll(items);
+    d->itemPool.clear();
+    d->offscreenConstraints.clear();
+    d->resetBand();
+    d->extentDirty = true;
 }
 
+/* Moves the items for a change of the grid. Items of a grid mapping
+ * linearly are moved from the spans they cached, without reading the
+ * model; the rows changed in the model were updated by updateRow()
+ * already.
+ */
 void GraphicsScene::updateItems()
 {
+    qreal origin = 0.;
+    qreal scale = 1.;
+    const bool linear = !d->timelinesStale && d->grid->timelineTransform(&origin, &scale);
+    d->timelinesStale = false;
     for (QHash<QPersistentModelIndex, GraphicsItem *>::iterator it = d->items.begin();
          it != d->items.end(); ++it) {
         GraphicsItem *const item = it.value();
+        if (linear) {
+            const QHash<GraphicsItem *, Span>::const_iterator timeline = d->timelines.constFind(item);
+            if (timeline != d->timelines.constEnd()) {
+                item->updateItemFromTimeline(*timeline, origin, scale);
+                continue;
+            }
+        }
         const QPersistentModelIndex &idx = it.key();
         item->updateItem(Span(item->pos().y(), item->rect().height()), idx);
+        d->updateTimeline(item, idx);
     }
     invalidate(QRectF(), QGraphicsScene::BackgroundLayer);
 }
@@ -553,12 +1029,15 @@ void GraphicsScene::clearConstraintItems()
 
 void GraphicsScene::slotConstraintAdded(const KDGantt::Constraint &c)
 {
+    d->constraintSpansDirty = true;
     d->createConstraintItem(c);
 }
 
 void GraphicsScene::slotConstraintRemoved(const KDGantt::Constraint &c)
 {
+    d->constraintSpansDirty = true;
     d->deleteConstraintItem(c);
+    d->removeOffscreenConstraint(c);
 }
 
 void GraphicsScene::slotGridChanged()
@@ -612,6 +1091,7 @@ void GraphicsScene::drawBackground(QPainter *painter, const QRectF &_rect)
     d->grid->paintGrid(painter, scn, rect, d->rowController);
 
     d->grid->drawBackground(painter, rect);
+    d->paintOffscreenConstraints(painter, rect);
 }
 
 void GraphicsScene::drawForeground(QPainter *painter, const QRectF &rect)
@@ -800,6 +1280,9 @@ void GraphicsScene::doPrint(QPainter *painter, const QRectF &targetRect,
     }
 
     setSceneRect(scnRect);
+    // All rows are printed, so all need items
+    const QRectF oldExposedRect(d->exposedRect);
+    setExposedRect(scnRect);
 
     painter->save();
     painter->setClipRect(targetRect);
@@ -834,6 +1317,7 @@ void GraphicsScene::doPrint(QPainter *painter, const QRectF &targetRect,
     qDeleteAll(textLabels);
     blockSignals(b);
     setSceneRect(oldScnRect);
+    setExposedRect(oldExposedRect);
     painter->restore();
 }
 
@@ -966,4 +1450,196 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, GraphicsView, "test")
     graphicsView.updateScene();
     assertFalse(foreignItemDestroyed);
 }
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, GraphicsSceneZoom, "test")
+{
+    QStandardItemModel model;
+    for (int row = 0; row < 20; ++row) {
+        auto *item = new QStandardItem();
+        item->setData(row % 5 ? KDGantt::TypeTask : KDGantt::TypeEvent, KDGantt::ItemTypeRole);
+        item->setData(QString::fromLatin1("Task %1").arg(row));
+        item->setData(row % 3, KDGantt::TextPositionRole);
+        item->setData(QDate(2007, 3, 1).startOfDay().addSecs(row * 4567), KDGantt::StartTimeRole);
+        item->setData(QDate(2007, 3, 2).startOfDay().addSecs(row * 7654), KDGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+
+    SceneTestRowController rowController;
+    rowController.setModel(&model);
+
+    KDGantt::GraphicsView graphicsView;
+    graphicsView.setRowController(&rowController);
+    graphicsView.setModel(&model);
+    graphicsView.constraintModel()->addConstraint(KDGantt::Constraint(model.index(1, 0), model.index(2, 0)));
+
+    auto *grid = qobject_cast<KDGantt::DateTimeGrid *>(graphicsView.grid());
+    assertTrue(grid != nullptr);
+    grid->setDayWidth(37.5);
+    grid->setStartDateTime(QDate(2007, 2, 27).startOfDay());
+    auto *scene = static_cast<KDGantt::GraphicsScene *>(graphicsView.scene());
+    QList<QRectF> zoomed;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const KDGantt::GraphicsItem *item = scene->findItem(scene->summaryHandlingModel()->index(row, 0));
+        zoomed << item->sceneBoundingRect() << item->mapRectToScene(item->rect());
+    }
+
+    // the same as the items created at this zoom level
+    graphicsView.updateScene();
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const KDGantt::GraphicsItem *item = scene->findItem(scene->summaryHandlingModel()->index(row, 0));
+        const QRectF rects[] = {item->sceneBoundingRect(), item->mapRectToScene(item->rect())};
+        for (int i = 0; i < 2; ++i) {
+            const QRectF &expected = zoomed.at(2 * row + i);
+            assertTrue(qAbs(rects[i].left() - expected.left()) < 1e-6);
+            assertTrue(qAbs(rects[i].right() - expected.right()) < 1e-6);
+            assertEqual(rects[i].top(), expected.top());
+            assertEqual(rects[i].height(), expected.height());
+        }
+    }
+}
+
+static int countGraphicsItems(QGraphicsScene *scene, bool visibleOnly)
+{
+    int count = 0;
+    Q_FOREACH (QGraphicsItem *item, scene->items()) {
+        if (qgraphicsitem_cast<KDGantt::GraphicsItem *>(item) && (!visibleOnly || item->isVisible()))
+            ++count;
+    }
+    return count;
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, GraphicsSceneVirtualization, "test")
+{
+    QStandardItemModel model;
+    for (int row = 0; row < 2000; ++row) {
+        auto *item = new QStandardItem();
+        item->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        item->setData(QString::fromLatin1("Task %1").arg(row));
+        item->setData(QDate(2007, 3, 1).startOfDay().addDays(row % 30), KDGantt::StartTimeRole);
+        item->setData(QDate(2007, 3, 3).startOfDay().addDays(row % 30), KDGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+
+    SceneTestRowController rowController;
+    rowController.setModel(&model);
+
+    KDGantt::GraphicsView graphicsView;
+    graphicsView.setRowController(&rowController);
+    graphicsView.setModel(&model);
+    const KDGantt::Constraint c(model.index(0, 0), model.index(1500, 0));
+    graphicsView.constraintModel()->addConstraint(c);
+
+    auto *scene = static_cast<KDGantt::GraphicsScene *>(graphicsView.scene());
+    const QAbstractProxyModel *proxy = scene->summaryHandlingModel();
+    assertEqual(countGraphicsItems(scene, false), 2000);
+    assertTrue(scene->findConstraintItem(c) != nullptr);
+
+    graphicsView.setVirtualizationEnabled(true);
+    scene->setVirtualizationMargin(60.);
+    scene->setExposedRect(QRectF(0., 0., 400., 300.));
+    // rows 0 to 12 are within 60 pixels of the exposed rect
+    assertEqual(countGraphicsItems(scene, true), 13);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(12, 0))) != nullptr);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(13, 0))) == nullptr);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(1500, 0))) == nullptr);
+    assertTrue(scene->findConstraintItem(c) == nullptr);
+    assertTrue(scene->virtualItemsBoundingRect().bottom() >= 2000 * 30.);
+
+    // scrolling reuses the items of the rows that left the band
+    const int created = countGraphicsItems(scene, false);
+    scene->setExposedRect(QRectF(0., 1500 * 30., 400., 300.));
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(0, 0))) == nullptr);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(1500, 0))) != nullptr);
+    assertEqual(countGraphicsItems(scene, true), 15);
+    assertEqual(countGraphicsItems(scene, false), qMax(created, 15));
+
+    // scrolling within the band does not change anything
+    scene->setExposedRect(QRectF(0., 1500 * 30. + 40., 400., 300.));
+    assertEqual(countGraphicsItems(scene, true), 15);
+
+    graphicsView.setVirtualizationEnabled(false);
+    assertEqual(countGraphicsItems(scene, false), 2000);
+    assertTrue(scene->findConstraintItem(c) != nullptr);
+}
+
+class ConstraintCountingDelegate : public KDGantt::ItemDelegate
+{
+public:
+    /*reimp*/ void paintConstraintItem(QPainter *painter, const QStyleOptionGraphicsItem &opt,
+                                       const QPointF &start, const QPointF &end,
+                                       const KDGantt::Constraint &constraint) override
+    {
+        painted << constraint;
+        KDGantt::ItemDelegate::paintConstraintItem(painter, opt, start, end, constraint);
+    }
+
+    QList<KDGantt::Constraint> painted;
+};
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, GraphicsSceneSpanningConstraints, "test")
+{
+    QStandardItemModel model;
+    for (int row = 0; row < 2000; ++row) {
+        auto *item = new QStandardItem();
+        item->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        item->setData(QDate(2007, 3, 1).startOfDay(), KDGantt::StartTimeRole);
+        item->setData(QDate(2007, 3, 3).startOfDay(), KDGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+
+    SceneTestRowController rowController;
+    rowController.setModel(&model);
+
+    ConstraintCountingDelegate delegate;
+    KDGantt::GraphicsView graphicsView;
+    graphicsView.setItemDelegate(&delegate);
+    graphicsView.setRowController(&rowController);
+    graphicsView.setModel(&model);
+    graphicsView.setVirtualizationEnabled(true);
+    auto *scene = static_cast<KDGantt::GraphicsScene *>(graphicsView.scene());
+    scene->setVirtualizationMargin(60.);
+
+    // scrolled to the middle of a constraint, none of its rows has an item
+    const KDGantt::Constraint c(model.index(100, 0), model.index(1500, 0));
+    graphicsView.constraintModel()->addConstraint(c);
+    const QAbstractProxyModel *proxy = scene->summaryHandlingModel();
+    const KDGantt::Span task = scene->grid()->mapToChart(proxy->mapFromSource(model.index(100, 0)));
+    const QRectF exposed(task.start() - 200., 800 * 30., task.length() + 400., 300.);
+    scene->setExposedRect(exposed);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(100, 0))) == nullptr);
+    assertTrue(scene->findItem(proxy->mapFromSource(model.index(1500, 0))) == nullptr);
+
+    QImage image(exposed.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    {
+        QPainter painter(&image);
+        scene->render(&painter, QRectF(), exposed);
+    }
+    assertEqual(delegate.painted.count(), 1);
+    assertTrue(delegate.painted.first() == c);
+
+    // constraints added while scrolled there are painted too, removed ones are not
+    const KDGantt::Constraint added(model.index(1900, 0), model.index(10, 0));
+    graphicsView.constraintModel()->addConstraint(added);
+    graphicsView.constraintModel()->removeConstraint(c);
+    delegate.painted.clear();
+    {
+        QPainter painter(&image);
+        scene->render(&painter, QRectF(), exposed);
+    }
+    assertEqual(delegate.painted.count(), 1);
+    assertTrue(delegate.painted.first() == added);
+
+    // after moving the band, the constraints ending above it are not collected either
+    graphicsView.constraintModel()->addConstraint(KDGantt::Constraint(model.index(20, 0), model.index(60, 0)));
+    graphicsView.constraintModel()->addConstraint(KDGantt::Constraint(model.index(700, 0), model.index(30, 0)));
+    const QRectF below = exposed.translated(0., 100 * 30.);
+    scene->setExposedRect(below);
+    delegate.painted.clear();
+    {
+        QPainter painter(&image);
+        scene->render(&painter, QRectF(), below);
+    }
+    assertEqual(delegate.painted.count(), 1);
+    assertTrue(delegate.painted.first() == added);
+}
 #endif /* KDAB_NO_UNIT_TESTS */
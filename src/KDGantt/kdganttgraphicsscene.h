@@ -80,6 +80,14 @@ public:
     void updateRow(const QModelIndex &idx);
     GraphicsItem *createItem(ItemType type) const;
 
+    void setVirtualizationEnabled(bool);
+    bool isVirtualizationEnabled() const;
+    void setVirtualizationMargin(qreal margin);
+    qreal virtualizationMargin() const;
+    void setExposedRect(const QRectF &rect);
+    QRectF exposedRect() const;
+    QRectF virtualItemsBoundingRect();
+
     /* used by GraphicsItem */
     void itemEntered(const QModelIndex &);
     void itemPressed(const QModelIndex &);
@@ -14,8 +14,10 @@
 #include <QAbstractProxyModel>
 #include <QHash>
 #include <QItemSelectionModel>
+#include <QMultiHash>
 #include <QPersistentModelIndex>
 #include <QPointer>
+#include <QVector>
 
 #include "kdganttconstraintmodel.h"
 #include "kdganttdatetimegrid.h"
@@ -35,6 +37,24 @@ public:
 
     void recursiveUpdateMultiItem(const Span &span, const QModelIndex &idx);
 
+    /* virtualization */
+    GraphicsItem *takeItem(ItemType type);
+    void recycleItem(GraphicsItem *item);
+    void updateTimeline(GraphicsItem *item, const QModelIndex &idx);
+    bool isInBand(const Span &rowGeometry) const;
+    void resetBand();
+    void updateBand();
+    QModelIndex firstRowAt(qreal y) const;
+    void extendExtent(const QModelIndex &rowidx);
+    void scanExtent();
+    void removeOffscreenConstraint(const Constraint &c);
+    bool spansBand(const Constraint &c) const;
+    void buildConstraintSpans();
+    void collectSpanningConstraints();
+    QPointF itemConnector(const GraphicsItem *item, bool isStart, int relationType) const;
+    bool rowConnector(const QModelIndex &sidx, bool isStart, int relationType, QPointF *point) const;
+    void paintOffscreenConstraints(QPainter *painter, const QRectF &exposed);
+
     GraphicsScene *q;
 
     QHash<QPersistentModelIndex, GraphicsItem *> items;
@@ -56,6 +76,45 @@ public:
     QPointer<ConstraintModel> constraintModel;
 
     QPointer<QItemSelectionModel> selectionModel;
+
+    /* The spans cached by the items for updateItems() do not match the
+     * grid or the item delegate anymore */
+    bool timelinesStale;
+    /* The spans of the items returned by AbstractGrid::mapToTimeline(),
+     * for moving them on grid changes without reading the model */
+    QHash<GraphicsItem *, Span> timelines;
+
+    /* Only the rows within the band, the exposed rect plus a margin, have
+     * items. Items of rows leaving the band go to the pool for reuse;
+     * constraints to rows outside the band are painted from the model
+     * instead of being items (offscreenConstraints, keyed by the item
+     * of the row inside the band). So are the constraints between rows
+     * above and below the band (spanningConstraints), which cross it
+     * without having an item in it. They are found from constraintSpans,
+     * the rows covered by each constraint sorted by the top, with the
+     * largest bottom of the spans up to each one in constraintSpansBottom,
+     * built again after the constraints or the rows changed. */
+    bool virtualized;
+    qreal virtualizationMargin;
+    QRectF exposedRect;
+    qreal bandTop;
+    qreal bandBottom;
+    QPersistentModelIndex bandFirstRow;
+    QVector<GraphicsItem *> itemPool;
+    QMultiHash<GraphicsItem *, Constraint> offscreenConstraints;
+    QList<Constraint> spanningConstraints;
+    struct ConstraintSpan
+    {
+        qreal top;
+        qreal bottom;
+        Constraint constraint;
+    };
+    QVector<ConstraintSpan> constraintSpans;
+    QVector<qreal> constraintSpansBottom;
+    bool constraintSpansDirty;
+    bool extentDirty;
+    qreal extentLeft;
+    qreal extentRight;
 };
 
 GraphicsScene::GraphicsScene(GraphicsScene::Private *d)
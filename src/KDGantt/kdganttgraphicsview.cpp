@@ -180,6 +180,11 @@ void GraphicsView::Private::updateHeaderGeometry()
                              rowcontroller->headerHeight());
 }
 
+void GraphicsView::Private::updateExposedRect()
+{
+    scene.setExposedRect(q->mapToScene(q->viewport()->rect()).boundingRect());
+}
+
 void GraphicsView::Private::slotGridChanged()
 {
     updateHeaderGeometry();
@@ -194,6 +199,13 @@ void GraphicsView::Private::slotHorizontalScrollValueChanged(int val)
     headerwidget.scrollTo(val - q->horizontalScrollBar()->minimum() + static_cast<int>(viewRect.left()));
 }
 
+void GraphicsView::Private::slotVerticalScrollValueChanged(int val)
+{
+    Q_UNUSED(val);
+    if (scene.isVirtualizationEnabled())
+        updateExposedRect();
+}
+
 void GraphicsView::Private::slotColumnsInserted(const QModelIndex &parent, int start, int end)
 {
     Q_UNUSED(start);
@@ -215,12 +227,41 @@ void GraphicsView::Private::slotColumnsRemoved(const QModelIndex &parent, int st
     q->updateScene();
 }
 
+static bool touchesHorizontalEdge(const QRectF &rect, const QRectF &sceneRect)
+{
+    return rect.left() <= sceneRect.left() || rect.right() >= sceneRect.right();
+}
+
 void GraphicsView::Private::slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
     // qDebug() << "GraphicsView::slotDataChanged("<<topLeft<<bottomRight<<")";
     const QModelIndex parent = topLeft.parent();
+    const QRectF sceneRect = scene.sceneRect();
+    bool sceneRectChanged = false;
     for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
-        scene.updateRow(scene.summaryHandlingModel()->index(row, 0, parent));
+        const QModelIndex rowidx = scene.summaryHandlingModel()->index(row, 0, parent);
+        // Only the changed rows can change the scene rect: items moving out
+        // of it grow it, items moving away from its left or right edge may
+        // shrink it
+        for (int col = 0; col < scene.summaryHandlingModel()->columnCount(parent); ++col) {
+            const GraphicsItem *item = scene.findItem(scene.summaryHandlingModel()->index(row, col, parent));
+            if (item && item->isVisible() && touchesHorizontalEdge(item->sceneBoundingRect(), sceneRect))
+                sceneRectChanged = true;
+        }
+        scene.updateRow(rowidx);
+        for (int col = 0; col < scene.summaryHandlingModel()->columnCount(parent); ++col) {
+            const GraphicsItem *item = scene.findItem(scene.summaryHandlingModel()->index(row, col, parent));
+            if (item && item->isVisible() && !sceneRect.contains(item->sceneBoundingRect()))
+                sceneRectChanged = true;
+        }
+    }
+    // Rows without items only widen the extent kept by the scene, and
+    // the items of the virtualized scene are few
+    if (sceneRectChanged || scene.isVirtualizationEnabled()) {
+        q->updateSceneRect();
+    } else {
+        // For rows that gained or lost information
+        scene.invalidate(QRectF(), QGraphicsScene::BackgroundLayer);
     }
 }
 
@@ -317,6 +358,8 @@ GraphicsView::GraphicsView(QWidget *parent)
 #endif
     connect(horizontalScrollBar(), SIGNAL(valueChanged(int)),
             this, SLOT(slotHorizontalScrollValueChanged(int)));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(slotVerticalScrollValueChanged(int)));
     connect(&_d->scene, SIGNAL(gridChanged()),
             this, SLOT(slotGridChanged()));
     connect(&_d->scene, SIGNAL(entered(const QModelIndex &)),
@@ -371,8 +414,6 @@ void GraphicsView::setModel(QAbstractItemModel *model)
     }
 
     d->scene.setModel(model);
-    connect(model, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)),
-            this, SLOT(updateSceneRect()));
     updateScene();
 }
 
@@ -531,6 +572,43 @@ bool GraphicsView::isReadOnly() const
     return d->scene.isReadOnly();
 }
 
+/*! Enables virtualization if \a enable is true: items are then only
+ * created for the rows in and around the viewport, and reused while
+ * scrolling. This keeps memory use and scene updates bounded for models
+ * with many rows. The default is false.
+ *
+ * \sa GraphicsScene::setVirtualizationEnabled()
+ */
+void GraphicsView::setVirtualizationEnabled(bool enable)
+{
+    if (d->scene.isVirtualizationEnabled() == enable)
+        return;
+    d->scene.setVirtualizationEnabled(enable);
+    updateScene();
+}
+
+/*!\returns true iff virtualization is enabled
+ */
+bool GraphicsView::isVirtualizationEnabled() const
+{
+    return d->scene.isVirtualizationEnabled();
+}
+
+/*! Sets the height in pixels of the rows getting items above and below
+ * the viewport when virtualization is enabled to \a margin.
+ */
+void GraphicsView::setVirtualizationMargin(int margin)
+{
+    d->scene.setVirtualizationMargin(margin);
+    if (d->scene.isVirtualizationEnabled())
+        updateScene();
+}
+
+int GraphicsView::virtualizationMargin() const
+{
+    return qRound(d->scene.virtualizationMargin());
+}
+
 /*! Sets the context menu policy for the header. The default value
  * Qt::DefaultContextMenu results in a standard context menu on the header
  * that allows the user to set the scale and zoom.
@@ -578,7 +656,7 @@ void GraphicsView::addConstraint(const QModelIndex &from,
 void GraphicsView::resizeEvent(QResizeEvent *ev)
 {
     d->updateHeaderGeometry();
-    QRectF r = scene()->itemsBoundingRect();
+    QRectF r = d->scene.virtualItemsBoundingRect();
     // To scroll more to the left than the actual item start, bug #4516
     r.setLeft(qMin<qreal>(0.0, r.left()));
     // TODO: take scrollbars into account (if not always on)
@@ -599,6 +677,8 @@ void GraphicsView::resizeEvent(QResizeEvent *ev)
     scene()->setSceneRect(r);
 
     QGraphicsView::resizeEvent(ev);
+    if (d->scene.isVirtualizationEnabled())
+        d->updateExposedRect();
 }
 
 /*!\returns The QModelIndex for the item located at
@@ -639,7 +719,7 @@ void GraphicsView::updateSceneRect()
      */
     qreal range = horizontalScrollBar()->maximum() - horizontalScrollBar()->minimum();
     const qreal hscroll = horizontalScrollBar()->value() / (range > 0 ? range : 1);
-    QRectF r = d->scene.itemsBoundingRect();
+    QRectF r = d->scene.virtualItemsBoundingRect();
     // To scroll more to the left than the actual item start, bug #4516
     r.setTop(0.);
     r.setLeft(qMin<qreal>(0.0, r.left()));
@@ -671,6 +751,13 @@ void GraphicsView::updateScene()
         return;
     if (!rowController())
         return;
+    if (d->scene.isVirtualizationEnabled()) {
+        // Only the rows around the viewport get items
+        updateSceneRect();
+        d->updateExposedRect();
+        scene()->invalidate(QRectF(), QGraphicsScene::BackgroundLayer);
+        return;
+    }
     QModelIndex idx = model()->index(0, 0, rootIndex());
     do {
         updateRow(idx);
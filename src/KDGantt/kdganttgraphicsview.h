@@ -39,6 +39,7 @@ class KDGANTT_EXPORT GraphicsView : public QGraphicsView
 
     Q_PRIVATE_SLOT(d, void slotGridChanged())
     Q_PRIVATE_SLOT(d, void slotHorizontalScrollValueChanged(int))
+    Q_PRIVATE_SLOT(d, void slotVerticalScrollValueChanged(int))
     Q_PRIVATE_SLOT(d, void slotHeaderContextMenuRequested(const QPoint &))
     /* slots for QAbstractItemModel signals */
     Q_PRIVATE_SLOT(d, void slotColumnsInserted(const QModelIndex &parent, int start, int end))
@@ -67,6 +68,11 @@ public:
 
     bool isReadOnly() const;
 
+    void setVirtualizationEnabled(bool);
+    bool isVirtualizationEnabled() const;
+    void setVirtualizationMargin(int);
+    int virtualizationMargin() const;
+
     void setHeaderContextMenuPolicy(Qt::ContextMenuPolicy);
     Qt::ContextMenuPolicy headerContextMenuPolicy() const;
 
@@ -49,9 +49,11 @@ public:
     explicit Private(GraphicsView *_q);
 
     void updateHeaderGeometry();
+    void updateExposedRect();
 
     void slotGridChanged();
     void slotHorizontalScrollValueChanged(int val);
+    void slotVerticalScrollValueChanged(int val);
 
     /* slots for QAbstractItemModel signals */
     void slotColumnsInserted(const QModelIndex &parent, int start, int end);
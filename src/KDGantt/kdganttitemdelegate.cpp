@@ -84,6 +84,7 @@ ItemDelegate::Private::Private()
     defaultpen[TypeTask] = pen;
     defaultpen[TypeSummary] = pen;
     defaultpen[TypeEvent] = pen;
+    criticalpathpen = QPen(Qt::red, 2.);
 }
 
 QPen ItemDelegate::Private::constraintPen(const QPointF &start, const QPointF &end, const Constraint &constraint)
@@ -163,6 +164,24 @@ QPen ItemDelegate::defaultPen(ItemType type) const
     return d->defaultpen[type];
 }
 
+/*! Sets the pen used for the items on the critical path to \a pen.
+ * These are the items for which the model returns true in the
+ * KDGantt::CriticalRole role, like CriticalPathProxyModel does.
+ *
+ * \see KDGantt::CriticalPathProxyModel
+ */
+void ItemDelegate::setCriticalPathPen(const QPen &pen)
+{
+    d->criticalpathpen = pen;
+}
+
+/*!\returns The pen used for the items on the critical path
+ */
+QPen ItemDelegate::criticalPathPen() const
+{
+    return d->criticalpathpen;
+}
+
 /*!\returns The tooltip for index \a idx
  */
 QString ItemDelegate::toolTip(const QModelIndex &idx) const
@@ -289,7 +308,7 @@ void ItemDelegate::paintGanttItem(QPainter *painter,
 
     painter->save();
 
-    QPen pen = defaultPen(typ);
+    QPen pen = idx.model()->data(idx, CriticalRole).toBool() ? criticalPathPen() : defaultPen(typ);
     if (opt.state & QStyle::State_Selected)
         pen.setWidth(2 * pen.width());
     painter->setPen(pen);
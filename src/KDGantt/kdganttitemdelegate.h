@@ -45,6 +45,9 @@ public:
     void setDefaultPen(ItemType type, const QPen &pen);
     QPen defaultPen(ItemType type) const;
 
+    void setCriticalPathPen(const QPen &pen);
+    QPen criticalPathPen() const;
+
     virtual Span itemBoundingSpan(const StyleOptionGanttItem &opt, const QModelIndex &idx) const;
     virtual QRectF constraintBoundingRect(const QPointF &start, const QPointF &end, const Constraint &constraint) const;
     virtual InteractionState interactionStateFor(const QPointF &pos,
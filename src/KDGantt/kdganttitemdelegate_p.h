@@ -25,6 +25,7 @@ public:
 
     QHash<ItemType, QBrush> defaultbrush;
     QHash<ItemType, QPen> defaultpen;
+    QPen criticalpathpen;
 };
 }
 
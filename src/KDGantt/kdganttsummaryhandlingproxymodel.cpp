@@ -35,57 +35,120 @@ using namespace KDGantt;
 
 typedef ForwardingProxyModel BASE;
 
-bool SummaryHandlingProxyModel::Private::cacheLookup(const QModelIndex &idx,
-                                                     QPair<QDateTime, QDateTime> *result) const
+void SummaryHandlingProxyModel::Private::RollUp::setChildExtent(int row, const Extent *extent)
 {
-    // qDebug() << "cacheLookup("<<idx<<"), cache has " << cached_summary_items.count() << "items";
-    QHash<QModelIndex, QPair<QDateTime, QDateTime>>::const_iterator it =
-        cached_summary_items.constFind(idx);
-    if (it != cached_summary_items.constEnd()) {
-        *result = *it;
-        return true;
-    } else {
-        return false;
+    QHash<int, Extent>::iterator it = children.find(row);
+    if (it != children.end()) {
+        if (--starts[it->first] == 0)
+            starts.remove(it->first);
+        if (--ends[it->second] == 0)
+            ends.remove(it->second);
+        children.erase(it);
+    }
+    if (extent) {
+        children.insert(row, *extent);
+        ++starts[extent->first];
+        ++ends[extent->second];
     }
 }
 
-void SummaryHandlingProxyModel::Private::insertInCache(const SummaryHandlingProxyModel *model,
-                                                       const QModelIndex &sourceIdx) const
+/* Returns the start and end time of the summary \a sourceIdx, rolling
+ * up its children the first time. */
+SummaryHandlingProxyModel::Private::Extent
+SummaryHandlingProxyModel::Private::summaryExtent(const SummaryHandlingProxyModel *model,
+                                                  const QModelIndex &sourceIdx) const
 {
+    QHash<QModelIndex, RollUp>::const_iterator it = rollups.constFind(sourceIdx);
+    if (it != rollups.constEnd())
+        return it->extent();
+
     QAbstractItemModel *sourceModel = model->sourceModel();
-    const QModelIndex &mainIdx = sourceIdx;
-    QDateTime st;
-    QDateTime et;
-
-    for (int r = 0; r < sourceModel->rowCount(mainIdx); ++r) {
-        QModelIndex pdIdx = model->mapFromSource(sourceModel->index(r, 0, mainIdx));
-        /* The probably results in recursive calls here */
-        QVariant tmpsv = model->data(pdIdx, StartTimeRole);
-        QVariant tmpev = model->data(pdIdx, EndTimeRole);
-        if (!tmpsv.canConvert(QVariant::DateTime) || !tmpev.canConvert(QVariant::DateTime)) {
-            qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
-            continue;
-        }
+    RollUp rollup;
+    for (int r = 0; r < sourceModel->rowCount(sourceIdx); ++r) {
+        Extent extent;
+        // Summaries among the children are rolled up first
+        if (childExtent(model, sourceModel->index(r, 0, sourceIdx), &extent))
+            rollup.setChildExtent(r, &extent);
+    }
+    const Extent extent = rollup.extent();
+    rollups.insert(sourceIdx, rollup);
+    writeBack(model, sourceIdx, extent);
+    return extent;
+}
 
-        // check for valid datetimes
-        if (tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid())
-            continue;
-        if (tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid())
-            continue;
-
-        // We need to test for empty strings to
-        // avoid a stupid Qt warning
-        if (tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty())
-            continue;
-        if (tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty())
-            continue;
-        QDateTime tmpst = tmpsv.toDateTime();
-        QDateTime tmpet = tmpev.toDateTime();
-        if (st.isNull() || st > tmpst)
-            st = tmpst;
-        if (et.isNull() || et < tmpet)
-            et = tmpet;
+/* Sets \a extent to the start and end time of \a sourceIdx, a child of
+ * a summary. Returns false if it has none. */
+bool SummaryHandlingProxyModel::Private::childExtent(const SummaryHandlingProxyModel *model,
+                                                     const QModelIndex &sourceIdx, Extent *extent) const
+{
+    if (isSummary(sourceIdx)) {
+        *extent = summaryExtent(model, sourceIdx);
+        return extent->first.isValid() && extent->second.isValid();
     }
+
+    QAbstractItemModel *sourceModel = model->sourceModel();
+    QVariant tmpsv = sourceModel->data(sourceIdx, StartTimeRole);
+    QVariant tmpev = sourceModel->data(sourceIdx, EndTimeRole);
+    if (!tmpsv.canConvert(QVariant::DateTime) || !tmpev.canConvert(QVariant::DateTime)) {
+        qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
+        return false;
+    }
+
+    // check for valid datetimes
+    if (tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid())
+        return false;
+    if (tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid())
+        return false;
+
+    // We need to test for empty strings to
+    // avoid a stupid Qt warning
+    if (tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty())
+        return false;
+    if (tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty())
+        return false;
+    *extent = Extent(tmpsv.toDateTime(), tmpev.toDateTime());
+    return true;
+}
+
+/* Updates the roll-ups of the ancestors of \a sourceIdx for a change of
+ * its times, up to the first one whose extent stays the same.
+ * Returns the summaries whose extent changed.
+ *
+ * Rolling up a summary rolls up the summaries below it, so the
+ * ancestors of a summary not rolled up yet are not either.
+ */
+QList<QModelIndex> SummaryHandlingProxyModel::Private::updateAncestors(const SummaryHandlingProxyModel *model,
+                                                                       const QModelIndex &sourceIdx) const
+{
+    QList<QModelIndex> changed;
+    QAbstractItemModel *sourceModel = model->sourceModel();
+    QModelIndex idx = sourceIdx.sibling(sourceIdx.row(), 0);
+    QModelIndex parentIdx;
+    while ((parentIdx = sourceModel->parent(idx)).isValid() && rollups.contains(parentIdx)) {
+        Extent extent;
+        const bool hasExtent = childExtent(model, idx, &extent);
+        RollUp &rollup = rollups[parentIdx];
+        const Extent oldExtent = rollup.extent();
+        rollup.setChildExtent(idx.row(), hasExtent ? &extent : nullptr);
+        const Extent newExtent = rollup.extent();
+        if (newExtent == oldExtent)
+            break;
+        writeBack(model, parentIdx, newExtent);
+        changed << parentIdx;
+        idx = parentIdx;
+    }
+    return changed;
+}
+
+/* Stores the start and end time of a summary in the source model, if it
+ * has them already. */
+void SummaryHandlingProxyModel::Private::writeBack(const SummaryHandlingProxyModel *model,
+                                                   const QModelIndex &mainIdx, const Extent &extent) const
+{
+    QAbstractItemModel *sourceModel = model->sourceModel();
+    const QDateTime &st = extent.first;
+    const QDateTime &et = extent.second;
+    ++writingBack;
     QVariant tmpssv = sourceModel->data(mainIdx, StartTimeRole);
     QVariant tmpsev = sourceModel->data(mainIdx, EndTimeRole);
     if (tmpssv.canConvert(QVariant::DateTime)
@@ -96,17 +159,12 @@ void SummaryHandlingProxyModel::Private::insertInCache(const SummaryHandlingProx
         && !(tmpsev.canConvert(QVariant::String) && tmpsev.toString().isEmpty())
         && tmpsev.toDateTime() != et)
         sourceModel->setData(mainIdx, et, EndTimeRole);
-    cached_summary_items[sourceIdx] = qMakePair(st, et);
-}
-
-void SummaryHandlingProxyModel::Private::removeFromCache(const QModelIndex &idx) const
-{
-    cached_summary_items.remove(idx);
+    --writingBack;
 }
 
 void SummaryHandlingProxyModel::Private::clearCache() const
 {
-    cached_summary_items.clear();
+    rollups.clear();
 }
 
 /*! Constructor. Creates a new SummaryHandlingProxyModel with
@@ -164,17 +222,29 @@ void SummaryHandlingProxyModel::sourceLayoutChanged()
 
 void SummaryHandlingProxyModel::sourceDataChanged(const QModelIndex &from, const QModelIndex &to)
 {
-    QAbstractItemModel *model = sourceModel();
-    QModelIndex parentIdx = from;
-    do {
-        const QModelIndex &dataIdx = parentIdx;
-        if (model->data(dataIdx, ItemTypeRole) == TypeSummary) {
-            // qDebug() << "removing " << parentIdx << "from cache";
-            d->removeFromCache(dataIdx);
+    // The times of the summaries written back to the source model are
+    // rolled up already
+    if (!d->writingBack) {
+        QAbstractItemModel *model = sourceModel();
+        const QModelIndex parentIdx = model->parent(from);
+        QList<QModelIndex> changed;
+        for (int row = from.row(); row <= to.row(); ++row) {
+            const QModelIndex dataIdx = model->index(row, 0, parentIdx);
+            if (d->isSummary(dataIdx)) {
+                // Restore the rolled up times if they were overwritten
+                if (d->rollups.contains(dataIdx))
+                    d->writeBack(this, dataIdx, d->rollups.value(dataIdx).extent());
+            } else {
+                // May have been a summary before
+                d->rollups.remove(dataIdx);
+            }
+            changed += d->updateAncestors(this, dataIdx);
+        }
+        Q_FOREACH (const QModelIndex &dataIdx, changed) {
             QModelIndex proxyDataIdx = mapFromSource(dataIdx);
             emit dataChanged(proxyDataIdx, proxyDataIdx);
         }
-    } while ((parentIdx = model->parent(parentIdx)) != QModelIndex());
+    }
 
     BASE::sourceDataChanged(from, to);
 }
@@ -227,39 +297,18 @@ QVariant SummaryHandlingProxyModel::data(const QModelIndex &proxyIndex, int role
     const QAbstractItemModel *model = sourceModel();
     if (d->isSummary(sidx) && (role == StartTimeRole || role == EndTimeRole)) {
         // qDebug() << "requested summary";
-        QPair<QDateTime, QDateTime> result;
-        if (d->cacheLookup(sidx, &result)) {
-            // qDebug() << "SummaryHandlingProxyModel::data(): Looking up summary for " << proxyIndex << role;
-            switch (role) {
-            case StartTimeRole:
-                return result.first;
-            case EndTimeRole:
-                return result.second;
-            default: /* fall thru */;
-            }
-        } else {
-            d->insertInCache(this, sidx);
-            return data(proxyIndex, role); /* TODO: Optimize */
-        }
+        const Private::Extent extent = d->summaryExtent(this, sidx);
+        return role == StartTimeRole ? extent.first : extent.second;
     }
     return model->data(sidx, role);
 }
 
-/*! \see QAbstractItemModel::setData */
+/*! \see QAbstractItemModel::setData
+ * The summaries containing \a index are updated when the source model
+ * reports the change.
+ */
 bool SummaryHandlingProxyModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-    QAbstractItemModel *model = sourceModel();
-    if (role == StartTimeRole || role == EndTimeRole) {
-        QModelIndex parentIdx = mapToSource(index);
-        do {
-            if (d->isSummary(parentIdx)) {
-                // qDebug() << "removing " << parentIdx << "from cache";
-                d->removeFromCache(parentIdx);
-                QModelIndex proxyParentIdx = mapFromSource(parentIdx);
-                emit dataChanged(proxyParentIdx, proxyParentIdx);
-            }
-        } while ((parentIdx = model->parent(parentIdx)) != QModelIndex());
-    }
     return BASE::setData(index, value, role);
 }
 
@@ -321,6 +370,86 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, SummaryHandlingProxyModel, "test")
     assertFalse(model.flags(topidx) & Qt::ItemIsEditable);
 }
 
+namespace {
+class TimeReadCountingModel : public QStandardItemModel
+{
+public:
+    QVariant data(const QModelIndex &idx, int role) const override
+    {
+        if (role == KDGantt::StartTimeRole || role == KDGantt::EndTimeRole)
+            ++timeReads;
+        return QStandardItemModel::data(idx, role);
+    }
+
+    mutable int timeReads = 0;
+};
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, SummaryHandlingProxyModelRollUp, "test")
+{
+    SummaryHandlingProxyModel model;
+    TimeReadCountingModel sourceModel;
+    model.setSourceModel(&sourceModel);
+
+    const QDateTime startdt(QDate(2007, 3, 1), QTime(8, 0));
+    auto *topitem = new QStandardItem(QString::fromLatin1("Project"));
+    topitem->setData(KDGantt::TypeSummary, KDGantt::ItemTypeRole);
+    sourceModel.appendRow(topitem);
+    QList<QStandardItem *> tasks;
+    for (int s = 0; s < 2; ++s) {
+        auto *summary = new QStandardItem(QString::fromLatin1("Phase %1").arg(s));
+        summary->setData(KDGantt::TypeSummary, KDGantt::ItemTypeRole);
+        // Times stored in the model are kept up to date
+        summary->setData(startdt, KDGantt::StartTimeRole);
+        summary->setData(startdt, KDGantt::EndTimeRole);
+        topitem->appendRow(summary);
+        for (int t = 0; t < 100; ++t) {
+            auto *task = new QStandardItem(QString::fromLatin1("Task %1").arg(t));
+            task->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+            task->setData(startdt.addDays(s * 100 + t), KDGantt::StartTimeRole);
+            task->setData(startdt.addDays(s * 100 + t + 2), KDGantt::EndTimeRole);
+            summary->appendRow(task);
+            tasks << task;
+        }
+    }
+
+    const QModelIndex topidx = model.index(0, 0);
+    const QModelIndex phase0idx = model.index(0, 0, topidx);
+    assertEqual(model.data(topidx, KDGantt::StartTimeRole).toDateTime(), startdt);
+    assertEqual(model.data(topidx, KDGantt::EndTimeRole).toDateTime(), startdt.addDays(201));
+    assertEqual(model.data(phase0idx, KDGantt::EndTimeRole).toDateTime(), startdt.addDays(101));
+    assertEqual(sourceModel.data(sourceModel.index(0, 0, sourceModel.index(0, 0)), KDGantt::EndTimeRole).toDateTime(),
+                startdt.addDays(101));
+
+    // Moving a task reads its times and the ones of its ancestors only
+    sourceModel.timeReads = 0;
+    tasks.at(150)->setData(startdt.addDays(-5), KDGantt::StartTimeRole);
+    assertTrue(sourceModel.timeReads < 20);
+    assertEqual(model.data(topidx, KDGantt::StartTimeRole).toDateTime(), startdt.addDays(-5));
+    assertEqual(model.data(model.index(1, 0, topidx), KDGantt::StartTimeRole).toDateTime(), startdt.addDays(-5));
+    assertEqual(model.data(phase0idx, KDGantt::StartTimeRole).toDateTime(), startdt);
+
+    // Shrinking back to the next earliest task
+    sourceModel.timeReads = 0;
+    tasks.at(150)->setData(startdt.addDays(150), KDGantt::StartTimeRole);
+    tasks.at(0)->setData(startdt.addDays(3), KDGantt::StartTimeRole);
+    tasks.at(199)->setData(startdt.addDays(10), KDGantt::EndTimeRole);
+    assertTrue(sourceModel.timeReads < 60);
+    assertEqual(model.data(topidx, KDGantt::StartTimeRole).toDateTime(), startdt.addDays(1));
+    assertEqual(model.data(topidx, KDGantt::EndTimeRole).toDateTime(), startdt.addDays(200));
+    assertEqual(model.data(model.index(1, 0, topidx), KDGantt::StartTimeRole).toDateTime(), startdt.addDays(100));
+    assertEqual(sourceModel.data(sourceModel.index(0, 0, sourceModel.index(0, 0)), KDGantt::StartTimeRole).toDateTime(),
+                startdt.addDays(1));
+
+    // A task becoming a summary of no tasks does not count anymore
+    tasks.at(1)->setData(KDGantt::TypeSummary, KDGantt::ItemTypeRole);
+    assertEqual(model.data(phase0idx, KDGantt::StartTimeRole).toDateTime(), startdt.addDays(2));
+
+    // Structural changes roll up again
+    topitem->child(0)->removeRow(2);
+    assertEqual(model.data(phase0idx, KDGantt::StartTimeRole).toDateTime(), startdt.addDays(3));
+}
+
 #endif /* KDAB_NO_UNIT_TESTS */
 
 #include "moc_kdganttsummaryhandlingproxymodel.cpp"
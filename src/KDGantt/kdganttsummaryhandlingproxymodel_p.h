@@ -15,6 +15,8 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QList>
+#include <QMap>
 #include <QPair>
 #include <QPersistentModelIndex>
 
@@ -22,10 +24,34 @@ namespace KDGantt {
 class SummaryHandlingProxyModel::Private
 {
 public:
-    bool cacheLookup(const QModelIndex &idx,
-                     QPair<QDateTime, QDateTime> *result) const;
-    void insertInCache(const SummaryHandlingProxyModel *model, const QModelIndex &idx) const;
-    void removeFromCache(const QModelIndex &idx) const;
+    typedef QPair<QDateTime, QDateTime> Extent;
+
+    /* The start and end times of the children of a summary. The times
+     * are counted, so that the extent of the summary is found again
+     * when the child at its start or end moves. */
+    struct RollUp
+    {
+        QHash<int, Extent> children; // by row, for the children having times
+        QMap<QDateTime, int> starts;
+        QMap<QDateTime, int> ends;
+
+        Extent extent() const
+        {
+            return Extent(starts.isEmpty() ? QDateTime() : starts.firstKey(),
+                          ends.isEmpty() ? QDateTime() : ends.lastKey());
+        }
+        void setChildExtent(int row, const Extent *extent);
+    };
+
+    Private()
+        : writingBack(0)
+    {
+    }
+
+    Extent summaryExtent(const SummaryHandlingProxyModel *model, const QModelIndex &idx) const;
+    bool childExtent(const SummaryHandlingProxyModel *model, const QModelIndex &idx, Extent *extent) const;
+    QList<QModelIndex> updateAncestors(const SummaryHandlingProxyModel *model, const QModelIndex &idx) const;
+    void writeBack(const SummaryHandlingProxyModel *model, const QModelIndex &idx, const Extent &extent) const;
     void clearCache() const;
 
     inline bool isSummary(const QModelIndex &idx) const
@@ -34,7 +60,8 @@ public:
         return (typ == TypeSummary) || (typ == TypeMulti);
     }
 
-    mutable QHash<QModelIndex, QPair<QDateTime, QDateTime>> cached_summary_items;
+    mutable QHash<QModelIndex, RollUp> rollups;
+    mutable int writingBack;
 };
 }
 
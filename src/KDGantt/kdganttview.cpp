@@ -141,6 +141,10 @@ void View::Private::updateScene()
     gfxview->clearItems();
     if (!model)
         return;
+    if (gfxview->isVirtualizationEnabled()) {
+        gfxview->updateScene();
+        return;
+    }
 
     if (auto *tw = qobject_cast<QTreeView *>(leftWidget)) {
         QModelIndex idx = ganttProxyModel.mapFromSource(model->index(0, 0, leftWidget->rootIndex()));
@@ -161,6 +165,11 @@ void View::Private::slotCollapsed(const QModelIndex &_idx)
     auto *tw = qobject_cast<QTreeView *>(leftWidget);
     if (!tw)
         return;
+    // All the rows below move, and only the ones in view have items
+    if (gfxview->isVirtualizationEnabled()) {
+        gfxview->updateScene();
+        return;
+    }
 
     bool blocked = gfxview->blockSignals(true);
 
@@ -194,6 +203,10 @@ void View::Private::slotCollapsed(const QModelIndex &_idx)
 
 void View::Private::slotExpanded(const QModelIndex &_idx)
 {
+    if (gfxview->isVirtualizationEnabled()) {
+        gfxview->updateScene();
+        return;
+    }
     QModelIndex idx(ganttProxyModel.mapFromSource(_idx));
     do {
         // qDebug() << "Updating row" << idx << idx.data( Qt::DisplayRole ).toString();
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef BENCHMARKTOOLS_H
+#define BENCHMARKTOOLS_H
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QPointer>
+
+#include <iostream>
+
+#include <KDGanttAbstractRowController>
+
+/* Shared by the Gantt benchmarks */
+
+/* Lays out the rows of a flat model with a fixed height, in constant
+ * time per row, so that the benchmarks measure the scene only. */
+class FlatRowController : public KDGantt::AbstractRowController
+{
+private:
+    static const int ROW_HEIGHT = 20;
+    QPointer<QAbstractItemModel> m_model;
+
+public:
+    void setModel(QAbstractItemModel *model)
+    {
+        m_model = model;
+    }
+
+    /*reimp*/ int headerHeight() const override
+    {
+        return 40;
+    }
+    /*reimp*/ bool isRowVisible(const QModelIndex &) const override
+    {
+        return true;
+    }
+    /*reimp*/ bool isRowExpanded(const QModelIndex &) const override
+    {
+        return false;
+    }
+    /*reimp*/ KDGantt::Span rowGeometry(const QModelIndex &idx) const override
+    {
+        return KDGantt::Span(idx.row() * ROW_HEIGHT, ROW_HEIGHT);
+    }
+    /*reimp*/ int maximumItemHeight() const override
+    {
+        return ROW_HEIGHT / 2;
+    }
+    /*reimp*/ int totalHeight() const override
+    {
+        return m_model.isNull() ? 0 : m_model->rowCount() * ROW_HEIGHT;
+    }
+    /*reimp*/ QModelIndex indexAt(int height) const override
+    {
+        return m_model->index(height / ROW_HEIGHT, 0);
+    }
+    /*reimp*/ QModelIndex indexBelow(const QModelIndex &idx) const override
+    {
+        if (!idx.isValid())
+            return QModelIndex();
+        return idx.model()->index(idx.row() + 1, idx.column(), idx.parent());
+    }
+    /*reimp*/ QModelIndex indexAbove(const QModelIndex &idx) const override
+    {
+        if (!idx.isValid())
+            return QModelIndex();
+        return idx.model()->index(idx.row() - 1, idx.column(), idx.parent());
+    }
+};
+
+/* Prints the time taken by step and restarts timer */
+inline void report(const char *step, QElapsedTimer &timer)
+{
+    std::cout << step << ": " << timer.restart() << " ms" << std::endl;
+}
+
+#endif /* BENCHMARKTOOLS_H */
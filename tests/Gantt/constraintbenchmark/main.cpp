@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStandardItemModel>
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <KDGanttConstraintModel>
+#include <KDGanttGraphicsView>
+
+#include "../benchmarktools.h"
+
+/* Builds the scene of a large plan with many dependencies and prints the
+ * time taken by each step.
+ *
+ * Usage: Ganttconstraintbenchmark-manual-test [tasks [constraints]]
+ */
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+
+    const int taskCount = argc > 1 ? atoi(argv[1]) : 50000;
+    const int constraintCount = argc > 2 ? atoi(argv[2]) : 80000;
+    std::cout << taskCount << " tasks, " << constraintCount << " constraints" << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStandardItemModel model(taskCount, 1);
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int row = 0; row < taskCount; ++row) {
+        const QModelIndex idx = model.index(row, 0);
+        model.setData(idx, QString::fromLatin1("Task %1").arg(row));
+        model.setData(idx, KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        model.setData(idx, start.addSecs(3600 * row), KDGantt::StartTimeRole);
+        model.setData(idx, start.addSecs(3600 * row + 7200), KDGantt::EndTimeRole);
+    }
+    report("model", timer);
+
+    // Each task depends on one or two of the tasks shortly before it
+    KDGantt::ConstraintModel constraints;
+    srand(42);
+    for (int i = 0; i < constraintCount && taskCount > 1; ++i) {
+        const int to = 1 + i % (taskCount - 1);
+        const int from = qMax(0, to - 1 - rand() % 16);
+        constraints.addConstraint(KDGantt::Constraint(model.index(from, 0), model.index(to, 0)));
+    }
+    report("constraints", timer);
+
+    FlatRowController rowController;
+    rowController.setModel(&model);
+    KDGantt::GraphicsView view;
+    view.setReadOnly(true);
+    view.setRowController(&rowController);
+    view.setConstraintModel(&constraints);
+    view.setModel(&model);
+    report("scene", timer);
+
+    // Sorting by name moves most persistent indexes, the view builds the scene again
+    model.sort(0, Qt::DescendingOrder);
+    report("scene after sorting", timer);
+
+    int degrees = 0;
+    for (int row = 0; row < taskCount; ++row)
+        degrees += constraints.constraintsForIndex(model.index(row, 0)).count();
+    report("constraintsForIndex for every task", timer);
+    std::cout << "total degree: " << degrees << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStandardItemModel>
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <KDGanttConstraintModel>
+#include <KDGanttCriticalPathProxyModel>
+
+#include "../benchmarktools.h"
+
+/* Computes the critical path of a large plan, then moves single tasks
+ * and prints the time taken by each step.
+ *
+ * Usage: Ganttcriticalpathbenchmark-manual-test [tasks [constraints [moves]]]
+ */
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const int taskCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    const int constraintCount = argc > 2 ? atoi(argv[2]) : 1500000;
+    const int moveCount = argc > 3 ? atoi(argv[3]) : 1000;
+    std::cout << taskCount << " tasks, " << constraintCount << " constraints" << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStandardItemModel model(taskCount, 1);
+    const QDateTime start(QDate(2024, 1, 1), QTime(8, 0));
+    for (int row = 0; row < taskCount; ++row) {
+        const QModelIndex idx = model.index(row, 0);
+        model.setData(idx, KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        model.setData(idx, start.addSecs(60 * row), KDGantt::StartTimeRole);
+        model.setData(idx, start.addSecs(60 * row + 600 * (1 + row % 7)), KDGantt::EndTimeRole);
+    }
+    report("model", timer);
+
+    // Each task depends on one or two of the tasks shortly before it
+    KDGantt::ConstraintModel constraints;
+    srand(42);
+    for (int i = 0; i < constraintCount && taskCount > 1; ++i) {
+        const int to = 1 + i % (taskCount - 1);
+        const int from = qMax(0, to - 1 - rand() % 16);
+        constraints.addConstraint(KDGantt::Constraint(model.index(from, 0), model.index(to, 0)));
+    }
+    report("constraints", timer);
+
+    KDGantt::CriticalPathProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setConstraintModel(&constraints);
+    timer.restart();
+
+    const QDateTime finish = proxy.projectFinish();
+    report("schedule", timer);
+    std::cout << "project finish: " << finish.toString().toStdString() << std::endl;
+
+    // The tasks are known already, only the dependencies are sorted again
+    constraints.addConstraint(KDGantt::Constraint(model.index(0, 0), model.index(taskCount - 1, 0)));
+    proxy.projectFinish();
+    report("schedule after adding a constraint", timer);
+
+    std::cout << "critical path: " << proxy.criticalPath().size() << " tasks" << std::endl;
+    timer.restart();
+
+    for (int i = 0; i < moveCount; ++i) {
+        const QModelIndex idx = model.index(rand() % taskCount, 0);
+        model.setData(idx, model.data(idx, KDGantt::StartTimeRole).toDateTime().addSecs(-300), KDGantt::StartTimeRole);
+    }
+    report("single task moves", timer);
+
+    return 0;
+}
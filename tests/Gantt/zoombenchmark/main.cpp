@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001-2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStandardItemModel>
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <KDGanttDateTimeGrid>
+#include <KDGanttGraphicsView>
+
+#include "../benchmarktools.h"
+
+/* Zooms the view of a large plan in and out, repainting after each step
+ * like an interactive zoom does, and prints the frames per second. Then
+ * changes the times of some tasks and prints the time taken.
+ *
+ * Usage: Ganttzoombenchmark-manual-test [tasks [steps]]
+ */
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+
+    const int taskCount = argc > 1 ? atoi(argv[1]) : 100000;
+    const int stepCount = argc > 2 ? atoi(argv[2]) : 40;
+    std::cout << taskCount << " tasks, " << stepCount << " zoom steps" << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStandardItemModel model(taskCount, 1);
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int row = 0; row < taskCount; ++row) {
+        const QModelIndex idx = model.index(row, 0);
+        model.setData(idx, QString::fromLatin1("Task %1").arg(row));
+        model.setData(idx, KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        model.setData(idx, start.addSecs(600 * row), KDGantt::StartTimeRole);
+        model.setData(idx, start.addSecs(600 * row + 7200), KDGantt::EndTimeRole);
+    }
+    report("model", timer);
+
+    FlatRowController rowController;
+    rowController.setModel(&model);
+    KDGantt::GraphicsView view;
+    view.setReadOnly(true);
+    view.setRowController(&rowController);
+    view.setModel(&model);
+    view.resize(1000, 600);
+    view.show();
+    app.processEvents();
+    report("scene", timer);
+
+    auto *grid = qobject_cast<KDGantt::DateTimeGrid *>(view.grid());
+    for (int step = 0; step < stepCount; ++step) {
+        // Zoom in for the first half of the steps, and out again
+        grid->setDayWidth(step < stepCount / 2 ? grid->dayWidth() * 1.2 : grid->dayWidth() / 1.2);
+        view.viewport()->repaint();
+    }
+    const qint64 zoomTime = qMax<qint64>(1, timer.restart());
+    std::cout << "zoom: " << zoomTime << " ms, " << stepCount * 1000. / zoomTime << " frames per second" << std::endl;
+
+    // Moving a few tasks updates their rows only
+    for (int i = 0; i < 1000; ++i) {
+        const QModelIndex idx = model.index((i * 7919) % taskCount, 0);
+        model.setData(idx, start.addSecs(600 * idx.row() + 60), KDGantt::StartTimeRole);
+    }
+    report("1000 start time changes", timer);
+
+    return 0;
+}